@@ -426,6 +426,7 @@ developer.
 %files client-tests
 %defattr(-,root,root)
 %{_bindir}/arraytest
+%{_bindir}/columnblock
 %{_bindir}/odbcsample1
 %{_bindir}/sample0
 %{_bindir}/sample1
@@ -0,0 +1,249 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 1997 - July 2008 CWI, August 2008 - 2018 MonetDB B.V.
+ */
+
+/* Fetch the same result set with the textual protocol, and with
+ * protocol 10 both row-wise and column-wise, and compare the values. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <mapi.h>
+
+#define die(dbh,hdl)	do {						\
+				if (hdl)				\
+					mapi_explain_result(hdl,stderr); \
+				else if (dbh)				\
+					mapi_explain(dbh,stderr);	\
+				else					\
+					fprintf(stderr,"command failed\n"); \
+				exit(-1);				\
+			} while (0)
+
+#define NROWS	10000
+#define NCOLS	5
+/* small blocks, so that the result set needs many of them */
+#define BLOCKSIZE	(16 * 1024)
+
+static const char query[] = "select * from colblock order by i";
+
+static Mapi
+db_connect(const char *host, int port, int protocol, const char *compression)
+{
+	Mapi dbh;
+
+	dbh = mapi_mapi(host, port, "monetdb", "monetdb", "sql", NULL);
+	if (dbh == NULL || mapi_error(dbh))
+		die(dbh, NULL);
+	if (protocol == 10 &&
+	    mapi_set_protocol(dbh, 10, BLOCKSIZE, compression) != MOK)
+		die(dbh, NULL);
+	if (mapi_reconnect(dbh) != MOK || mapi_error(dbh))
+		die(dbh, NULL);
+	return dbh;
+}
+
+static char *
+dupfield(const char *s)
+{
+	char *p;
+
+	if (s == NULL)
+		return NULL;
+	if ((p = strdup(s)) == NULL) {
+		fprintf(stderr, "out of memory\n");
+		exit(-1);
+	}
+	return p;
+}
+
+/* compare value i of a column buffer with its textual form (NULL for
+ * NULL) */
+static int
+same_value(const MapiColumnBuffer *buf, int64_t i, const char *txt)
+{
+	const char *p;
+	char digits[64];
+	int64_t v;
+	size_t j, k;
+
+	if (buf->type == MAPI_VARCHAR) {
+		p = buf->values[i];
+		if (p == NULL || txt == NULL)
+			return p == txt;
+		return strcmp(p, txt) == 0;
+	}
+	p = (const char *) buf->data + i * buf->width;
+	if (buf->null && memcmp(p, buf->null, buf->width) == 0)
+		return txt == NULL;
+	if (txt == NULL)
+		return 0;
+	switch (buf->type) {
+	case MAPI_FLOAT: {
+		float f;
+
+		memcpy(&f, p, sizeof(f));
+		return f == strtof(txt, NULL);
+	}
+	case MAPI_DOUBLE: {
+		double d;
+
+		memcpy(&d, p, sizeof(d));
+		return d == strtod(txt, NULL);
+	}
+	default:
+		/* integers, and decimals which are sent unscaled */
+		for (j = k = 0; txt[j] && k < sizeof(digits) - 1; j++)
+			if (txt[j] != '.')
+				digits[k++] = txt[j];
+		digits[k] = 0;
+		switch (buf->width) {
+		case 1: {
+			int8_t x;
+			memcpy(&x, p, sizeof(x));
+			v = x;
+			break;
+		}
+		case 2: {
+			int16_t x;
+			memcpy(&x, p, sizeof(x));
+			v = x;
+			break;
+		}
+		case 4: {
+			int32_t x;
+			memcpy(&x, p, sizeof(x));
+			v = x;
+			break;
+		}
+		case 8:
+			memcpy(&v, p, sizeof(v));
+			break;
+		default:
+			return 0;
+		}
+		return v == strtoll(digits, NULL, 10);
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	Mapi dbh, dbh10;
+	MapiHdl hdl = NULL;
+	static char *txt[NROWS][NCOLS];
+	const MapiColumnBuffer *buf;
+	int64_t n, nrows = 0, r, blocks = 0, diffs = 0;
+	int i;
+
+	if (argc != 4) {
+		printf("usage:%s <host> <port> <compression>\n", argv[0]);
+		exit(-1);
+	}
+
+	dbh = db_connect(argv[1], atoi(argv[2]), 9, NULL);
+	if ((hdl = mapi_query(dbh, "create table colblock (i int, l bigint, d decimal(10,2), f double, s varchar(30))")) == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+	if ((hdl = mapi_query(dbh,
+			      "insert into colblock select value,"
+			      " case when value % 7 = 0 then null else (value - 5000) * 1000000007 end,"
+			      " case when value % 11 = 0 then null else (value - 5000) / 8.0 end,"
+			      " case when value % 13 = 0 then null else (value - 5000) / 16.0 end,"
+			      " case when value % 17 = 0 then null when value % 5 = 0 then 'q\"t\\tb\\\\n\\n' || value when value % 5 = 1 then '' else 's' || value end"
+			      " from generate_series(0, 10000)")) == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+
+	/* the reference: the textual protocol */
+	if ((hdl = mapi_query(dbh, query)) == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	while (mapi_fetch_row(hdl)) {
+		if (nrows == NROWS || mapi_get_field_count(hdl) != NCOLS) {
+			fprintf(stderr, "unexpected result\n");
+			exit(-1);
+		}
+		for (i = 0; i < NCOLS; i++)
+			txt[nrows][i] = dupfield(mapi_fetch_field(hdl, i));
+		nrows++;
+	}
+	if (mapi_error(dbh))
+		die(dbh, hdl);
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+	printf("text: %" PRId64 " rows\n", nrows);
+
+	dbh10 = db_connect(argv[1], atoi(argv[2]), 10, argv[3]);
+	printf("protocol %d, compression %s\n", mapi_get_protocol(dbh10), argv[3]);
+
+	/* protocol 10, row-wise */
+	if ((hdl = mapi_query(dbh10, query)) == NULL || mapi_error(dbh10))
+		die(dbh10, hdl);
+	for (r = 0; mapi_fetch_row(hdl); r++) {
+		if (r == nrows || mapi_get_field_count(hdl) != NCOLS) {
+			fprintf(stderr, "unexpected result\n");
+			exit(-1);
+		}
+		for (i = 0; i < NCOLS; i++) {
+			const char *p = mapi_fetch_field(hdl, i);
+
+			if (p == NULL || txt[r][i] == NULL ?
+			    p != txt[r][i] : strcmp(p, txt[r][i]) != 0)
+				diffs++;
+		}
+	}
+	if (mapi_error(dbh10))
+		die(dbh10, hdl);
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh10, hdl);
+	printf("rows: %" PRId64 " rows, %" PRId64 " differences\n", r, diffs);
+
+	/* protocol 10, column-wise */
+	diffs = 0;
+	if ((hdl = mapi_query(dbh10, query)) == NULL || mapi_error(dbh10))
+		die(dbh10, hdl);
+	for (r = 0; (n = mapi_fetch_column_block(hdl)) > 0; r += n) {
+		blocks++;
+		if (r + n > nrows) {
+			fprintf(stderr, "unexpected result\n");
+			exit(-1);
+		}
+		for (i = 0; i < NCOLS; i++) {
+			int64_t j;
+
+			if ((buf = mapi_get_column_buffer(hdl, i)) == NULL)
+				die(dbh10, hdl);
+			if (buf->count != n) {
+				fprintf(stderr, "unexpected column size\n");
+				exit(-1);
+			}
+			for (j = 0; j < n; j++)
+				if (!same_value(buf, j, txt[r + j][i]))
+					diffs++;
+		}
+	}
+	if (n < 0 || mapi_error(dbh10))
+		die(dbh10, hdl);
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh10, hdl);
+	printf("column blocks: %" PRId64 " rows, %s block, %" PRId64 " differences\n",
+	       r, blocks > 1 ? "more than one" : "one", diffs);
+
+	if ((hdl = mapi_query(dbh, "drop table colblock")) == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+	mapi_destroy(dbh10);
+	mapi_destroy(dbh);
+	for (r = 0; r < nrows; r++)
+		for (i = 0; i < NCOLS; i++)
+			free(txt[r][i]);
+	return 0;
+}
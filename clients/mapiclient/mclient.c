@@ -1940,6 +1940,10 @@ format_result(Mapi mid, MapiHdl hdl, bool singleinstr)
 
 			switch (formatter) {
 			case TRASHformatter:
+				/* binary result blocks need not be
+				 * converted to text */
+				while (mapi_fetch_column_block(hdl) > 0)
+					;
 				break;
 			case XMLformatter:
 				XMLrenderer(hdl);
@@ -3013,6 +3017,8 @@ usage(const char *prog, int xit)
 	fprintf(stderr, " -p portnr   | --port=portnr      port to connect to\n");
 	fprintf(stderr, " -u user     | --user=user        user id\n");
 	fprintf(stderr, " -d database | --database=database  database to connect to (may be URI)\n");
+	fprintf(stderr, " -B          | --binary           receive result sets in binary (protocol 10)\n");
+	fprintf(stderr, " -C kind     | --compression=kind compression of binary results {none,snappy,lz4}\n");
 
 	fprintf(stderr, " -e          | --echo             echo the query\n");
 #ifdef HAVE_ICONV
@@ -3071,8 +3077,12 @@ main(int argc, char **argv)
 	bool autocommit = true;	/* autocommit mode default on */
 	bool user_set_as_flag = false;
 	bool passwd_set_as_flag = false;
+	bool binary = false;
+	const char *compression = NULL;
 	static struct option long_options[] = {
 		{"autocommit", 0, 0, 'a'},
+		{"binary", 0, 0, 'B'},
+		{"compression", 1, 0, 'C'},
 		{"database", 1, 0, 'd'},
 		{"dump", 0, 0, 'D'},
 		{"inserts", 0, 0, 'N'},
@@ -3127,7 +3137,7 @@ main(int argc, char **argv)
 		mode = SQL;
 	}
 
-	while ((c = getopt_long(argc, argv, "ad:De"
+	while ((c = getopt_long(argc, argv, "aBC:d:De"
 #ifdef HAVE_ICONV
 				"E:"
 #endif
@@ -3149,6 +3159,14 @@ main(int argc, char **argv)
 		case 'a':
 			autocommit = false;
 			break;
+		case 'B':
+			binary = true;
+			break;
+		case 'C':
+			assert(optarg);
+			compression = optarg;
+			binary = true;
+			break;
 		case 'd':
 			assert(optarg);
 			if (dbname)
@@ -3363,6 +3381,11 @@ main(int argc, char **argv)
 	if (dbname)
 		free(dbname);
 	dbname = NULL;
+	if (mid && binary && mapi_error(mid) == MOK &&
+	    mapi_set_protocol(mid, 10, 0, compression) != MOK) {
+		fprintf(stderr, "%s\n", mapi_error_str(mid));
+		exit(2);
+	}
 	if (mid && mapi_error(mid) == MOK)
 		mapi_reconnect(mid);	/* actually, initial connect */
 
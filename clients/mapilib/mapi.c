@@ -270,6 +270,7 @@
  * @item mapi_explain()	@tab	Display error message and context on stream
  * @item mapi_explain_query()	@tab	Display error message and context on stream
  * @item mapi_fetch_all_rows()	@tab	Fetch all answers from server into cache
+ * @item mapi_fetch_column_block()	@tab	Fetch next block of rows column-wise
  * @item mapi_fetch_field()	@tab Fetch a field from the current row
  * @item mapi_fetch_field_len()	@tab Fetch the length of a field from the current row
  * @item mapi_fetch_line()	@tab	Retrieve the next line
@@ -284,8 +285,10 @@
  * @item mapi_get_mapi_version()	@tab Mapi version name
  * @item mapi_get_monet_version()	@tab MonetDB version name
  * @item mapi_get_motd()	@tab	Get server welcome message
+ * @item mapi_get_protocol()	@tab	Protocol version in use
  * @item mapi_get_row_count()	@tab	Number of rows in cache or -1
  * @item mapi_get_last_id()	@tab	last inserted id of an auto_increment (or alike) column
+ * @item mapi_get_column_buffer()	@tab	Get a column of the current block
  * @item mapi_get_from()	@tab	Get the stream 'from'
  * @item mapi_get_to()	@tab	Get the stream 'to'
  * @item mapi_get_trace()	@tab	Get trace flag
@@ -302,6 +305,7 @@
  * @item mapi_rows_affected()	@tab Obtain number of rows changed
  * @item mapi_seek_row()	@tab	Move row reader to specific location in cache
  * @item mapi_setAutocommit()	@tab	Set auto-commit flag
+ * @item mapi_set_protocol()	@tab	Select the protocol for the next connection
  * @item mapi_stream_query()	@tab Send query and prepare for reading tuple stream
  * @item mapi_table()	@tab	Get current table name
  * @item mapi_timeout()	@tab	Set timeout for long-running queries[TODO]
@@ -422,6 +426,19 @@
  * @item MapiMsg mapi_ping(Mapi mid)
  *
  * Test availability of the server. Returns zero upon success.
+ *
+ * @item MapiMsg mapi_set_protocol(Mapi mid, int protover, size_t blocksize, const char *compression)
+ *
+ * Select the protocol used when the connection is (re)established.
+ * Version 9 is the textual protocol.  With version 10 the server
+ * sends result sets column-wise in binary blocks of at most
+ * @emph{blocksize} bytes (0 for the default), compressed using
+ * @emph{compression} ("none", "snappy" or "lz4", when supported).
+ * Version 9 is used when the server does not support version 10.
+ *
+ * @item int mapi_get_protocol(Mapi mid)
+ *
+ * Return the protocol version used by the current connection.
  * @end itemize
  *
  * @subsection Sending Queries
@@ -515,6 +532,26 @@
  * @code{mapi_fetch_row()} will take the row from the cache. The number or
  * rows cached is returned.
  *
+ * @item int64_t mapi_fetch_column_block(MapiHdl hdl)
+ *
+ * Fetch the next block of rows of a result set received with protocol
+ * version 10 without converting them to text.  The number of rows in
+ * the block is returned, zero if there are no more rows (or the result
+ * set was not received in binary), and -1 on error.  The rows can
+ * no longer be fetched with @code{mapi_fetch_row()}.
+ *
+ * @item const MapiColumnBuffer *mapi_get_column_buffer(MapiHdl hdl, int fnr)
+ *
+ * Return the values of column @emph{fnr} in the block fetched last.
+ * Fixed-width values are accessed in place in the received block
+ * through the @code{data} field, of which the @code{width} and
+ * @code{type} are given; @code{null} points to the value that
+ * represents NULL.  Dates and timestamps are given in milliseconds
+ * since the epoch, times in milliseconds since midnight, and decimals
+ * unscaled.  For strings and blobs, @code{values} holds pointers to the
+ * values (NULL for NULL) and @code{lengths} their lengths.  The buffer
+ * is valid until the next call of @code{mapi_fetch_column_block()}.
+ *
  * @item MapiMsg mapi_seek_row(MapiHdl hdl, int64_t rownr, int whence)
  *
  * Reset the row pointer to the requested row number.  If whence is
@@ -824,6 +861,54 @@ struct BlockCache {
 	int nxt;
 	int end;
 	int eos;		/* end of sequence */
+	int eom;		/* end of message already read from stream */
+};
+
+/*
+ * With protocol 10 the server ships the tuples of a result set
+ * column-wise in binary blocks.  Each block is a separate message
+ * which is kept as received; fixed-width columns are accessed in
+ * place, for the others an array of pointers into the block is
+ * built.  Applications that fetch rows are served from the row
+ * cache, into which the blocks are converted.
+ */
+enum MapiBinaryKind {
+	BIN_INT,		/* tinyint .. hugeint, month_interval */
+	BIN_BOOL,
+	BIN_DEC,		/* decimal, sec_interval */
+	BIN_FLT,
+	BIN_DBL,
+	BIN_OID,
+	BIN_DATE,		/* milliseconds since the epoch */
+	BIN_TIMESTAMP,		/* milliseconds since the epoch */
+	BIN_TIME,		/* milliseconds since midnight */
+	BIN_STR,
+	BIN_BLOB
+};
+
+struct MapiBinaryColumn {
+	enum MapiBinaryKind kind;
+	int typelen;		/* -1 for variable sized columns */
+	int quote;		/* quote value in the row cache */
+	int has_tz;
+	int fraction;		/* digits after the second */
+	int scale;
+	int nil_len;		/* 0 if the column has no NULL values */
+	char *nil;
+	MapiColumnBuffer buf;	/* current block of this column */
+	const char **values;	/* space for buf.values */
+	size_t *lengths;	/* space for buf.lengths */
+	int64_t size;		/* allocated size of values and lengths */
+};
+
+struct MapiBinaryResult {
+	int timezone;		/* in milliseconds */
+	int columnar;		/* application uses column blocks */
+	int initial;		/* still reading the initial response */
+	int64_t received;	/* number of rows received */
+	char *block;		/* current block, NULL if none */
+	int64_t rows;		/* number of rows in the current block */
+	struct MapiBinaryColumn *cols;
 };
 
 /* A connection to a server is represented by a struct MapiStruct.  An
@@ -864,6 +949,11 @@ struct MapiStruct {
 	stream *tracelog;	/* keep a log for inspection */
 	stream *from, *to;
 	int index;		/* to mark the log records */
+
+	int protocol;		/* requested protocol version: 9 or 10 */
+	size_t blocksize;	/* block size for protocol 10 */
+	compression_method compression;	/* compression for protocol 10 */
+	int prot10;		/* protocol 10 is in use */
 };
 
 struct MapiResultSet {
@@ -884,6 +974,7 @@ struct MapiResultSet {
 	struct MapiColumn *fields;
 	struct MapiRowBuf cache;
 	int commentonly;	/* only comments seen so far */
+	struct MapiBinaryResult *binary;	/* protocol 10 result set */
 };
 
 struct MapiStatement {
@@ -966,6 +1057,7 @@ static MapiMsg read_into_cache(MapiHdl hdl, int lookahead);
 static int unquote(const char *msg, char **start, const char **next, int endchar, size_t *lenp);
 static int mapi_slice_row(struct MapiResultSet *result, int cr);
 static void mapi_store_bind(struct MapiResultSet *result, int cr);
+static void free_binary_result(struct MapiResultSet *result);
 
 static int mapi_initialized = 0;
 
@@ -1411,6 +1503,50 @@ mapi_ping(Mapi mid)
 	return mid->error;
 }
 
+/* Select the protocol used for subsequent connections: 9 is the
+   textual protocol, 10 sends result sets column-wise in binary.  A
+   blocksize of 0 selects the default. */
+MapiMsg
+mapi_set_protocol(Mapi mid, int protover, size_t blocksize, const char *compression)
+{
+	compression_method comp = COMPRESSION_NONE;
+
+	assert(mid);
+	mapi_clrError(mid);
+	if (protover != 9 && protover != 10)
+		return mapi_setError(mid, "Unsupported protocol version", "mapi_set_protocol", MERROR);
+	if (blocksize != 0 && blocksize < BLOCK)
+		return mapi_setError(mid, "Block size too small", "mapi_set_protocol", MERROR);
+	if (compression == NULL || strcmp(compression, "none") == 0) {
+		comp = COMPRESSION_NONE;
+	} else if (strcmp(compression, "snappy") == 0) {
+#ifdef HAVE_LIBSNAPPY
+		comp = COMPRESSION_SNAPPY;
+#else
+		return mapi_setError(mid, "Snappy compression not supported", "mapi_set_protocol", MERROR);
+#endif
+	} else if (strcmp(compression, "lz4") == 0) {
+#ifdef HAVE_LIBLZ4
+		comp = COMPRESSION_LZ4;
+#else
+		return mapi_setError(mid, "LZ4 compression not supported", "mapi_set_protocol", MERROR);
+#endif
+	} else {
+		return mapi_setError(mid, "Unknown compression method", "mapi_set_protocol", MERROR);
+	}
+	mid->protocol = protover;
+	mid->blocksize = blocksize == 0 ? 1024 * 1024 : blocksize;
+	mid->compression = comp;
+	return MOK;
+}
+
+/* return the protocol version used by the current connection */
+int
+mapi_get_protocol(Mapi mid)
+{
+	return mid->prot10 ? 10 : 9;
+}
+
 /* allocate a new structure to represent a result set */
 static struct MapiResultSet *
 new_result(MapiHdl hdl)
@@ -1461,6 +1597,7 @@ new_result(MapiHdl hdl)
 	result->cache.line = NULL;
 
 	result->commentonly = 1;
+	result->binary = NULL;
 
 	return result;
 }
@@ -1578,6 +1715,8 @@ close_result(MapiHdl hdl)
 		result->cache.line = NULL;
 		result->cache.tuplecount = 0;
 	}
+	if (result->binary)
+		free_binary_result(result);
 	if (result->errorstr && result->errorstr != nomem)
 		free(result->errorstr);
 	result->errorstr = NULL;
@@ -1859,10 +1998,15 @@ mapi_new(void)
 	mid->password = NULL;
 
 	mid->cachelimit = 100;
+	mid->protocol = 9;
+	mid->blocksize = 1024 * 1024;
+	mid->compression = COMPRESSION_NONE;
+	mid->prot10 = 0;
 	mid->redircnt = 0;
 	mid->redirmax = 10;
 	mid->tracelog = NULL;
 	mid->blk.eos = 0;
+	mid->blk.eom = 0;
 	mid->blk.buf = malloc(BLOCK + 1);
 	if (mid->blk.buf == NULL) {
 		mapi_destroy(mid);
@@ -2182,6 +2326,8 @@ mapi_reconnect(Mapi mid)
 	size_t len;
 	MapiHdl hdl;
 	int pversion = 0;
+	int prot10 = 0;
+	char bigendian = 0;
 	char *chal;
 	char *server;
 	char *protover;
@@ -2598,6 +2744,7 @@ mapi_reconnect(Mapi mid)
 		};
 		char **algs = algsv;
 		char *p;
+		char protopts[128] = "";
 
 		/* rBuCQ9WTn3:mserver:9:RIPEMD160,SHA256,SHA1,MD5:LIT:SHA1: */
 
@@ -2726,18 +2873,31 @@ mapi_reconnect(Mapi mid)
 			return mapi_setError(mid, buf, "mapi_reconnect", MERROR);
 		}
 
-		mnstr_set_byteorder(mid->from, strcmp(byteo, "BIG") == 0);
+		bigendian = strcmp(byteo, "BIG") == 0;
+		mnstr_set_byteorder(mid->from, bigendian);
+
+		/* only a database server itself can switch to the binary
+		 * result set protocol */
+		prot10 = mid->protocol == 10 && strcmp(server, "mserver") == 0;
+		if (prot10)
+			snprintf(protopts, sizeof(protopts),
+				 "PROT10:%s:%zu:COMPUTECOLWIDTH:",
+				 mid->compression == COMPRESSION_SNAPPY ? "COMPRESSION_SNAPPY" :
+				 mid->compression == COMPRESSION_LZ4 ? "COMPRESSION_LZ4" :
+				 "COMPRESSION_NONE",
+				 mid->blocksize);
 
 		/* note: if we make the database field an empty string, it
 		 * means we want the default.  However, it *should* be there. */
-		if (snprintf(buf, BLOCK, "%s:%s:%s:%s:%s:\n",
+		if (snprintf(buf, BLOCK, "%s:%s:%s:%s:%s:%s\n",
 #ifdef WORDS_BIGENDIAN
 			     "BIG",
 #else
 			     "LIT",
 #endif
 			     mid->username, hash, mid->language,
-			     mid->database == NULL ? "" : mid->database) >= BLOCK) {;
+			     mid->database == NULL ? "" : mid->database,
+			     protopts) >= BLOCK) {;
 			mapi_setError(mid, "combination of database name and user name too long", "mapi_reconnect", MERROR);
 			free(hash);
 			close_connection(mid);
@@ -2766,6 +2926,34 @@ mapi_reconnect(Mapi mid)
 	mnstr_flush(mid->to);
 	check_stream(mid, mid->to, "Could not send initial byte sequence", "mapi_reconnect", mid->error);
 
+	if (prot10) {
+		/* from here on the server talks to us through
+		 * block_stream2 streams, like we must talk to it */
+		stream *from, *to;
+
+		from = bs_stealstream(mid->from);
+		to = bs_stealstream(mid->to);
+		close_stream(mid->from);
+		close_stream(mid->to);
+		mid->from = block_stream2(from, mid->blocksize, mid->compression, COLUMN_COMPRESSION_NONE);
+		mid->to = block_stream2(to, mid->blocksize, mid->compression, COLUMN_COMPRESSION_NONE);
+		if (mid->from == NULL || mid->to == NULL) {
+			if (mid->to)
+				close_stream(mid->to);
+			else
+				close_stream(to);
+			if (mid->from)
+				close_stream(mid->from);
+			else
+				close_stream(from);
+			mid->from = mid->to = NULL;
+			close_connection(mid);
+			return mapi_setError(mid, "Could not create protocol 10 streams", "mapi_reconnect", MERROR);
+		}
+		mnstr_set_byteorder(mid->from, bigendian);
+		mid->prot10 = 1;
+	}
+
 	/* consume the welcome message from the server */
 	hdl = mapi_new_handle(mid);
 	if (hdl == NULL) {
@@ -3011,6 +3199,8 @@ close_connection(Mapi mid)
 		close_stream(mid->from);
 		mid->from = 0;
 	}
+	mid->prot10 = 0;
+	mid->blk.eom = 0;
 	mapi_log_record(mid, "Connection closed\n");
 }
 
@@ -3467,8 +3657,15 @@ read_line(Mapi mid)
 		/* fetch one more block */
 		if (mid->trace == MAPI_TRACE)
 			printf("fetch next block: start at:%d\n", mid->blk.end);
-		len = mnstr_read(mid->from, mid->blk.buf + mid->blk.end, 1, BLOCK);
-		check_stream(mid, mid->from, "Connection terminated during read line", "read_line", (mid->blk.eos = 1, (char *) 0));
+		if (mid->blk.eom) {
+			/* the end of the message was already consumed
+			 * by read_message() */
+			mid->blk.eom = 0;
+			len = 0;
+		} else {
+			len = mnstr_read(mid->from, mid->blk.buf + mid->blk.end, 1, BLOCK);
+			check_stream(mid, mid->from, "Connection terminated during read line", "read_line", (mid->blk.eos = 1, (char *) 0));
+		}
 		if (mid->tracelog) {
 			mapi_log_header(mid, "R");
 			mnstr_write(mid->tracelog, mid->blk.buf + mid->blk.end, 1, len);
@@ -3911,6 +4108,906 @@ parse_header_line(MapiHdl hdl, char *line, struct MapiResultSet *result)
 	return result;
 }
 
+/*
+ * Protocol 10 result sets.  The header of a result set and each
+ * block of rows is a separate message on the block_stream2 stream.
+ * All binary values are in the byte order of the server.
+ */
+
+/* reverse the byte order of n values of the given width */
+static void
+swap_values(void *p, size_t width, int64_t n)
+{
+	char *s = p, c;
+	size_t i;
+
+	for (; n > 0; n--, s += width) {
+		for (i = 0; i < width / 2; i++) {
+			c = s[i];
+			s[i] = s[width - 1 - i];
+			s[width - 1 - i] = c;
+		}
+	}
+}
+
+/* Read the rest of the current message from the server.  The message
+   starts with what read_line() left in the block cache.  The
+   returned buffer is malloced and NULL terminated. */
+static char *
+read_message(Mapi mid, size_t *lenp)
+{
+	size_t len = (size_t) (mid->blk.end - mid->blk.nxt);
+	size_t lim = len + mid->blocksize;
+	char *msg;
+	ssize_t n;
+
+	if ((msg = malloc(lim + 1)) == NULL) {
+		mapi_setError(mid, "Memory allocation failure", "read_message", MERROR);
+		return NULL;
+	}
+	memcpy(msg, mid->blk.buf + mid->blk.nxt, len);
+	mid->blk.nxt = mid->blk.end = 0;
+	mid->blk.buf[0] = 0;
+	if (mid->blk.eom) {
+		/* end of message was seen already */
+		mid->blk.eom = 0;
+	} else {
+		for (;;) {
+			if (lim - len < BLOCK) {
+				lim += mid->blocksize;
+				REALLOC(msg, lim + 1);
+				if (msg == NULL) {
+					close_connection(mid);
+					mapi_setError(mid, "Memory allocation failure", "read_message", MERROR);
+					return NULL;
+				}
+			}
+			n = mnstr_read(mid->from, msg + len, 1, lim - len);
+			if (n < 0 || mnstr_errnr(mid->from)) {
+				free(msg);
+				close_connection(mid);
+				mapi_setError(mid, "Connection terminated during read", "read_message", MTIMEOUT);
+				return NULL;
+			}
+			if (n == 0)
+				break;
+			len += (size_t) n;
+		}
+	}
+	msg[len] = 0;
+	if (mid->tracelog) {
+		mapi_log_header(mid, "R");
+		mnstr_printf(mid->tracelog, "binary message of %zu bytes\n", len);
+		mnstr_flush(mid->tracelog);
+	}
+	*lenp = len;
+	return msg;
+}
+
+struct MapiBinaryReader {
+	const char *buf;
+	size_t len;
+	size_t pos;
+	int swap;
+};
+
+static int
+get_binary(struct MapiBinaryReader *rd, void *dst, size_t size)
+{
+	if (rd->len - rd->pos < size)
+		return 0;
+	memcpy(dst, rd->buf + rd->pos, size);
+	if (rd->swap)
+		swap_values(dst, size, 1);
+	rd->pos += size;
+	return 1;
+}
+
+static const char *
+get_binary_str(struct MapiBinaryReader *rd)
+{
+	const char *s = rd->buf + rd->pos;
+	const char *e = memchr(s, 0, rd->len - rd->pos);
+
+	if (e == NULL)
+		return NULL;
+	rd->pos = (size_t) (e + 1 - rd->buf);
+	return s;
+}
+
+/* set the kind of a column and the type of its column buffer based
+   on the SQL type */
+static int
+classify_binary_column(struct MapiBinaryColumn *col, const char *type, int digits)
+{
+	col->quote = 0;
+	col->has_tz = 0;
+	col->fraction = digits > 0 ? digits - 1 : 0;
+	col->buf.width = col->typelen > 0 ? col->typelen : 0;
+	if (col->typelen < 0) {
+		if (strcmp(type, "blob") == 0) {
+			col->kind = BIN_BLOB;
+			col->buf.type = MAPI_BLOB;
+		} else {
+			col->kind = BIN_STR;
+			col->buf.type = MAPI_VARCHAR;
+			col->quote = strcmp(type, "char") == 0 ||
+				strcmp(type, "varchar") == 0 ||
+				strcmp(type, "clob") == 0;
+		}
+		return 0;
+	}
+	if (strcmp(type, "boolean") == 0)
+		col->kind = BIN_BOOL;
+	else if (strcmp(type, "decimal") == 0 ||
+		 strcmp(type, "sec_interval") == 0)
+		col->kind = BIN_DEC;
+	else if (strcmp(type, "real") == 0 ||
+		 strcmp(type, "double") == 0 ||
+		 strcmp(type, "float") == 0)
+		col->kind = col->typelen == 4 ? BIN_FLT : BIN_DBL;
+	else if (strcmp(type, "oid") == 0)
+		col->kind = BIN_OID;
+	else if (strcmp(type, "date") == 0)
+		col->kind = BIN_DATE;
+	else if (strncmp(type, "timestamp", 9) == 0) {
+		col->kind = BIN_TIMESTAMP;
+		col->has_tz = strcmp(type, "timestamptz") == 0;
+	} else if (strncmp(type, "time", 4) == 0) {
+		col->kind = BIN_TIME;
+		col->has_tz = strcmp(type, "timetz") == 0;
+	} else
+		col->kind = BIN_INT;
+	switch (col->typelen) {
+	case 0:
+	case 1:
+		col->buf.type = MAPI_TINY;
+		break;
+	case 2:
+		col->buf.type = MAPI_SHORT;
+		break;
+	case 4:
+		col->buf.type = col->kind == BIN_FLT ? MAPI_FLOAT : MAPI_INT;
+		break;
+	case 8:
+		col->buf.type = col->kind == BIN_DBL ? MAPI_DOUBLE : MAPI_LONGLONG;
+		break;
+#ifdef HAVE_HGE
+	case 16:
+		col->buf.type = MAPI_HUGE;
+		break;
+#endif
+	default:
+		return -1;
+	}
+	return 0;
+}
+
+/* add the header lines the textual protocol would have sent, so that
+   applications that look at them see no difference */
+static void
+add_binary_header_lines(struct MapiResultSet *result, int cacheall)
+{
+	static const char *tags[] = {"table_name", "name", "type", "length"};
+	char *line, *p;
+	size_t len;
+	int i, t;
+	char num[24];
+
+	for (t = 0; t < 4; t++) {
+		len = 32;
+		for (i = 0; i < result->fieldcnt; i++) {
+			struct MapiColumn *f = &result->fields[i];
+			const char *s = t == 0 ? f->tablename : t == 1 ? f->columnname : t == 2 ? f->columntype : NULL;
+			len += (s ? strlen(s) : sizeof(num)) + 2;
+		}
+		if ((line = malloc(len)) == NULL)
+			return;
+		p = line;
+		*p++ = '%';
+		for (i = 0; i < result->fieldcnt; i++) {
+			struct MapiColumn *f = &result->fields[i];
+			const char *s = t == 0 ? f->tablename : t == 1 ? f->columnname : t == 2 ? f->columntype : NULL;
+
+			if (s == NULL) {
+				snprintf(num, sizeof(num), "%d", f->columnlength);
+				s = num;
+			}
+			p += sprintf(p, "%s%s", i == 0 ? " " : ",\t", s);
+		}
+		sprintf(p, " # %s", tags[t]);
+		add_cache(result, line, cacheall);
+	}
+}
+
+static void
+free_binary_block(struct MapiBinaryResult *bin)
+{
+	if (bin->block) {
+		free(bin->block);
+		bin->block = NULL;
+	}
+	bin->rows = 0;
+}
+
+static void
+free_binary_result(struct MapiResultSet *result)
+{
+	struct MapiBinaryResult *bin = result->binary;
+	int i;
+
+	free_binary_block(bin);
+	if (bin->cols) {
+		for (i = 0; i < result->fieldcnt; i++) {
+			if (bin->cols[i].nil)
+				free(bin->cols[i].nil);
+			if (bin->cols[i].values)
+				free(bin->cols[i].values);
+			if (bin->cols[i].lengths)
+				free(bin->cols[i].lengths);
+		}
+		free(bin->cols);
+	}
+	free(bin);
+	result->binary = NULL;
+}
+
+/* Parse the header of a protocol 10 result set.  The "*" line was
+   just read by read_line. */
+static struct MapiResultSet *
+parse_binary_header(MapiHdl hdl, struct MapiResultSet *result, int cacheall)
+{
+	Mapi mid = hdl->mid;
+	struct MapiBinaryReader rd;
+	struct MapiBinaryResult *bin;
+	char *msg;
+	size_t len;
+	int tableid, timezone, i;
+	int64_t queryid, rowcount, colcount;
+
+	if ((msg = read_message(mid, &len)) == NULL)
+		return NULL;
+	rd.buf = msg;
+	rd.len = len;
+	rd.pos = 0;
+	rd.swap = mnstr_byteorder(mid->from) != 1234;
+	if (!get_binary(&rd, &tableid, sizeof(tableid)) ||
+	    !get_binary(&rd, &queryid, sizeof(queryid)) ||
+	    !get_binary(&rd, &rowcount, sizeof(rowcount)) ||
+	    !get_binary(&rd, &colcount, sizeof(colcount)) ||
+	    !get_binary(&rd, &timezone, sizeof(timezone)) ||
+	    rowcount < 0 || colcount < 0 || colcount > INT_MAX)
+		goto bailout;
+	(void) queryid;		/* ignored for now */
+
+	if (result == NULL || !result->commentonly)
+		result = new_result(hdl);
+	if (result == NULL) {
+		free(msg);
+		mapi_setError(mid, "Memory allocation failure", "parse_binary_header", MERROR);
+		return NULL;
+	}
+	result->querytype = Q_TABLE;
+	result->commentonly = 0;
+	result->querytime = 0;
+	result->maloptimizertime = 0;
+	result->sqloptimizertime = 0;
+	result->tableid = tableid;
+	result->row_count = rowcount;
+	result->tuple_count = 0;
+	if (colcount > result->maxfields) {
+		REALLOC(result->fields, colcount);
+		memset(result->fields + result->maxfields, 0, (colcount - result->maxfields) * sizeof(*result->fields));
+		result->maxfields = (int) colcount;
+	}
+	result->fieldcnt = (int) colcount;
+
+	if ((bin = malloc(sizeof(*bin))) == NULL ||
+	    (bin->cols = calloc(colcount > 0 ? (size_t) colcount : 1, sizeof(*bin->cols))) == NULL) {
+		free(bin);
+		free(msg);
+		mapi_setError(mid, "Memory allocation failure", "parse_binary_header", MERROR);
+		return NULL;
+	}
+	bin->timezone = timezone;
+	bin->columnar = 0;
+	bin->initial = 1;
+	bin->received = 0;
+	bin->block = NULL;
+	bin->rows = 0;
+	result->binary = bin;
+
+	for (i = 0; i < result->fieldcnt; i++) {
+		struct MapiColumn *f = &result->fields[i];
+		struct MapiBinaryColumn *col = &bin->cols[i];
+		const char *tn, *name, *type;
+		int digits, scale;
+		int64_t print_width;
+
+		if ((tn = get_binary_str(&rd)) == NULL ||
+		    (name = get_binary_str(&rd)) == NULL ||
+		    (type = get_binary_str(&rd)) == NULL ||
+		    !get_binary(&rd, &col->typelen, sizeof(col->typelen)) ||
+		    !get_binary(&rd, &digits, sizeof(digits)) ||
+		    !get_binary(&rd, &scale, sizeof(scale)) ||
+		    !get_binary(&rd, &col->nil_len, sizeof(col->nil_len)) ||
+		    col->nil_len < 0 ||
+		    (size_t) col->nil_len > rd.len - rd.pos ||
+		    (col->typelen >= 0 && col->nil_len != 0 && col->nil_len != col->typelen))
+			goto bailout;
+		if (col->nil_len > 0) {
+			if ((col->nil = malloc(col->nil_len)) == NULL)
+				goto bailout;
+			memcpy(col->nil, rd.buf + rd.pos, col->nil_len);
+			if (rd.swap && col->typelen > 1)
+				swap_values(col->nil, col->typelen, 1);
+			rd.pos += col->nil_len;
+		}
+		if (!get_binary(&rd, &print_width, sizeof(print_width)) ||
+		    classify_binary_column(col, type, digits) < 0)
+			goto bailout;
+		col->scale = scale;
+
+		if (f->tablename)
+			free(f->tablename);
+		f->tablename = strdup(tn);
+		if (f->columnname)
+			free(f->columnname);
+		f->columnname = strdup(name);
+		if (f->columntype)
+			free(f->columntype);
+		f->columntype = strdup(type);
+		f->columnlength = print_width > 0 ? (int) print_width : digits;
+		f->digits = digits;
+		f->scale = scale;
+	}
+	free(msg);
+	add_binary_header_lines(result, cacheall);
+	return result;
+
+  bailout:
+	free(msg);
+	close_connection(mid);
+	mapi_setError(mid, "Invalid result set header received", "parse_binary_header", MERROR);
+	return NULL;
+}
+
+/* Set up the column buffers for a block of rows.  Fixed-width values
+   are used in place, for the others pointers into the block are
+   collected. */
+static int
+decode_binary_block(Mapi mid, struct MapiResultSet *result, char *msg, size_t len)
+{
+	struct MapiBinaryResult *bin = result->binary;
+	int swap = mnstr_byteorder(mid->from) != 1234;
+	size_t pos = 2 + sizeof(int64_t);
+	int64_t rows, r;
+	int i;
+
+	memcpy(&rows, msg + 2, sizeof(rows));
+	if (swap)
+		swap_values(&rows, sizeof(rows), 1);
+	if (rows < 0 || (uint64_t) rows > len)
+		return -1;
+	for (i = 0; i < result->fieldcnt; i++) {
+		struct MapiBinaryColumn *col = &bin->cols[i];
+
+		/* all columns are aligned on 8 bytes */
+		pos = (pos + 7) & ~(size_t) 7;
+		if (pos > len)
+			return -1;
+		col->buf.count = rows;
+		if (col->typelen >= 0) {
+			size_t size = (size_t) rows * (size_t) col->typelen;
+
+			if (len - pos < size)
+				return -1;
+			if (swap && col->typelen > 1)
+				swap_values(msg + pos, col->typelen, rows);
+			col->buf.data = msg + pos;
+			col->buf.null = col->nil;
+			col->buf.values = NULL;
+			col->buf.lengths = NULL;
+			pos += size;
+		} else {
+			const char *p, *end;
+			int64_t total;
+
+			if (len - pos < sizeof(total))
+				return -1;
+			memcpy(&total, msg + pos, sizeof(total));
+			if (swap)
+				swap_values(&total, sizeof(total), 1);
+			pos += sizeof(total);
+			if (total < 0 || (uint64_t) total > len - pos)
+				return -1;
+			if (rows > col->size) {
+				REALLOC(col->values, rows);
+				REALLOC(col->lengths, rows);
+				if (col->values == NULL || col->lengths == NULL) {
+					col->size = 0;
+					return -1;
+				}
+				col->size = rows;
+			}
+			p = msg + pos;
+			end = p + total;
+			for (r = 0; r < rows; r++) {
+				if (col->kind == BIN_BLOB) {
+					int64_t l;
+
+					if ((size_t) (end - p) < sizeof(l))
+						return -1;
+					memcpy(&l, p, sizeof(l));
+					if (swap)
+						swap_values(&l, sizeof(l), 1);
+					p += sizeof(l);
+					if (l < 0) {
+						col->values[r] = NULL;
+						col->lengths[r] = 0;
+					} else {
+						if (l > end - p)
+							return -1;
+						col->values[r] = p;
+						col->lengths[r] = (size_t) l;
+						p += l;
+					}
+				} else {
+					const char *e = memchr(p, 0, end - p);
+
+					if (e == NULL)
+						return -1;
+					if (p[0] == '\200' && p[1] == 0) {
+						/* str_nil */
+						col->values[r] = NULL;
+						col->lengths[r] = 0;
+					} else {
+						col->values[r] = p;
+						col->lengths[r] = (size_t) (e - p);
+					}
+					p = e + 1;
+				}
+			}
+			col->buf.data = NULL;
+			col->buf.null = NULL;
+			col->buf.values = col->values;
+			col->buf.lengths = col->lengths;
+			pos += (size_t) total;
+		}
+	}
+	bin->block = msg;
+	bin->rows = rows;
+	bin->received += rows;
+	return 0;
+}
+
+#ifdef HAVE_HGE
+typedef hge mapi_bigint;
+#else
+typedef int64_t mapi_bigint;
+#endif
+
+/* format an integer with the given number of digits after the
+   decimal point, the way the server does */
+static void
+format_integer(char *buf, const void *p, int width, int scale)
+{
+	char tmp[64];
+	int cur = 63, i, neg;
+	mapi_bigint v;
+
+	switch (width) {
+	case 1: {
+		int8_t x;
+		memcpy(&x, p, sizeof(x));
+		v = x;
+		break;
+	}
+	case 2: {
+		int16_t x;
+		memcpy(&x, p, sizeof(x));
+		v = x;
+		break;
+	}
+	case 4: {
+		int32_t x;
+		memcpy(&x, p, sizeof(x));
+		v = x;
+		break;
+	}
+	case 8: {
+		int64_t x;
+		memcpy(&x, p, sizeof(x));
+		v = x;
+		break;
+	}
+	default:
+		memcpy(&v, p, sizeof(v));
+		break;
+	}
+	neg = v < 0;
+	if (neg)
+		v = -v;
+	tmp[cur--] = 0;
+	if (scale > 0) {
+		for (i = 0; i < scale && cur > 2; i++) {
+			tmp[cur--] = (char) ('0' + v % 10);
+			v /= 10;
+		}
+		tmp[cur--] = '.';
+	}
+	do {
+		tmp[cur--] = (char) ('0' + v % 10);
+		v /= 10;
+	} while (v > 0 && cur > 0);
+	if (neg)
+		tmp[cur--] = '-';
+	strcpy(buf, tmp + cur + 1);
+}
+
+/* format a date given as days since 1970-01-01 in the proleptic
+   Gregorian calendar; like the server we hide the year 0 */
+static size_t
+format_date(char *buf, int64_t z)
+{
+	int64_t era, y;
+	unsigned doe, yoe, doy, mp, d, m;
+
+	z += 719468;
+	era = (z >= 0 ? z : z - 146096) / 146097;
+	doe = (unsigned) (z - era * 146097);
+	yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	y = (int64_t) yoe + era * 400;
+	doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	mp = (5 * doy + 2) / 153;
+	d = doy - (153 * mp + 2) / 5 + 1;
+	m = mp < 10 ? mp + 3 : mp - 9;
+	if (m <= 2)
+		y++;
+	if (y <= 0)
+		y--;
+	return (size_t) sprintf(buf, "%" PRId64 "-%02u-%02u", y, m, d);
+}
+
+/* format a time of day in milliseconds with fraction digits after
+   the second */
+static size_t
+format_time(char *buf, int64_t ms, int fraction)
+{
+	size_t n;
+	int i;
+	char frac[8];
+
+	n = (size_t) sprintf(buf, "%02d:%02d:%02d",
+			     (int) (ms / 3600000), (int) (ms / 60000 % 60),
+			     (int) (ms / 1000 % 60));
+	if (fraction > 0) {
+		snprintf(frac, sizeof(frac), "%03d", (int) (ms % 1000));
+		buf[n++] = '.';
+		for (i = 0; i < fraction; i++)
+			buf[n++] = i < 3 ? frac[i] : '0';
+		buf[n] = 0;
+	}
+	return n;
+}
+
+static size_t
+format_timezone(char *buf, int timezone)
+{
+	int tz = timezone / 60000;
+
+	if (tz < 0)
+		tz = -tz;
+	return (size_t) sprintf(buf, "%c%02d:%02d", timezone >= 0 ? '+' : '-', tz / 60, tz % 60);
+}
+
+/* Return the textual representation of value r of a column, or NULL
+   if the value is NULL.  The result is malloced. */
+static char *
+format_binary_value(struct MapiBinaryResult *bin, struct MapiBinaryColumn *col, int64_t r)
+{
+	char buf[128];
+	const char *p;
+	int i;
+
+	if (col->typelen < 0) {
+		const unsigned char *s;
+		char *val, *v;
+
+		if ((p = col->buf.values[r]) == NULL)
+			return NULL;
+		if (col->kind == BIN_STR)
+			return strdup(p);
+		if ((val = malloc(col->buf.lengths[r] * 2 + 1)) == NULL)
+			return NULL;
+		s = (const unsigned char *) p;
+		for (v = val; s < (const unsigned char *) p + col->buf.lengths[r]; s++) {
+			*v++ = "0123456789ABCDEF"[*s >> 4];
+			*v++ = "0123456789ABCDEF"[*s & 15];
+		}
+		*v = 0;
+		return val;
+	}
+	if (col->typelen == 0)
+		return NULL;
+	p = (const char *) col->buf.data + r * col->typelen;
+	if (col->nil && memcmp(p, col->nil, col->typelen) == 0)
+		return NULL;
+	switch (col->kind) {
+	case BIN_INT:
+		format_integer(buf, p, col->typelen, 0);
+		break;
+	case BIN_DEC:
+		format_integer(buf, p, col->typelen, col->scale);
+		break;
+	case BIN_BOOL:
+		strcpy(buf, *p ? "true" : "false");
+		break;
+	case BIN_FLT: {
+		float f;
+
+		memcpy(&f, p, sizeof(f));
+		for (i = 4; i < 10; i++) {
+			snprintf(buf, sizeof(buf), "%.*g", i, f);
+			if (strtof(buf, NULL) == f)
+				break;
+		}
+		break;
+	}
+	case BIN_DBL: {
+		double d;
+
+		memcpy(&d, p, sizeof(d));
+		for (i = 4; i < 18; i++) {
+			snprintf(buf, sizeof(buf), "%.*g", i, d);
+			if (strtod(buf, NULL) == d)
+				break;
+		}
+		break;
+	}
+	case BIN_OID:
+		if (col->typelen == 4) {
+			uint32_t o;
+
+			memcpy(&o, p, sizeof(o));
+			snprintf(buf, sizeof(buf), "%" PRIu32 "@0", o);
+		} else {
+			uint64_t o;
+
+			memcpy(&o, p, sizeof(o));
+			snprintf(buf, sizeof(buf), "%" PRIu64 "@0", o);
+		}
+		break;
+	case BIN_DATE:
+	case BIN_TIMESTAMP: {
+		int64_t ms, days;
+		size_t n;
+
+		memcpy(&ms, p, sizeof(ms));
+		if (col->has_tz)
+			ms += bin->timezone;
+		days = ms / 86400000;
+		ms %= 86400000;
+		if (ms < 0) {
+			ms += 86400000;
+			days--;
+		}
+		n = format_date(buf, days);
+		if (col->kind == BIN_TIMESTAMP) {
+			buf[n++] = ' ';
+			n += format_time(buf + n, ms, col->fraction);
+			if (col->has_tz)
+				format_timezone(buf + n, bin->timezone);
+		}
+		break;
+	}
+	case BIN_TIME: {
+		int32_t t;
+		int64_t ms;
+		size_t n;
+
+		memcpy(&t, p, sizeof(t));
+		ms = t;
+		if (col->has_tz) {
+			ms += bin->timezone;
+			if (ms < 0)
+				ms += 86400000;
+			if (ms > 86400000)
+				ms -= 86400000;
+		}
+		n = format_time(buf, ms, col->fraction);
+		if (col->has_tz)
+			format_timezone(buf + n, bin->timezone);
+		break;
+	}
+	default:
+		return NULL;
+	}
+	return strdup(buf);
+}
+
+/* append a string value to a row, quoted and escaped like the server
+   does for strings in the textual protocol */
+static char *
+quote_value(char *dst, const char *val)
+{
+	const char *src;
+
+	*dst++ = '"';
+	for (src = val; *src; src++) {
+		unsigned char c = (unsigned char) *src;
+
+		if ((c < ' ' || c == 0177) ||
+		    (c == 0302 && 0200 <= (unsigned char) src[1] && (unsigned char) src[1] <= 0237) ||
+		    (src > val && c >= 0200 && c <= 0237 && src[-1] == '\302')) {
+			*dst++ = '\\';
+			switch (c) {
+			case '\t':
+				*dst++ = 't';
+				break;
+			case '\n':
+				*dst++ = 'n';
+				break;
+			case '\r':
+				*dst++ = 'r';
+				break;
+			case '\f':
+				*dst++ = 'f';
+				break;
+			default:
+				dst += sprintf(dst, "%03o", c);
+				break;
+			}
+		} else {
+			if (c == '\\' || c == '"')
+				*dst++ = '\\';
+			*dst++ = (char) c;
+		}
+	}
+	*dst++ = '"';
+	return dst;
+}
+
+/* Add the rows of the current block to the row cache, both as the
+   line the textual protocol would have sent and already sliced. */
+static int
+binary_block_to_rows(struct MapiResultSet *result, int cacheall)
+{
+	struct MapiBinaryResult *bin = result->binary;
+	int64_t r;
+	int i, n = result->fieldcnt;
+
+	for (r = 0; r < bin->rows; r++) {
+		char **anchors = malloc((n > 0 ? n : 1) * sizeof(*anchors));
+		size_t *lens = malloc((n > 0 ? n : 1) * sizeof(*lens));
+		size_t len = 4;
+		char *line, *p;
+
+		if (anchors == NULL || lens == NULL) {
+			free(anchors);
+			free(lens);
+			return -1;
+		}
+		for (i = 0; i < n; i++) {
+			anchors[i] = format_binary_value(bin, &bin->cols[i], r);
+			if (anchors[i]) {
+				lens[i] = strlen(anchors[i]);
+				len += bin->cols[i].quote ? 4 * lens[i] + 4 : lens[i] + 2;
+			} else {
+				lens[i] = 0;
+				len += 6;
+			}
+		}
+		if ((line = malloc(len)) == NULL) {
+			for (i = 0; i < n; i++)
+				free(anchors[i]);
+			free(anchors);
+			free(lens);
+			return -1;
+		}
+		p = line;
+		*p++ = '[';
+		for (i = 0; i < n; i++) {
+			if (i > 0)
+				*p++ = ',';
+			*p++ = i > 0 ? '\t' : ' ';
+			if (anchors[i] == NULL) {
+				strcpy(p, "NULL");
+				p += 4;
+			} else if (bin->cols[i].quote) {
+				p = quote_value(p, anchors[i]);
+			} else {
+				strcpy(p, anchors[i]);
+				p += lens[i];
+			}
+		}
+		strcpy(p, "\t]");
+		add_cache(result, line, cacheall);
+		result->cache.line[result->cache.writer - 1].anchors = anchors;
+		result->cache.line[result->cache.writer - 1].lens = lens;
+		result->cache.line[result->cache.writer - 1].fldcnt = n;
+	}
+	return 0;
+}
+
+/* Read the next message of a protocol 10 result set.  Returns 1 if a
+   block of rows was received, 0 if the message is not a block, in
+   which case it is left in the block cache for read_line, and -1 on
+   error.  In row-at-a-time mode the rows are added to the row cache;
+   in column-at-a-time mode the block is kept unless skip is set. */
+static int
+read_binary_message(MapiHdl hdl, struct MapiResultSet *result, int cacheall, int skip)
+{
+	Mapi mid = hdl->mid;
+	struct MapiBinaryResult *bin = result->binary;
+	char *msg;
+	size_t len;
+	int64_t v;
+
+	for (;;) {
+		if ((msg = read_message(mid, &len)) == NULL)
+			return -1;
+		if (len == 2 * sizeof(int64_t)) {
+			memcpy(&v, msg, sizeof(v));
+			if (v == -1) {
+				/* the server needs larger blocks */
+				memcpy(&v, msg + sizeof(v), sizeof(v));
+				if (mnstr_byteorder(mid->from) != 1234)
+					swap_values(&v, sizeof(v), 1);
+				free(msg);
+				if (v < BLOCK || bs2_resizebuf(mid->from, (size_t) v) < 0) {
+					close_connection(mid);
+					mapi_setError(mid, "Could not resize the block buffer", "read_binary_message", MERROR);
+					return -1;
+				}
+				mid->blocksize = (size_t) v;
+				continue;
+			}
+		}
+		break;
+	}
+	if (len >= 2 + sizeof(int64_t) &&
+	    (msg[0] == '+' || msg[0] == '-') && msg[1] == '\n') {
+		free_binary_block(bin);
+		if (decode_binary_block(mid, result, msg, len) < 0) {
+			free(msg);
+			close_connection(mid);
+			mapi_setError(mid, "Invalid result set block received", "read_binary_message", MERROR);
+			return -1;
+		}
+		if (bin->initial)
+			result->tuple_count += bin->rows;
+		if (!bin->columnar) {
+			if (binary_block_to_rows(result, cacheall) < 0) {
+				free_binary_block(bin);
+				mapi_setError(mid, "Memory allocation failure", "read_binary_message", MERROR);
+				return -1;
+			}
+			free_binary_block(bin);
+		} else if (skip)
+			free_binary_block(bin);
+		return 1;
+	}
+	/* not part of the result set: let read_line deal with it */
+	if ((size_t) mid->blk.lim < len) {
+		REALLOC(mid->blk.buf, len + 1);
+		if (mid->blk.buf == NULL) {
+			free(msg);
+			mid->blk.lim = 0;
+			close_connection(mid);
+			mapi_setError(mid, "Memory allocation failure", "read_binary_message", MERROR);
+			return -1;
+		}
+		mid->blk.lim = (int) len;
+	}
+	memcpy(mid->blk.buf, msg, len + 1);
+	mid->blk.nxt = 0;
+	mid->blk.end = (int) len;
+	mid->blk.eom = 1;
+	free(msg);
+	return 0;
+}
+
 /* Read ahead and cache data read.  Depending on the second argument,
    reading may stop at the first non-header and non-error line, or at
    a prompt.
@@ -3941,6 +5038,21 @@ read_into_cache(MapiHdl hdl, int lookahead)
 	if ((result = hdl->active) == NULL)
 		result = hdl->result;	/* may also be NULL */
 	for (;;) {
+		if (hdl->active && hdl->active->binary &&
+		    mid->blk.nxt >= mid->blk.end && !mid->blk.eom) {
+			/* at a message boundary in a protocol 10 result set */
+			switch (read_binary_message(hdl, hdl->active, !lookahead,
+						    lookahead <= 0)) {
+			case -1:
+				return mid->error;
+			case 1:
+				if (lookahead > 0)
+					return mid->error;
+				continue;
+			default:
+				break;
+			}
+		}
 		line = read_line(mid);
 		if (line == NULL)
 			return mid->error;
@@ -3991,6 +5103,21 @@ read_into_cache(MapiHdl hdl, int lookahead)
 			if (result && *line != '&')
 				add_cache(result, strdup(line), !lookahead);
 			break;
+		case '*':
+			if (mid->prot10 && line[1] == 0) {
+				/* header of a protocol 10 result set; the
+				 * rows are read when they are needed */
+				if (lookahead < 0)
+					lookahead = 1;
+				result = parse_binary_header(hdl, result, !lookahead);
+				if (result == NULL)
+					return mid->error;
+				hdl->active = result;
+				if (lookahead > 0)
+					return mid->error;
+				break;
+			}
+			/* fall through */
 		default:
 			if (result == NULL) {
 				result = new_result(hdl);
@@ -4543,6 +5670,8 @@ mapi_fetch_line(MapiHdl hdl)
 			read_into_cache(hdl->mid->active, 0);
 		hdl->mid->active = hdl;
 		hdl->active = result;
+		if (result->binary)
+			result->binary->initial = 0;
 		if (hdl->mid->tracelog) {
 			mapi_log_header(hdl->mid, "W");
 			mnstr_printf(hdl->mid->tracelog, "X" "export %d %" PRId64 "\n",
@@ -5075,6 +6204,8 @@ mapi_fetch_all_rows(MapiHdl hdl)
 		    result->cache.first + result->cache.tuplecount < result->row_count) {
 			mid->active = hdl;
 			hdl->active = result;
+			if (result->binary)
+				result->binary->initial = 0;
 			if (mid->tracelog) {
 				mapi_log_header(mid, "W");
 				mnstr_printf(mid->tracelog, "X" "export %d %" PRId64 "\n",
@@ -5094,6 +6225,80 @@ mapi_fetch_all_rows(MapiHdl hdl)
 	return result ? result->cache.tuplecount : 0;
 }
 
+/*
+ * Fetch the next block of rows of a protocol 10 result set
+ * column-at-a-time.  The column buffers of the block are valid until
+ * the next call.  Returns the number of rows in the block, 0 if there
+ * are no more, and -1 on error.
+ */
+int64_t
+mapi_fetch_column_block(MapiHdl hdl)
+{
+	Mapi mid;
+	struct MapiResultSet *result;
+	struct MapiBinaryResult *bin;
+	int exported = 0;
+
+	mapi_hdl_check(hdl, "mapi_fetch_column_block");
+	mid = hdl->mid;
+	if ((result = hdl->result) == NULL || (bin = result->binary) == NULL)
+		return 0;
+	bin->columnar = 1;
+	free_binary_block(bin);
+	for (;;) {
+		if (mid->active == hdl && hdl->active == result) {
+			if (read_into_cache(hdl, 1) != MOK)
+				return -1;
+			if (bin->block)
+				return bin->rows;
+			continue;
+		}
+		if (exported ||
+		    hdl->needmore ||
+		    result->tableid < 0 ||
+		    bin->received >= result->row_count)
+			return 0;
+		/* ask the server for the next rows */
+		if (mid->active != NULL && read_into_cache(mid->active, 0) != MOK)
+			return -1;
+		bin->initial = 0;
+		mid->active = hdl;
+		hdl->active = result;
+		if (mid->tracelog) {
+			mapi_log_header(mid, "W");
+			mnstr_printf(mid->tracelog, "X" "export %d %" PRId64 "\n",
+				      result->tableid, bin->received);
+			mnstr_flush(mid->tracelog);
+		}
+		if (mnstr_printf(mid->to, "X" "export %d %" PRId64 "\n",
+				  result->tableid, bin->received) < 0 ||
+		    mnstr_flush(mid->to))
+			check_stream(mid, mid->to, mnstr_error(mid->to), "mapi_fetch_column_block", -1);
+		exported = 1;
+	}
+}
+
+/* Return the buffer of a column of the block fetched last by
+   mapi_fetch_column_block. */
+const MapiColumnBuffer *
+mapi_get_column_buffer(MapiHdl hdl, int fnr)
+{
+	struct MapiResultSet *result;
+
+	mapi_hdl_check0(hdl, "mapi_get_column_buffer");
+	if ((result = hdl->result) == NULL ||
+	    result->binary == NULL ||
+	    result->binary->block == NULL) {
+		mapi_setError(hdl->mid, "Must do a successful mapi_fetch_column_block first", "mapi_get_column_buffer", MERROR);
+		return NULL;
+	}
+	if (fnr < 0 || fnr >= result->fieldcnt) {
+		mapi_setError(hdl->mid, "Illegal field number", "mapi_get_column_buffer", MERROR);
+		return NULL;
+	}
+	return &result->binary->cols[fnr].buf;
+}
+
 char *
 mapi_fetch_field(MapiHdl hdl, int fnr)
 {
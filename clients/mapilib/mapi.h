@@ -31,6 +31,8 @@
 #define MAPI_TIME	16
 #define MAPI_DATETIME	17
 #define MAPI_NUMERIC	18
+#define MAPI_HUGE	19	/* 128 bit integer, only in column buffers */
+#define MAPI_BLOB	20	/* binary data, only in column buffers */
 
 #define PLACEHOLDER	'?'
 
@@ -120,6 +122,20 @@ typedef struct {		/* used by MAPI_DATETIME */
 	unsigned int fraction;	/* in 1000 millionths of a second (10e-9) */
 } MapiDateTime;
 
+/* a column of a block of rows received in the binary (protocol 10)
+   result set format, see mapi_fetch_column_block() */
+typedef struct {
+	int type;		/* MAPI_TINY, MAPI_SHORT, MAPI_INT,
+				 * MAPI_LONGLONG, MAPI_HUGE, MAPI_FLOAT,
+				 * MAPI_DOUBLE, MAPI_VARCHAR or MAPI_BLOB */
+	int width;		/* size of fixed-width values, else 0 */
+	int64_t count;		/* number of values in the block */
+	const void *data;	/* the fixed-width values */
+	const void *null;	/* representation of NULL in data, or NULL */
+	const char **values;	/* variable-width values, NULL for NULL */
+	const size_t *lengths;	/* lengths of MAPI_BLOB values */
+} MapiColumnBuffer;
+
 /* connection-oriented functions */
 mapi_export Mapi mapi_mapi(const char *host, int port, const char *username, const char *password, const char *lang, const char *dbname);
 mapi_export Mapi mapi_mapiuri(const char *url, const char *user, const char *pass, const char *lang);
@@ -130,6 +146,8 @@ mapi_export char **mapi_resolve(const char *host, int port, const char *pattern)
 mapi_export MapiMsg mapi_disconnect(Mapi mid);
 mapi_export MapiMsg mapi_reconnect(Mapi mid);
 mapi_export MapiMsg mapi_ping(Mapi mid);
+mapi_export MapiMsg mapi_set_protocol(Mapi mid, int protover, size_t blocksize, const char *compression);
+mapi_export int mapi_get_protocol(Mapi mid);
 
 mapi_export MapiMsg mapi_error(Mapi mid);
 mapi_export const char *mapi_error_str(Mapi mid);
@@ -186,6 +204,8 @@ mapi_export MapiMsg mapi_seek_row(MapiHdl hdl, int64_t rowne, int whence);
 mapi_export MapiMsg mapi_timeout(Mapi mid, unsigned int time);
 mapi_export int mapi_fetch_row(MapiHdl hdl);
 mapi_export int64_t mapi_fetch_all_rows(MapiHdl hdl);
+mapi_export int64_t mapi_fetch_column_block(MapiHdl hdl);
+mapi_export const MapiColumnBuffer *mapi_get_column_buffer(MapiHdl hdl, int fnr);
 mapi_export int mapi_get_field_count(MapiHdl hdl);
 mapi_export int64_t mapi_get_row_count(MapiHdl hdl);
 mapi_export int64_t mapi_get_last_id(MapiHdl hdl);
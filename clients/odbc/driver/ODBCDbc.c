@@ -65,6 +65,7 @@ newODBCDbc(ODBCEnv *env)
 	dbc->host = NULL;
 	dbc->port = 0;
 	dbc->dbname = NULL;
+	dbc->protocol = 0;
 
 	dbc->Connected = false;
 	dbc->has_comment = false;
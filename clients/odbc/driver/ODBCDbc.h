@@ -53,6 +53,7 @@ typedef struct tODBCDRIVERDBC {
 	char *host;		/* Server host */
 	int port;		/* Server port */
 	char *dbname;		/* Database Name or NULL */
+	int protocol;		/* requested MAPI protocol version or 0 */
 	bool Connected;		/* whether we are connecte to a server */
 	bool has_comment;	/* whether the server has sys.comments */
 	SQLUINTEGER sql_attr_autocommit;
@@ -208,6 +208,13 @@ MNDBConnect(ODBCDbc *dbc,
 	if (port == 0)
 		port = 50000;
 
+	if (dbc->protocol == 0 && dsn && *dsn) {
+		n = SQLGetPrivateProfileString(dsn, "protocol", "9",
+					       buf, sizeof(buf), "odbc.ini");
+		if (n > 0)
+			dbc->protocol = atoi(buf);
+	}
+
 	if (host == NULL || *host == 0) {
 		host = "localhost";
 		if (dsn && *dsn) {
@@ -227,7 +234,16 @@ MNDBConnect(ODBCDbc *dbc,
 
 	/* connect to a server on host via port */
 	/* FIXME: use dbname/catalog from ODBC connect string/options here */
-	mid = mapi_connect(host, port, uid, pwd, "sql", catalog);
+	if (dbc->protocol == 10) {
+		/* result sets are received in binary and converted
+		 * to rows by the MAPI library */
+		mid = mapi_mapi(host, port, uid, pwd, "sql", catalog);
+		if (mid && mapi_error(mid) == MOK &&
+		    mapi_set_protocol(mid, 10, 0, NULL) == MOK)
+			mapi_reconnect(mid);
+	} else {
+		mid = mapi_connect(host, port, uid, pwd, "sql", catalog);
+	}
 	if (mid == NULL || mapi_error(mid)) {
 		/* Client unable to establish connection */
 		addDbcError(dbc, "08001", NULL, 0);
@@ -199,6 +199,19 @@ ODBCConnectionString(SQLRETURN rc,
 			BufferLength = -1;
 		}
 	}
+	if (dbc->protocol != 0) {
+		if (BufferLength > 0) {
+			n = snprintf((char *) OutConnectionString,
+				     BufferLength,
+				     "PROTOCOL=%d;", dbc->protocol);
+			if (n < 0)
+				n = BufferLength + 1;
+			BufferLength -= n;
+			OutConnectionString += n;
+		} else {
+			BufferLength = -1;
+		}
+	}
 #ifdef ODBCDEBUG
 	if (ODBCdebug && getenv("ODBCDEBUG") == NULL) {
 		if (BufferLength > 0) {
@@ -324,6 +337,9 @@ MNDBDriverConnect(ODBCDbc *dbc,
 		else if (strcasecmp(key, "port") == 0 && port == 0) {
 			port = atoi(attr);
 			free(attr);
+		} else if (strcasecmp(key, "protocol") == 0) {
+			dbc->protocol = atoi(attr);
+			free(attr);
 #ifdef ODBCDEBUG
 		} else if (strcasecmp(key, "logfile") == 0 &&
 			   getenv("ODBCDEBUG") == NULL) {
@@ -580,6 +580,7 @@ typedef struct {
 	storage_t newstorage;	/* new desired storage mode at re-allocation. */
 	bte farmid;		/* id of farm where heap is located */
 	bat parentid;		/* cache id of VIEW parent bat */
+	size_t faults;		/* page faults taken by prefaulting */
 } Heap;
 
 typedef struct {
@@ -714,6 +715,8 @@ gdk_export int VALisnil(const ValRecord *v);
  *           Hash   *thash;           // linear chained hash table on tail
  *           Imprints *timprints;     // column imprints index on tail
  *           orderidx torderidx;      // order oid index on tail
+ *           Heap   *tzonemap;        // per-zone min/max of tail
+ *           Heap   *tpacked;         // compressed copy of tail
  *  } BAT;
  * @end verbatim
  *
@@ -778,6 +781,8 @@ typedef struct {
 	Hash *hash;		/* hash table */
 	Imprints *imprints;	/* column imprints index */
 	Heap *orderidx;		/* order oid index */
+	Heap *zonemap;		/* per-zone minimum and maximum */
+	Heap *packed;		/* compressed copy of the values */
 
 	PROPrec *props;		/* list of dynamic properties stored in the bat descriptor */
 } COLrec;
@@ -833,6 +838,8 @@ typedef struct BATiter {
 #define trevsorted	T.revsorted
 #define tident		T.id
 #define torderidx	T.orderidx
+#define tzonemap	T.zonemap
+#define tpacked		T.packed
 #define twidth		T.width
 #define tshift		T.shift
 #define tnonil		T.nonil
@@ -888,6 +895,8 @@ gdk_export gdk_return HEAPextend(Heap *h, size_t size, int mayshare)
 	__attribute__ ((__warn_unused_result__));
 gdk_export size_t HEAPvmsize(Heap *h);
 gdk_export size_t HEAPmemsize(Heap *h);
+gdk_export void HEAPcacheflush(void);
+gdk_export void HEAPcachestats(lng *hits, lng *misses, size_t *cached);
 
 /*
  * @- Internal HEAP Chunk Management
@@ -1568,8 +1577,8 @@ typedef struct {
 	BAT *desc;		/* the BAT descriptor */
 	char physical[20];	/* dir + basename for storage */
 	str options;		/* A string list of options */
-	int refs;		/* in-memory references on which the loaded status of a BAT relies */
-	int lrefs;		/* logical references on which the existence of a BAT relies */
+	volatile ATOMIC_TYPE refs;	/* in-memory references on which the loaded status of a BAT relies */
+	volatile ATOMIC_TYPE lrefs;	/* logical references on which the existence of a BAT relies */
 	volatile int status;	/* status mask used for spin locking */
 	/* MT_Id pid;           non-zero thread-id if this BAT is private */
 } BBPrec;
@@ -1606,7 +1615,7 @@ gdk_export BBPrec *BBP[N_BBPINIT];
 /* macros that nicely check parameters */
 #define BBPcacheid(b)	((b)->batCacheid)
 #define BBPstatus(i)	(BBPcheck((i),"BBPstatus")?BBP_status(i):-1)
-#define BBPrefs(i)	(BBPcheck((i),"BBPrefs")?BBP_refs(i):-1)
+#define BBPrefs(i)	(BBPcheck((i),"BBPrefs")?(int) BBP_refs(i):-1)
 #define BBPcache(i)	(BBPcheck((i),"BBPcache")?BBP_cache(i):(BAT*) NULL)
 #define BBPname(i)						\
 	(BBPcheck((i), "BBPname") ?				\
@@ -1857,6 +1866,14 @@ gdk_export gdk_return BATimprints(BAT *b);
 gdk_export void IMPSdestroy(BAT *b);
 gdk_export lng IMPSimprintsize(BAT *b);
 
+/* The zone map: minimum, maximum and number of nils per block */
+
+gdk_export gdk_return BATzonemap(BAT *b);
+
+/* The packed (compressed) form of a column */
+
+gdk_export gdk_return BATpacked(BAT *b);
+
 /* The ordered index structure */
 
 gdk_export gdk_return BATorderidx(BAT *b, int stable);
@@ -2733,6 +2750,7 @@ gdk_export void BATsetprop(BAT *b, int idx, int type, void *v);
 
 gdk_export BAT *BATselect(BAT *b, BAT *s, const void *tl, const void *th, int li, int hi, int anti);
 gdk_export BAT *BATthetaselect(BAT *b, BAT *s, const void *val, const char *op);
+gdk_export BAT *BATdictselect(BAT *b, BAT *s, int (*pred)(const char *, void *), void *arg, int anti);
 
 gdk_export BAT *BATconstant(oid hseq, int tt, const void *val, BUN cnt, int role);
 gdk_export gdk_return BATsubcross(BAT **r1p, BAT **r2p, BAT *l, BAT *r, BAT *sl, BAT *sr)
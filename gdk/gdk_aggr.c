@@ -935,6 +935,59 @@ BATsum(void *res, int tp, BAT *b, BAT *s, int skip_nils, int abort_on_error, int
 	}
 	if (BATcount(b) == 0)
 		return GDK_SUCCEED;
+#ifdef HAVE_HGE
+	if (cand == NULL && start < end && ATOMstorage(tp) == tp &&
+	    tp != TYPE_flt && tp != TYPE_dbl &&
+	    ATOMsize(tp) >= ATOMsize(b->ttype)) {
+		hge sum;
+		lng mx;
+
+		/* sum the packed form of the column, if it has one;
+		 * on overflow we let dosum report the error */
+		switch (tp) {
+		case TYPE_bte:
+			mx = GDK_bte_max;
+			break;
+		case TYPE_sht:
+			mx = GDK_sht_max;
+			break;
+		case TYPE_int:
+			mx = GDK_int_max;
+			break;
+		default:
+			mx = GDK_lng_max;
+			break;
+		}
+		if (PCKsum(b, start, end, &sum, &nils) &&
+		    ((nils > 0 && !skip_nils) || tp == TYPE_hge ||
+		     (sum >= -mx && sum <= mx))) {
+			bool isnil = nils > 0 && !skip_nils;
+
+			if (nils == end - start && skip_nils) {
+				/* only nils: result as initialized */
+				return GDK_SUCCEED;
+			}
+			switch (tp) {
+			case TYPE_bte:
+				* (bte *) res = isnil ? bte_nil : (bte) sum;
+				break;
+			case TYPE_sht:
+				* (sht *) res = isnil ? sht_nil : (sht) sum;
+				break;
+			case TYPE_int:
+				* (int *) res = isnil ? int_nil : (int) sum;
+				break;
+			case TYPE_lng:
+				* (lng *) res = isnil ? lng_nil : (lng) sum;
+				break;
+			default:
+				* (hge *) res = isnil ? hge_nil : sum;
+				break;
+			}
+			return GDK_SUCCEED;
+		}
+	}
+#endif
 	nils = dosum(Tloc(b, 0), b->tnonil, b->hseqbase, start, end,
 		     res, 1, b->ttype, tp, cand, candend, &min, min, max,
 		     skip_nils, abort_on_error, nil_if_empty, "BATsum");
@@ -2611,7 +2664,12 @@ BATminmax(BAT *b, void *aggr,
 	const void *res;
 	size_t s;
 	BATiter bi;
+	lng v;			/* large enough for any packed value */
 
+	if (PCKminmax(b, minmax == do_groupmax, &v)) {
+		res = &v;
+		goto found;
+	}
 	if ((VIEWtparent(b) == 0 ||
 	     BATcount(b) == BATcount(BBPdescriptor(VIEWtparent(b)))) &&
 	    BATcheckimprints(b)) {
@@ -2646,6 +2704,7 @@ BATminmax(BAT *b, void *aggr,
 		bi = bat_iterator(b);
 		res = BUNtail(bi, pos - b->hseqbase);
 	}
+  found:
 	if (aggr == NULL) {
 		s = ATOMlen(b->ttype, res);
 		aggr = GDKmalloc(s);
@@ -133,6 +133,9 @@ VIEWcreate(oid seq, BAT *b)
 	bn->timprints = NULL;
 	/* Order OID index */
 	bn->torderidx = NULL;
+	/* zone maps are used through the parent */
+	bn->tzonemap = NULL;
+	bn->tpacked = NULL;
 	if (BBPcacheit(bn, 1) != GDK_SUCCEED) {	/* enter in BBP */
 		if (tp)
 			BBPunshare(tp);
@@ -178,6 +181,8 @@ BATmaterialize(BAT *b)
 	/* cleanup possible ACC's */
 	HASHdestroy(b);
 	IMPSdestroy(b);
+	ZNMdestroy(b);
+	PCKdestroy(b);
 	OIDXdestroy(b);
 
 	snprintf(b->theap.filename, sizeof(b->theap.filename), "%s.tail", BBP_physical(b->batCacheid));
@@ -423,6 +428,8 @@ VIEWdestroy(BAT *b)
 	/* remove any leftover private hash structures */
 	HASHdestroy(b);
 	IMPSdestroy(b);
+	ZNMdestroy(b);
+	PCKdestroy(b);
 	OIDXdestroy(b);
 	VIEWunlink(b);
 
@@ -466,7 +466,7 @@ BATextend(BAT *b, BUN newcap)
 	    HEAPextend(&b->theap, theap_size, b->batRestricted == BAT_READ) != GDK_SUCCEED)
 		return GDK_FAIL;
 	HASHdestroy(b);
-	IMPSdestroy(b);
+	/* imprints don't refer to the heap, so they stay */
 	OIDXdestroy(b);
 	return GDK_SUCCEED;
 }
@@ -498,6 +498,8 @@ BATclear(BAT *b, int force)
 	/* kill all search accelerators */
 	HASHdestroy(b);
 	IMPSdestroy(b);
+	ZNMdestroy(b);
+	PCKdestroy(b);
 	OIDXdestroy(b);
 	PROPdestroy(b->tprops);
 	b->tprops = NULL;
@@ -565,6 +567,8 @@ BATfree(BAT *b)
 	b->tprops = NULL;
 	HASHfree(b);
 	IMPSfree(b);
+	ZNMfree(b);
+	PCKfree(b);
 	OIDXfree(b);
 	if (b->ttype)
 		HEAPfree(&b->theap, 0);
@@ -1046,7 +1050,9 @@ BUNappend(BAT *b, const void *t, bit force)
 	}
 
 
-	IMPSdestroy(b); /* no support for inserts in imprints yet */
+	IMPSappend(b, p);
+	ZNMappend(b, p);
+	PCKdestroy(b);
 	OIDXdestroy(b);
 	PROPdestroy(b->tprops);
 	b->tprops = NULL;
@@ -1111,6 +1117,8 @@ BUNdelete(BAT *b, oid o)
 		}
 	}
 	IMPSdestroy(b);
+	ZNMdestroy(b);
+	PCKdestroy(b);
 	OIDXdestroy(b);
 	HASHdestroy(b);
 	PROPdestroy(b->tprops);
@@ -1161,6 +1169,8 @@ BUNinplace(BAT *b, BUN p, const void *t, bit force)
 	b->tprops = NULL;
 	OIDXdestroy(b);
 	IMPSdestroy(b);
+	ZNMdestroy(b);
+	PCKdestroy(b);
 	Treplacevalue(b, BUNtloc(bi, p), t);
 
 	tt = b->ttype;
@@ -508,7 +508,7 @@ gdk_return
 BATappend(BAT *b, BAT *n, BAT *s, bit force)
 {
 	BUN start, end, cnt;
-	BUN r;
+	BUN r, oldcnt;
 	const oid *restrict cand = NULL, *candend = NULL;
 
 	if (b == NULL || n == NULL || (cnt = BATcount(n)) == 0) {
@@ -583,7 +583,8 @@ BATappend(BAT *b, BAT *n, BAT *s, bit force)
 
 	b->batDirty = 1;
 
-	IMPSdestroy(b);		/* imprints do not support updates yet */
+	/* imprints are extended with the new values at the end */
+	oldcnt = BATcount(b);
 	OIDXdestroy(b);
 	PROPdestroy(b->tprops);
 	b->tprops = NULL;
@@ -742,10 +743,16 @@ BATappend(BAT *b, BAT *n, BAT *s, bit force)
 			}
 		}
 	}
+	IMPSappend(b, oldcnt);
+	ZNMappend(b, oldcnt);
+	PCKdestroy(b);
 	if (b->tunique)
 		BBPunfix(s->batCacheid);
 	return GDK_SUCCEED;
       bunins_failed:
+	IMPSdestroy(b);
+	ZNMdestroy(b);
+	PCKdestroy(b);
 	if (b->tunique)
 		BBPunfix(s->batCacheid);
 	return GDK_FAIL;
@@ -861,6 +868,11 @@ BATdel(BAT *b, BAT *d)
 	b->tnokey[0] = b->tnokey[1] = 0;
 	PROPdestroy(b->tprops);
 	b->tprops = NULL;
+	/* the accelerators that are extended on append describe the
+	 * values that were removed */
+	IMPSdestroy(b);
+	ZNMdestroy(b);
+	PCKdestroy(b);
 
 	return GDK_SUCCEED;
 }
@@ -1267,15 +1279,305 @@ BATordered_rev(BAT *b)
 	return b->trevsorted;
 }
 
+/* Parallel sort.
+ *
+ * Large inputs are cut into one run per thread, the runs are sorted
+ * concurrently with the sequential sort functions, after which
+ * adjacent runs are merged pairwise until a single run is left.  So
+ * that all threads keep busy during the last rounds of merging, each
+ * merge of two runs is split into pieces of about equal size by
+ * searching for the points where the two runs cross the piece
+ * boundaries in the output ("merge path").  On equal values the left
+ * run goes first, so if the runs were sorted stably, so is the
+ * result. */
+
+/* minimum number of values for which we sort in parallel */
+#define PSORT_MIN	((size_t) 1 << 20)
+/* minimum number of values per run */
+#define PSORT_RUN	((size_t) 1 << 16)
+
+struct psort {
+	char *h, *t;		/* data being sorted */
+	char *hbuf, *tbuf;	/* same sized scratch space */
+	const char *base;	/* vheap for var-sized types */
+	size_t n;
+	int hs, ts, tpe;
+	int reverse, stable;
+	int (*cmp)(const void *, const void *);
+	int nthreads;
+	size_t *runs;		/* run r is [runs[r], runs[r+1]) */
+	int nruns;
+	struct psortpiece {
+		size_t a, alen;	/* left run */
+		size_t b, blen;	/* right run */
+		size_t lo, hi;	/* part of the output to produce */
+	} *pieces;
+	int npieces;
+	int round;		/* merge round: source is h or hbuf */
+	gdk_return rc;
+	MT_Lock lock;		/* protects next and rc */
+	int next;		/* next unclaimed run or piece */
+};
+
+struct psortarg {
+	struct psort *ps;
+	int merge;		/* 0: sort runs, 1: merge pieces */
+};
+
+#define PSORTVAL(ps, p, i)						\
+	((ps)->base ?							\
+	 (const void *) ((ps)->base + VarHeapVal((p), (i), (ps)->hs)) :	\
+	 (const void *) ((p) + (i) * (ps)->hs))
+
+/* compare value i of run a with value j of run b in sort order */
+static inline int
+psortcmp(const struct psort *ps, const char *a, size_t i, const char *b, size_t j)
+{
+	int c = ps->cmp(PSORTVAL(ps, a, i), PSORTVAL(ps, b, j));
+
+	return ps->reverse ? -c : c;
+}
+
+/* find how many of the first d outputs of merging runs a and b come
+ * from a */
+static size_t
+psortsplit(const struct psort *ps, const char *h, size_t a, size_t alen,
+	   size_t b, size_t blen, size_t d)
+{
+	size_t lo = d > blen ? d - blen : 0;
+	size_t hi = d < alen ? d : alen;
+
+	while (lo < hi) {
+		size_t i = (lo + hi) / 2;
+		/* the i-th value of a goes before the (d-i-1)-th
+		 * value of b if it isn't larger */
+		if (psortcmp(ps, h, a + i, h, b + d - i - 1) <= 0)
+			lo = i + 1;
+		else
+			hi = i;
+	}
+	return lo;
+}
+
+static void
+psortmerge(const struct psort *ps, const struct psortpiece *pc)
+{
+	const char *sh = ps->round & 1 ? ps->hbuf : ps->h;
+	const char *st = ps->round & 1 ? ps->tbuf : ps->t;
+	char *dh = ps->round & 1 ? ps->h : ps->hbuf;
+	char *dt = ps->round & 1 ? ps->t : ps->tbuf;
+	size_t i, ie, j, je, o;
+	const int hs = ps->hs, ts = ps->ts;
+
+	i = pc->a + psortsplit(ps, sh, pc->a, pc->alen, pc->b, pc->blen, pc->lo);
+	ie = pc->a + psortsplit(ps, sh, pc->a, pc->alen, pc->b, pc->blen, pc->hi);
+	j = pc->b + pc->lo - (i - pc->a);
+	je = pc->b + pc->hi - (ie - pc->a);
+	/* the output of merging a and b goes where a starts */
+	for (o = pc->a + pc->lo; i < ie || j < je; o++) {
+		size_t s;
+		if (j == je || (i < ie && psortcmp(ps, sh, i, sh, j) <= 0))
+			s = i++;
+		else
+			s = j++;
+		memcpy(dh + o * hs, sh + s * hs, hs);
+		if (ts)
+			memcpy(dt + o * ts, st + s * ts, ts);
+	}
+}
+
+static void
+psortworker(void *arg)
+{
+	struct psortarg *a = arg;
+	struct psort *ps = a->ps;
+	int i;
+	gdk_return rc;
+
+	for (;;) {
+		MT_lock_set(&ps->lock);
+		i = ps->next++;
+		MT_lock_unset(&ps->lock);
+		if (a->merge) {
+			if (i >= ps->npieces)
+				break;
+			psortmerge(ps, &ps->pieces[i]);
+		} else {
+			size_t lo, n;
+
+			if (i >= ps->nruns)
+				break;
+			lo = ps->runs[i];
+			n = ps->runs[i + 1] - lo;
+			rc = GDK_SUCCEED;
+			if (ps->stable)
+				rc = (ps->reverse ? GDKssort_rev : GDKssort)(
+					ps->h + lo * ps->hs,
+					ps->ts ? ps->t + lo * ps->ts : NULL,
+					ps->base, n, ps->hs, ps->ts, ps->tpe);
+			else
+				(ps->reverse ? GDKqsort_rev : GDKqsort)(
+					ps->h + lo * ps->hs,
+					ps->ts ? ps->t + lo * ps->ts : NULL,
+					ps->base, n, ps->hs, ps->ts, ps->tpe);
+			if (rc != GDK_SUCCEED) {
+				MT_lock_set(&ps->lock);
+				ps->rc = rc;
+				MT_lock_unset(&ps->lock);
+			}
+		}
+	}
+}
+
+static void
+psortrun(struct psort *ps, struct psortarg *args, MT_Id *tids, int merge)
+{
+	int i;
+
+	ps->next = 0;
+	for (i = 0; i < ps->nthreads; i++) {
+		args[i] = (struct psortarg) {
+			.ps = ps,
+			.merge = merge,
+		};
+		tids[i] = 0;
+		if (i > 0 &&
+		    MT_create_thread(&tids[i], psortworker, &args[i],
+				     MT_THR_JOINABLE) < 0)
+			tids[i] = 0;
+	}
+	/* threads that could not be started leave more work for the
+	 * others */
+	psortworker(&args[0]);
+	for (i = 1; i < ps->nthreads; i++)
+		if (tids[i])
+			MT_join_thread(tids[i]);
+}
+
+/* Sort in parallel; returns GDK_SUCCEED if sorted, GDK_FAIL if an
+ * error occurred, and -1 (without error) if there was not enough
+ * memory to sort in parallel. */
+static int
+do_psort(void *restrict h, void *restrict t, const void *restrict base,
+	 size_t n, int hs, int ts, int tpe, int reverse, int stable)
+{
+	struct psort ps = {
+		.h = h,
+		.t = t,
+		.base = ATOMvarsized(tpe) ? base : NULL,
+		.n = n,
+		.hs = hs,
+		.ts = t ? ts : 0,
+		.tpe = tpe,
+		.reverse = reverse,
+		.stable = stable,
+		.cmp = ATOMcompare(tpe),
+		.rc = GDK_SUCCEED,
+	};
+	struct psortarg *args = NULL;
+	MT_Id *tids = NULL;
+	int i, r, rc = -1;
+	size_t len;
+	lng t0 = 0;
+
+	ALGODEBUG t0 = GDKusec();
+	ps.nthreads = GDKnr_threads;
+	if ((size_t) ps.nthreads > n / PSORT_RUN)
+		ps.nthreads = (int) (n / PSORT_RUN);
+	ps.nruns = ps.nthreads;
+	ps.hbuf = GDKmalloc(n * hs);
+	ps.tbuf = ps.ts ? GDKmalloc(n * ps.ts) : NULL;
+	ps.runs = GDKmalloc((ps.nruns + 1) * sizeof(size_t));
+	/* a round has fewer than 2 pieces per thread */
+	ps.pieces = GDKmalloc(2 * ps.nthreads * sizeof(struct psortpiece));
+	args = GDKmalloc(ps.nthreads * sizeof(struct psortarg));
+	tids = GDKmalloc(ps.nthreads * sizeof(MT_Id));
+	if (ps.hbuf == NULL || (ps.ts && ps.tbuf == NULL) ||
+	    ps.runs == NULL || ps.pieces == NULL ||
+	    args == NULL || tids == NULL) {
+		GDKclrerr();
+		goto bailout;
+	}
+	MT_lock_init(&ps.lock, "do_psort");
+
+	for (r = 0; r <= ps.nruns; r++)
+		ps.runs[r] = n / ps.nruns * r;
+	ps.runs[ps.nruns] = n;
+	psortrun(&ps, args, tids, 0);
+	if (ps.rc != GDK_SUCCEED) {
+		rc = GDK_FAIL;
+		goto bailout_locked;
+	}
+
+	for (ps.round = 0; ps.nruns > 1; ps.round++) {
+		/* merge runs 2r and 2r+1 into new run r */
+		ps.npieces = 0;
+		for (r = 0; r < ps.nruns; r += 2) {
+			size_t a = ps.runs[r];
+			size_t alen = ps.runs[r + 1] - a;
+			size_t b = ps.runs[r + 1];
+			size_t blen = r + 1 < ps.nruns ? ps.runs[r + 2] - b : 0;
+			int np;
+
+			len = alen + blen;
+			/* number of pieces proportional to size */
+			np = (int) ((len * ps.nthreads + n - 1) / n);
+			if (np < 1)
+				np = 1;
+			for (i = 0; i < np; i++) {
+				ps.pieces[ps.npieces++] = (struct psortpiece) {
+					.a = a,
+					.alen = alen,
+					.b = b,
+					.blen = blen,
+					.lo = len / np * i,
+					.hi = i == np - 1 ? len : len / np * (i + 1),
+				};
+			}
+			ps.runs[r / 2] = a;
+		}
+		ps.nruns = (ps.nruns + 1) / 2;
+		ps.runs[ps.nruns] = n;
+		psortrun(&ps, args, tids, 1);
+	}
+	if (ps.round & 1) {
+		/* result ended up in the scratch space */
+		memcpy(h, ps.hbuf, n * hs);
+		if (ps.ts)
+			memcpy(t, ps.tbuf, n * ps.ts);
+	}
+	rc = GDK_SUCCEED;
+	ALGODEBUG fprintf(stderr, "#do_psort: %zu values, %d threads, "
+			  "%d merge rounds, " LLFMT " usec\n",
+			  n, ps.nthreads, ps.round, GDKusec() - t0);
+
+  bailout_locked:
+	MT_lock_destroy(&ps.lock);
+  bailout:
+	GDKfree(ps.hbuf);
+	GDKfree(ps.tbuf);
+	GDKfree(ps.runs);
+	GDKfree(ps.pieces);
+	GDKfree(args);
+	GDKfree(tids);
+	return rc;
+}
+
 /* figure out which sort function is to be called
  * stable sort can produce an error (not enough memory available),
- * "quick" sort does not produce errors */
+ * "quick" sort does not produce errors; large inputs are sorted in
+ * parallel if there is enough memory for it */
 static gdk_return
 do_sort(void *restrict h, void *restrict t, const void *restrict base, size_t n, int hs, int ts, int tpe,
 	int reverse, int stable)
 {
 	if (n <= 1)		/* trivially sorted */
 		return GDK_SUCCEED;
+	if (n >= PSORT_MIN && GDKnr_threads > 1) {
+		int rc = do_psort(h, t, base, n, hs, ts, tpe, reverse, stable);
+		if (rc >= 0)
+			return (gdk_return) rc;
+	}
 	if (reverse) {
 		if (stable) {
 			return GDKssort_rev(h, t, base, n, hs, ts, tpe);
@@ -1765,8 +1765,8 @@ BBPdump(void)
 			i,
 			ATOMname(b->ttype),
 			BBP_logical(i) ? BBP_logical(i) : "<NULL>",
-			BBP_refs(i),
-			BBP_lrefs(i),
+			(int) BBP_refs(i),
+			(int) BBP_lrefs(i),
 			BBP_status(i),
 			b->batCount);
 		if (b->batSharecnt > 0)
@@ -1926,17 +1926,22 @@ BBPgetsubdir(str s, bat i)
 
 /* There are BBP_THREADMASK+1 (64) free lists, and ours (idx) is
  * empty.  Here we find a longish free list (at least 20 entries), and
- * if we can find one, we take one entry from that list.  If no long
- * enough list can be found, we create a new entry by either just
- * increasing BBPsize (up to BBPlimit) or extending the BBP (which
- * increases BBPlimit).  Every time this function is called we start
+ * if we can find one, we move BBP_FREEBATCH entries from that list to
+ * ours.  If no long enough list can be found, we create
+ * BBP_FREEBATCH new entries by either just increasing BBPsize (up to
+ * BBPlimit) or extending the BBP (which increases BBPlimit).  Moving
+ * a batch at a time means that a thread that creates many transient
+ * BATs only rarely needs to come here, which is where all free list
+ * locks are needed.  Every time this function is called we start
  * searching in a following free list (variable "last"). */
+#define BBP_FREEBATCH	16
+
 static gdk_return
 maybeextend(int idx)
 {
 	int t, m;
 	int n, l;
-	bat i;
+	bat i, size;
 	static int last = 0;
 
 	l = 0;			/* length of longest list */
@@ -1954,17 +1959,24 @@ maybeextend(int idx)
 		}
 	}
 	if (l > 20) {
-		/* list is long enough, get an entry from there */
-		i = BBP_free(m);
-		BBP_free(m) = BBP_next(i);
-		BBP_next(i) = 0;
-		BBP_free(idx) = i;
+		/* list is long enough, get a batch of entries from
+		 * there */
+		for (n = 0; n < BBP_FREEBATCH; n++) {
+			i = BBP_free(m);
+			BBP_free(m) = BBP_next(i);
+			BBP_next(i) = BBP_free(idx);
+			BBP_free(idx) = i;
+		}
 	} else {
-		/* let the longest list alone, get a fresh entry */
-		if ((bat) ATOMIC_ADD(BBPsize, 1, BBPsizeLock) >= BBPlimit) {
+		/* let the longest list alone, get fresh entries */
+		size = (bat) ATOMIC_ADD(BBPsize, BBP_FREEBATCH, BBPsizeLock);
+		if (size + BBP_FREEBATCH > BBPlimit) {
+			/* on success, BBPextend rebuilds the free
+			 * lists, which then include the new
+			 * entries */
 			if (BBPextend(idx, true) != GDK_SUCCEED) {
 				/* undo add */
-				ATOMIC_SUB(BBPsize, 1, BBPsizeLock);
+				ATOMIC_SUB(BBPsize, BBP_FREEBATCH, BBPsizeLock);
 				/* couldn't extend; if there is any
 				 * free entry, take it from the
 				 * longest list after all */
@@ -1979,7 +1991,12 @@ maybeextend(int idx)
 				}
 			}
 		} else {
-			BBP_free(idx) = (bat) ATOMIC_GET(BBPsize, BBPsizeLock) - 1;
+			/* push in reverse so that the lowest
+			 * numbered entry is used first */
+			for (i = size + BBP_FREEBATCH - 1; i >= size; i--) {
+				BBP_next(i) = BBP_free(idx);
+				BBP_free(idx) = i;
+			}
 		}
 	}
 	last = (last + 1) & BBP_THREADMASK;
@@ -2302,6 +2319,22 @@ BBPspin(bat i, const char *s, int event)
 	}
 }
 
+/*
+ * The reference counts of a BAT are changed with atomic instructions
+ * so that, as long as a count stays positive, it can be changed
+ * without taking GDKswapLock.  Only the transitions to and from zero
+ * (which may load, unload or destroy the BAT) go through the lock.
+ * If there are no atomic instructions, all changes are done while
+ * holding the lock.
+ */
+#ifdef ATOMIC_LOCK
+#define BBPrefinc(r)	(++(r))
+#define BBPrefdec(r)	(--(r))
+#else
+#define BBPrefinc(r)	ATOMIC_INC(r, dummy)
+#define BBPrefdec(r)	ATOMIC_DEC(r, dummy)
+#endif
+
 static inline int
 incref(bat i, bool logical, bool lock)
 {
@@ -2320,6 +2353,28 @@ incref(bat i, bool logical, bool lock)
 	if (!BBPcheck(i, logical ? "BBPretain" : "BBPfix"))
 		return 0;
 
+#ifndef ATOMIC_LOCK
+	if (lock) {
+		volatile ATOMIC_TYPE *rp = logical ? &BBP_lrefs(i) : &BBP_refs(i);
+		ATOMIC_TYPE r;
+
+		/* fast path: add a reference to a BAT that already
+		 * has one */
+		while ((r = ATOMIC_GET(*rp, dummy)) > 0 &&
+		       !(BBP_status(i) & (BBPUNSTABLE|BBPLOADING))) {
+			if (ATOMIC_CAS(*rp, r, r + 1, dummy)) {
+				/* the count may have gone through zero
+				 * since we looked at the status, in
+				 * which case the parents of a view may
+				 * still be loading */
+				if (!logical)
+					BBPspin(i, "BBPfix", BBPLOADING);
+				return (int) (r + 1);
+			}
+		}
+	}
+#endif
+
 	if (lock) {
 		for (;;) {
 			MT_lock_set(&GDKswapLock(i));
@@ -2345,21 +2400,21 @@ incref(bat i, bool logical, bool lock)
 	if (logical) {
 		/* parent BATs are not relevant for logical refs */
 		tp = tvp = 0;
-		refs = ++BBP_lrefs(i);
+		refs = (int) BBPrefinc(BBP_lrefs(i));
 	} else {
 		tp = b->theap.parentid;
 		assert(tp >= 0);
 		tvp = b->tvheap == 0 || b->tvheap->parentid == i ? 0 : b->tvheap->parentid;
-		refs = ++BBP_refs(i);
-		if (refs == 1 && (tp || tvp)) {
+		if (BBP_refs(i) == 0 && (tp || tvp)) {
 			/* If this is a view, we must load the parent
 			 * BATs, but we must do that outside of the
-			 * lock.  Set the BBPLOADING flag so that
-			 * other threads will wait until we're
-			 * done. */
+			 * lock.  Set the BBPLOADING flag (before
+			 * the count becomes visible) so that other
+			 * threads will wait until we're done. */
 			BBP_status_on(i, BBPLOADING, "BBPfix");
 			load = true;
 		}
+		refs = (int) BBPrefinc(BBP_refs(i));
 	}
 	if (lock)
 		MT_lock_unset(&GDKswapLock(i));
@@ -2431,6 +2486,22 @@ decref(bat i, bool logical, bool releaseShare, bool lock, const char *func)
 	BAT *b;
 
 	assert(i > 0);
+#ifndef ATOMIC_LOCK
+	if (lock && !releaseShare) {
+		volatile ATOMIC_TYPE *rp = logical ? &BBP_lrefs(i) : &BBP_refs(i);
+		ATOMIC_TYPE r;
+
+		/* fast path: dropping a reference that is not the
+		 * last one doesn't change whether the BAT can be
+		 * unloaded, provided, for a logical reference, that
+		 * there also is a physical one */
+		while ((r = ATOMIC_GET(*rp, dummy)) > 1 &&
+		       (!logical || ATOMIC_GET(BBP_refs(i), dummy) > 0)) {
+			if (ATOMIC_CAS(*rp, r, r - 1, dummy))
+				return (int) (r - 1);
+		}
+	}
+#endif
 	if (lock)
 		MT_lock_set(&GDKswapLock(i));
 	if (releaseShare) {
@@ -2456,7 +2527,7 @@ decref(bat i, bool logical, bool releaseShare, bool lock, const char *func)
 			GDKerror("%s: %s does not have logical references.\n", func, BBPname(i));
 			assert(0);
 		} else {
-			refs = --BBP_lrefs(i);
+			refs = (int) BBPrefdec(BBP_lrefs(i));
 		}
 	} else {
 		if (BBP_refs(i) == 0) {
@@ -2465,7 +2536,7 @@ decref(bat i, bool logical, bool releaseShare, bool lock, const char *func)
 		} else {
 			assert(b == NULL || b->theap.parentid == 0 || BBP_refs(b->theap.parentid) > 0);
 			assert(b == NULL || b->tvheap == NULL || b->tvheap->parentid == 0 || BBP_refs(b->tvheap->parentid) > 0);
-			refs = --BBP_refs(i);
+			refs = (int) BBPrefdec(BBP_refs(i));
 			if (b && refs == 0) {
 				if ((tp = b->theap.parentid) != 0)
 					b->theap.base = (char *) (b->theap.base - BBP_cache(tp)->theap.base);
@@ -2658,6 +2729,10 @@ getBBPdescriptor(bat i, bool lock)
 		BBP_status_off(i, BBPLOADING, "BBPdescriptor");
 		CHECKDEBUG if (b != NULL)
 			BATassertProps(b);
+		/* if we hold all locks, we can't fix the BAT for the
+		 * prefaulting thread */
+		if (b != NULL && lock)
+			BATprefault(b);
 	}
 	return b;
 }
@@ -3635,6 +3710,16 @@ BBPdiskscan(const char *parent, size_t baseoff)
 #else
 				delete = true;
 #endif
+			} else if (strncmp(p + 1, "tzonemap", 8) == 0) {
+				BAT *b = getdesc(bid);
+				delete = b == NULL;
+				if (!delete)
+					b->tzonemap = (Heap *) 1;
+			} else if (strncmp(p + 1, "tpacked", 7) == 0) {
+				BAT *b = getdesc(bid);
+				delete = b == NULL;
+				if (!delete)
+					b->tpacked = (Heap *) 1;
 			} else if (strncmp(p + 1, "priv", 4) != 0 &&
 				   strncmp(p + 1, "new", 3) != 0 &&
 				   strncmp(p + 1, "head", 4) != 0 &&
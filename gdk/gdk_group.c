@@ -387,6 +387,16 @@
 	/* COMP   */	cmp(v, BUNtail(bi, hb)) == 0		\
 	)
 
+/* strings with fingerprints: only compare the strings if the
+ * fingerprints are equal */
+#define GRP_use_existing_hash_table_fps()			\
+	GRP_use_existing_hash_table(				\
+	/* INIT_0 */					,	\
+	/* INIT_1 */	v = BUNtail(bi, p)		,	\
+	/* COMP   */	fps[p] == fps[hb] &&			\
+			GDK_STREQ(v, BUNtvar(bi, hb))		\
+	)
+
 /* reverse the bits of an OID value */
 static inline oid
 rev(oid x)
@@ -538,6 +548,16 @@ pop(oid x)
 	/* COMP   */	cmp(v, BUNtail(bi, hb)) == 0		\
 	)
 
+/* strings with fingerprints: the fingerprint is the hash value */
+#define GRP_create_partial_hash_table_fps()			\
+	GRP_create_partial_hash_table(				\
+	/* INIT_0 */					,	\
+	/* INIT_1 */	v = BUNtail(bi, p)		,	\
+	/* HASH   */	((BUN) fps[p] & hs->mask)	,	\
+	/* COMP   */	fps[p] == fps[hb] &&			\
+			GDK_STREQ(v, BUNtvar(bi, hb))		\
+	)
+
 
 gdk_return
 BATgroup_internal(BAT **groups, BAT **extents, BAT **histo,
@@ -564,6 +584,8 @@ BATgroup_internal(BAT **groups, BAT **extents, BAT **histo,
 	const oid *restrict cand, *candend;
 	oid maxgrp = oid_nil;	/* maximum value of g BAT (if subgrouping) */
 	PROPrec *prop;
+	const unsigned int *fps;	/* string fingerprints */
+	Heap *fpspin = NULL;		/* keeps fps valid */
 
 	if (b == NULL) {
 		GDKerror("BATgroup: b must exist\n");
@@ -744,6 +766,12 @@ BATgroup_internal(BAT **groups, BAT **extents, BAT **histo,
 			return GDK_SUCCEED;
 		}
 	}
+	if (g == NULL && cand == NULL && !subsorted &&
+	    !BATordered(b) && !BATordered_rev(b) &&
+	    PCKgroup(groups, extents, histo, b, hseqb, start, end) == GDK_SUCCEED) {
+		/* group on the codes of the packed form */
+		return GDK_SUCCEED;
+	}
 	assert(g == NULL || !BATtdense(g)); /* i.e. g->ttype == TYPE_oid */
 	bi = bat_iterator(b);
 	cmp = ATOMcompare(b->ttype);
@@ -1077,6 +1105,12 @@ BATgroup_internal(BAT **groups, BAT **extents, BAT **histo,
 		case TYPE_dbl:
 			GRP_use_existing_hash_table_tpe(dbl);
 			break;
+		case TYPE_str:
+			if ((fps = PCKfingerprints(b, &fpspin)) != NULL) {
+				GRP_use_existing_hash_table_fps();
+				break;
+			}
+			/* fall through */
 		default:
 			GRP_use_existing_hash_table_any();
 			break;
@@ -1203,6 +1237,12 @@ BATgroup_internal(BAT **groups, BAT **extents, BAT **histo,
 		case TYPE_dbl:
 			GRP_create_partial_hash_table_tpe(dbl);
 			break;
+		case TYPE_str:
+			if ((fps = PCKfingerprints(b, &fpspin)) != NULL) {
+				GRP_create_partial_hash_table_fps();
+				break;
+			}
+			/* fall through */
 		default:
 			GRP_create_partial_hash_table_any();
 		}
@@ -1210,6 +1250,7 @@ BATgroup_internal(BAT **groups, BAT **extents, BAT **histo,
 		HEAPfree(&hs->heap, 1);
 		GDKfree(hs);
 	}
+	PCKunpin(fpspin);
 	if (extents) {
 		BATsetcount(en, (BUN) ngrp);
 		en->tkey = 1;
@@ -1243,6 +1284,7 @@ BATgroup_internal(BAT **groups, BAT **extents, BAT **histo,
 	*groups = gn;
 	return GDK_SUCCEED;
   error:
+	PCKunpin(fpspin);
 	if (hs != NULL && hs != b->thash) {
 		HEAPfree(&hs->heap, 1);
 		GDKfree(hs);
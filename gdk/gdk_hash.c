@@ -308,15 +308,11 @@ BAThashsync(void *arg)
  * Its argument is the element type and the maximum number of BUNs be
  * stored under the hash function.
  */
-gdk_return
-BAThash(BAT *b, BUN masksize)
+static gdk_return
+BAThash_intern(BAT *b, BUN masksize, const unsigned int *fps)
 {
 	lng t0 = 0, t1 = 0;
 
-	assert(b->batCacheid > 0);
-	if (BATcheckhash(b)) {
-		return GDK_SUCCEED;
-	}
 	MT_lock_set(&GDKhashLock(b->batCacheid));
 	if (b->thash == NULL) {
 		unsigned int tpe = ATOMbasetype(b->ttype);
@@ -391,6 +387,10 @@ BAThash(BAT *b, BUN masksize)
 				GDKfree(h);
 				return GDK_FAIL;
 			}
+#if SIZEOF_BUN > 4
+			if (h->mask > (BUN) 0xFFFFFFFF)
+				fps = NULL;
+#endif
 
 			switch (tpe) {
 			case TYPE_bte:
@@ -418,8 +418,8 @@ BAThash(BAT *b, BUN masksize)
 #endif
 			default:
 				for (; r < p; r++) {
-					ptr v = BUNtail(bi, r);
-					BUN c = (BUN) heap_hash_any(b->tvheap, h, v);
+					BUN c = fps ? (BUN) fps[r] & h->mask :
+						(BUN) heap_hash_any(b->tvheap, h, BUNtail(bi, r));
 
 					if (HASHget(h, c) == HASHnil(h) &&
 					    nslots-- == 0)
@@ -459,8 +459,8 @@ BAThash(BAT *b, BUN masksize)
 #endif
 		default:
 			for (; p < q; p++) {
-				ptr v = BUNtail(bi, p);
-				BUN c = (BUN) heap_hash_any(b->tvheap, h, v);
+				BUN c = fps ? (BUN) fps[p] & h->mask :
+					(BUN) heap_hash_any(b->tvheap, h, BUNtail(bi, p));
 
 				HASHputlink(h, p, HASHget(h, c));
 				HASHput(h, c, p);
@@ -495,6 +495,26 @@ BAThash(BAT *b, BUN masksize)
 	return GDK_SUCCEED;
 }
 
+gdk_return
+BAThash(BAT *b, BUN masksize)
+{
+	const unsigned int *fps;
+	Heap *pin;
+	gdk_return ret;
+
+	assert(b->batCacheid > 0);
+	if (BATcheckhash(b)) {
+		return GDK_SUCCEED;
+	}
+	/* the fingerprints of a string column are the (low 32 bits
+	 * of the) hash values, so we don't need to look at the
+	 * strings themselves */
+	fps = PCKfingerprints(b, &pin);
+	ret = BAThash_intern(b, masksize, fps);
+	PCKunpin(pin);
+	return ret;
+}
+
 /*
  * The entry on which a value hashes can be calculated with the
  * routine HASHprobe.
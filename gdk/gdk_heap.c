@@ -46,6 +46,10 @@
 #include "gdk.h"
 #include "gdk_private.h"
 
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>	/* getrusage */
+#endif
+
 static void *
 HEAPcreatefile(int farmid, size_t *maxsz, const char *fn)
 {
@@ -85,6 +89,231 @@ decompose_filename(str nme)
 	return ext;
 }
 
+/*
+ * @- Heap cache
+ * Every MAL instruction creates intermediate BATs whose heaps are
+ * freed again soon after.  For heaps of HEAPCACHE_MINSIZE bytes and
+ * more, the C library serves each allocation with a fresh anonymous
+ * memory map, so we pay for page faults when the heap is filled and
+ * for a munmap when it is freed.  To avoid that, the memory of freed
+ * STORE_MEM heaps is kept in size classes and handed out again to new
+ * heaps of the same class.  There are four classes per power of two,
+ * so at most a quarter of a heap is wasted by rounding up its size.
+ *
+ * At most GDK_heapcache_maxsize bytes are kept (a value of zero
+ * disables the cache).  The cached memory is released in bulk by
+ * HEAPcacheflush, which the MAL interpreter calls whenever the last
+ * running query finishes.  So memory is recycled between the
+ * instructions of a query and between concurrently running queries,
+ * but it is not held on to for long when the server is idle.
+ */
+#define HEAPCACHE_MINLOG	17	/* 128 KiB, glibc's mmap threshold */
+#define HEAPCACHE_MAXLOG	30	/* 1 GiB */
+#define HEAPCACHE_MINSIZE	((size_t) 1 << HEAPCACHE_MINLOG)
+#define HEAPCACHE_NCLASSES	((HEAPCACHE_MAXLOG - HEAPCACHE_MINLOG) * 4 + 1)
+
+static MT_Lock HEAPcacheLock MT_LOCK_INITIALIZER("HEAPcacheLock");
+static struct {
+	void *free;		/* list of free areas, linked through
+				 * their first word */
+	int cnt;		/* length of the list */
+} HEAPcache[HEAPCACHE_NCLASSES];
+static size_t HEAPcachesize;	/* number of bytes in the cache */
+static lng HEAPcachehits, HEAPcachemisses;
+
+/* Return the size class for a heap of SIZE bytes and round SIZE up to
+ * the size of the class, or return -1 if the heap is not to be
+ * cached. */
+static int
+HEAPcacheclass(size_t *size)
+{
+	int log = HEAPCACHE_MINLOG;
+	size_t step;
+
+	if (*size < HEAPCACHE_MINSIZE ||
+	    *size > ((size_t) 1 << HEAPCACHE_MAXLOG) ||
+	    *size > GDK_heapcache_maxsize / 4)
+		return -1;
+	while (log < HEAPCACHE_MAXLOG && (*size >> (log + 1)) != 0)
+		log++;
+	step = (size_t) 1 << (log - 2);
+	*size = (*size + step - 1) & ~(step - 1);
+	if (*size >> (log + 1) != 0)
+		return (log + 1 - HEAPCACHE_MINLOG) * 4;
+	return (log - HEAPCACHE_MINLOG) * 4 + (int) (*size >> (log - 2)) - 4;
+}
+
+/* Get an area of SIZE bytes from the cache (SIZE must be the size of
+ * class C). */
+static void *
+HEAPcacheget(int c, size_t size)
+{
+	void *p;
+
+	MT_lock_set(&HEAPcacheLock);
+	if ((p = HEAPcache[c].free) != NULL) {
+		HEAPcache[c].free = *(void **) p;
+		HEAPcache[c].cnt--;
+		HEAPcachesize -= size;
+		HEAPcachehits++;
+	} else {
+		HEAPcachemisses++;
+	}
+	MT_lock_unset(&HEAPcacheLock);
+	return p;
+}
+
+/* Try to put the memory of heap H in the cache, return whether that
+ * succeeded. */
+static bool
+HEAPcacheput(Heap *h)
+{
+	size_t size = h->size;
+	int c;
+
+	if (GDK_heapcache_maxsize == 0 ||
+	    (c = HEAPcacheclass(&size)) < 0 ||
+	    size != h->size ||
+	    GDKmallocated(h->base) != size)
+		return false;
+	MT_lock_set(&HEAPcacheLock);
+	if (HEAPcachesize + size > GDK_heapcache_maxsize) {
+		MT_lock_unset(&HEAPcacheLock);
+		return false;
+	}
+	*(void **) h->base = HEAPcache[c].free;
+	HEAPcache[c].free = h->base;
+	HEAPcache[c].cnt++;
+	HEAPcachesize += size;
+	MT_lock_unset(&HEAPcacheLock);
+	return true;
+}
+
+/* Release all memory in the heap cache. */
+void
+HEAPcacheflush(void)
+{
+	void *lists[HEAPCACHE_NCLASSES];
+	void *p;
+	int c;
+
+	MT_lock_set(&HEAPcacheLock);
+	if (HEAPcachesize == 0) {
+		MT_lock_unset(&HEAPcacheLock);
+		return;
+	}
+	for (c = 0; c < HEAPCACHE_NCLASSES; c++) {
+		lists[c] = HEAPcache[c].free;
+		HEAPcache[c].free = NULL;
+		HEAPcache[c].cnt = 0;
+	}
+	HEAPcachesize = 0;
+	MT_lock_unset(&HEAPcacheLock);
+	/* free outside of the lock */
+	for (c = 0; c < HEAPCACHE_NCLASSES; c++) {
+		while ((p = lists[c]) != NULL) {
+			lists[c] = *(void **) p;
+			GDKfree(p);
+		}
+	}
+}
+
+/* Return statistics about the heap cache: the number of heaps that
+ * did and did not find memory in the cache, and the number of bytes
+ * currently in the cache. */
+void
+HEAPcachestats(lng *hits, lng *misses, size_t *cached)
+{
+	MT_lock_set(&HEAPcacheLock);
+	*hits = HEAPcachehits;
+	*misses = HEAPcachemisses;
+	*cached = HEAPcachesize;
+	MT_lock_unset(&HEAPcacheLock);
+}
+
+/*
+ * @- Huge pages and prefaulting
+ * Scanning a large heap that was just allocated or loaded costs a
+ * page fault and a TLB miss for every (small) page that is touched.
+ *
+ * When GDK_hugepages is set (option gdk_hugepages), we ask the kernel
+ * to back large heaps with transparent huge pages (it can only do so
+ * for the 2 MiB aligned part).  We use madvise(MADV_HUGEPAGE) instead of MAP_HUGETLB, since
+ * the latter needs a preallocated pool of huge pages and does not
+ * work for memory mapped files.  Whether the kernel actually uses
+ * huge pages for file-backed maps depends on the file system.
+ *
+ * When GDK_prefault is set (option gdk_prefault), BBPdescriptor queues
+ * the memory mapped heaps of a BAT that was just loaded for a single
+ * background thread (see BATprefault in gdk_storage.c) which tells
+ * the kernel to start reading the heap and, where supported, to fault
+ * it in, so that the first scan of the BAT does not have to.  The
+ * number of page faults taken by that thread is recorded per heap in
+ * h->faults. */
+#define HUGEPAGE_SIZE	((size_t) 1 << 21)
+
+static void
+HEAPhugepages(Heap *h)
+{
+#if defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+	uintptr_t lo, hi;
+	int ret;
+
+	if (!GDK_hugepages || h->base == NULL || h->size < 2 * HUGEPAGE_SIZE)
+		return;
+	/* advise all pages of the heap: advising only the 2 MiB aligned
+	 * part would split the mapping, after which mremap can no
+	 * longer extend it; the kernel only uses huge pages for the
+	 * aligned part anyway */
+	lo = (uintptr_t) h->base & ~(uintptr_t) (MT_pagesize() - 1);
+	hi = ((uintptr_t) h->base + h->size + MT_pagesize() - 1) & ~(uintptr_t) (MT_pagesize() - 1);
+	ret = madvise((void *) lo, hi - lo, MADV_HUGEPAGE);
+	HEAPDEBUG fprintf(stderr, "#HEAPhugepages(%s,%p,%zu) = %d\n",
+			  h->filename, (void *) lo, (size_t) (hi - lo), ret);
+	(void) ret;
+#else
+	(void) h;
+#endif
+}
+
+static size_t
+HEAPthreadfaults(void)
+{
+#if defined(HAVE_SYS_RESOURCE_H) && defined(RUSAGE_THREAD)
+	struct rusage ru;
+
+	if (getrusage(RUSAGE_THREAD, &ru) == 0)
+		return (size_t) ru.ru_minflt + (size_t) ru.ru_majflt;
+#endif
+	return 0;
+}
+
+/* Fault in the used part of a memory mapped heap.  This runs without
+ * holding any lock, so the heap may be extended (and thus moved)
+ * concurrently.  That is why we only ask the kernel to do the work:
+ * madvise on a range that is no longer mapped fails harmlessly,
+ * whereas touching the pages ourselves could crash. */
+void
+HEAPprefault(Heap *h)
+{
+	char *base = h->base;
+	size_t len = (h->free + GDK_mmap_pagesize - 1) & ~(GDK_mmap_pagesize - 1);
+	size_t faults;
+
+	if (base == NULL || h->storage == STORE_MEM || len == 0)
+		return;
+	if (len > h->size)
+		len = h->size;
+	faults = HEAPthreadfaults();
+	(void) posix_madvise(base, len, POSIX_MADV_WILLNEED);
+#if defined(HAVE_MADVISE) && defined(MADV_POPULATE_READ)
+	(void) madvise(base, len, MADV_POPULATE_READ);
+#endif
+	h->faults += HEAPthreadfaults() - faults;
+	HEAPDEBUG fprintf(stderr, "#HEAPprefault(%s,%zu) faults %zu\n",
+			  h->filename, len, h->faults);
+}
+
 /*
  * @- HEAPalloc
  *
@@ -112,8 +341,20 @@ HEAPalloc(Heap *h, size_t nitems, size_t itemsize)
 	if (h->size < 4 * GDK_mmap_pagesize ||
 	    (GDKmem_cursize() + h->size < GDK_mem_maxsize &&
 	     h->size < (h->farmid == 0 ? GDK_mmap_minsize_persistent : GDK_mmap_minsize_transient))) {
+		size_t size = h->size;
+		int c;
+
 		h->storage = STORE_MEM;
-		h->base = (char *) GDKmalloc(h->size);
+		if (GDK_heapcache_maxsize > 0 &&
+		    (c = HEAPcacheclass(&size)) >= 0) {
+			/* allocate the full size of the class, so
+			 * that the memory can be reused by any heap
+			 * of the same class */
+			h->size = size;
+			h->base = HEAPcacheget(c, size);
+		}
+		if (h->base == NULL)
+			h->base = (char *) GDKmalloc(h->size);
 		HEAPDEBUG fprintf(stderr, "#HEAPalloc %zu %p\n", h->size, h->base);
 	}
 	if (h->base == NULL) {
@@ -152,6 +393,7 @@ HEAPalloc(Heap *h, size_t nitems, size_t itemsize)
 		return GDK_FAIL;
 	}
 	h->newstorage = h->storage;
+	HEAPhugepages(h);
 	return GDK_SUCCEED;
 }
 
@@ -212,6 +454,7 @@ HEAPextend(Heap *h, size_t size, int mayshare)
 		if (p) {
 			h->size = size;
 			h->base = p;
+			HEAPhugepages(h);
  			return GDK_SUCCEED; /* success */
  		}
 		failure = "GDKmremap() failed";
@@ -231,8 +474,10 @@ HEAPextend(Heap *h, size_t size, int mayshare)
 			h->base = GDKrealloc(h->base, size);
 			HEAPDEBUG fprintf(stderr, "#HEAPextend: extending malloced heap %zu %zu %p %p\n", size, h->size, bak.base, h->base);
 			h->size = size;
-			if (h->base)
+			if (h->base) {
+				HEAPhugepages(h);
 				return GDK_SUCCEED; /* success */
+			}
 			/* bak.base is still valid and may get restored */
 			failure = "h->storage == STORE_MEM && !must_map && !h->base";
 		}
@@ -257,6 +502,7 @@ HEAPextend(Heap *h, size_t size, int mayshare)
 				h->newstorage = h->storage = STORE_MMAP;
 				memcpy(h->base, bak.base, bak.free);
 				HEAPfree(&bak, 0);
+				HEAPhugepages(h);
 				return GDK_SUCCEED;
 			}
 		}
@@ -567,7 +813,8 @@ HEAPfree(Heap *h, int rmheap)
 			HEAPDEBUG fprintf(stderr, "#HEAPfree %zu"
 					  " %p\n",
 					  h->size, h->base);
-			GDKfree(h->base);
+			if (!HEAPcacheput(h))
+				GDKfree(h->base);
 		} else if (h->storage == STORE_CMEM) {
 			//heap is stored in regular C memory rather than GDK memory,so we call free()
 			free(h->base);
@@ -683,6 +930,7 @@ HEAPload_intern(Heap *h, const char *nme, const char *ext, const char *suffix, i
 	h->base = GDKload(h->farmid, nme, ext, h->free, &h->size, h->newstorage);
 	if (h->base == NULL)
 		return GDK_FAIL; /* file could  not be read satisfactorily */
+	HEAPhugepages(h);
 
 	return GDK_SUCCEED;
 }
@@ -763,6 +1011,106 @@ HEAPdelete(Heap *h, const char *o, const char *ext)
 	return (GDKunlink(h->farmid, BATDIR, o, ext) == GDK_SUCCEED) | (GDKunlink(h->farmid, BATDIR, o, ext2) == GDK_SUCCEED) ? GDK_SUCCEED : GDK_FAIL;
 }
 
+/*
+ * @- Accelerator files
+ * The imprints, zone map and packed form of a persistent column are
+ * stored in files next to it.  Such a file starts with a header of
+ * size_t values, the first of which holds the version number and a
+ * flag that is only set once the rest of the file is on disk, so that
+ * a file that was being written during a crash is not used.
+ */
+static void
+HEAPsyncaux(int fd)
+{
+	if (!(GDKdebug & NOSYNCMASK)) {
+#if defined(NATIVE_WIN32)
+		_commit(fd);
+#elif defined(HAVE_FDATASYNC)
+		fdatasync(fd);
+#elif defined(HAVE_FSYNC)
+		fsync(fd);
+#endif
+	}
+}
+
+/* Load the accelerator file ext of b into h, whose farmid must be set,
+ * if its header of nhdr values is accepted by check, which returns the
+ * size the file must have for the first cnt values of b, or 0 if the
+ * file can't be used.  A file that can't be used is removed. */
+gdk_return
+HEAPloadaux(Heap *h, BAT *b, BUN cnt, const char *ext, size_t nhdr,
+	    size_t (*check)(const BAT *b, BUN cnt, const size_t *hdr))
+{
+	const char *nme = BBP_physical(b->batCacheid);
+	size_t hdr[8];
+	struct stat st;
+	int fd;
+
+	assert(nhdr <= sizeof(hdr) / sizeof(hdr[0]));
+	snprintf(h->filename, sizeof(h->filename), "%s.%s", nme, ext);
+	if ((fd = GDKfdlocate(h->farmid, nme, "rb", ext)) < 0)
+		return GDK_FAIL;
+	if (read(fd, hdr, nhdr * SIZEOF_SIZE_T) == (ssize_t) (nhdr * SIZEOF_SIZE_T) &&
+	    (h->size = check(b, cnt, hdr)) > 0 &&
+	    fstat(fd, &st) == 0 &&
+	    st.st_size >= (off_t) h->size) {
+		h->free = h->size;
+		if (HEAPload(h, nme, ext, 0) == GDK_SUCCEED) {
+			close(fd);
+			return GDK_SUCCEED;
+		}
+	}
+	close(fd);
+	GDKunlink(h->farmid, BATDIR, nme, ext);
+	return GDK_FAIL;
+}
+
+/* Write the accelerator heap h of b to the file ext, and once it is
+ * there, set the flag synced in the first header value, both in the
+ * heap and in the file. */
+gdk_return
+HEAPsaveaux(Heap *h, BAT *b, const char *ext, size_t synced)
+{
+	const char *nme = BBP_physical(b->batCacheid);
+	int fd;
+
+	if (HEAPsave(h, nme, ext) != GDK_SUCCEED ||
+	    (fd = GDKfdlocate(h->farmid, nme, "rb+", ext)) < 0)
+		return GDK_FAIL;
+	((size_t *) h->base)[0] |= synced;
+	if (write(fd, h->base, SIZEOF_SIZE_T) < 0) {
+		GDKsyserror("HEAPsaveaux: write %s failed\n", h->filename);
+		close(fd);
+		return GDK_FAIL;
+	}
+	HEAPsyncaux(fd);
+	close(fd);
+	return GDK_SUCCEED;
+}
+
+/* The accelerator heap h of b is about to change: clear the flag
+ * synced, and if the heap is the file itself, do that on disk first. */
+gdk_return
+HEAPunsyncaux(Heap *h, BAT *b, const char *ext, size_t synced)
+{
+	int fd;
+
+	if (!(((size_t *) h->base)[0] & synced))
+		return GDK_SUCCEED;
+	((size_t *) h->base)[0] &= ~synced;
+	if (h->storage == STORE_MEM)
+		return GDK_SUCCEED;
+	if ((fd = GDKfdlocate(h->farmid, BBP_physical(b->batCacheid), "rb+", ext)) < 0)
+		return GDK_FAIL;
+	if (write(fd, h->base, SIZEOF_SIZE_T) < 0) {
+		close(fd);
+		return GDK_FAIL;
+	}
+	HEAPsyncaux(fd);
+	close(fd);
+	return GDK_SUCCEED;
+}
+
 int
 HEAPwarm(Heap *h)
 {
@@ -18,8 +18,35 @@
 #include "gdk_private.h"
 #include "gdk_imprints.h"
 
-#define IMPRINTS_VERSION	2
-#define IMPRINTS_HEADER_SIZE	4 /* nr of size_t fields in header */
+#define IMPRINTS_VERSION	3
+#define IMPRINTS_HEADER_SIZE	6 /* nr of size_t fields in header */
+
+/* The heap consists of a header followed by four parts:
+ * bins, max 64 entries with bin boundaries, domain of b;
+ * stats, min/max/count for each bin, min/max are oid, and count BUN;
+ * imps, max one entry per "page", entry is "bits" wide;
+ * dict, max one entry per "page".
+ * The header holds bits (plus version and sync-on-disk bit), impcnt,
+ * dictcnt, the number of values covered, the number of pages there is
+ * room for in imps and dict, so that the imprints can be extended when
+ * values are appended to the column, and the number of values the
+ * bins were chosen for. */
+#define IMPRINTS_IMPS_OFF(W)					\
+	(IMPRINTS_HEADER_SIZE * SIZEOF_SIZE_T + /* extra info */	\
+	 64 * (W) +		/* bins */				\
+	 64 * 2 * SIZEOF_OID +	/* {min,max}_bins */			\
+	 64 * SIZEOF_BUN)	/* cnt_bins */
+/* the dict is aligned on a 64 bit boundary after the imps */
+#define IMPRINTS_DICT_OFF(W, B, P)					\
+	((IMPRINTS_IMPS_OFF(W) + (P) * ((B) / 8) + sizeof(uint64_t)) &	\
+	 ~(sizeof(uint64_t) - 1))
+#define IMPRINTS_SIZE(W, B, P)						\
+	(IMPRINTS_DICT_OFF(W, B, P) + (P) * sizeof(cchdc_t))
+
+#define IMPRINTS_SYNCED		((size_t) 1 << 16)
+
+/* number of imprints "pages" needed for cnt values of width w */
+#define IMPRINTS_PAGES(cnt, w)	((((size_t) (cnt) * (w)) + IMPS_PAGE - 1) / IMPS_PAGE)
 
 #define BINSIZE(B, FUNC, T) do {		\
 	switch (B) {				\
@@ -48,8 +75,8 @@ do {									\
 	const TYPE *restrict col = (TYPE *) Tloc(b, 0);			\
 	const TYPE *restrict bins = (TYPE *) inbins;			\
 	const BUN page = IMPS_PAGE / sizeof(TYPE);			\
-	prvmask = 0;							\
-	for (i = 0; i < b->batCount; ) {				\
+	prvmask = icnt > 0 ? im[icnt - 1] : 0;				\
+	for (i = first; i < b->batCount; ) {				\
 		const BUN lim = MIN(i + page, b->batCount);		\
 		/* new mask */						\
 		mask = 0;						\
@@ -58,7 +85,8 @@ do {									\
 			register const TYPE val = col[i];		\
 			GETBIN(bin,val,B);				\
 			mask = IMPSsetBit(B,mask,bin);			\
-			if (!is_##TYPE##_nil(val)) { /* do not count nils */ \
+			/* do not count nils, nor values counted before */ \
+			if (i >= start && !is_##TYPE##_nil(val)) {	\
 				if (!cnt_bins[bin]++) {			\
 					min_bins[bin] = max_bins[bin] = i; \
 				} else {				\
@@ -105,22 +133,47 @@ do {									\
 	}								\
 } while (0)
 
+/* Create the imprints for the values of b starting at start.  If start
+ * is not 0, impcnt and dictcnt describe the imprints of the first start
+ * values, and the values from start onward are added to them (the
+ * page that contained the last of those values is redone). */
 static void
 imprints_create(BAT *b, void *inbins, BUN *stats, bte bits,
-		void *imps, BUN *impcnt, cchdc_t *dict, BUN *dictcnt)
+		void *imps, BUN *impcnt, cchdc_t *dict, BUN *dictcnt,
+		BUN start)
 {
-	BUN i;
+	BUN i, first;
 	BUN dcnt, icnt;
 	BUN *restrict min_bins = stats;
 	BUN *restrict max_bins = min_bins + 64;
 	BUN *restrict cnt_bins = max_bins + 64;
 	int bin = 0;
-	dcnt = icnt = 0;
+
+	if (start == 0) {
+		dcnt = icnt = 0;
 #ifndef NDEBUG
-	memset(min_bins, 0, 64 * SIZEOF_BUN);
-	memset(max_bins, 0, 64 * SIZEOF_BUN);
+		memset(min_bins, 0, 64 * SIZEOF_BUN);
+		memset(max_bins, 0, 64 * SIZEOF_BUN);
 #endif
-	memset(cnt_bins, 0, 64 * SIZEOF_BUN);
+		memset(cnt_bins, 0, 64 * SIZEOF_BUN);
+	} else {
+		dcnt = *dictcnt;
+		icnt = *impcnt;
+	}
+	first = start - start % (IMPS_PAGE / b->twidth);
+	if (first < start) {
+		/* the last page is incomplete: remove it from the
+		 * imprints, it is created again below */
+		assert(dcnt > 0 && icnt > 0);
+		if (dict[dcnt - 1].repeat && dict[dcnt - 1].cnt > 1) {
+			/* the mask stays for the other pages */
+			dict[dcnt - 1].cnt--;
+		} else {
+			icnt--;
+			if (--dict[dcnt - 1].cnt == 0)
+				dcnt--;
+		}
+	}
 
 	switch (ATOMbasetype(b->ttype)) {
 	case TYPE_bte:
@@ -182,6 +235,61 @@ do {									\
 	}								\
 } while (0)
 
+/* set the pointers into the imprints heap which has room for pages
+ * pages */
+static void
+imprints_setptrs(Imprints *imprints, int width, size_t pages)
+{
+	imprints->bins = imprints->imprints.base + IMPRINTS_HEADER_SIZE * SIZEOF_SIZE_T;
+	imprints->stats = (BUN *) ((char *) imprints->bins + 64 * width);
+	imprints->imps = (void *) (imprints->stats + 64 * 3);
+	imprints->dict = (void *) (imprints->imprints.base + IMPRINTS_DICT_OFF(width, imprints->bits, pages));
+}
+
+/* the size of the persisted imprints with header hdr if they
+ * describe the first cnt values of b, or 0 */
+static size_t
+imprints_check(const BAT *b, BUN cnt, const size_t *hdr)
+{
+	if (!(hdr[0] & IMPRINTS_SYNCED) ||
+	    ((hdr[0] & 0xFF00) >> 8) != IMPRINTS_VERSION ||
+	    hdr[3] != (size_t) cnt ||
+	    hdr[4] < IMPRINTS_PAGES(cnt, b->twidth) ||
+	    hdr[1] > hdr[4] ||
+	    hdr[2] > hdr[4] ||
+	    hdr[5] > hdr[3])
+		return 0;
+	return IMPRINTS_DICT_OFF(b->twidth, (bte) hdr[0], hdr[4]) +
+		hdr[2] * sizeof(cchdc_t);
+}
+
+/* Load the persisted imprints of b if they describe the first cnt
+ * values of b, and set b->timprints accordingly.  Must be called with
+ * the imprints lock held and b->timprints == (Imprints *) 1. */
+static void
+imprints_load(BAT *b, BUN cnt)
+{
+	Imprints *imprints;
+
+	b->timprints = NULL;
+	if ((imprints = GDKzalloc(sizeof(Imprints))) != NULL &&
+	    (imprints->imprints.farmid = BBPselectfarm(b->batRole, b->ttype, imprintsheap)) >= 0 &&
+	    HEAPloadaux(&imprints->imprints, b, cnt, "timprints", IMPRINTS_HEADER_SIZE, imprints_check) == GDK_SUCCEED) {
+		const size_t *hdr = (const size_t *) imprints->imprints.base;
+
+		imprints->bits = (bte) (hdr[0] & 0xFF);
+		imprints->impcnt = (BUN) hdr[1];
+		imprints->dictcnt = (BUN) hdr[2];
+		imprints_setptrs(imprints, b->twidth, hdr[4]);
+		imprints->imprints.parentid = b->batCacheid;
+		b->timprints = imprints;
+		ALGODEBUG fprintf(stderr, "#BATcheckimprints: reusing persisted imprints %d\n", b->batCacheid);
+		return;
+	}
+	GDKfree(imprints);
+	GDKclrerr();	/* we're not currently interested in errors */
+}
+
 /* Check whether we have imprints on b (and return true if we do).  It
  * may be that the imprints were made persistent, but we hadn't seen
  * that yet, so check the file system.  This also returns true if b is
@@ -190,8 +298,8 @@ do {									\
  * Note that the b->timprints pointer can be NULL, meaning there are
  * no imprints; (Imprints *) 1, meaning there are no imprints loaded,
  * but they may exist on disk; or a valid pointer to loaded imprints.
- * These values are maintained here, in the IMPSdestroy and IMPSfree
- * functions, and in BBPdiskscan during initialization. */
+ * These values are maintained here, in the IMPSappend, IMPSdestroy and
+ * IMPSfree functions, and in BBPdiskscan during initialization. */
 bool
 BATcheckimprints(BAT *b)
 {
@@ -204,61 +312,11 @@ BATcheckimprints(BAT *b)
 
 	MT_lock_set(&GDKimprintsLock(b->batCacheid));
 	if (b->timprints == (Imprints *) 1) {
-		Imprints *imprints;
-		const char *nme = BBP_physical(b->batCacheid);
-
-		b->timprints = NULL;
-		if ((imprints = GDKzalloc(sizeof(Imprints))) != NULL &&
-		    (imprints->imprints.farmid = BBPselectfarm(b->batRole, b->ttype, imprintsheap)) >= 0) {
-			int fd;
-
-			snprintf(imprints->imprints.filename, sizeof(imprints->imprints.filename), "%s.timprints", nme);
-			/* check whether a persisted imprints index
-			 * can be found */
-			if ((fd = GDKfdlocate(imprints->imprints.farmid, nme, "rb", "timprints")) >= 0) {
-				size_t hdata[4];
-				struct stat st;
-				size_t pages;
-
-				pages = (((size_t) BATcount(b) * b->twidth) + IMPS_PAGE - 1) / IMPS_PAGE;
-				if (read(fd, hdata, sizeof(hdata)) == sizeof(hdata) &&
-				    hdata[0] & ((size_t) 1 << 16) &&
-				    ((hdata[0] & 0xFF00) >> 8) == IMPRINTS_VERSION &&
-				    hdata[3] == (size_t) BATcount(b) &&
-				    fstat(fd, &st) == 0 &&
-				    st.st_size >= (off_t) (imprints->imprints.size =
-							   imprints->imprints.free =
-							   64 * b->twidth +
-							   64 * 2 * SIZEOF_OID +
-							   64 * SIZEOF_BUN +
-							   pages * ((bte) hdata[0] / 8) +
-							   hdata[2] * sizeof(cchdc_t) +
-							   sizeof(uint64_t) /* padding for alignment */
-							   + 4 * SIZEOF_SIZE_T) &&
-				    HEAPload(&imprints->imprints, nme, "timprints", 0) == GDK_SUCCEED) {
-					/* usable */
-					imprints->bits = (bte) (hdata[0] & 0xFF);
-					imprints->impcnt = (BUN) hdata[1];
-					imprints->dictcnt = (BUN) hdata[2];
-					imprints->bins = imprints->imprints.base + 4 * SIZEOF_SIZE_T;
-					imprints->stats = (BUN *) ((char *) imprints->bins + 64 * b->twidth);
-					imprints->imps = (void *) (imprints->stats + 64 * 3);
-					imprints->dict = (void *) ((uintptr_t) ((char *) imprints->imps + pages * (imprints->bits / 8) + sizeof(uint64_t)) & ~(sizeof(uint64_t) - 1));
-					close(fd);
-					imprints->imprints.parentid = b->batCacheid;
-					b->timprints = imprints;
-					ALGODEBUG fprintf(stderr, "#BATcheckimprints: reusing persisted imprints %d\n", b->batCacheid);
-					MT_lock_unset(&GDKimprintsLock(b->batCacheid));
-
-					return true;
-				}
-				close(fd);
-				/* unlink unusable file */
-				GDKunlink(imprints->imprints.farmid, BATDIR, nme, "timprints");
-			}
+		imprints_load(b, BATcount(b));
+		if (b->timprints != NULL) {
+			MT_lock_unset(&GDKimprintsLock(b->batCacheid));
+			return true;
 		}
-		GDKfree(imprints);
-		GDKclrerr();	/* we're not currently interested in errors */
 	}
 	ret = b->timprints != NULL;
 	MT_lock_unset(&GDKimprintsLock(b->batCacheid));
@@ -266,6 +324,18 @@ BATcheckimprints(BAT *b)
 	return ret;
 }
 
+/* Write the imprints to disk, and when that succeeded, mark them as
+ * usable on disk.  Must be called with the imprints lock held. */
+static void
+imprints_persist(BAT *b, Imprints *imprints)
+{
+	if (HEAPsaveaux(&imprints->imprints, b, "timprints", IMPRINTS_SYNCED) != GDK_SUCCEED) {
+		GDKclrerr();	/* not persisting is not an error */
+		return;
+	}
+	ALGODEBUG fprintf(stderr, "#BATimprints: persisting imprints\n");
+}
+
 gdk_return
 BATimprints(BAT *b)
 {
@@ -312,7 +382,6 @@ BATimprints(BAT *b)
 		BUN cnt;
 		const char *nme = BBP_physical(b->batCacheid);
 		size_t pages;
-		int fd;
 
 		ALGODEBUG fprintf(stderr, "#BATimprints(b=%s#" BUNFMT ") %s: "
 				  "created imprints\n", BATgetId(b),
@@ -324,7 +393,7 @@ BATimprints(BAT *b)
 			return GDK_FAIL;
 		}
 		snprintf(imprints->imprints.filename, sizeof(imprints->imprints.filename), "%s.timprints", nme);
-		pages = (((size_t) BATcount(b) * b->twidth) + IMPS_PAGE - 1) / IMPS_PAGE;
+		pages = IMPRINTS_PAGES(BATcount(b), b->twidth);
 		imprints->imprints.farmid = BBPselectfarm(b->batRole, b->ttype,
 							   imprintsheap);
 
@@ -370,23 +439,13 @@ BATimprints(BAT *b)
 		if (cnt <= 8)
 			imprints->bits = 8;
 
-		/* The heap we create here consists of four parts:
-		 * bins, max 64 entries with bin boundaries, domain of b;
-		 * stats, min/max/count for each bin, min/max are oid, and count BUN;
-		 * imps, max one entry per "page", entry is "bits" wide;
-		 * dict, max two entries per three "pages".
-		 * In addition, we add some housekeeping entries at
-		 * the start so that we can determine whether we can
-		 * trust the imprints when encountered on startup (including
-		 * a version number -- CURRENT VERSION is 2). */
+		/* See IMPRINTS_SIZE for the layout of the heap.  The
+		 * housekeeping entries at the start allow us to
+		 * determine whether we can trust the imprints when
+		 * encountered on startup (including a version number
+		 * -- CURRENT VERSION is 3). */
 		if (HEAPalloc(&imprints->imprints,
-			      IMPRINTS_HEADER_SIZE * SIZEOF_SIZE_T + /* extra info */
-			      64 * b->twidth + /* bins */
-			      64 * 2 * SIZEOF_OID + /* {min,max}_bins */
-			      64 * SIZEOF_BUN +	    /* cnt_bins */
-			      pages * (imprints->bits / 8) + /* imps */
-			      sizeof(uint64_t) + /* padding for alignment */
-			      pages * sizeof(cchdc_t), /* dict */
+			      IMPRINTS_SIZE(b->twidth, imprints->bits, pages),
 			      1) != GDK_SUCCEED) {
 			MT_lock_unset(&GDKimprintsLock(b->batCacheid));
 			GDKfree(imprints);
@@ -397,10 +456,7 @@ BATimprints(BAT *b)
 			BBPunfix(s4->batCacheid);
 			return GDK_FAIL;
 		}
-		imprints->bins = imprints->imprints.base + IMPRINTS_HEADER_SIZE * SIZEOF_SIZE_T;
-		imprints->stats = (BUN *) ((char *) imprints->bins + 64 * b->twidth);
-		imprints->imps = (void *) (imprints->stats + 64 * 3);
-		imprints->dict = (void *) ((uintptr_t) ((char *) imprints->imps + pages * (imprints->bits / 8) + sizeof(uint64_t)) & ~(sizeof(uint64_t) - 1));
+		imprints_setptrs(imprints, b->twidth, pages);
 
 		switch (ATOMbasetype(b->ttype)) {
 		case TYPE_bte:
@@ -438,7 +494,8 @@ BATimprints(BAT *b)
 				imprints->imps,
 				&imprints->impcnt,
 				imprints->dict,
-				&imprints->dictcnt);
+				&imprints->dictcnt,
+				0);
 		assert(imprints->impcnt <= pages);
 		assert(imprints->dictcnt <= pages);
 #ifndef NDEBUG
@@ -446,32 +503,14 @@ BATimprints(BAT *b)
 #endif
 		imprints->imprints.free = (size_t) ((char *) ((cchdc_t *) imprints->dict + imprints->dictcnt) - imprints->imprints.base);
 		/* add info to heap for when they become persistent */
-		((size_t *) imprints->imprints.base)[0] = (size_t) (imprints->bits);
+		((size_t *) imprints->imprints.base)[0] = (size_t) (imprints->bits) | ((size_t) IMPRINTS_VERSION << 8);
 		((size_t *) imprints->imprints.base)[1] = (size_t) imprints->impcnt;
 		((size_t *) imprints->imprints.base)[2] = (size_t) imprints->dictcnt;
 		((size_t *) imprints->imprints.base)[3] = (size_t) BATcount(b);
-		if ((BBP_status(b->batCacheid) & BBPEXISTING) &&
-		    HEAPsave(&imprints->imprints, nme, "timprints") == GDK_SUCCEED &&
-		    (fd = GDKfdlocate(imprints->imprints.farmid, nme, "rb+",
-				      "timprints")) >= 0) {
-			ALGODEBUG fprintf(stderr, "#BATimprints: persisting imprints\n");
-			/* add version number */
-			((size_t *) imprints->imprints.base)[0] |= (size_t) IMPRINTS_VERSION << 8;
-			/* sync-on-disk checked bit */
-			((size_t *) imprints->imprints.base)[0] |= (size_t) 1 << 16;
-			if (write(fd, imprints->imprints.base, sizeof(size_t)) < 0)
-				perror("write imprints");
-			if (!(GDKdebug & NOSYNCMASK)) {
-#if defined(NATIVE_WIN32)
-				_commit(fd);
-#elif defined(HAVE_FDATASYNC)
-				fdatasync(fd);
-#elif defined(HAVE_FSYNC)
-				fsync(fd);
-#endif
-			}
-			close(fd);
-		}
+		((size_t *) imprints->imprints.base)[4] = pages;
+		((size_t *) imprints->imprints.base)[5] = (size_t) BATcount(b);
+		if (BBP_status(b->batCacheid) & BBPEXISTING)
+			imprints_persist(b, imprints);
 		imprints->imprints.parentid = b->batCacheid;
 		b->timprints = imprints;
 	}
@@ -578,7 +617,7 @@ IMPSremove(BAT *b)
 		b->timprints = NULL;
 
 		if ((GDKdebug & ALGOMASK) &&
-		    * (size_t *) imprints->imprints.base & (1 << 16))
+		    * (size_t *) imprints->imprints.base & IMPRINTS_SYNCED)
 			fprintf(stderr, "#IMPSremove: removing persisted imprints\n");
 		if (HEAPdelete(&imprints->imprints, BBP_physical(b->batCacheid),
 			       "timprints") != GDK_SUCCEED)
@@ -605,6 +644,107 @@ IMPSdestroy(BAT *b)
 	}
 }
 
+/* Extend the imprints of b, which describe the first start values of
+ * b, with the values that were appended after those.  The bins are
+ * not changed, so once b has grown to more than twice the number of
+ * values the imprints were built for, the imprints are destroyed
+ * instead and created anew (with new bins) when next needed. */
+void
+IMPSappend(BAT *b, BUN start)
+{
+	Imprints *imprints;
+	size_t *hdr, pages, cap, ncap;
+	lng t0 = 0;
+
+	if (b == NULL || b->timprints == NULL)
+		return;
+	assert(!VIEWtparent(b));
+	if (start == 0) {
+		IMPSdestroy(b);
+		return;
+	}
+	MT_lock_set(&GDKimprintsLock(b->batCacheid));
+	ALGODEBUG t0 = GDKusec();
+	if (b->timprints == (Imprints *) 1)
+		imprints_load(b, start);
+	if ((imprints = b->timprints) == NULL) {
+		MT_lock_unset(&GDKimprintsLock(b->batCacheid));
+		return;
+	}
+	hdr = (size_t *) imprints->imprints.base;
+	if (hdr[3] != (size_t) start ||
+	    (size_t) BATcount(b) > 2 * hdr[5])
+		goto bailout;
+	/* the persisted imprints will not describe b anymore */
+	if (HEAPunsyncaux(&imprints->imprints, b, "timprints", IMPRINTS_SYNCED) != GDK_SUCCEED)
+		goto bailout;
+
+	/* make room for the new pages; the dict moves along with the
+	 * end of the imps */
+	pages = IMPRINTS_PAGES(BATcount(b), b->twidth);
+	cap = ncap = hdr[4];
+	if (pages > cap)
+		ncap = MAX(pages, cap + cap / 2);
+	if (imprints->imprints.size < IMPRINTS_SIZE(b->twidth, imprints->bits, ncap)) {
+		if (HEAPextend(&imprints->imprints, IMPRINTS_SIZE(b->twidth, imprints->bits, ncap), 0) != GDK_SUCCEED)
+			goto bailout;
+		imprints_setptrs(imprints, b->twidth, cap);
+	}
+	if (ncap != cap) {
+		cchdc_t *odict = imprints->dict;
+
+		imprints_setptrs(imprints, b->twidth, ncap);
+		memmove(imprints->dict, odict, imprints->dictcnt * sizeof(cchdc_t));
+	}
+	hdr = (size_t *) imprints->imprints.base;
+
+	imprints_create(b,
+			imprints->bins,
+			imprints->stats,
+			imprints->bits,
+			imprints->imps,
+			&imprints->impcnt,
+			imprints->dict,
+			&imprints->dictcnt,
+			start);
+	assert(imprints->impcnt <= pages);
+	assert(imprints->dictcnt <= pages);
+	imprints->imprints.free = (size_t) ((char *) ((cchdc_t *) imprints->dict + imprints->dictcnt) - imprints->imprints.base);
+	imprints->imprints.dirty = 1;
+	hdr[1] = (size_t) imprints->impcnt;
+	hdr[2] = (size_t) imprints->dictcnt;
+	hdr[3] = (size_t) BATcount(b);
+	hdr[4] = ncap;
+	ALGODEBUG fprintf(stderr, "#IMPSappend(b=%s#" BUNFMT "): extended imprints from " BUNFMT " values in " LLFMT " usec\n", BATgetId(b), BATcount(b), start, GDKusec() - t0);
+	MT_lock_unset(&GDKimprintsLock(b->batCacheid));
+	return;
+
+  bailout:
+	MT_lock_unset(&GDKimprintsLock(b->batCacheid));
+	GDKclrerr();	/* not maintaining the imprints is not an error */
+	IMPSdestroy(b);
+}
+
+/* Persist the imprints of the persistent BAT b if they were changed
+ * (or created) since they were last written to disk.  Called when b
+ * itself is saved, so that they survive a restart. */
+void
+IMPSpersist(BAT *b)
+{
+	Imprints *imprints;
+
+	if (b->timprints == NULL || b->timprints == (Imprints *) 1 ||
+	    VIEWtparent(b))
+		return;
+	MT_lock_set(&GDKimprintsLock(b->batCacheid));
+	if ((imprints = b->timprints) != NULL &&
+	    imprints != (Imprints *) 1 &&
+	    !(((size_t *) imprints->imprints.base)[0] & IMPRINTS_SYNCED) &&
+	    ((size_t *) imprints->imprints.base)[3] == (size_t) BATcount(b))
+		imprints_persist(b, imprints);
+	MT_lock_unset(&GDKimprintsLock(b->batCacheid));
+}
+
 /* free the memory associated with the imprints, do not remove the
  * heap files; indicate that imprints are available on disk by setting
  * the imprints pointer to 1 */
@@ -2658,6 +2658,8 @@ hashjoin(BAT *r1, BAT *r2, BAT *l, BAT *r, BAT *sl, BAT *sr, bool nil_matches,
 	bool lskipped = false;	/* whether we skipped values in l */
 	const Hash *restrict hsh;
 	int t;
+	const unsigned int *lfps = NULL, *rfps = NULL;
+	Heap *lpin = NULL, *rpin = NULL; /* keep lfps and rfps valid */
 
 	ALGODEBUG fprintf(stderr, "#hashjoin(l=%s#" BUNFMT "[%s]%s%s%s,"
 			  "r=%s#" BUNFMT "[%s]%s%s%s,sl=%s#" BUNFMT "%s%s%s,"
@@ -2754,6 +2756,18 @@ hashjoin(BAT *r1, BAT *r2, BAT *l, BAT *r, BAT *sl, BAT *sr, bool nil_matches,
 	nrcand = (BUN) (rcandend - rcand);
 	hsh = r->thash;
 	t = ATOMbasetype(r->ttype);
+	if (t == TYPE_str) {
+		/* the fingerprints of strings are the low 32 bits of
+		 * their hash values: use them instead of hashing the
+		 * values of l, and to skip most values of r that
+		 * don't match without looking at them */
+		lfps = PCKfingerprints(l, &lpin);
+		rfps = PCKfingerprints(r, &rpin);
+#if SIZEOF_BUN > 4
+		if (hsh->mask > (BUN) 0xFFFFFFFF)
+			lfps = NULL;
+#endif
+	}
 
 	if (lcand == NULL && rcand == NULL && lvars == NULL &&
 	    !nil_matches && !nil_on_miss && !semi && !only_misses &&
@@ -2954,6 +2968,28 @@ hashjoin(BAT *r1, BAT *r2, BAT *l, BAT *r, BAT *sl, BAT *sr, bool nil_matches,
 					}
 					break;
 #endif
+				case TYPE_str:
+					if (nil_matches || !GDK_STRNIL(v)) {
+						BUN hv = lfps ? (BUN) lfps[lstart - 1] : strHash(v);
+
+						for (rb = HASHget(hsh, hv & hsh->mask);
+						     rb != HASHnil(hsh);
+						     rb = HASHgetlink(hsh, rb)) {
+							if (rb < rl || rb >= rh ||
+							    (rfps && rfps[rb] != (unsigned int) hv) ||
+							    !GDK_STREQ(v, BUNtvar(ri, rb)))
+								continue;
+							ro = (oid) (rb - rl + rseq);
+							if (only_misses) {
+								nr++;
+								break;
+							}
+							HASHLOOPBODY();
+							if (semi)
+								break;
+						}
+					}
+					break;
 				default:
 					if (nil_matches || cmp(v, nil) != 0) {
 						HASHloop_bound(ri, hsh, rb, v, rl, rh) {
@@ -3025,6 +3061,8 @@ hashjoin(BAT *r1, BAT *r2, BAT *l, BAT *r, BAT *sl, BAT *sr, bool nil_matches,
 				r1->trevsorted = false;
 		}
 	}
+	PCKunpin(lpin);
+	PCKunpin(rpin);
 	/* also set other bits of heap to correct value to indicate size */
 	BATsetcount(r1, BATcount(r1));
 	if (BATcount(r1) <= 1) {
@@ -3070,6 +3108,480 @@ hashjoin(BAT *r1, BAT *r2, BAT *l, BAT *r, BAT *sl, BAT *sr, bool nil_matches,
 	return GDK_SUCCEED;
 
   bailout:
+	PCKunpin(lpin);
+	PCKunpin(rpin);
+	BBPreclaim(r1);
+	BBPreclaim(r2);
+	return GDK_FAIL;
+}
+
+/* Radix-partitioned hash join.
+ *
+ * When the inner (right) side of a join is large, a single hash table
+ * over all of it is much larger than the CPU caches, and each insert
+ * and each probe costs a cache miss and often a TLB miss as well.
+ * Instead, we partition both inputs on the low bits of a hash of the
+ * value into partitions small enough that their hash tables fit in
+ * the cache, and then join corresponding partitions using a small
+ * hash table per partition.  Partitioning takes one or two passes,
+ * each of which writes to at most 1 << RADIX_PASS_BITS partitions at
+ * the same time so that the scattered writes don't thrash the TLB.
+ * All phases are spread over GDKnr_threads threads: the first pass
+ * over slices of the inputs, the other phases over partitions.
+ *
+ * This is only used for the common case of a join of two int or lng
+ * (or types stored as such) columns without (or with dense)
+ * candidate lists where nils don't match, see BATjoin.  The number of
+ * matches of each left value is counted first, so that the results
+ * can be written in the order of the left input, which means that,
+ * just like with hashjoin, the left output is sorted. */
+
+/* minimum size of the inner side for which we use a radix join */
+#define RADIX_JOIN_MIN		((BUN) 1 << 20)
+/* targeted number of inner values per partition */
+#define RADIX_PART_SIZE		((BUN) 1 << 14)
+/* maximum number of radix bits per partitioning pass */
+#define RADIX_PASS_BITS		8
+
+#define RADIX_HIST	0	/* count partition sizes of first pass */
+#define RADIX_SCATTER	1	/* first partitioning pass */
+#define RADIX_REFINE	2	/* second partitioning pass */
+#define RADIX_COUNT	3	/* build hash tables and count results */
+#define RADIX_PROBE	4	/* produce results */
+
+struct radixjoin {
+	int type;		/* TYPE_int or TYPE_lng */
+	int nthreads;
+	int b1, b2;		/* radix bits of first and second pass */
+	BUN nparts;		/* total number of partitions */
+	struct radixside {
+		const void *vals; /* input values */
+		oid seq;	/* oid of first input value */
+		BUN cnt;	/* number of input values */
+		void *tuples;	/* partitioned (value, oid) pairs */
+		void *tmp;	/* result of first of two passes */
+		BUN *hist;	/* per thread offsets for first pass */
+		BUN *bounds1;	/* partitions of first pass */
+		BUN *bounds;	/* partition p is [bounds[p], bounds[p+1]) */
+	} side[2];		/* [0] is left, [1] is right */
+	BUN *bstart;		/* first hash bucket of each partition */
+	BUN *buckets;		/* hash buckets (index + 1 into right) */
+	BUN *links;		/* hash chains (index + 1 into right) */
+	BUN *lpos;		/* results per left value, then offsets */
+	oid *r1, *r2;		/* results */
+	MT_Lock lock;		/* protects next */
+	BUN next;		/* next partition to be claimed */
+};
+
+struct radixarg {
+	struct radixjoin *rj;
+	int id;
+	int phase;
+};
+
+static BUN
+radixclaim(struct radixjoin *rj)
+{
+	BUN p;
+
+	MT_lock_set(&rj->lock);
+	p = rj->next++;
+	MT_lock_unset(&rj->lock);
+	return p;
+}
+
+static inline BUN
+radixhash_int(int v)
+{
+	unsigned int h = (unsigned int) v * 0x9E3779B1U;
+
+	return (BUN) (h ^ (h >> 16));
+}
+
+static inline BUN
+radixhash_lng(lng v)
+{
+	ulng h = (ulng) v * (ulng) LL_CONSTANT(0x9E3779B97F4A7C15);
+
+	return (BUN) (h ^ (h >> 32));
+}
+
+#define RADIXPHASE(TYPE)						\
+typedef struct {							\
+	TYPE v;								\
+	oid o;								\
+} radixtuple_##TYPE;							\
+									\
+static void								\
+radixphase_##TYPE(struct radixjoin *rj, int phase, int id)		\
+{									\
+	const BUN P1 = (BUN) 1 << rj->b1;				\
+	const BUN P2 = (BUN) 1 << rj->b2;				\
+	const int shift = rj->b1 + rj->b2;				\
+	struct radixside *sd;						\
+	const radixtuple_##TYPE *restrict lt, *restrict rt;		\
+	BUN i, j, k, p, lo, hi, *restrict h;				\
+	oid seq;							\
+	int s;								\
+									\
+	switch (phase) {						\
+	case RADIX_HIST:						\
+	case RADIX_SCATTER:						\
+		/* each thread does its own slice of both inputs */	\
+		for (s = 0; s < 2; s++) {				\
+			const TYPE *restrict vals;			\
+			radixtuple_##TYPE *restrict dst;		\
+									\
+			sd = &rj->side[s];				\
+			vals = sd->vals;				\
+			lo = (BUN) id * (sd->cnt / rj->nthreads);	\
+			hi = id == rj->nthreads - 1 ? sd->cnt :		\
+				lo + sd->cnt / rj->nthreads;		\
+			h = sd->hist + (BUN) id * P1;			\
+			if (phase == RADIX_HIST) {			\
+				for (i = lo; i < hi; i++)		\
+					if (!is_##TYPE##_nil(vals[i]))	\
+						h[radixhash_##TYPE(vals[i]) & (P1 - 1)]++; \
+				continue;				\
+			}						\
+			dst = rj->b2 ? sd->tmp : sd->tuples;		\
+			for (i = lo; i < hi; i++) {			\
+				if (!is_##TYPE##_nil(vals[i])) {	\
+					p = radixhash_##TYPE(vals[i]) & (P1 - 1); \
+					dst[h[p]].v = vals[i];		\
+					dst[h[p]].o = sd->seq + i;	\
+					h[p]++;				\
+				}					\
+			}						\
+		}							\
+		break;							\
+	case RADIX_REFINE:						\
+		/* split each partition of the first pass further */	\
+		while ((p = radixclaim(rj)) < 2 * P1) {			\
+			BUN cnt[1 << RADIX_PASS_BITS];			\
+			const radixtuple_##TYPE *restrict src;		\
+			radixtuple_##TYPE *restrict dst;		\
+									\
+			sd = &rj->side[p & 1];				\
+			p >>= 1;					\
+			src = sd->tmp;					\
+			dst = sd->tuples;				\
+			lo = sd->bounds1[p];				\
+			hi = sd->bounds1[p + 1];			\
+			memset(cnt, 0, P2 * sizeof(BUN));		\
+			for (i = lo; i < hi; i++)			\
+				cnt[(radixhash_##TYPE(src[i].v) >> rj->b1) & (P2 - 1)]++; \
+			for (j = 0, k = lo; j < P2; j++) {		\
+				sd->bounds[p * P2 + j] = k;		\
+				k += cnt[j];				\
+				cnt[j] = sd->bounds[p * P2 + j];	\
+			}						\
+			for (i = lo; i < hi; i++)			\
+				dst[cnt[(radixhash_##TYPE(src[i].v) >> rj->b1) & (P2 - 1)]++] = src[i]; \
+		}							\
+		break;							\
+	case RADIX_COUNT:						\
+	case RADIX_PROBE:						\
+		lt = rj->side[0].tuples;				\
+		rt = rj->side[1].tuples;				\
+		seq = rj->side[0].seq;					\
+		while ((p = radixclaim(rj)) < rj->nparts) {		\
+			BUN *restrict bk = rj->buckets + rj->bstart[p];	\
+			const BUN mask = rj->bstart[p + 1] - rj->bstart[p] - 1; \
+			BUN *restrict links = rj->links;		\
+			BUN nr = 0;					\
+									\
+			lo = rj->side[0].bounds[p];			\
+			hi = rj->side[0].bounds[p + 1];			\
+			if (lo == hi ||					\
+			    rj->side[1].bounds[p] == rj->side[1].bounds[p + 1]) \
+				continue; /* lpos is zero-initialized */ \
+			if (phase == RADIX_COUNT) {			\
+				/* build hash table of right partition */ \
+				for (j = rj->side[1].bounds[p + 1];	\
+				     j > rj->side[1].bounds[p];		\
+				     j--) {				\
+					k = (radixhash_##TYPE(rt[j - 1].v) >> shift) & mask; \
+					links[j - 1] = bk[k];		\
+					bk[k] = j;			\
+				}					\
+				for (i = lo; i < hi; i++) {		\
+					k = (radixhash_##TYPE(lt[i].v) >> shift) & mask; \
+					nr = 0;				\
+					for (j = bk[k]; j; j = links[j - 1]) \
+						nr += rt[j - 1].v == lt[i].v; \
+					rj->lpos[lt[i].o - seq] = nr;	\
+				}					\
+			} else {					\
+				oid *restrict r1 = rj->r1;		\
+				oid *restrict r2 = rj->r2;		\
+									\
+				for (i = lo; i < hi; i++) {		\
+					k = (radixhash_##TYPE(lt[i].v) >> shift) & mask; \
+					nr = rj->lpos[lt[i].o - seq];	\
+					for (j = bk[k]; j; j = links[j - 1]) { \
+						if (rt[j - 1].v == lt[i].v) { \
+							r1[nr] = lt[i].o; \
+							if (r2)		\
+								r2[nr] = rt[j - 1].o; \
+							nr++;		\
+						}			\
+					}				\
+				}					\
+			}						\
+		}							\
+		break;							\
+	}								\
+}
+
+RADIXPHASE(int)
+RADIXPHASE(lng)
+
+static void
+radixworker(void *arg)
+{
+	struct radixarg *a = arg;
+
+	if (a->rj->type == TYPE_int)
+		radixphase_int(a->rj, a->phase, a->id);
+	else
+		radixphase_lng(a->rj, a->phase, a->id);
+}
+
+/* run one phase of the radix join on all threads */
+static void
+radixrun(struct radixjoin *rj, struct radixarg *args, MT_Id *tids, int phase)
+{
+	int i;
+
+	rj->next = 0;
+	for (i = 0; i < rj->nthreads; i++) {
+		args[i] = (struct radixarg) {
+			.rj = rj,
+			.id = i,
+			.phase = phase,
+		};
+		tids[i] = 0;
+		if (i > 0 &&
+		    MT_create_thread(&tids[i], radixworker, &args[i],
+				     MT_THR_JOINABLE) < 0)
+			tids[i] = 0;
+	}
+	radixworker(&args[0]);
+	for (i = 1; i < rj->nthreads; i++) {
+		if (tids[i])
+			MT_join_thread(tids[i]);
+		else
+			radixworker(&args[i]); /* do the work ourselves */
+	}
+}
+
+static void
+radixfree(struct radixjoin *rj, struct radixarg *args, MT_Id *tids)
+{
+	int s;
+
+	for (s = 0; s < 2; s++) {
+		GDKfree(rj->side[s].tuples);
+		GDKfree(rj->side[s].tmp);
+		GDKfree(rj->side[s].hist);
+		if (rj->side[s].bounds != rj->side[s].bounds1)
+			GDKfree(rj->side[s].bounds);
+		GDKfree(rj->side[s].bounds1);
+	}
+	GDKfree(rj->bstart);
+	GDKfree(rj->buckets);
+	GDKfree(rj->links);
+	GDKfree(rj->lpos);
+	GDKfree(tids);
+	GDKfree(args);
+	MT_lock_destroy(&rj->lock);
+}
+
+static gdk_return
+radixjoin(BAT *r1, BAT *r2, BAT *l, BAT *r, BAT *sl, BAT *sr,
+	  lng t0, bool swapped, const char *reason)
+{
+	BUN lstart, lend, lcnt;
+	const oid *lcand, *lcandend;
+	BUN rstart, rend, rcnt;
+	const oid *rcand, *rcandend;
+	struct radixjoin rj;
+	struct radixarg *args = NULL;
+	MT_Id *tids = NULL;
+	size_t tsize;
+	BUN p, n, nb, cnt;
+	int bits, s;
+
+	ALGODEBUG fprintf(stderr, "#radixjoin(l=%s#" BUNFMT "[%s]%s%s%s,"
+			  "r=%s#" BUNFMT "[%s]%s%s%s,sl=%s#" BUNFMT "%s%s%s,"
+			  "sr=%s#" BUNFMT "%s%s%s)%s%s%s\n",
+			  BATgetId(l), BATcount(l), ATOMname(l->ttype),
+			  l->tsorted ? "-sorted" : "",
+			  l->trevsorted ? "-revsorted" : "",
+			  l->tkey ? "-key" : "",
+			  BATgetId(r), BATcount(r), ATOMname(r->ttype),
+			  r->tsorted ? "-sorted" : "",
+			  r->trevsorted ? "-revsorted" : "",
+			  r->tkey ? "-key" : "",
+			  sl ? BATgetId(sl) : "NULL", sl ? BATcount(sl) : 0,
+			  sl && sl->tsorted ? "-sorted" : "",
+			  sl && sl->trevsorted ? "-revsorted" : "",
+			  sl && sl->tkey ? "-key" : "",
+			  sr ? BATgetId(sr) : "NULL", sr ? BATcount(sr) : 0,
+			  sr && sr->tsorted ? "-sorted" : "",
+			  sr && sr->trevsorted ? "-revsorted" : "",
+			  sr && sr->tkey ? "-key" : "",
+			  swapped ? " swapped" : "",
+			  *reason ? " " : "", reason);
+
+	assert(ATOMtype(l->ttype) == ATOMtype(r->ttype));
+	assert(ATOMsize(l->ttype) == sizeof(int) ||
+	       ATOMsize(l->ttype) == sizeof(lng));
+
+	CANDINIT(l, sl, lstart, lend, lcnt, lcand, lcandend);
+	CANDINIT(r, sr, rstart, rend, rcnt, rcand, rcandend);
+	assert(lcand == NULL && rcand == NULL);
+	(void) lcandend;
+	(void) rcandend;
+
+	if (lstart == lend || rstart == rend)
+		return nomatch(r1, r2, l, r, lstart, lend, NULL, NULL,
+			       false, false, "radixjoin", t0);
+
+	rj = (struct radixjoin) {
+		.type = ATOMsize(l->ttype) == sizeof(int) ? TYPE_int : TYPE_lng,
+		.side[0].vals = Tloc(l, lstart),
+		.side[0].seq = l->hseqbase + lstart,
+		.side[0].cnt = lend - lstart,
+		.side[1].vals = Tloc(r, rstart),
+		.side[1].seq = r->hseqbase + rstart,
+		.side[1].cnt = rend - rstart,
+	};
+	/* the oid pads the (int, oid) tuple to the size of the (lng,
+	 * oid) one, so both use the same amount of memory */
+	tsize = sizeof(radixtuple_lng);
+
+	/* number of radix bits such that the right partitions are
+	 * about RADIX_PART_SIZE */
+	for (bits = 1;
+	     bits < 2 * RADIX_PASS_BITS &&
+		     ((BUN) RADIX_PART_SIZE << bits) < rj.side[1].cnt;
+	     bits++)
+		;
+	rj.b1 = bits < RADIX_PASS_BITS ? bits : RADIX_PASS_BITS;
+	rj.b2 = bits - rj.b1;
+	rj.nparts = (BUN) 1 << bits;
+	n = (rj.side[0].cnt + rj.side[1].cnt) / RADIX_PART_SIZE;
+	rj.nthreads = GDKnr_threads <= 1 ? 1 : n < (BUN) GDKnr_threads ? (int) n + 1 : GDKnr_threads;
+	MT_lock_init(&rj.lock, "radixjoin");
+
+	args = GDKmalloc(rj.nthreads * sizeof(struct radixarg));
+	tids = GDKmalloc(rj.nthreads * sizeof(MT_Id));
+	rj.bstart = GDKmalloc((rj.nparts + 1) * sizeof(BUN));
+	rj.lpos = GDKzalloc((rj.side[0].cnt + 1) * sizeof(BUN));
+	rj.links = GDKmalloc(rj.side[1].cnt * sizeof(BUN));
+	if (args == NULL || tids == NULL || rj.bstart == NULL ||
+	    rj.lpos == NULL || rj.links == NULL)
+		goto bailout;
+	for (s = 0; s < 2; s++) {
+		struct radixside *sd = &rj.side[s];
+
+		sd->tuples = GDKmalloc(sd->cnt * tsize);
+		sd->hist = GDKzalloc(rj.nthreads * ((BUN) 1 << rj.b1) * sizeof(BUN));
+		sd->bounds1 = GDKmalloc((((BUN) 1 << rj.b1) + 1) * sizeof(BUN));
+		if (sd->tuples == NULL || sd->hist == NULL || sd->bounds1 == NULL)
+			goto bailout;
+		if (rj.b2) {
+			sd->tmp = GDKmalloc(sd->cnt * tsize);
+			sd->bounds = GDKmalloc((rj.nparts + 1) * sizeof(BUN));
+			if (sd->tmp == NULL || sd->bounds == NULL)
+				goto bailout;
+		} else {
+			sd->bounds = sd->bounds1;
+		}
+	}
+
+	/* first partitioning pass: histogram, then convert the per
+	 * thread histograms into the offsets where each thread
+	 * writes its values of each partition */
+	radixrun(&rj, args, tids, RADIX_HIST);
+	for (s = 0; s < 2; s++) {
+		struct radixside *sd = &rj.side[s];
+		BUN P1 = (BUN) 1 << rj.b1;
+		int t;
+
+		for (p = 0, cnt = 0; p < P1; p++) {
+			sd->bounds1[p] = cnt;
+			for (t = 0; t < rj.nthreads; t++) {
+				n = sd->hist[t * P1 + p];
+				sd->hist[t * P1 + p] = cnt;
+				cnt += n;
+			}
+		}
+		sd->bounds1[P1] = cnt;
+		sd->bounds[rj.nparts] = cnt; /* nils were skipped */
+	}
+	radixrun(&rj, args, tids, RADIX_SCATTER);
+	if (rj.b2)
+		radixrun(&rj, args, tids, RADIX_REFINE);
+
+	/* a power of two number of hash buckets per partition */
+	for (p = 0, nb = 0; p < rj.nparts; p++) {
+		rj.bstart[p] = nb;
+		cnt = rj.side[1].bounds[p + 1] - rj.side[1].bounds[p];
+		for (n = 1; n < cnt; n <<= 1)
+			;
+		nb += n;
+	}
+	rj.bstart[rj.nparts] = nb;
+	if ((rj.buckets = GDKzalloc(nb * sizeof(BUN))) == NULL)
+		goto bailout;
+
+	/* count the matches of each left value, then turn the counts
+	 * into the offsets where its results go, so that the output
+	 * is in the order of the left input */
+	radixrun(&rj, args, tids, RADIX_COUNT);
+	for (p = 0, cnt = 0; p < rj.side[0].cnt; p++) {
+		n = rj.lpos[p];
+		rj.lpos[p] = cnt;
+		cnt += n;
+	}
+	if (cnt > BATcapacity(r1) &&
+	    (BATextend(r1, cnt) != GDK_SUCCEED ||
+	     (r2 && BATextend(r2, cnt) != GDK_SUCCEED)))
+		goto bailout;
+	rj.r1 = (oid *) Tloc(r1, 0);
+	rj.r2 = r2 ? (oid *) Tloc(r2, 0) : NULL;
+	radixrun(&rj, args, tids, RADIX_PROBE);
+
+	radixfree(&rj, args, tids);
+
+	/* the left output is sorted, and it is key if each left value
+	 * matches at most one right value, in which case it is dense
+	 * if all left values matched; the right output is not
+	 * ordered */
+	BATsetcount(r1, cnt);
+	r1->tsorted = true;
+	r1->trevsorted = cnt <= 1;
+	r1->tkey = r->tkey || cnt <= 1;
+	r1->tseqbase = cnt == 0 ? 0 : r1->tkey && cnt == rj.side[0].cnt ? rj.side[0].seq : cnt == 1 ? *(oid *) Tloc(r1, 0) : oid_nil;
+	if (r2) {
+		BATsetcount(r2, cnt);
+		r2->tkey = l->tkey || cnt <= 1;
+		r2->tsorted = r2->trevsorted = cnt <= 1;
+		r2->tseqbase = cnt == 0 ? 0 : cnt == 1 ? *(oid *) Tloc(r2, 0) : oid_nil;
+	}
+	ALGODEBUG fprintf(stderr, "#radixjoin(l=%s,r=%s)=(%s#"BUNFMT",%s#"BUNFMT") "
+			  "%d bits, %d threads " LLFMT "us\n",
+			  BATgetId(l), BATgetId(r),
+			  BATgetId(r1), BATcount(r1),
+			  r2 ? BATgetId(r2) : "--", r2 ? BATcount(r2) : 0,
+			  bits, rj.nthreads, GDKusec() - t0);
+	return GDK_SUCCEED;
+
+  bailout:
+	radixfree(&rj, args, tids);
 	BBPreclaim(r1);
 	BBPreclaim(r2);
 	return GDK_FAIL;
@@ -4109,6 +4621,25 @@ BATjoin(BAT **r1p, BAT **r2p, BAT *l, BAT *r, BAT *sl, BAT *sr, int nil_matches,
 		swap = true;
 		reason = "left is smaller";
 	}
+	if (!(swap ? lhash : rhash) &&
+	    (swap ? lcount : rcount) >= RADIX_JOIN_MIN &&
+	    !nil_matches &&
+	    !BATtvoid(l) && !BATtvoid(r) &&
+	    (sl == NULL || BATtdense(sl)) &&
+	    (sr == NULL || BATtdense(sr)) &&
+	    (ATOMbasetype(l->ttype) == TYPE_int ||
+	     ATOMbasetype(l->ttype) == TYPE_lng ||
+	     ATOMbasetype(l->ttype) == TYPE_oid) &&
+	    /* the partitioned copies of the inputs and the hash
+	     * chains and result offsets must fit */
+	    (lcount + rcount) * 5 * sizeof(lng) < GDK_mem_maxsize) {
+		/* inner side is large and there is no hash table
+		 * to reuse: partition instead of building one big
+		 * hash table */
+		if (swap)
+			return radixjoin(r2, r1, r, l, sr, sl, t0, true, reason);
+		return radixjoin(r1, r2, l, r, sl, sr, t0, false, reason);
+	}
 	if (swap) {
 		return hashjoin(r2, r1, r, l, sr, sl, nil_matches, false, false, false, maxsize, t0, true, reason);
 	} else {
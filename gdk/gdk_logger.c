@@ -248,16 +248,18 @@ log_read_clear(logger *lg, trans *tr, char *name)
 	return LOG_OK;
 }
 
+/* tid is the highest transaction id seen when the change was
+ * committed */
 static int
-avoid_snapshot(logger *lg, log_bid bid)
+avoid_snapshot(logger *lg, log_bid bid, int tid)
 {
 	if (BATcount(lg->snapshots_bid)-BATcount(lg->dsnapshots)) {
 		BUN p = log_find(lg->snapshots_bid, lg->dsnapshots, bid);
 
 		if (p != BUN_NONE) {
-			int tid = *(int *) Tloc(lg->snapshots_tid, p);
+			int stid = *(int *) Tloc(lg->snapshots_tid, p);
 
-			if (lg->tid <= tid)
+			if (tid <= stid)
 				return 1;
 		}
 	}
@@ -274,7 +276,7 @@ la_bat_clear(logger *lg, logaction *la)
 		fprintf(stderr, "#la_bat_clear %s\n", la->name);
 
 	/* do we need to skip these old updates */
-	if (avoid_snapshot(lg, bid))
+	if (avoid_snapshot(lg, bid, lg->tid))
 		return GDK_SUCCEED;
 
 	b = BATdescriptor(bid);
@@ -508,27 +510,13 @@ log_read_updates(logger *lg, trans *tr, logformat *l, char *name)
 	return res;
 }
 
+/* apply the inserts or updates of la to b */
 static gdk_return
-la_bat_updates(logger *lg, logaction *la)
+la_bat_updates_(BAT *b, logaction *la)
 {
-	log_bid bid = logger_find_bat(lg, la->name);
-	BAT *b;
-
-	if (bid == 0)
-		return GDK_SUCCEED; /* ignore bats no longer in the catalog */
-
-	/* do we need to skip these old updates */
-	if (avoid_snapshot(lg, bid))
-		return GDK_SUCCEED;
-
-	b = BATdescriptor(bid);
-	if (b == NULL)
-		return GDK_FAIL;
 	if (la->type == LOG_INSERT) {
-		if (BATappend(b, la->b, NULL, TRUE) != GDK_SUCCEED) {
-			logbat_destroy(b);
+		if (BATappend(b, la->b, NULL, TRUE) != GDK_SUCCEED)
 			return GDK_FAIL;
-		}
 	} else if (la->type == LOG_UPDATE) {
 		BATiter vi = bat_iterator(la->b);
 		BATiter ii = bat_iterator(la->uid);
@@ -548,28 +536,43 @@ la_bat_updates(logger *lg, logaction *la)
 					const void *tv = ATOMnilptr(b->ttype);
 
 					while (b->hseqbase + b->batCount < h) {
-						if (BUNappend(b, tv, TRUE) != GDK_SUCCEED) {
-							logbat_destroy(b);
+						if (BUNappend(b, tv, TRUE) != GDK_SUCCEED)
 							return GDK_FAIL;
-						}
 					}
 				}
-				if (BUNappend(b, t, TRUE) != GDK_SUCCEED) {
-					logbat_destroy(b);
+				if (BUNappend(b, t, TRUE) != GDK_SUCCEED)
 					return GDK_FAIL;
-				}
 			} else {
-				if (BUNreplace(b, h, t, TRUE) != GDK_SUCCEED) {
-					logbat_destroy(b);
+				if (BUNreplace(b, h, t, TRUE) != GDK_SUCCEED)
 					return GDK_FAIL;
-				}
 			}
 		}
 	}
-	logbat_destroy(b);
 	return GDK_SUCCEED;
 }
 
+static gdk_return
+la_bat_updates(logger *lg, logaction *la)
+{
+	log_bid bid = logger_find_bat(lg, la->name);
+	BAT *b;
+	gdk_return ret;
+
+	if (bid == 0)
+		return GDK_SUCCEED; /* ignore bats no longer in the catalog */
+
+	/* do we need to skip these old updates */
+	if (avoid_snapshot(lg, bid, lg->tid))
+		return GDK_SUCCEED;
+
+	b = BATdescriptor(bid);
+	if (b == NULL)
+		return GDK_FAIL;
+	ret = la_bat_updates_(b, la);
+	logbat_destroy(b);
+	return ret;
+}
+
 static log_return
 log_read_destroy(logger *lg, trans *tr, char *name)
 {
@@ -858,8 +861,195 @@ tr_abort(logger *lg, trans *tr)
 	return tr_destroy(tr);
 }
 
+/*
+ * Replay
+ * The inserts and updates of committed transactions are not applied
+ * right away, but queued, so that they can be applied in parallel: all
+ * changes to one BAT are applied by one thread in commit order, and
+ * different BATs are done by different threads.  Other changes (create,
+ * use, destroy, clear) modify the logger catalog; the queue is applied
+ * before those, so they are applied in log order.  A failure to apply
+ * any change fails the complete replay, as before.
+ */
+/* apply the queue when it holds this many values */
+#define REPLAY_BATCH	((BUN) 1 << 20)
+/* or this many changes */
+#define REPLAY_CHANGES	4096
+
+typedef struct replay {
+	logaction *changes;	/* queued inserts and updates */
+	int *tids;		/* lg->tid at commit of each change */
+	lng *order;		/* target bid << 32 | change, sorted */
+	int nr, sz;
+	BUN cnt;		/* number of values queued */
+	lng ntrans;		/* number of transactions replayed */
+} replay;
+
+#define ORDER_BID(o)	((log_bid) ((o) >> 32))
+#define ORDER_CHANGE(o)	((int) ((o) & 0xFFFFFFFF))
+
+struct replayarg {
+	replay *rp;
+	int n;			/* number of entries in rp->order */
+	MT_Lock *lock;
+	int *next;		/* next entry in rp->order to do */
+	gdk_return res;
+};
+
+/* apply the changes to the BATs, one BAT at a time */
+static void
+replay_worker(void *arg)
+{
+	struct replayarg *ra = arg;
+	replay *rp = ra->rp;
+
+	for (;;) {
+		int i, j;
+		log_bid bid = 0;
+		BAT *b;
+
+		MT_lock_set(ra->lock);
+		i = j = *ra->next;
+		if (i < ra->n) {
+			bid = ORDER_BID(rp->order[i]);
+			while (j < ra->n && ORDER_BID(rp->order[j]) == bid)
+				j++;
+			*ra->next = j;
+		}
+		MT_lock_unset(ra->lock);
+		if (i == j)
+			break;
+		if ((b = BATdescriptor(bid)) == NULL) {
+			ra->res = GDK_FAIL;
+			continue;
+		}
+		for (; i < j && ra->res == GDK_SUCCEED; i++)
+			ra->res = la_bat_updates_(b, &rp->changes[ORDER_CHANGE(rp->order[i])]);
+		logbat_destroy(b);
+	}
+}
+
+static gdk_return
+replay_flush(logger *lg, replay *rp)
+{
+	struct replayarg *args;
+	MT_Id *tids;
+	MT_Lock lock;
+	int i, n, nbats, nthreads, next = 0;
+	gdk_return res = GDK_SUCCEED;
+
+	if (rp->nr == 0)
+		return GDK_SUCCEED;
+	if (lg->debug & 1)
+		fprintf(stderr, "#replay_flush %d changes\n", rp->nr);
+
+	/* find the targets, skipping those we don't need */
+	for (i = 0, n = 0; i < rp->nr; i++) {
+		log_bid bid = logger_find_bat(lg, rp->changes[i].name);
+
+		/* ignore bats no longer in the catalog */
+		if (bid != 0 && !avoid_snapshot(lg, bid, rp->tids[i]))
+			rp->order[n++] = (lng) bid << 32 | i;
+	}
+	/* sorting on bid and then position keeps the commit order
+	 * per BAT */
+	GDKqsort(rp->order, NULL, NULL, (size_t) n, sizeof(lng), 0, TYPE_lng);
+	for (i = 0, nbats = 0; i < n; i++)
+		if (i == 0 || ORDER_BID(rp->order[i]) != ORDER_BID(rp->order[i - 1]))
+			nbats++;
+
+	nthreads = GDKnr_threads > 1 ? GDKnr_threads : 1;
+	if (nthreads > nbats)
+		nthreads = nbats;
+	if (nthreads > 0) {
+		args = GDKmalloc(nthreads * sizeof(struct replayarg));
+		tids = GDKzalloc(nthreads * sizeof(MT_Id));
+		if (args == NULL || tids == NULL) {
+			GDKfree(args);
+			GDKfree(tids);
+			return GDK_FAIL;
+		}
+		MT_lock_init(&lock, "replay_flush");
+		for (i = 0; i < nthreads; i++) {
+			args[i] = (struct replayarg) {
+				.rp = rp,
+				.n = n,
+				.lock = &lock,
+				.next = &next,
+				.res = GDK_SUCCEED,
+			};
+			if (i > 0 &&
+			    MT_create_thread(&tids[i], replay_worker, &args[i],
+					     MT_THR_JOINABLE) < 0)
+				tids[i] = 0;
+		}
+		/* if threads could not be started, this one does
+		 * all the work */
+		replay_worker(&args[0]);
+		for (i = 0; i < nthreads; i++) {
+			if (i > 0 && tids[i])
+				MT_join_thread(tids[i]);
+			if (args[i].res != GDK_SUCCEED)
+				res = GDK_FAIL;
+		}
+		MT_lock_destroy(&lock);
+		GDKfree(args);
+		GDKfree(tids);
+	}
+
+	for (i = 0; i < rp->nr; i++) {
+		la_destroy(&rp->changes[i]);
+		lg->changes += (res == GDK_SUCCEED);
+	}
+	rp->nr = 0;
+	rp->cnt = 0;
+	return res;
+}
+
+static gdk_return
+replay_add(logger *lg, replay *rp, logaction *la)
+{
+	if (rp->nr == rp->sz) {
+		int sz = rp->sz ? rp->sz * 2 : REPLAY_CHANGES;
+		logaction *changes;
+		int *tids;
+		lng *order;
+
+		if ((changes = GDKrealloc(rp->changes, sz * sizeof(logaction))) == NULL)
+			return GDK_FAIL;
+		rp->changes = changes;
+		if ((tids = GDKrealloc(rp->tids, sz * sizeof(int))) == NULL)
+			return GDK_FAIL;
+		rp->tids = tids;
+		if ((order = GDKrealloc(rp->order, sz * sizeof(lng))) == NULL)
+			return GDK_FAIL;
+		rp->order = order;
+		rp->sz = sz;
+	}
+	rp->changes[rp->nr] = *la;
+	rp->tids[rp->nr] = lg->tid;
+	rp->nr++;
+	rp->cnt += BATcount(la->b);
+	/* the queue owns it now */
+	la->name = NULL;
+	la->b = NULL;
+	return GDK_SUCCEED;
+}
+
+static void
+replay_destroy(replay *rp)
+{
+	int i;
+
+	for (i = 0; i < rp->nr; i++)
+		la_destroy(&rp->changes[i]);
+	GDKfree(rp->changes);
+	GDKfree(rp->tids);
+	GDKfree(rp->order);
+}
+
 static trans *
-tr_commit(logger *lg, trans *tr)
+tr_commit(logger *lg, trans *tr, replay *rp)
 {
 	int i;
 
@@ -867,13 +1057,33 @@ tr_commit(logger *lg, trans *tr)
 		fprintf(stderr, "#tr_commit\n");
 
 	for (i = 0; i < tr->nr; i++) {
-		if (la_apply(lg, &tr->changes[i]) != GDK_SUCCEED) {
+		logaction *la = &tr->changes[i];
+		gdk_return res;
+
+		if (la->type == LOG_INSERT || la->type == LOG_UPDATE) {
+			res = replay_add(lg, rp, la);
+		} else {
+			/* keep the order with respect to the
+			 * catalog changes */
+			res = replay_flush(lg, rp);
+			if (res == GDK_SUCCEED)
+				res = la_apply(lg, la);
+		}
+		if (res != GDK_SUCCEED) {
 			do {
 				tr = tr_abort(lg, tr);
 			} while (tr != NULL);
 			return (trans *) -1;
 		}
-		la_destroy(&tr->changes[i]);
+		la_destroy(la);
+	}
+	rp->ntrans++;
+	if ((rp->cnt >= REPLAY_BATCH || rp->nr >= REPLAY_CHANGES) &&
+	    replay_flush(lg, rp) != GDK_SUCCEED) {
+		do {
+			tr = tr_abort(lg, tr);
+		} while (tr != NULL);
+		return (trans *) -1;
 	}
 	return tr_destroy(tr);
 }
@@ -977,8 +1187,19 @@ logger_open(logger *lg)
 static void
 logger_close(logger *lg)
 {
+	/* sync outstanding group commits, and make sure no log_sync
+	 * is using the stream while we close it */
+	MT_lock_set(&lg->flush_lock);
+	MT_lock_set(&lg->lock);
+	if (lg->synced < lg->written) {
+		if (!(GDKdebug & NOSYNCMASK) && mnstr_fsync(lg->log))
+			fprintf(stderr, "!ERROR: logger_close: sync failed\n");
+		lg->synced = lg->written;
+	}
+	MT_lock_unset(&lg->lock);
 	close_stream(lg->log);
 	lg->log = NULL;
+	MT_lock_unset(&lg->flush_lock);
 }
 
 static gdk_return
@@ -990,7 +1211,8 @@ logger_readlog(logger *lg, char *filename)
 	time_t t0, t1;
 	struct stat sb;
 	int dbg = GDKdebug;
-	int fd;
+	int fd, progress = 0;
+	replay rp = {0};
 
 	GDKdebug &= ~(CHECKMASK|PROPMASK);
 
@@ -1031,8 +1253,9 @@ logger_readlog(logger *lg, char *filename)
 			/* not more than once every 10 seconds */
 			fpos = (lng) getfilepos(getFile(lg->log));
 			if (fpos >= 0) {
-				printf("# still reading write-ahead log \"%s\" (%d%% done)\n", filename, (int) ((fpos * 100 + 50) / sb.st_size));
+				printf("# still reading write-ahead log \"%s\" (%d%% done, " LLFMT " transactions replayed)\n", filename, (int) ((fpos * 100 + 50) / sb.st_size), rp.ntrans);
 				fflush(stdout);
+				progress = 1;
 			}
 		}
 		if (l.flag != LOG_START && l.flag != LOG_END && l.flag != LOG_SEQ) {
@@ -1088,7 +1311,7 @@ logger_readlog(logger *lg, char *filename)
 			else if (l.tid != l.nr)	/* abort record */
 				tr = tr_abort(lg, tr);
 			else
-				tr = tr_commit(lg, tr);
+				tr = tr_commit(lg, tr, &rp);
 			break;
 		case LOG_SEQ:
 			err = log_read_seq(lg, &l);
@@ -1137,10 +1360,18 @@ logger_readlog(logger *lg, char *filename)
 	}
 	logger_close(lg);
 
+	/* apply what is left of the committed transactions */
+	if (err != LOG_ERR && replay_flush(lg, &rp) != GDK_SUCCEED)
+		err = LOG_ERR;
+	replay_destroy(&rp);
 	/* remaining transactions are not committed, ie abort */
 	while (tr)
 		tr = tr_abort(lg, tr);
 	t0 = time(NULL);
+	if (progress) {
+		printf("# finished reading write-ahead log \"%s\" (" LLFMT " transactions replayed)\n", filename, rp.ntrans);
+		fflush(stdout);
+	}
 	if (lg->debug & 1) {
 		printf("# Finished reading the write-ahead log '%s'\n", filename);
 		fflush(stdout);
@@ -2083,6 +2314,12 @@ logger_new(int debug, const char *fn, const char *logdir, int version, preversio
 	lg->postfuncp = postfuncp;
 	lg->log = NULL;
 	lg->end = 0;
+	MT_lock_init(&lg->lock, "logger_lock");
+	MT_lock_init(&lg->flush_lock, "logger_flush_lock");
+	lg->written = 0;
+	lg->synced = 0;
+	lg->commit_delay = GDKgetenv_int("gdk_commit_delay", 0);
+	lg->relaxed = GDKgetenv_isyes("gdk_relaxed_durability");
 	lg->catalog_bid = NULL;
 	lg->catalog_nme = NULL;
 	lg->dcatalog = NULL;
@@ -2191,6 +2428,8 @@ logger_destroy(logger *lg)
 	GDKfree(lg->fn);
 	GDKfree(lg->dir);
 	logger_close(lg);
+	MT_lock_destroy(&lg->lock);
+	MT_lock_destroy(&lg->flush_lock);
 	GDKfree(lg);
 }
 
@@ -2736,14 +2975,17 @@ pre_allocate(logger *lg)
 	return GDK_SUCCEED;
 }
 
+/* Write the end of the transaction to the log, without syncing it.
+ * The sequence number of the transaction, to be passed to log_sync, is
+ * returned in *lsn. */
 gdk_return
-log_tend(logger *lg)
+log_tend_group(logger *lg, lng *lsn)
 {
 	logformat l;
 	gdk_return res = GDK_SUCCEED;
 
 	if (lg->debug & 1)
-		fprintf(stderr, "#log_tend %d\n", lg->tid);
+		fprintf(stderr, "#log_tend_group %d\n", lg->tid);
 
 	if (DELTAdirty(lg->snapshots_bid)) {
 		/* sub commit all new snapshots */
@@ -2778,11 +3020,90 @@ log_tend(logger *lg)
 	if (res != GDK_SUCCEED ||
 	    log_write_format(lg, &l) != GDK_SUCCEED ||
 	    mnstr_flush(lg->log) ||
-	    (!(GDKdebug & NOSYNCMASK) && mnstr_fsync(lg->log)) ||
 	    pre_allocate(lg) != GDK_SUCCEED) {
 		fprintf(stderr, "!ERROR: log_tend: write failed\n");
 		return GDK_FAIL;
 	}
+	MT_lock_set(&lg->lock);
+	*lsn = ++lg->written;
+	MT_lock_unset(&lg->lock);
+	return GDK_SUCCEED;
+}
+
+/* Sync the log up to at least transaction lsn.  Only one thread syncs
+ * at a time, transactions that end while it does are covered by the
+ * next sync, which is done by the first of them to get the
+ * flush_lock.  The others find their transaction synced when they get
+ * the lock in turn. */
+static gdk_return
+log_sync_(logger *lg, lng lsn, int delay)
+{
+	gdk_return res = GDK_SUCCEED;
+	lng target;
+
+	MT_lock_set(&lg->lock);
+	target = lg->synced;
+	MT_lock_unset(&lg->lock);
+	if (target >= lsn)
+		return GDK_SUCCEED;
+
+	MT_lock_set(&lg->flush_lock);
+	MT_lock_set(&lg->lock);
+	target = lg->synced;
+	MT_lock_unset(&lg->lock);
+	if (target < lsn) {
+		/* give concurrent transactions the chance to join */
+		if (delay > 0)
+			MT_sleep_ms(delay);
+		MT_lock_set(&lg->lock);
+		target = lg->written;
+		MT_lock_unset(&lg->lock);
+		/* everything up to target has been flushed to the
+		 * file by log_tend_group, so the sync covers it */
+		if (!(GDKdebug & NOSYNCMASK) && mnstr_fsync(lg->log)) {
+			fprintf(stderr, "!ERROR: log_sync: sync failed\n");
+			res = GDK_FAIL;
+		} else {
+			MT_lock_set(&lg->lock);
+			lg->synced = target;
+			MT_lock_unset(&lg->lock);
+		}
+	}
+	MT_lock_unset(&lg->flush_lock);
+	return res;
+}
+
+/* Wait until transaction lsn, as returned by log_tend_group, is on
+ * disk.  With relaxed durability this returns immediately and the log
+ * is synced by log_flush. */
+gdk_return
+log_sync(logger *lg, lng lsn)
+{
+	if (lg->relaxed)
+		return GDK_SUCCEED;
+	return log_sync_(lg, lsn, lg->commit_delay);
+}
+
+/* Sync all transactions written so far. */
+gdk_return
+log_flush(logger *lg)
+{
+	lng lsn;
+
+	MT_lock_set(&lg->lock);
+	lsn = lg->written;
+	MT_lock_unset(&lg->lock);
+	return log_sync_(lg, lsn, 0);
+}
+
+gdk_return
+log_tend(logger *lg)
+{
+	lng lsn;
+
+	if (log_tend_group(lg, &lsn) != GDK_SUCCEED ||
+	    log_sync_(lg, lsn, 0) != GDK_SUCCEED)
+		return GDK_FAIL;
 	return GDK_SUCCEED;
 }
 
@@ -2938,7 +3259,7 @@ bm_commit(logger *lg)
 
 		if (lg->debug & 1)
 			fprintf(stderr, "#bm_commit: create %d (%d)\n",
-				bid, BBP_lrefs(bid));
+				bid, (int) BBP_lrefs(bid));
 	}
 	res = bm_subcommit(lg, lg->catalog_bid, lg->catalog_nme, lg->catalog_bid, lg->catalog_nme, lg->dcatalog, n, lg->debug);
 	BBPreclaim(n);
@@ -3011,7 +3332,7 @@ logger_del_bat(logger *lg, log_bid bid)
 		if (lg->debug & 1)
 			fprintf(stderr,
 				"#logger_del_bat release snapshot %d (%d)\n",
-				bid, BBP_lrefs(bid));
+				bid, (int) BBP_lrefs(bid));
 		if (BUNappend(lg->freed, &bid, FALSE) != GDK_SUCCEED) {
 			logbat_destroy(b);
 			return GDK_FAIL;
@@ -57,6 +57,15 @@ typedef struct logger {
 	postversionfix_fptr postfuncp;
 	stream *log;
 	lng end;		/* end of pre-allocated blocks for faster f(data)sync */
+	/* group commit: transactions ended with log_tend_group are
+	 * numbered; log_sync waits until a single f(data)sync covers
+	 * them */
+	MT_Lock lock;		/* protects written and synced */
+	MT_Lock flush_lock;	/* held while syncing the log */
+	lng written;		/* last transaction written to the log */
+	lng synced;		/* last transaction synced to disk */
+	int commit_delay;	/* ms to wait for more commits before a sync */
+	int relaxed;		/* don't wait for the sync on commit */
 	/* Store log_bids (int) to circumvent trouble with reference counting */
 	BAT *catalog_bid;	/* int bid column */
 	BAT *catalog_nme;	/* str name column */
@@ -127,6 +136,9 @@ gdk_export gdk_return log_delta(logger *lg, BAT *uid, BAT *uval, const char *n);
 
 gdk_export gdk_return log_tstart(logger *lg);	/* TODO return transaction id */
 gdk_export gdk_return log_tend(logger *lg);
+gdk_export gdk_return log_tend_group(logger *lg, lng *lsn);
+gdk_export gdk_return log_sync(logger *lg, lng lsn);
+gdk_export gdk_return log_flush(logger *lg);
 gdk_export gdk_return log_abort(logger *lg);
 
 gdk_export gdk_return log_sequence(logger *lg, int seq, lng id);
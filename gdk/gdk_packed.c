@@ -0,0 +1,1667 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 1997 - July 2008 CWI, August 2008 - 2018 MonetDB B.V.
+ */
+
+/*
+ * Packed columns.
+ *
+ * Persistent columns of the integer types (and types derived from
+ * them) with at least PACKED_MIN values get a compressed copy of
+ * their values, the "packed" form, which is stored next to the
+ * column.  One of three encodings is used, whichever is smallest:
+ *
+ * - frame of reference: each value is stored as its distance to the
+ *   smallest value of the column plus one (zero is nil), using as few
+ *   bits as the largest distance needs;
+ * - dictionary: the distinct values are stored in ascending order and
+ *   each value is stored as its index in that list, again using as
+ *   few bits as needed;
+ * - run length: each run of equal values is stored as the value and
+ *   the position just after the run.
+ *
+ * The codes of the first two encodings are ordered in the same way as
+ * the values they represent (nil is smallest), so a range of values
+ * is a range of codes.  If no encoding is at most half the size of
+ * the column, only a header saying so is stored, so that we don't
+ * look again until the column changes.
+ *
+ * Persistent string columns with at most PACKED_MAXDICT distinct
+ * values always get a dictionary: the offsets of the distinct strings
+ * in the string heap, sorted on the strings.  Here the codes are not
+ * (only) smaller than the column, they allow a predicate to be
+ * evaluated once per distinct string: a range of strings is a range
+ * of codes, and the strings that match a LIKE pattern are a set of
+ * codes.  Grouping also works on the codes of a dictionary.
+ *
+ * String columns with more distinct values get fingerprints instead:
+ * the low 32 bits of the hash (strHash) of each value.  An equality
+ * select only looks at the strings whose fingerprint matches, and
+ * since strHash is also the hash function of hash tables on strings,
+ * hash tables are built from the fingerprints, and joins and grouping
+ * compare fingerprints before comparing strings.
+ *
+ * Selections, projections and the sum, minimum and maximum of a
+ * column (or of a view on it, such as the slices that mitosis
+ * creates) are computed from the packed form, a block of values at a
+ * time, without touching the column itself.  All other operators
+ * continue to use the column, so the packed form is an accelerator
+ * like the zone map: it is created when the column is saved or
+ * analyzed, dropped when the column changes, and any failure to use
+ * it just means that the column is used instead.  The operators pin
+ * the packed form while they read it, so that dropping it (which can
+ * happen at any time) leaves freeing the memory to the last of them.
+ *
+ * The heap starts with PACKED_HEADER size_t values: version number
+ * and flags, the encoding, the number of values described, the
+ * number of bits per code, the number of dictionary entries or runs,
+ * and the number of nils.  Then follow the smallest and largest
+ * non-nil value (as lng), the dictionary or run values (of the width
+ * of the column, padded to a multiple of 8 bytes), the run ends (BUN)
+ * or the codes (packed in 64 bit words).
+ */
+
+#include "monetdb_config.h"
+#include "gdk.h"
+#include "gdk_private.h"
+
+#define PACKED_VERSION		((size_t) 1)
+#define PACKED_SYNCED		((size_t) 1 << 24)
+#define PACKED_HEADER		6	/* nr of size_t fields in header */
+
+#define PACKED_DATA		(PACKED_HEADER * SIZEOF_SIZE_T + 2 * sizeof(lng))
+#define PACKED_BLOCK		1024	/* values decoded at a time */
+#define PACKED_MAXDICT		((BUN) 1 << 16)
+#define PACKED_HASHBITS		17	/* hash table size for PACKED_MAXDICT */
+
+#define PHDR(hp, i)		(((size_t *) (hp)->base)[i])
+#define PMIN(hp)		(((lng *) ((hp)->base + PACKED_HEADER * SIZEOF_SIZE_T))[0])
+#define PMAX(hp)		(((lng *) ((hp)->base + PACKED_HEADER * SIZEOF_SIZE_T))[1])
+#define PALIGN(sz)		(((sz) + 7) & ~(size_t) 7)
+
+enum {
+	PACK_NONE,		/* not worth packing */
+	PACK_FOR,		/* frame of reference */
+	PACK_RLE,		/* run length */
+	PACK_DICT,		/* dictionary */
+	PACK_HASH		/* string fingerprints */
+};
+
+/* the packed form in memory; b->tpacked points to its heap */
+typedef struct {
+	Heap heap;		/* must be first */
+	int pins;		/* users, protected by GDKhashLock */
+	bool dropped;		/* not b->tpacked anymore */
+} PackedHeap;
+
+/* a description of a packed form */
+typedef struct {
+	int enc;		/* PACK_* */
+	int width;		/* width of the values */
+	int bits;		/* bits per code (FOR, DICT) */
+	BUN cnt;		/* number of values */
+	BUN n;			/* number of dictionary entries or runs */
+	BUN nils;		/* number of nils */
+	lng min, max;		/* smallest and largest non-nil value */
+	lng nil;		/* nil of the type of the column */
+	ulng mask;		/* mask for one code */
+	const void *vals;	/* dictionary or run values */
+	const char *base;	/* string heap (string columns only) */
+	const BUN *ends;	/* run ends */
+	const ulng *words;	/* codes */
+	const unsigned int *fps; /* string fingerprints */
+	PackedHeap *pin;	/* the packed form, pinned */
+} packed;
+
+/* the types we can pack */
+static bool
+packed_type(const BAT *b)
+{
+	if (ATOMtype(b->ttype) == TYPE_oid)
+		return false;
+	switch (ATOMbasetype(b->ttype)) {
+	case TYPE_bte:
+	case TYPE_sht:
+	case TYPE_int:
+	case TYPE_lng:
+		return true;
+	case TYPE_str:
+		return b->ttype == TYPE_str;
+	default:
+		return false;
+	}
+}
+
+/* width of the values in the packed form: string columns store the
+ * offsets of the strings */
+static inline int
+packed_width(const BAT *b)
+{
+	return b->tvarsized ? SIZEOF_VAR_T : b->twidth;
+}
+
+static inline lng
+packed_val(const void *vals, int width, BUN i)
+{
+	switch (width) {
+	case 1:
+		return ((const bte *) vals)[i];
+	case 2:
+		return ((const sht *) vals)[i];
+	case 4:
+		return ((const int *) vals)[i];
+	default:
+		return ((const lng *) vals)[i];
+	}
+}
+
+static inline void
+packed_store(void *vals, int width, BUN i, lng v)
+{
+	switch (width) {
+	case 1:
+		((bte *) vals)[i] = (bte) v;
+		break;
+	case 2:
+		((sht *) vals)[i] = (sht) v;
+		break;
+	case 4:
+		((int *) vals)[i] = (int) v;
+		break;
+	default:
+		((lng *) vals)[i] = v;
+		break;
+	}
+}
+
+static inline lng
+packed_nil(int width)
+{
+	switch (width) {
+	case 1:
+		return bte_nil;
+	case 2:
+		return sht_nil;
+	case 4:
+		return int_nil;
+	default:
+		return lng_nil;
+	}
+}
+
+static inline int
+packed_bits(ulng v)
+{
+	int n = 0;
+
+	while (v) {
+		n++;
+		v >>= 1;
+	}
+	return n;
+}
+
+/* number of 64 bit words for cnt codes of the given size, plus one
+ * so that a code can always be read as two words */
+static inline size_t
+packed_words(size_t cnt, size_t bits)
+{
+	return (cnt * bits + 63) / 64 + 1;
+}
+
+static size_t
+packed_size(int width, size_t enc, size_t cnt, size_t bits, size_t n)
+{
+	switch (enc) {
+	case PACK_FOR:
+		return PACKED_DATA + packed_words(cnt, bits) * sizeof(ulng);
+	case PACK_DICT:
+		return PACKED_DATA + PALIGN(n * width) +
+			packed_words(cnt, bits) * sizeof(ulng);
+	case PACK_RLE:
+		return PACKED_DATA + PALIGN(n * width) + n * SIZEOF_BUN;
+	case PACK_HASH:
+		return PACKED_DATA + PALIGN(cnt * sizeof(unsigned int));
+	default:
+		return PACKED_DATA;
+	}
+}
+
+static inline void
+packed_put(ulng *restrict words, int bits, BUN i, ulng c)
+{
+	ulng bit = (ulng) i * bits;
+	size_t w = (size_t) (bit >> 6);
+	int off = (int) (bit & 63);
+
+	words[w] |= c << off;
+	if (off + bits > 64)
+		words[w + 1] |= c >> (64 - off);
+}
+
+static inline ulng
+packed_get(const ulng *restrict words, int bits, ulng mask, BUN i)
+{
+	ulng bit = (ulng) i * bits;
+	const ulng *w = words + (bit >> 6);
+	int off = (int) (bit & 63);
+
+	/* the second shift is split so that it is at most 63 */
+	return ((w[0] >> off) | ((w[1] << 1) << (63 - off))) & mask;
+}
+
+/* decode the n codes starting at position i */
+static void
+packed_decode(const packed *p, BUN i, BUN n, unsigned int *restrict dst)
+{
+	const ulng *restrict words = p->words;
+	const int bits = p->bits;
+	const ulng mask = p->mask;
+	BUN j;
+
+	for (j = 0; j < n; j++)
+		dst[j] = (unsigned int) packed_get(words, bits, mask, i + j);
+}
+
+/* index of the run that contains position i */
+static BUN
+packed_run(const packed *p, BUN i)
+{
+	BUN lo = 0, hi = p->n;
+
+	while (lo < hi) {
+		BUN m = lo + (hi - lo) / 2;
+		if (p->ends[m] <= i)
+			lo = m + 1;
+		else
+			hi = m;
+	}
+	return lo;
+}
+
+static void
+packed_describe(const BAT *b, const Heap *hp, packed *p)
+{
+	const char *data = hp->base + PACKED_DATA;
+
+	p->enc = (int) PHDR(hp, 1);
+	p->cnt = (BUN) PHDR(hp, 2);
+	p->bits = (int) PHDR(hp, 3);
+	p->n = (BUN) PHDR(hp, 4);
+	p->nils = (BUN) PHDR(hp, 5);
+	p->min = PMIN(hp);
+	p->max = PMAX(hp);
+	p->width = packed_width(b);
+	p->nil = packed_nil(p->width);
+	p->mask = p->bits == 64 ? ~(ulng) 0 : ((ulng) 1 << p->bits) - 1;
+	p->vals = data;
+	p->base = b->tvarsized ? b->tvheap->base : NULL;
+	p->ends = NULL;
+	p->words = (const ulng *) data;
+	p->fps = (const unsigned int *) data;
+	if (p->enc == PACK_DICT)
+		p->words = (const ulng *) (data + PALIGN(p->n * p->width));
+	else if (p->enc == PACK_RLE)
+		p->ends = (const BUN *) (data + PALIGN(p->n * p->width));
+}
+
+/* collect the distinct values of b in a (sorted) dictionary; returns
+ * the number of entries, or BUN_NONE if there are more than
+ * PACKED_MAXDICT or we ran out of memory */
+static BUN
+packed_dict(BAT *b, lng **dictp)
+{
+	const size_t hsize = (size_t) 1 << PACKED_HASHBITS;
+	const void *src = Tloc(b, 0);
+	BUN cnt = BATcount(b), i, n = 0;
+	lng *keys, *dict;
+	bte *used;
+
+	*dictp = NULL;
+	keys = GDKmalloc(hsize * sizeof(lng));
+	used = GDKzalloc(hsize);
+	dict = GDKmalloc(PACKED_MAXDICT * sizeof(lng));
+	if (keys == NULL || used == NULL || dict == NULL) {
+		GDKfree(keys);
+		GDKfree(used);
+		GDKfree(dict);
+		return BUN_NONE;
+	}
+	for (i = 0; i < cnt; i++) {
+		lng v = packed_val(src, b->twidth, i);
+		size_t h = (size_t) (((ulng) v * 0x9E3779B97F4A7C15ULL) >> (64 - PACKED_HASHBITS));
+
+		while (used[h] && keys[h] != v)
+			h = (h + 1) & (hsize - 1);
+		if (!used[h]) {
+			if (n == PACKED_MAXDICT) {
+				n = BUN_NONE;
+				break;
+			}
+			used[h] = 1;
+			keys[h] = v;
+			dict[n++] = v;
+		}
+	}
+	GDKfree(keys);
+	GDKfree(used);
+	if (n == BUN_NONE) {
+		GDKfree(dict);
+		return BUN_NONE;
+	}
+	/* the nil of the column type is also the smallest lng value
+	 * of that type, so nil ends up in front */
+	GDKqsort(dict, NULL, NULL, (size_t) n, sizeof(lng), 0, TYPE_lng);
+	*dictp = dict;
+	return n;
+}
+
+static BUN
+packed_code(const lng *dict, BUN n, lng v)
+{
+	BUN lo = 0, hi = n;
+
+	while (lo < hi) {
+		BUN m = lo + (hi - lo) / 2;
+		if (dict[m] < v)
+			lo = m + 1;
+		else
+			hi = m;
+	}
+	assert(lo < n && dict[lo] == v);
+	return lo;
+}
+
+/* hash slot of string v: either the slot of the entry that holds it,
+ * or the empty slot where it should go */
+static inline size_t
+packed_strslot(const BUN *slots, const var_t *dict, const char *base, const char *v)
+{
+	const size_t mask = ((size_t) 1 << PACKED_HASHBITS) - 1;
+	size_t h = (size_t) strHash(v) & mask;
+
+	while (slots[h] && strcmp(base + dict[slots[h] - 1], v) != 0)
+		h = (h + 1) & mask;
+	return h;
+}
+
+/* create the packed form of the string column b in hp: a dictionary
+ * with the offsets of the distinct strings, sorted on the strings, or
+ * the fingerprints of the strings if there are too many */
+static gdk_return
+packed_create_str(BAT *b, Heap *hp)
+{
+	const char *base = b->tvheap->base;
+	const void *src = Tloc(b, 0);
+	BUN cnt = BATcount(b), i, n = 0, nils = 0, c = 0;
+	BUN *slots, *codes = NULL;	/* hash slot -> entry + 1; entry -> code */
+	var_t *dict, *sorted = NULL, o, prev = 0;
+	int bits = 0, enc = PACK_DICT;
+	size_t sz;
+	unsigned int fp = 0;
+
+	slots = GDKzalloc(((size_t) 1 << PACKED_HASHBITS) * sizeof(BUN));
+	dict = GDKmalloc(PACKED_MAXDICT * sizeof(var_t));
+	if (slots == NULL || dict == NULL)
+		goto bailout;
+	for (i = 0; i < cnt; i++) {
+		size_t h;
+
+		o = VarHeapVal(src, i, b->twidth);
+		if (GDK_STRNIL(base + o))
+			nils++;
+		if (i > 0 && o == prev)
+			continue;
+		prev = o;
+		h = packed_strslot(slots, dict, base, base + o);
+		if (slots[h] == 0) {
+			if (n == PACKED_MAXDICT) {
+				enc = PACK_HASH;
+				break;
+			}
+			dict[n++] = o;
+			slots[h] = n;
+		}
+	}
+	if (enc == PACK_DICT) {
+		/* the codes are the positions in the sorted
+		 * dictionary; nil sorts first */
+		sorted = GDKmalloc(n * sizeof(var_t));
+		codes = GDKmalloc(n * sizeof(BUN));
+		if (sorted == NULL || codes == NULL)
+			goto bailout;
+		memcpy(sorted, dict, n * sizeof(var_t));
+		GDKqsort(sorted, NULL, base, (size_t) n, SIZEOF_VAR_T, 0, TYPE_str);
+		for (i = 0; i < n; i++)
+			codes[slots[packed_strslot(slots, dict, base, base + sorted[i])] - 1] = i;
+		bits = packed_bits((ulng) n - 1);
+	}
+	sz = packed_size(SIZEOF_VAR_T, enc, cnt, bits, n);
+	if (HEAPextend(hp, sz, 0) != GDK_SUCCEED)
+		goto bailout;
+	memset(hp->base, 0, sz);
+	PHDR(hp, 0) = PACKED_VERSION;
+	PHDR(hp, 1) = (size_t) enc;
+	PHDR(hp, 2) = (size_t) cnt;
+	if (enc == PACK_DICT) {
+		char *data = hp->base + PACKED_DATA;
+		ulng *restrict words = (ulng *) (data + PALIGN(n * SIZEOF_VAR_T));
+
+		PHDR(hp, 3) = (size_t) bits;
+		PHDR(hp, 4) = (size_t) n;
+		PHDR(hp, 5) = (size_t) nils;
+		memcpy(data, sorted, n * sizeof(var_t));
+		for (i = 0; bits > 0 && i < cnt; i++) {
+			o = VarHeapVal(src, i, b->twidth);
+			if (i == 0 || o != prev)
+				c = codes[slots[packed_strslot(slots, dict, base, base + o)] - 1];
+			prev = o;
+			packed_put(words, bits, i, (ulng) c);
+		}
+	} else {
+		unsigned int *restrict fps = (unsigned int *) (hp->base + PACKED_DATA);
+
+		for (i = 0, nils = 0; i < cnt; i++) {
+			o = VarHeapVal(src, i, b->twidth);
+			if (i == 0 || o != prev)
+				fp = (unsigned int) strHash(base + o);
+			prev = o;
+			fps[i] = fp;
+			nils += GDK_STRNIL(base + o);
+		}
+		PHDR(hp, 5) = (size_t) nils;
+	}
+	GDKfree(slots);
+	GDKfree(dict);
+	GDKfree(sorted);
+	GDKfree(codes);
+	hp->free = sz;
+	hp->dirty = 1;
+	return GDK_SUCCEED;
+
+  bailout:
+	GDKfree(slots);
+	GDKfree(dict);
+	GDKfree(sorted);
+	GDKfree(codes);
+	return GDK_FAIL;
+}
+
+/* create the packed form of b in hp, which has been zeroed */
+static gdk_return
+packed_create(BAT *b, Heap *hp)
+{
+	const void *src = Tloc(b, 0);
+	const int width = b->twidth;
+	const lng nil = packed_nil(width);
+	BUN cnt = BATcount(b), i, nils = 0, nruns = 0, ndict;
+	lng mn = 0, mx = 0, prev = 0;
+	lng *dict = NULL;
+	size_t forsz = 0, dictsz = 0, rlesz, best;
+	int forbits = -1, dictbits = 0, enc;
+	char *data;
+
+	if (b->tvarsized)
+		return packed_create_str(b, hp);
+	for (i = 0; i < cnt; i++) {
+		lng v = packed_val(src, width, i);
+
+		if (i == 0 || v != prev)
+			nruns++;
+		prev = v;
+		if (v == nil)
+			nils++;
+		else if (nils == i) {
+			/* first non-nil */
+			mn = mx = v;
+		} else if (v < mn)
+			mn = v;
+		else if (v > mx)
+			mx = v;
+	}
+	if (nils < cnt && (ulng) mx - (ulng) mn < ((ulng) 1 << 32) - 1)
+		forbits = packed_bits((ulng) mx - (ulng) mn + 1);
+	else if (nils == cnt)
+		forbits = 0;
+	if (forbits >= 0)
+		forsz = packed_size(width, PACK_FOR, cnt, forbits, 0);
+	rlesz = packed_size(width, PACK_RLE, cnt, 0, nruns);
+	ndict = packed_dict(b, &dict);
+	if (ndict != BUN_NONE) {
+		dictbits = packed_bits((ulng) ndict - 1);
+		dictsz = packed_size(width, PACK_DICT, cnt, dictbits, ndict);
+	}
+	GDKclrerr();		/* no dictionary is not an error */
+
+	enc = PACK_RLE;
+	best = rlesz;
+	if (forbits >= 0 && forsz <= best) {
+		enc = PACK_FOR;
+		best = forsz;
+	}
+	if (dict && dictsz < best) {
+		enc = PACK_DICT;
+		best = dictsz;
+	}
+	if (best > (size_t) cnt * width / 2) {
+		enc = PACK_NONE;
+		best = packed_size(width, PACK_NONE, cnt, 0, 0);
+	}
+
+	if (HEAPextend(hp, best, 0) != GDK_SUCCEED) {
+		GDKfree(dict);
+		return GDK_FAIL;
+	}
+	memset(hp->base, 0, best);
+	PHDR(hp, 0) = PACKED_VERSION;
+	PHDR(hp, 1) = (size_t) enc;
+	PHDR(hp, 2) = (size_t) cnt;
+	PHDR(hp, 5) = (size_t) nils;
+	PMIN(hp) = nils == cnt ? nil : mn;
+	PMAX(hp) = nils == cnt ? nil : mx;
+	data = hp->base + PACKED_DATA;
+
+	switch (enc) {
+	case PACK_FOR: {
+		ulng *restrict words = (ulng *) data;
+
+		PHDR(hp, 3) = (size_t) forbits;
+		if (forbits > 0) {
+			for (i = 0; i < cnt; i++) {
+				lng v = packed_val(src, width, i);
+				packed_put(words, forbits, i,
+					   v == nil ? 0 : (ulng) v - (ulng) mn + 1);
+			}
+		}
+		break;
+	}
+	case PACK_DICT: {
+		ulng *restrict words = (ulng *) (data + PALIGN(ndict * width));
+
+		PHDR(hp, 3) = (size_t) dictbits;
+		PHDR(hp, 4) = (size_t) ndict;
+		for (i = 0; i < ndict; i++)
+			packed_store(data, width, i, dict[i]);
+		if (dictbits > 0) {
+			for (i = 0; i < cnt; i++) {
+				lng v = packed_val(src, width, i);
+				packed_put(words, dictbits, i,
+					   (ulng) packed_code(dict, ndict, v));
+			}
+		}
+		break;
+	}
+	case PACK_RLE: {
+		BUN *restrict ends = (BUN *) (data + PALIGN(nruns * width));
+		BUN r = 0;
+
+		PHDR(hp, 4) = (size_t) nruns;
+		for (i = 0; i < cnt; i++) {
+			lng v = packed_val(src, width, i);
+
+			if (i == 0 || v != prev) {
+				if (i > 0)
+					ends[r++] = i;
+				packed_store(data, width, r, v);
+			}
+			prev = v;
+		}
+		ends[r++] = cnt;
+		assert(r == nruns);
+		break;
+	}
+	default:
+		break;
+	}
+	GDKfree(dict);
+	hp->free = best;
+	hp->dirty = 1;
+	return GDK_SUCCEED;
+}
+
+/* write the packed form to disk and mark it as usable there; must be
+ * called with the lock held */
+static void
+packed_persist(BAT *b, Heap *hp)
+{
+	lng t0 = 0;
+
+	ALGODEBUG t0 = GDKusec();
+	if (HEAPsaveaux(hp, b, "tpacked", PACKED_SYNCED) != GDK_SUCCEED) {
+		GDKclrerr();	/* not persisting is not an error */
+		return;
+	}
+	ALGODEBUG fprintf(stderr, "#BATpacked: persisting packed form %d (" LLFMT " usec)\n", b->batCacheid, GDKusec() - t0);
+}
+
+/* the size of the persisted packed form with header hdr if it
+ * describes the cnt values of b, or 0 */
+static size_t
+packed_check(const BAT *b, BUN cnt, const size_t *hdr)
+{
+	if (hdr[0] != (PACKED_SYNCED | PACKED_VERSION) ||
+	    hdr[1] > PACK_HASH ||
+	    hdr[2] != (size_t) cnt ||
+	    hdr[3] > 32)
+		return 0;
+	return packed_size(packed_width(b), hdr[1], hdr[2], hdr[3], hdr[4]);
+}
+
+/* a new, empty packed form for b */
+static Heap *
+packed_new(BAT *b)
+{
+	PackedHeap *ph;
+
+	if ((ph = GDKzalloc(sizeof(PackedHeap))) == NULL)
+		return NULL;
+	if ((ph->heap.farmid = BBPselectfarm(b->batRole, b->ttype, packedheap)) < 0) {
+		GDKfree(ph);
+		return NULL;
+	}
+	ph->heap.parentid = b->batCacheid;
+	return &ph->heap;
+}
+
+/* Load the persisted packed form of b if it describes its current
+ * values; must be called with the lock held and b->tpacked ==
+ * (Heap *) 1. */
+static void
+packed_load(BAT *b)
+{
+	Heap *hp;
+
+	b->tpacked = NULL;
+	if ((hp = packed_new(b)) != NULL &&
+	    HEAPloadaux(hp, b, BATcount(b), "tpacked", PACKED_HEADER, packed_check) == GDK_SUCCEED) {
+		b->tpacked = hp;
+		ALGODEBUG fprintf(stderr, "#BATcheckpacked: reusing persisted packed form %d\n", b->batCacheid);
+		return;
+	}
+	GDKfree(hp);
+	GDKclrerr();	/* we're not currently interested in errors */
+}
+
+/* Return true if we have a packed form (possibly saying that b isn't
+ * worth packing) of b, even if we need to read it from disk. */
+static bool
+BATcheckpacked(BAT *b)
+{
+	bool ret;
+
+	assert(b->batCacheid > 0);
+	MT_lock_set(&GDKhashLock(b->batCacheid));
+	if (b->tpacked == (Heap *) 1)
+		packed_load(b);
+	ret = b->tpacked != NULL;
+	MT_lock_unset(&GDKhashLock(b->batCacheid));
+	return ret;
+}
+
+/* Create the packed form of b (or of its parent if b is a view).
+ * Columns of a type that can't be packed, or too small to be worth
+ * it, are left alone.  This is done when the column is saved or
+ * analyzed, never while a query waits. */
+gdk_return
+BATpacked(BAT *b)
+{
+	Heap *hp;
+	lng t0 = 0;
+
+	if (VIEWtparent(b))
+		b = BBPdescriptor(VIEWtparent(b));
+	if (!packed_type(b) || BATcount(b) < PACKED_MIN)
+		return GDK_SUCCEED;
+	if (BATcheckpacked(b))
+		return GDK_SUCCEED;
+	MT_lock_set(&GDKhashLock(b->batCacheid));
+	if (b->tpacked == NULL) {
+		ALGODEBUG t0 = GDKusec();
+		if ((hp = packed_new(b)) == NULL ||
+		    snprintf(hp->filename, sizeof(hp->filename), "%s.tpacked", BBP_physical(b->batCacheid)) < 0 ||
+		    HEAPalloc(hp, PACKED_DATA, 1) != GDK_SUCCEED) {
+			MT_lock_unset(&GDKhashLock(b->batCacheid));
+			GDKfree(hp);
+			return GDK_FAIL;
+		}
+		if (packed_create(b, hp) != GDK_SUCCEED) {
+			MT_lock_unset(&GDKhashLock(b->batCacheid));
+			HEAPfree(hp, 1);
+			GDKfree(hp);
+			return GDK_FAIL;
+		}
+		b->tpacked = hp;
+		ALGODEBUG fprintf(stderr, "#BATpacked(%s#" BUNFMT "): encoding %d, %zu bytes in " LLFMT " usec\n", BATgetId(b), BATcount(b), (int) PHDR(hp, 1), hp->free, GDKusec() - t0);
+		if (BBP_status(b->batCacheid) & BBPEXISTING)
+			packed_persist(b, hp);
+	}
+	MT_lock_unset(&GDKhashLock(b->batCacheid));
+	return GDK_SUCCEED;
+}
+
+/* Find the packed form that describes the values of b: that of b
+ * itself or, if b is a view, that of its parent, in which case *off
+ * is set to the position of the first value of b in it.  The packed
+ * form is pinned until packed_close is called. */
+static bool
+packed_open(BAT *b, packed *p, BUN *off)
+{
+	BAT *pb = b;
+	Heap *hp;
+
+	*off = 0;
+	if (VIEWtparent(b)) {
+		pb = BBPdescriptor(VIEWtparent(b));
+		*off = (BUN) ((Tloc(b, 0) - Tloc(pb, 0)) >> b->tshift);
+	}
+	if (BATcount(pb) < PACKED_MIN || !packed_type(pb) ||
+	    pb->ttype != b->ttype || BATcount(b) == 0)
+		return false;
+	MT_lock_set(&GDKhashLock(pb->batCacheid));
+	if (pb->tpacked == (Heap *) 1)
+		packed_load(pb);
+	hp = pb->tpacked;
+	if (hp == NULL ||
+	    PHDR(hp, 1) == PACK_NONE ||
+	    PHDR(hp, 2) != (size_t) BATcount(pb) ||
+	    *off + BATcount(b) > BATcount(pb)) {
+		MT_lock_unset(&GDKhashLock(pb->batCacheid));
+		return false;
+	}
+	packed_describe(pb, hp, p);
+	p->pin = (PackedHeap *) hp;
+	p->pin->pins++;
+	MT_lock_unset(&GDKhashLock(pb->batCacheid));
+	return true;
+}
+
+/* Unpin the packed form, and free it if it was dropped while it was
+ * pinned. */
+static void
+packed_unpin(PackedHeap *ph)
+{
+	bool drop;
+
+	MT_lock_set(&GDKhashLock(ph->heap.parentid));
+	assert(ph->pins > 0);
+	drop = --ph->pins == 0 && ph->dropped;
+	MT_lock_unset(&GDKhashLock(ph->heap.parentid));
+	if (drop) {
+		HEAPfree(&ph->heap, 0);
+		GDKfree(ph);
+	}
+}
+
+static inline void
+packed_close(packed *p)
+{
+	packed_unpin(p->pin);
+}
+
+/* smallest code whose value is at least v, and largest code whose
+ * value is at most v (both nil if v is nil); v is not nil */
+static ulng
+packed_code_ge(const packed *p, lng v)
+{
+	if (p->enc == PACK_FOR) {
+		if (p->nils == p->cnt || v > p->max)
+			return p->mask + 1;
+		if (v <= p->min)
+			return 1;
+		return (ulng) v - (ulng) p->min + 1;
+	} else {
+		BUN lo = 0, hi = p->n;
+
+		while (lo < hi) {
+			BUN m = lo + (hi - lo) / 2;
+			if (packed_val(p->vals, p->width, m) < v)
+				lo = m + 1;
+			else
+				hi = m;
+		}
+		return (ulng) lo;
+	}
+}
+
+static ulng
+packed_code_le(const packed *p, lng v)
+{
+	if (p->enc == PACK_FOR) {
+		if (p->nils == p->cnt || v < p->min)
+			return 0;
+		if (v >= p->max)
+			return (ulng) p->max - (ulng) p->min + 1;
+		return (ulng) v - (ulng) p->min + 1;
+	} else {
+		BUN lo = 0, hi = p->n;
+
+		while (lo < hi) {
+			BUN m = lo + (hi - lo) / 2;
+			if (packed_val(p->vals, p->width, m) <= v)
+				lo = m + 1;
+			else
+				hi = m;
+		}
+		/* lo is the number of entries <= v; 0 is fine since
+		 * then the range is empty (or only covers nil, but v
+		 * is larger than nil) */
+		return (ulng) lo - 1;
+	}
+}
+
+/* the code of nil, or ~0 if there is none */
+static ulng
+packed_code_nil(const packed *p)
+{
+	if (p->enc == PACK_FOR)
+		return 0;
+	return packed_val(p->vals, p->width, 0) == p->nil ? 0 : ~(ulng) 0;
+}
+
+/* the positions [*lo,*hi) of b that the (dense) candidate list s
+ * covers */
+static void
+packed_range(BAT *b, BAT *s, BUN *lo, BUN *hi)
+{
+	*lo = 0;
+	*hi = BATcount(b);
+	if (s) {
+		oid sl = s->tseqbase, sh = s->tseqbase + BATcount(s);
+
+		assert(BATtdense(s));
+		if (sl > b->hseqbase)
+			*lo = MIN(sl - b->hseqbase, *hi);
+		if (sh < b->hseqbase)
+			*hi = 0;
+		else if (sh - b->hseqbase < *hi)
+			*hi = sh - b->hseqbase;
+		if (*lo > *hi)
+			*lo = *hi;
+	}
+}
+
+static void
+packed_selected(BAT *bn, BUN cnt)
+{
+	BATsetcount(bn, cnt);
+	bn->tsorted = 1;
+	bn->trevsorted = cnt <= 1;
+	bn->tkey = 1;
+	bn->tnil = 0;
+	bn->tnonil = 1;
+}
+
+/* Select the positions [lo,hi) of b whose code is in [a1,a1+d1] or
+ * [a2,a2+d2] (an empty range has a == ~0 and d == 0), or, if qual is
+ * not NULL, whose code c has qual[c] set. */
+static BAT *
+packed_select(BAT *b, const packed *p, BUN off, BUN lo, BUN hi,
+	      ulng a1, ulng d1, ulng a2, ulng d2, const bte *qual)
+{
+	unsigned int codes[PACKED_BLOCK];
+	BUN i, j, n, cnt = 0;
+	oid *restrict dst;
+	BAT *bn;
+
+	if ((bn = COLnew(0, TYPE_oid, MIN(hi - lo, PACKED_BLOCK), TRANSIENT)) == NULL) {
+		GDKclrerr();
+		return NULL;
+	}
+	if (qual == NULL && a1 == ~(ulng) 0 && a2 == ~(ulng) 0)
+		hi = lo;
+	for (i = lo; i < hi; i += n) {
+		n = MIN(hi - i, PACKED_BLOCK);
+		packed_decode(p, off + i, n, codes);
+		if (BATcapacity(bn) < cnt + n &&
+		    BATextend(bn, MAX(BATcapacity(bn) * 2, cnt + n)) != GDK_SUCCEED) {
+			BBPreclaim(bn);
+			GDKclrerr();
+			return NULL;
+		}
+		dst = (oid *) Tloc(bn, 0);
+		if (qual) {
+			for (j = 0; j < n; j++) {
+				dst[cnt] = b->hseqbase + i + j;
+				cnt += qual[codes[j]];
+			}
+		} else {
+			for (j = 0; j < n; j++) {
+				dst[cnt] = b->hseqbase + i + j;
+				cnt += (codes[j] - a1 <= d1) | (codes[j] - a2 <= d2);
+			}
+		}
+	}
+	packed_selected(bn, cnt);
+	return bn;
+}
+
+/* the numeric select of PCKselect on the packed form p */
+static BAT *
+packed_numselect(BAT *b, BAT *s, const packed *p, BUN off,
+		 const void *tl, const void *th, int equi, int anti)
+{
+	BUN lo, hi, cnt = 0;
+	lng vl, vh;
+	oid *restrict dst;
+	BAT *bn;
+
+	packed_range(b, s, &lo, &hi);
+	vl = packed_val(tl, p->width, 0);
+	vh = packed_val(th, p->width, 0);
+
+	if (p->enc == PACK_RLE) {
+		BUN r, rs, re;
+
+		if ((bn = COLnew(0, TYPE_oid, MIN(hi - lo, PACKED_BLOCK), TRANSIENT)) == NULL) {
+			GDKclrerr();
+			return NULL;
+		}
+		for (r = lo < hi ? packed_run(p, off + lo) : p->n; r < p->n; r++) {
+			lng v = packed_val(p->vals, p->width, r);
+			bool q;
+
+			rs = r == 0 ? 0 : p->ends[r - 1];
+			if (rs >= off + hi)
+				break;
+			if (equi)
+				q = v == vl;
+			else if (anti)
+				q = (v <= vl || v >= vh) && v != p->nil;
+			else
+				q = v >= vl && v <= vh;
+			if (!q)
+				continue;
+			rs = MAX(rs, off + lo);
+			re = MIN(p->ends[r], off + hi);
+			if (BATcapacity(bn) < cnt + re - rs &&
+			    BATextend(bn, MAX(BATcapacity(bn) * 2, cnt + re - rs)) != GDK_SUCCEED) {
+				BBPreclaim(bn);
+				GDKclrerr();
+				return NULL;
+			}
+			dst = (oid *) Tloc(bn, 0);
+			for (; rs < re; rs++)
+				dst[cnt++] = b->hseqbase + rs - off;
+		}
+		packed_selected(bn, cnt);
+	} else {
+		ulng a1 = ~(ulng) 0, d1 = 0, a2 = ~(ulng) 0, d2 = 0, e;
+
+		if (equi && vl == p->nil) {
+			if ((e = packed_code_nil(p)) != ~(ulng) 0 && p->nils > 0)
+				a1 = e;
+		} else if (anti) {
+			ulng first = p->enc == PACK_FOR ? 1 : packed_code_nil(p) + 1;
+
+			if ((e = packed_code_le(p, vl)) != ~(ulng) 0 && e >= first) {
+				a1 = first;
+				d1 = e - first;
+			}
+			a2 = packed_code_ge(p, vh);
+			e = p->enc == PACK_FOR ? (ulng) p->max - (ulng) p->min + 1 : (ulng) p->n - 1;
+			if (a2 <= e && p->nils < p->cnt)
+				d2 = e - a2;
+			else
+				a2 = ~(ulng) 0;
+		} else {
+			a1 = packed_code_ge(p, vl);
+			e = packed_code_le(p, vh);
+			if (a1 <= e && e != ~(ulng) 0)
+				d1 = e - a1;
+			else
+				a1 = ~(ulng) 0;
+		}
+		bn = packed_select(b, p, off, lo, hi, a1, d1, a2, d2, NULL);
+	}
+	return bn;
+}
+
+/* Select from b the values that satisfy the normalized conditions of
+ * BATselect: v == *tl if equi (this includes nil), *tl <= v <= *th if
+ * not anti, and (v <= *tl || v >= *th) && v != nil if anti.  There is
+ * no candidate list, or a dense one.  Returns NULL if b has no packed
+ * form (or we failed), in which case the column must be used. */
+BAT *
+PCKselect(BAT *b, BAT *s, const void *tl, const void *th, int equi, int anti)
+{
+	packed p;
+	BUN off;
+	BAT *bn;
+
+	if (b->tvarsized || !packed_open(b, &p, &off))
+		return NULL;
+	bn = packed_numselect(b, s, &p, off, tl, th, equi, anti);
+	packed_close(&p);
+	ALGODEBUG if (bn) fprintf(stderr, "#PCKselect(b=%s#" BUNFMT ",anti=%d): "
+				  "encoding %d, " BUNFMT " results\n",
+				  BATgetId(b), BATcount(b), anti, p.enc, BATcount(bn));
+	return bn;
+}
+
+/* first entry of the string dictionary that is larger than v, or, if
+ * !upper, not smaller than v */
+static BUN
+packed_strbound(const packed *p, const char *v, bool upper)
+{
+	BUN lo = 0, hi = p->n;
+
+	while (lo < hi) {
+		BUN m = lo + (hi - lo) / 2;
+		int c = GDK_STRCMP(p->base + (var_t) packed_val(p->vals, p->width, m), v);
+
+		if (c < 0 || (upper && c == 0))
+			lo = m + 1;
+		else
+			hi = m;
+	}
+	return lo;
+}
+
+/* Select the positions [lo,hi) of the string column b whose value is
+ * (anti: is not, and is not nil) equal to v.  Only the rows whose
+ * fingerprint is that of v (or, if anti, of v or nil) are compared. */
+static BAT *
+packed_hashselect(BAT *b, const packed *p, BUN off, BUN lo, BUN hi, const char *v, int anti)
+{
+	const unsigned int *restrict fps = p->fps + off;
+	const unsigned int fv = (unsigned int) strHash(v);
+	const unsigned int fnil = (unsigned int) strHash(str_nil);
+	const void *src = Tloc(b, 0);
+	BUN i, j, k, n, cnt = 0;
+	oid *restrict dst;
+	BAT *bn;
+
+	if ((bn = COLnew(0, TYPE_oid, MIN(hi - lo, PACKED_BLOCK), TRANSIENT)) == NULL) {
+		GDKclrerr();
+		return NULL;
+	}
+	for (i = lo; i < hi; i += n) {
+		n = MIN(hi - i, PACKED_BLOCK);
+		if (BATcapacity(bn) < cnt + n &&
+		    BATextend(bn, MAX(BATcapacity(bn) * 2, cnt + n)) != GDK_SUCCEED) {
+			BBPreclaim(bn);
+			GDKclrerr();
+			return NULL;
+		}
+		dst = (oid *) Tloc(bn, 0);
+		if (anti) {
+			for (j = i; j < i + n; j++) {
+				const char *w;
+
+				if (fps[j] != fv && fps[j] != fnil) {
+					dst[cnt++] = b->hseqbase + j;
+					continue;
+				}
+				w = p->base + VarHeapVal(src, j, b->twidth);
+				if (!GDK_STRNIL(w) && strcmp(w, v) != 0)
+					dst[cnt++] = b->hseqbase + j;
+			}
+		} else {
+			/* first collect the rows with the right
+			 * fingerprint, then weed out the false
+			 * positives */
+			k = cnt;
+			for (j = i; j < i + n; j++) {
+				dst[cnt] = b->hseqbase + j;
+				cnt += fps[j] == fv;
+			}
+			for (j = k; j < cnt; j++) {
+				const char *w = p->base + VarHeapVal(src, dst[j] - b->hseqbase, b->twidth);
+
+				if (GDK_STREQ(w, v))
+					dst[k++] = dst[j];
+			}
+			cnt = k;
+		}
+	}
+	packed_selected(bn, cnt);
+	return bn;
+}
+
+/* Select from the string column b the values that satisfy the
+ * conditions of BATselect, with the arguments as they are at the
+ * point where it scans the column: unlike the numeric types, the
+ * string bounds are not normalized, so li, hi, lval and hval still
+ * count.  There is no candidate list, or a dense one.  Returns NULL
+ * if b has no dictionary (or we failed). */
+BAT *
+PCKstrselect(BAT *b, BAT *s, const char *tl, const char *th,
+	     int li, int hi, int equi, int anti, int lval, int hval)
+{
+	packed p;
+	BUN off, lo, end, first, x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+	BAT *bn;
+
+	if (!b->tvarsized || !packed_open(b, &p, &off))
+		return NULL;
+	packed_range(b, s, &lo, &end);
+	if (p.enc == PACK_HASH) {
+		/* fingerprints only help with (in)equality */
+		if (!equi && !(anti && li && hi && GDK_STREQ(tl, th))) {
+			packed_close(&p);
+			return NULL;
+		}
+		bn = packed_hashselect(b, &p, off, lo, end, tl, anti);
+		packed_close(&p);
+		ALGODEBUG if (bn) fprintf(stderr, "#PCKstrselect(b=%s#" BUNFMT ",anti=%d): "
+					  "fingerprints, " BUNFMT " results\n",
+					  BATgetId(b), BATcount(b), anti, BATcount(bn));
+		return bn;
+	}
+	if (p.enc != PACK_DICT) {
+		packed_close(&p);
+		return NULL;
+	}
+	/* the qualifying codes are [x1,y1) and [x2,y2) */
+	first = p.nils > 0;	/* nil sorts first */
+	if (equi) {
+		x1 = packed_strbound(&p, tl, false);
+		y1 = packed_strbound(&p, tl, true);
+	} else if (anti) {
+		assert(lval && hval);
+		x1 = first;
+		y1 = packed_strbound(&p, tl, !li);
+		x2 = packed_strbound(&p, th, hi);
+		y2 = p.n;
+	} else {
+		x1 = !lval ? first : packed_strbound(&p, tl, !li);
+		y1 = !hval ? p.n : packed_strbound(&p, th, hi);
+		if (x1 < first)
+			x1 = first;
+	}
+	bn = packed_select(b, &p, off, lo, end,
+			   x1 < y1 ? (ulng) x1 : ~(ulng) 0,
+			   x1 < y1 ? (ulng) (y1 - x1 - 1) : 0,
+			   x2 < y2 ? (ulng) x2 : ~(ulng) 0,
+			   x2 < y2 ? (ulng) (y2 - x2 - 1) : 0,
+			   NULL);
+	packed_close(&p);
+	ALGODEBUG if (bn) fprintf(stderr, "#PCKstrselect(b=%s#" BUNFMT ",anti=%d): "
+				  "codes [" BUNFMT "," BUNFMT ") [" BUNFMT "," BUNFMT "), "
+				  BUNFMT " results\n",
+				  BATgetId(b), BATcount(b), anti, x1, y1, x2, y2, BATcount(bn));
+	return bn;
+}
+
+/* Select from the string column b the non-nil values v for which
+ * pred(v, arg) returns non-zero (zero if anti), evaluating the
+ * predicate once per distinct value instead of once per row.  There
+ * is no candidate list, or a dense one.  Returns NULL without setting
+ * an error if b has no dictionary, in which case the caller must scan
+ * the column itself. */
+BAT *
+BATdictselect(BAT *b, BAT *s, int (*pred)(const char *, void *), void *arg, int anti)
+{
+	packed p;
+	BUN off, lo, hi, i, n = 0;
+	bte *qual;
+	BAT *bn;
+
+	if (b == NULL || ATOMstorage(b->ttype) != TYPE_str ||
+	    (s && !BATtdense(s)) ||
+	    !packed_open(b, &p, &off))
+		return NULL;
+	if (p.enc != PACK_DICT) {
+		packed_close(&p);
+		return NULL;
+	}
+	if ((qual = GDKmalloc(p.n)) == NULL) {
+		packed_close(&p);
+		GDKclrerr();
+		return NULL;
+	}
+	for (i = 0; i < p.n; i++) {
+		const char *v = p.base + (var_t) packed_val(p.vals, p.width, i);
+
+		qual[i] = !GDK_STRNIL(v) && (pred(v, arg) != 0) != anti;
+		n += qual[i];
+	}
+	packed_range(b, s, &lo, &hi);
+	if (n == 0)
+		hi = lo;
+	bn = packed_select(b, &p, off, lo, hi, 0, 0, 0, 0, qual);
+	packed_close(&p);
+	GDKfree(qual);
+	ALGODEBUG if (bn) fprintf(stderr, "#BATdictselect(b=%s#" BUNFMT ",anti=%d): "
+				  BUNFMT " of " BUNFMT " codes, " BUNFMT " results\n",
+				  BATgetId(b), BATcount(b), anti, n, p.n, BATcount(bn));
+	return bn;
+}
+
+#define PCK_PROJECT(TYPE)						\
+	do {								\
+		TYPE *restrict bt = (TYPE *) Tloc(bn, 0);		\
+		const TYPE *restrict dict = (const TYPE *) p.vals;	\
+		BUN run = 0;						\
+		TYPE v;							\
+		for (lo = 0; lo < hi; lo++) {				\
+			if (o[lo] < rseq || o[lo] >= rend) {		\
+				if (!is_oid_nil(o[lo]))			\
+					goto bailout;			\
+				bt[lo] = TYPE##_nil;			\
+				oidnils = true;				\
+				continue;				\
+			}						\
+			pos = o[lo] - rseq + off;			\
+			switch (p.enc) {				\
+			case PACK_FOR:					\
+				c = packed_get(p.words, p.bits, p.mask, pos); \
+				v = c ? (TYPE) (p.min + (lng) (c - 1)) : TYPE##_nil; \
+				break;					\
+			case PACK_DICT:					\
+				v = dict[packed_get(p.words, p.bits, p.mask, pos)]; \
+				break;					\
+			default:					\
+				/* walk forward if the positions go up */ \
+				if (!(run < p.n && pos < p.ends[run] &&	\
+				      (run == 0 || pos >= p.ends[run - 1]))) { \
+					if (run + 1 < p.n &&		\
+					    pos >= p.ends[run] &&	\
+					    pos < p.ends[run + 1])	\
+						run++;			\
+					else				\
+						run = packed_run(&p, pos); \
+				}					\
+				v = dict[run];				\
+				break;					\
+			}						\
+			bt[lo] = v;					\
+			nils |= is_##TYPE##_nil(v);			\
+		}							\
+	} while (0)
+
+/* Fill bn with the values of r at the (non-dense) positions l, as
+ * BATproject does.  Returns GDK_FAIL if r has no packed form or if an
+ * oid is out of range, in which case the column must be used (and
+ * the latter is reported then); the count and properties of bn are
+ * only set on success. */
+gdk_return
+PCKproject(BAT *bn, BAT *l, BAT *r)
+{
+	packed p;
+	BUN off, lo, hi = BATcount(l), pos;
+	const oid *restrict o = (const oid *) Tloc(l, 0);
+	oid rseq = r->hseqbase, rend = r->hseqbase + BATcount(r);
+	ulng c;
+	bool nils = false, oidnils = false;
+
+	assert(l->ttype == TYPE_oid);
+	if (r->tvarsized || !packed_open(r, &p, &off))
+		return GDK_FAIL;
+	if (p.width != bn->twidth)
+		goto bailout;
+	switch (p.width) {
+	case 1:
+		PCK_PROJECT(bte);
+		break;
+	case 2:
+		PCK_PROJECT(sht);
+		break;
+	case 4:
+		PCK_PROJECT(int);
+		break;
+	default:
+		PCK_PROJECT(lng);
+		break;
+	}
+	packed_close(&p);
+	BATsetcount(bn, hi);
+	if (oidnils) {
+		bn->tsorted = 0;
+		bn->trevsorted = 0;
+		bn->tkey = 0;
+	}
+	if (nils || oidnils) {
+		bn->tnonil = 0;
+		bn->tnil = 1;
+	}
+	ALGODEBUG fprintf(stderr, "#PCKproject(l=%s,r=%s): encoding %d\n",
+			  BATgetId(l), BATgetId(r), p.enc);
+	return GDK_SUCCEED;
+
+  bailout:
+	packed_close(&p);
+	return GDK_FAIL;
+}
+
+/* Find the smallest (or largest) non-nil value of b and store it
+ * with the width of b in res, or nil if there is none.  Returns false
+ * if b has no packed form (or we failed). */
+bool
+PCKminmax(BAT *b, bool max, void *res)
+{
+	packed p;
+	BUN off, cnt = BATcount(b);
+	lng v;
+
+	if (b->tvarsized || !packed_open(b, &p, &off))
+		return false;
+	if (off == 0 && cnt == p.cnt) {
+		v = p.nils == p.cnt ? p.nil : max ? p.max : p.min;
+	} else if (p.enc == PACK_RLE) {
+		BUN r;
+
+		v = p.nil;
+		for (r = packed_run(&p, off); r < p.n && (r == 0 || p.ends[r - 1] < off + cnt); r++) {
+			lng x = packed_val(p.vals, p.width, r);
+
+			if (x != p.nil &&
+			    (v == p.nil || (max ? x > v : x < v)))
+				v = x;
+		}
+	} else {
+		unsigned int codes[PACKED_BLOCK];
+		ulng cnil = packed_code_nil(&p), cmin = ~(ulng) 0, cmax = 0;
+		bool seen = false;
+		BUN i, j, n;
+
+		for (i = 0; i < cnt; i += n) {
+			n = MIN(cnt - i, PACKED_BLOCK);
+			packed_decode(&p, off + i, n, codes);
+			for (j = 0; j < n; j++) {
+				if (codes[j] == cnil)
+					continue;
+				seen = true;
+				if (codes[j] < cmin)
+					cmin = codes[j];
+				if (codes[j] > cmax)
+					cmax = codes[j];
+			}
+		}
+		if (!seen)
+			v = p.nil;
+		else if (p.enc == PACK_FOR)
+			v = p.min + (lng) ((max ? cmax : cmin) - 1);
+		else
+			v = packed_val(p.vals, p.width, max ? cmax : cmin);
+	}
+	packed_close(&p);
+	packed_store(res, p.width, 0, v);
+	return true;
+}
+
+#ifdef HAVE_HGE
+/* Sum the values of b in positions [start,end) into *sum, and count
+ * the nils.  Returns false if b has no packed form (or we failed). */
+bool
+PCKsum(BAT *b, BUN start, BUN end, hge *sum, BUN *nils)
+{
+	packed p;
+	BUN off;
+	hge s = 0;
+	BUN z = 0;
+
+	if (b->tvarsized || !packed_open(b, &p, &off))
+		return false;
+	if (p.enc == PACK_RLE) {
+		BUN r;
+
+		for (r = start < end ? packed_run(&p, off + start) : p.n; r < p.n; r++) {
+			BUN rs = r == 0 ? 0 : p.ends[r - 1];
+			BUN re = MIN(p.ends[r], off + end);
+			lng v = packed_val(p.vals, p.width, r);
+
+			if (rs >= off + end)
+				break;
+			rs = MAX(rs, off + start);
+			if (v == p.nil)
+				z += re - rs;
+			else
+				s += (hge) v * (hge) (re - rs);
+		}
+	} else if (p.enc == PACK_FOR) {
+		unsigned int codes[PACKED_BLOCK];
+		BUN i, j, n;
+
+		for (i = start; i < end; i += n) {
+			ulng bs = 0;
+			BUN bz = 0;
+
+			n = MIN(end - i, PACKED_BLOCK);
+			packed_decode(&p, off + i, n, codes);
+			for (j = 0; j < n; j++) {
+				bs += codes[j];
+				bz += codes[j] == 0;
+			}
+			s += bs;
+			z += bz;
+		}
+		/* each non-nil code is its value - min + 1 */
+		s += (hge) (end - start - z) * ((hge) p.min - 1);
+	} else {
+		unsigned int codes[PACKED_BLOCK];
+		BUN i, j, n, *hist;
+
+		if ((hist = GDKzalloc(p.n * sizeof(BUN))) == NULL) {
+			packed_close(&p);
+			GDKclrerr();
+			return false;
+		}
+		for (i = start; i < end; i += n) {
+			n = MIN(end - i, PACKED_BLOCK);
+			packed_decode(&p, off + i, n, codes);
+			for (j = 0; j < n; j++)
+				hist[codes[j]]++;
+		}
+		for (i = 0; i < p.n; i++) {
+			lng v = packed_val(p.vals, p.width, i);
+
+			if (v == p.nil)
+				z += hist[i];
+			else
+				s += (hge) v * (hge) hist[i];
+		}
+		GDKfree(hist);
+	}
+	packed_close(&p);
+	*sum = s;
+	*nils = z;
+	return true;
+}
+#endif
+
+/* The fingerprints (the low 32 bits of strHash) of the values of the
+ * string column b, one per row, or NULL if b has none.  They stay
+ * valid until PCKunpin is called with what is returned in *pin. */
+const unsigned int *
+PCKfingerprints(BAT *b, Heap **pin)
+{
+	packed p;
+	BUN off;
+
+	*pin = NULL;
+	if (ATOMstorage(b->ttype) != TYPE_str ||
+	    !packed_open(b, &p, &off))
+		return NULL;
+	if (p.enc != PACK_HASH) {
+		packed_close(&p);
+		return NULL;
+	}
+	*pin = &p.pin->heap;
+	return p.fps + off;
+}
+
+/* release the fingerprints that PCKfingerprints returned */
+void
+PCKunpin(Heap *pin)
+{
+	if (pin)
+		packed_unpin((PackedHeap *) pin);
+}
+
+/* Group the values of b in positions [start,end) on their codes,
+ * which works for a dictionary and for a frame of reference with few
+ * codes, as BATgroup does without candidate list and previous
+ * grouping: the groups are numbered in order of first appearance.
+ * Returns GDK_FAIL without setting an error if b has no such packed
+ * form (or we failed), in which case the column must be used. */
+gdk_return
+PCKgroup(BAT **groups, BAT **extents, BAT **histo, BAT *b, oid hseq, BUN start, BUN end)
+{
+	packed p;
+	BUN off, ncodes, i, j, n, r = 0;
+	unsigned int codes[PACKED_BLOCK];
+	oid *restrict map, *restrict grps, *restrict exts = NULL, ngrp = 0;
+	lng *restrict cnts = NULL;
+	BAT *gn = NULL, *en = NULL, *hn = NULL;
+	bool sorted = true;
+
+	if (!packed_open(b, &p, &off))
+		return GDK_FAIL;
+	if ((p.enc != PACK_DICT && p.enc != PACK_FOR) ||
+	    (ncodes = p.enc == PACK_DICT ? p.n : (BUN) p.mask + 1) > PACKED_MAXDICT) {
+		packed_close(&p);
+		return GDK_FAIL;
+	}
+	if ((map = GDKmalloc(ncodes * sizeof(oid))) == NULL ||
+	    (gn = COLnew(hseq, TYPE_oid, end - start, TRANSIENT)) == NULL ||
+	    (extents && (en = COLnew(0, TYPE_oid, ncodes, TRANSIENT)) == NULL) ||
+	    (histo && (hn = COLnew(0, TYPE_lng, ncodes, TRANSIENT)) == NULL)) {
+		packed_close(&p);
+		GDKfree(map);
+		BBPreclaim(gn);
+		BBPreclaim(en);
+		GDKclrerr();
+		return GDK_FAIL;
+	}
+	for (i = 0; i < ncodes; i++)
+		map[i] = oid_nil;
+	grps = (oid *) Tloc(gn, 0);
+	if (en)
+		exts = (oid *) Tloc(en, 0);
+	if (hn) {
+		cnts = (lng *) Tloc(hn, 0);
+		memset(cnts, 0, ncodes * sizeof(lng));
+	}
+	for (i = start; i < end; i += n) {
+		n = MIN(end - i, PACKED_BLOCK);
+		packed_decode(&p, off + i, n, codes);
+		for (j = 0; j < n; j++, r++) {
+			oid g = map[codes[j]];
+
+			if (is_oid_nil(g)) {
+				map[codes[j]] = g = ngrp++;
+				if (exts)
+					exts[g] = b->hseqbase + i + j;
+			}
+			grps[r] = g;
+			sorted &= r == 0 || g >= grps[r - 1];
+			if (cnts)
+				cnts[g]++;
+		}
+	}
+	packed_close(&p);
+	GDKfree(map);
+	BATsetcount(gn, r);
+	gn->tsorted = sorted;
+	gn->trevsorted = ngrp == 1 || r <= 1;
+	gn->tkey = ngrp == r;
+	gn->tnonil = 1;
+	gn->tnil = 0;
+	*groups = gn;
+	if (extents) {
+		BATsetcount(en, ngrp);
+		en->tsorted = 1;
+		en->trevsorted = ngrp <= 1;
+		en->tkey = 1;
+		en->tnonil = 1;
+		en->tnil = 0;
+		*extents = en;
+	}
+	if (histo) {
+		BATsetcount(hn, ngrp);
+		hn->tsorted = ngrp == r || ngrp == 1;
+		hn->trevsorted = ngrp == r || ngrp == 1;
+		hn->tkey = ngrp == 1;
+		hn->tnonil = 1;
+		hn->tnil = 0;
+		*histo = hn;
+	}
+	ngrp--;			/* max value is one less than number of values */
+	BATsetprop(gn, GDK_MAX_VALUE, TYPE_oid, &ngrp);
+	ALGODEBUG fprintf(stderr, "#PCKgroup(b=%s#" BUNFMT "): encoding %d, "
+			  OIDFMT " groups\n",
+			  BATgetId(b), BATcount(b), p.enc, ngrp + 1);
+	return GDK_SUCCEED;
+}
+
+/* Called when the persistent BAT b is saved: create the packed form
+ * if there isn't one yet, and write it to disk if it changed. */
+void
+PCKpersist(BAT *b)
+{
+	Heap *hp;
+
+	if (VIEWtparent(b) || !packed_type(b) || BATcount(b) < PACKED_MIN)
+		return;
+	if (b->tpacked == NULL) {
+		if (BATpacked(b) != GDK_SUCCEED) {
+			GDKclrerr();
+			return;
+		}
+	}
+	MT_lock_set(&GDKhashLock(b->batCacheid));
+	if ((hp = b->tpacked) != NULL && hp != (Heap *) 1 &&
+	    !(PHDR(hp, 0) & PACKED_SYNCED) &&
+	    PHDR(hp, 2) == (size_t) BATcount(b))
+		packed_persist(b, hp);
+	MT_lock_unset(&GDKhashLock(b->batCacheid));
+}
+
+/* free the memory of the packed form, but keep it on disk */
+void
+PCKfree(BAT *b)
+{
+	if (b) {
+		Heap *hp;
+
+		MT_lock_set(&GDKhashLock(b->batCacheid));
+		if ((hp = b->tpacked) != NULL && hp != (Heap *) 1) {
+			b->tpacked = (Heap *) 1;
+			if (((PackedHeap *) hp)->pins > 0) {
+				/* the last user frees it */
+				((PackedHeap *) hp)->dropped = true;
+				hp = NULL;
+			}
+		} else {
+			hp = NULL;
+		}
+		MT_lock_unset(&GDKhashLock(b->batCacheid));
+		if (hp) {
+			HEAPfree(hp, 0);
+			GDKfree(hp);
+		}
+	}
+}
+
+/* the packed form doesn't describe b anymore: remove it */
+void
+PCKdestroy(BAT *b)
+{
+	if (b && b->tpacked) {
+		Heap *hp;
+
+		MT_lock_set(&GDKhashLock(b->batCacheid));
+		hp = b->tpacked;
+		b->tpacked = NULL;
+		if (hp != NULL && hp != (Heap *) 1 &&
+		    ((PackedHeap *) hp)->pins > 0) {
+			/* the last user frees the memory */
+			((PackedHeap *) hp)->dropped = true;
+			hp = (Heap *) 1;
+		}
+		MT_lock_unset(&GDKhashLock(b->batCacheid));
+		if (hp == (Heap *) 1) {
+			GDKunlink(BBPselectfarm(b->batRole, b->ttype, packedheap),
+				  BATDIR,
+				  BBP_physical(b->batCacheid),
+				  "tpacked");
+		} else if (hp != NULL) {
+			HEAPdelete(hp, BBP_physical(b->batCacheid), "tpacked");
+			GDKfree(hp);
+		}
+	}
+}
@@ -23,7 +23,9 @@ enum heaptype {
 	varheap,
 	hashheap,
 	imprintsheap,
-	orderidxheap
+	orderidxheap,
+	zonemapheap,
+	packedheap
 };
 
 __hidden gdk_return ATOMheap(int id, Heap *hp, size_t cap)
@@ -47,6 +49,8 @@ __hidden gdk_return BATcheckmodes(BAT *b, bool persistent)
 	__attribute__((__visibility__("hidden")));
 __hidden bool BATcheckorderidx(BAT *b)
 	__attribute__((__visibility__("hidden")));
+__hidden bool BATcheckzonemap(BAT *b)
+	__attribute__((__visibility__("hidden")));
 __hidden BAT *BATcreatedesc(oid hseq, int tt, int heapnames, int role)
 	__attribute__((__visibility__("hidden")));
 __hidden void BATdelete(BAT *b)
@@ -65,11 +69,22 @@ __hidden BAT *BATload_intern(bat bid, bool lock)
 __hidden gdk_return BATmaterialize(BAT *b)
 	__attribute__((__warn_unused_result__))
 	__attribute__((__visibility__("hidden")));
+__hidden void BATprefault(BAT *b)
+	__attribute__((__visibility__("hidden")));
 __hidden gdk_return BATsave(BAT *b)
 	__attribute__((__warn_unused_result__))
 	__attribute__((__visibility__("hidden")));
 __hidden void BATsetdims(BAT *b)
 	__attribute__((__visibility__("hidden")));
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__INTEL_COMPILER) && (__GNUC__ >= 5 || defined(__clang__))
+#define GDK_SELECT_SIMD 1
+__hidden BUN BATselect_simd(BAT *b, BAT *bn, const void *tl, const void *th, int equi, int anti, BUN p, BUN q, BUN cnt, lng off)
+	__attribute__((__visibility__("hidden")));
+__hidden int BATselect_simd_ok(BAT *b)
+	__attribute__((__visibility__("hidden")));
+__hidden void SIMDinit(void)
+	__attribute__((__visibility__("hidden")));
+#endif
 __hidden gdk_return BBPcacheit(BAT *bn, bool lock)
 	__attribute__((__warn_unused_result__))
 	__attribute__((__visibility__("hidden")));
@@ -127,6 +142,8 @@ __hidden char *GDKload(int farmid, const char *nme, const char *ext, size_t size
 __hidden void GDKlog(_In_z_ _Printf_format_string_ FILE * fl, const char *format, ...)
 	__attribute__((__format__(__printf__, 2, 3)))
 	__attribute__((__visibility__("hidden")));
+__hidden size_t GDKmallocated(const void *s)
+	__attribute__((__visibility__("hidden")));
 __hidden gdk_return GDKmove(int farmid, const char *dir1, const char *nme1, const char *ext1, const char *dir2, const char *nme2, const char *ext2)
 	__attribute__((__warn_unused_result__))
 	__attribute__((__visibility__("hidden")));
@@ -170,16 +187,29 @@ __hidden void HEAPfree(Heap *h, int remove)
 __hidden gdk_return HEAPload(Heap *h, const char *nme, const char *ext, int trunc)
 	__attribute__((__warn_unused_result__))
 	__attribute__((__visibility__("hidden")));
+__hidden gdk_return HEAPloadaux(Heap *h, BAT *b, BUN cnt, const char *ext, size_t nhdr, size_t (*check)(const BAT *b, BUN cnt, const size_t *hdr))
+	__attribute__((__warn_unused_result__))
+	__attribute__((__visibility__("hidden")));
 __hidden void HEAP_recover(Heap *, const var_t *, BUN)
 	__attribute__((__visibility__("hidden")));
+__hidden void HEAPprefault(Heap *h)
+	__attribute__((__visibility__("hidden")));
 __hidden gdk_return HEAPsave(Heap *h, const char *nme, const char *ext)
 	__attribute__((__warn_unused_result__))
 	__attribute__((__visibility__("hidden")));
+__hidden gdk_return HEAPsaveaux(Heap *h, BAT *b, const char *ext, size_t synced)
+	__attribute__((__warn_unused_result__))
+	__attribute__((__visibility__("hidden")));
 __hidden gdk_return HEAPshrink(Heap *h, size_t size)
 	__attribute__((__warn_unused_result__))
 	__attribute__((__visibility__("hidden")));
+__hidden gdk_return HEAPunsyncaux(Heap *h, BAT *b, const char *ext, size_t synced)
+	__attribute__((__warn_unused_result__))
+	__attribute__((__visibility__("hidden")));
 __hidden int HEAPwarm(Heap *h)
 	__attribute__((__visibility__("hidden")));
+__hidden void IMPSappend(BAT *b, BUN start)
+	__attribute__((__visibility__("hidden")));
 __hidden void IMPSfree(BAT *b)
 	__attribute__((__visibility__("hidden")));
 __hidden int IMPSgetbin(int tpe, bte bits, const char *restrict bins, const void *restrict v)
@@ -188,6 +218,8 @@ __hidden int IMPSgetbin(int tpe, bte bits, const char *restrict bins, const void
 __hidden void IMPSprint(BAT *b)
 	__attribute__((__visibility__("hidden")));
 #endif
+__hidden void IMPSpersist(BAT *b)
+	__attribute__((__visibility__("hidden")));
 __hidden void MT_init_posix(void)
 	__attribute__((__visibility__("hidden")));
 __hidden void *MT_mremap(const char *path, int mode, void *old_address, size_t old_size, size_t *new_size)
@@ -223,6 +255,50 @@ __hidden void gdk_bbp_reset(void)
 	__attribute__((__visibility__("hidden")));
 __hidden void gdk_system_reset(void)
 	__attribute__((__visibility__("hidden")));
+__hidden void ZNMappend(BAT *b, BUN start)
+	__attribute__((__visibility__("hidden")));
+__hidden void ZNMdestroy(BAT *b)
+	__attribute__((__visibility__("hidden")));
+__hidden void ZNMfree(BAT *b)
+	__attribute__((__visibility__("hidden")));
+__hidden void ZNMpersist(BAT *b)
+	__attribute__((__visibility__("hidden")));
+__hidden BUN ZNMselect(BAT *b, const void *tl, const void *th, int li, int hi, int equi, int anti, int lval, int hval, int lnil, BUN *runs, BUN maxruns)
+	__attribute__((__visibility__("hidden")));
+__hidden void PCKdestroy(BAT *b)
+	__attribute__((__visibility__("hidden")));
+__hidden const unsigned int *PCKfingerprints(BAT *b, Heap **pin)
+	__attribute__((__visibility__("hidden")));
+__hidden void PCKfree(BAT *b)
+	__attribute__((__visibility__("hidden")));
+__hidden gdk_return PCKgroup(BAT **groups, BAT **extents, BAT **histo, BAT *b, oid hseq, BUN start, BUN end)
+	__attribute__((__visibility__("hidden")));
+__hidden bool PCKminmax(BAT *b, bool max, void *res)
+	__attribute__((__visibility__("hidden")));
+__hidden void PCKpersist(BAT *b)
+	__attribute__((__visibility__("hidden")));
+__hidden gdk_return PCKproject(BAT *bn, BAT *l, BAT *r)
+	__attribute__((__visibility__("hidden")));
+__hidden BAT *PCKselect(BAT *b, BAT *s, const void *tl, const void *th, int equi, int anti)
+	__attribute__((__visibility__("hidden")));
+__hidden BAT *PCKstrselect(BAT *b, BAT *s, const char *tl, const char *th, int li, int hi, int equi, int anti, int lval, int hval)
+	__attribute__((__visibility__("hidden")));
+__hidden void PCKunpin(Heap *pin)
+	__attribute__((__visibility__("hidden")));
+#ifdef HAVE_HGE
+__hidden bool PCKsum(BAT *b, BUN start, BUN end, hge *sum, BUN *nils)
+	__attribute__((__visibility__("hidden")));
+#endif
+
+/* zone maps: one zone per ZONEMAP_SIZE values; columns with fewer
+ * than ZONEMAP_MIN values don't get one */
+#define ZONEMAP_SHIFT	12
+#define ZONEMAP_SIZE	((BUN) 1 << ZONEMAP_SHIFT)
+#define ZONEMAP_MIN	(4 * ZONEMAP_SIZE)
+
+/* packed columns: columns with fewer than PACKED_MIN values are not
+ * packed */
+#define PACKED_MIN	((BUN) 1 << 16)
 
 #define BBP_BATMASK	511
 #define BBP_THREADMASK	63
@@ -272,6 +348,9 @@ extern bbplock_t GDKbbpLock[BBP_THREADMASK + 1];
 extern size_t GDK_mmap_minsize_persistent; /* size after which we use memory mapped files for persistent heaps */
 extern size_t GDK_mmap_minsize_transient; /* size after which we use memory mapped files for transient heaps */
 extern size_t GDK_mmap_pagesize; /* mmap granularity */
+extern size_t GDK_heapcache_maxsize; /* memory of freed heaps kept for reuse */
+extern int GDK_hugepages;	/* back large heaps with huge pages */
+extern int GDK_prefault;	/* prefault heaps of loaded BATs */
 extern MT_Lock GDKnameLock;
 extern MT_Lock GDKthreadLock;
 extern MT_Lock GDKtmLock;
@@ -300,6 +300,12 @@ BATproject(BAT *l, BAT *r)
 	}
 	bn->tnil = 0;
 
+	if (!stringtrick &&
+	    ATOMtype(r->ttype) != TYPE_oid &&
+	    ATOMstorage(tpe) == ATOMbasetype(r->ttype) &&
+	    PCKproject(bn, l, r) == GDK_SUCCEED)
+		goto done;
+
 	switch (tpe) {
 	case TYPE_bte:
 		res = project_bte(bn, l, r, nilcheck);
@@ -343,6 +349,7 @@ BATproject(BAT *l, BAT *r)
 	if (res != GDK_SUCCEED)
 		goto bailout;
 
+  done:
 	/* handle string trick */
 	if (stringtrick) {
 		if (r->batRestricted == BAT_READ) {
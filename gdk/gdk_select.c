@@ -947,6 +947,13 @@ BAT_scanselect(BAT *b, BAT *s, BAT *bn, const void *tl, const void *th,
 			q = BUNlast(b);
 		}
 		candlist = NULL;
+#ifdef GDK_SELECT_SIMD
+		/* vectorized scan if the CPU allows */
+		if (!use_imprints && BATselect_simd_ok(b))
+			cnt = BATselect_simd(b, bn, tl, th, equi, anti,
+					     p, q, cnt, off);
+		else
+#endif
 		/* call type-specific core scan select function */
 		switch (t) {
 		case TYPE_bte:
@@ -1171,6 +1178,54 @@ BAT_scanselect(BAT *b, BAT *s, BAT *bn, const void *tl, const void *th,
 		/* in the case where equi==1, the check is x == *tl */	\
 	} while (0)
 
+/* maximum number of ranges of zones that we select from separately */
+#define MAXZONERUNS	64
+
+/* Select from the nruns ranges runs of b that according to the zone
+ * map may contain qualifying values, and combine the results.  The
+ * selection arguments are the original ones of BATselect. */
+static BAT *
+BAT_zoneselect(BAT *b, BAT *s, const void *tl, const void *th,
+	       int li, int hi, int anti, const BUN *runs, BUN nruns)
+{
+	BAT *bn = NULL, *v, *r;
+	BUN i;
+
+	for (i = 0; i < nruns; i++) {
+		if ((v = BATslice(b, runs[2 * i], runs[2 * i + 1])) == NULL)
+			goto bailout;
+		r = BATselect(v, s, tl, th, li, hi, anti);
+		BBPunfix(v->batCacheid);
+		if (r == NULL)
+			goto bailout;
+		if (nruns == 1)
+			return r;
+		if (bn == NULL &&
+		    (bn = COLnew(0, TYPE_oid, BATcount(r), TRANSIENT)) == NULL) {
+			BBPunfix(r->batCacheid);
+			goto bailout;
+		}
+		/* the ranges are ascending, so the result stays
+		 * sorted */
+		if (BATappend(bn, r, NULL, FALSE) != GDK_SUCCEED) {
+			BBPunfix(r->batCacheid);
+			goto bailout;
+		}
+		BBPunfix(r->batCacheid);
+	}
+	bn->tsorted = 1;
+	bn->trevsorted = BATcount(bn) <= 1;
+	bn->tkey = 1;
+	bn->tnil = 0;
+	bn->tnonil = 1;
+	return virtualize(bn);
+
+  bailout:
+	if (bn)
+		BBPunfix(bn->batCacheid);
+	return NULL;
+}
+
 BAT *
 BATselect(BAT *b, BAT *s, const void *tl, const void *th,
 	     int li, int hi, int anti)
@@ -1182,6 +1237,10 @@ BATselect(BAT *b, BAT *s, const void *tl, const void *th,
 	BUN estimate = BUN_NONE, maximum = BUN_NONE;
 	oid vwl = 0, vwh = 0;
 	int use_orderidx = 0;
+	BUN nruns, runs[2 * MAXZONERUNS];
+	/* the arguments as given, for selecting from zones */
+	const void *otl = tl, *oth = th;
+	const int oli = li, ohi = hi, oanti = anti;
 	union {
 		bte v_bte;
 		sht v_sht;
@@ -1643,6 +1702,60 @@ BATselect(BAT *b, BAT *s, const void *tl, const void *th,
 		return virtualize(bn);
 	}
 
+	/* Use the zone map to skip the parts of the column that
+	 * cannot contain qualifying values.  If nothing qualifies,
+	 * this is how slices of a persistent column that mitosis
+	 * created are dismissed without looking at their values.  A
+	 * point select is better served by a hash table, if there is
+	 * one. */
+	if (ATOMtype(b->ttype) != TYPE_oid &&
+	    !(equi && (BATcheckhash(b) ||
+		       (VIEWtparent(b) &&
+			BATcheckhash(BBPdescriptor(VIEWtparent(b)))))) &&
+	    (nruns = ZNMselect(b, tl, th, li, hi, equi, anti, lval, hval,
+			       lnil, runs, MAXZONERUNS)) != BUN_NONE) {
+		BUN covered = 0, i;
+
+		for (i = 0; i < nruns; i++)
+			covered += runs[2 * i + 1] - runs[2 * i];
+		if (nruns == 0) {
+			ALGODEBUG fprintf(stderr, "#BATselect(b=%s#" BUNFMT
+					  ",s=%s%s,anti=%d): zonemap: "
+					  "no qualifying zones\n",
+					  BATgetId(b), BATcount(b),
+					  s ? BATgetId(s) : "NULL",
+					  s && BATtdense(s) ? "(dense)" : "",
+					  anti);
+			return BATdense(0, 0, 0);
+		}
+		if (covered <= BATcount(b) / 4 * 3 &&
+		    BATtrestricted(b) == BAT_READ) {
+			ALGODEBUG fprintf(stderr, "#BATselect(b=%s#" BUNFMT
+					  ",s=%s%s,anti=%d): zonemap: "
+					  BUNFMT " values in " BUNFMT
+					  " ranges\n",
+					  BATgetId(b), BATcount(b),
+					  s ? BATgetId(s) : "NULL",
+					  s && BATtdense(s) ? "(dense)" : "",
+					  anti, covered, nruns);
+			return BAT_zoneselect(b, s, otl, oth, oli, ohi, oanti,
+					      runs, nruns);
+		}
+	}
+
+	/* Select from the packed form of the column, which is much
+	 * smaller than the column itself (for strings: on the codes of
+	 * the dictionary).  Here too a point select is better served
+	 * by a hash table. */
+	if ((!s || BATtdense(s)) &&
+	    !(equi && (BATcheckhash(b) ||
+		       (VIEWtparent(b) &&
+			BATcheckhash(BBPdescriptor(VIEWtparent(b)))))) &&
+	    (bn = t == TYPE_str ?
+	     PCKstrselect(b, s, tl, th, li, hi, equi, anti, lval, hval) :
+	     PCKselect(b, s, tl, th, equi, anti)) != NULL)
+		return virtualize(bn);
+
 	/* upper limit for result size */
 	maximum = BATcount(b);
 	if (s) {
@@ -0,0 +1,433 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 1997 - July 2008 CWI, August 2008 - 2018 MonetDB B.V.
+ */
+
+/*
+ * SIMD scan select
+ *
+ * Branch-free versions of the fullscan loops of BAT_scanselect for
+ * the fixed width numeric types.  A block of values is compared in
+ * vector registers which results in a bit mask of qualifying rows.
+ * The mask is then turned into oids: on AVX-512 with a compress
+ * store, on AVX2 with a table of bit positions per byte of the mask.
+ *
+ * The kernels are compiled for their instruction set using target
+ * attributes, and the instruction set is chosen at runtime based on
+ * the CPU we are running on.  If neither AVX2 nor AVX-512 is
+ * available, BAT_scanselect uses its scalar loops.
+ *
+ * The predicates are the ones BATselect leaves us with after
+ * normalization (see NORMALIZE in gdk_select.c):
+ * range:  vl <= v && v <= vh
+ * anti:   (v <= vl || v >= vh) && v != nil
+ * equi:   v == vl
+ * For the integer types nil is the smallest value, so the range
+ * check excludes nil automatically; for the floating point types nil
+ * is NaN, for which all ordered comparisons fail.
+ */
+
+#include "monetdb_config.h"
+#include "gdk.h"
+#include "gdk_private.h"
+
+#ifdef GDK_SELECT_SIMD
+
+#include <immintrin.h>
+
+#define SIMD_NONE	0
+#define SIMD_AVX2	1
+#define SIMD_AVX512	2
+
+#define SEL_RANGE	0
+#define SEL_ANTI	1
+#define SEL_EQUI	2
+
+/* number of rows handled between result capacity checks */
+#define SIMD_CHUNK	((BUN) 1 << 14)
+/* AVX2 always stores 8 oids for each byte of the mask */
+#define SIMD_SLACK	8
+
+static int simd_level = SIMD_NONE;
+
+/* positions of the bits set in each possible byte */
+static unsigned char simd_positions[256][8];
+
+void
+SIMDinit(void)
+{
+	int m, i, k;
+
+	for (m = 0; m < 256; m++) {
+		for (i = k = 0; i < 8; i++)
+			if (m & (1 << i))
+				simd_positions[m][k++] = (unsigned char) i;
+	}
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f") &&
+	    __builtin_cpu_supports("avx512bw"))
+		simd_level = SIMD_AVX512;
+	else if (__builtin_cpu_supports("avx2"))
+		simd_level = SIMD_AVX2;
+	else
+		simd_level = SIMD_NONE;
+}
+
+/* AVX2 */
+
+static inline __attribute__((__target__("avx2"))) BUN
+emit_avx2(unsigned int m, oid o, oid *restrict dst)
+{
+	__m256i pos = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) simd_positions[m]));
+	__m256i base = _mm256_set1_epi64x((long long) o);
+
+	_mm256_storeu_si256((__m256i *) dst,
+			    _mm256_add_epi64(base, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(pos))));
+	_mm256_storeu_si256((__m256i *) (dst + 4),
+			    _mm256_add_epi64(base, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(pos, 1))));
+	return (BUN) __builtin_popcount(m);
+}
+
+/* movemask of a comparison result, one bit per lane */
+#define MASK2_bte(x)	((uint64_t) (unsigned int) _mm256_movemask_epi8(x))
+#define MASK2_sht(x)	((uint64_t) (unsigned int) _mm_movemask_epi8(	\
+				 _mm_packs_epi16(_mm256_castsi256_si128(x), \
+						 _mm256_extracti128_si256((x), 1))))
+#define MASK2_int(x)	((uint64_t) (unsigned int) _mm256_movemask_ps(_mm256_castsi256_ps(x)))
+#define MASK2_lng(x)	((uint64_t) (unsigned int) _mm256_movemask_pd(_mm256_castsi256_pd(x)))
+#define MASK2_flt(x)	((uint64_t) (unsigned int) _mm256_movemask_ps(x))
+#define MASK2_dbl(x)	((uint64_t) (unsigned int) _mm256_movemask_pd(x))
+
+#define SET2_bte(v)	_mm256_set1_epi8(v)
+#define SET2_sht(v)	_mm256_set1_epi16(v)
+#define SET2_int(v)	_mm256_set1_epi32(v)
+#define SET2_lng(v)	_mm256_set1_epi64x(v)
+#define SET2_flt(v)	_mm256_set1_ps(v)
+#define SET2_dbl(v)	_mm256_set1_pd(v)
+
+#define GT2_bte(a, b)	_mm256_cmpgt_epi8(a, b)
+#define GT2_sht(a, b)	_mm256_cmpgt_epi16(a, b)
+#define GT2_int(a, b)	_mm256_cmpgt_epi32(a, b)
+#define GT2_lng(a, b)	_mm256_cmpgt_epi64(a, b)
+#define EQ2_bte(a, b)	_mm256_cmpeq_epi8(a, b)
+#define EQ2_sht(a, b)	_mm256_cmpeq_epi16(a, b)
+#define EQ2_int(a, b)	_mm256_cmpeq_epi32(a, b)
+#define EQ2_lng(a, b)	_mm256_cmpeq_epi64(a, b)
+
+#define LOAD2_bte(p)	_mm256_loadu_si256((const __m256i *) (p))
+#define LOAD2_sht(p)	_mm256_loadu_si256((const __m256i *) (p))
+#define LOAD2_int(p)	_mm256_loadu_si256((const __m256i *) (p))
+#define LOAD2_lng(p)	_mm256_loadu_si256((const __m256i *) (p))
+#define LOAD2_flt(p)	_mm256_loadu_ps(p)
+#define LOAD2_dbl(p)	_mm256_loadu_pd(p)
+
+/* qualifying lanes of one vector for the integer types: there is
+ * only a signed greater-than, so we compute the rows that fail and
+ * invert */
+#define RANGE2_INT(TYPE, v)						\
+	(~MASK2_##TYPE(_mm256_or_si256(GT2_##TYPE(lo, v), GT2_##TYPE(v, hi))) & lanes)
+#define ANTI2_INT(TYPE, v)						\
+	(~MASK2_##TYPE(_mm256_or_si256(_mm256_and_si256(GT2_##TYPE(v, lo), \
+							GT2_##TYPE(hi, v)), \
+				       EQ2_##TYPE(v, nil))) & lanes)
+#define EQUI2_INT(TYPE, v)	MASK2_##TYPE(EQ2_##TYPE(v, lo))
+
+#define RANGE2_FLT(TYPE, CMP, AND, OR, v)				\
+	MASK2_##TYPE(AND(CMP(v, lo, _CMP_GE_OQ), CMP(v, hi, _CMP_LE_OQ)))
+#define ANTI2_FLT(TYPE, CMP, AND, OR, v)				\
+	MASK2_##TYPE(OR(CMP(v, lo, _CMP_LE_OQ), CMP(v, hi, _CMP_GE_OQ)))
+#define EQUI2_FLT(TYPE, CMP, AND, OR, v)				\
+	MASK2_##TYPE(CMP(v, lo, _CMP_EQ_OQ))
+
+/* 32 rows per block, i.e. sizeof(TYPE) vectors of 32/sizeof(TYPE)
+ * lanes; the resulting mask is turned into oids byte by byte */
+#define SIMDLOOP2(TYPE, TEST)						\
+	do {								\
+		for (; i + 32 <= n; i += 32) {				\
+			uint64_t m = 0;					\
+			int j;						\
+			for (j = 0; j < (int) sizeof(TYPE); j++) {	\
+				const TYPE *p = src + i + j * L;	\
+				m |= (uint64_t) (TEST) << (j * L);	\
+			}						\
+			for (j = 0; m; j += 8, m >>= 8)			\
+				if (m & 0xFF)				\
+					cnt += emit_avx2((unsigned int) (m & 0xFF), \
+							 o + i + j, dst + cnt); \
+		}							\
+	} while (0)
+
+#define AVX2_INT(TYPE)							\
+static __attribute__((__target__("avx2"))) BUN				\
+select_##TYPE##_avx2(const TYPE *restrict src, BUN n, TYPE vl, TYPE vh,	\
+		     int mode, oid o, oid *restrict dst)		\
+{									\
+	const int L = 32 / (int) sizeof(TYPE);				\
+	const uint64_t lanes = ((uint64_t) 1 << L) - 1;			\
+	const __m256i lo = SET2_##TYPE(vl);				\
+	const __m256i hi = SET2_##TYPE(vh);				\
+	const __m256i nil = SET2_##TYPE(TYPE##_nil);			\
+	BUN i = 0, cnt = 0;						\
+									\
+	(void) lanes;							\
+	(void) nil;							\
+	switch (mode) {							\
+	case SEL_RANGE:							\
+		SIMDLOOP2(TYPE, RANGE2_INT(TYPE, LOAD2_##TYPE(p)));	\
+		break;							\
+	case SEL_ANTI:							\
+		SIMDLOOP2(TYPE, ANTI2_INT(TYPE, LOAD2_##TYPE(p)));	\
+		break;							\
+	default:							\
+		SIMDLOOP2(TYPE, EQUI2_INT(TYPE, LOAD2_##TYPE(p)));	\
+		break;							\
+	}								\
+	SCALARLOOP(TYPE);						\
+	return cnt;							\
+}
+
+#define AVX2_FLT(TYPE, VT, CMP, AND, OR)				\
+static __attribute__((__target__("avx2"))) BUN				\
+select_##TYPE##_avx2(const TYPE *restrict src, BUN n, TYPE vl, TYPE vh,	\
+		     int mode, oid o, oid *restrict dst)		\
+{									\
+	const int L = 32 / (int) sizeof(TYPE);				\
+	const VT lo = SET2_##TYPE(vl);					\
+	const VT hi = SET2_##TYPE(vh);					\
+	const TYPE nil = TYPE##_nil;					\
+	BUN i = 0, cnt = 0;						\
+									\
+	(void) nil;							\
+	switch (mode) {							\
+	case SEL_RANGE:							\
+		SIMDLOOP2(TYPE, RANGE2_FLT(TYPE, CMP, AND, OR, LOAD2_##TYPE(p))); \
+		break;							\
+	case SEL_ANTI:							\
+		SIMDLOOP2(TYPE, ANTI2_FLT(TYPE, CMP, AND, OR, LOAD2_##TYPE(p))); \
+		break;							\
+	default:							\
+		SIMDLOOP2(TYPE, EQUI2_FLT(TYPE, CMP, AND, OR, LOAD2_##TYPE(p))); \
+		break;							\
+	}								\
+	SCALARLOOP(TYPE);						\
+	return cnt;							\
+}
+
+/* the remaining rows that do not fill a block */
+#define SCALARLOOP(TYPE)						\
+	do {								\
+		for (; i < n; i++) {					\
+			TYPE v = src[i];				\
+			dst[cnt] = o + i;				\
+			cnt += mode == SEL_RANGE ? v >= vl && v <= vh :	\
+				mode == SEL_ANTI ? (v <= vl || v >= vh) && !is_##TYPE##_nil(v) : \
+				v == vl;				\
+		}							\
+	} while (0)
+
+AVX2_INT(bte)
+AVX2_INT(sht)
+AVX2_INT(int)
+AVX2_INT(lng)
+AVX2_FLT(flt, __m256, _mm256_cmp_ps, _mm256_and_ps, _mm256_or_ps)
+AVX2_FLT(dbl, __m256d, _mm256_cmp_pd, _mm256_and_pd, _mm256_or_pd)
+
+/* AVX-512 */
+
+static inline __attribute__((__target__("avx512f"))) BUN
+emit_avx512(unsigned int m, oid o, oid *restrict dst)
+{
+	const __m512i pos = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+
+	_mm512_mask_compressstoreu_epi64(dst, (__mmask8) m,
+					 _mm512_add_epi64(_mm512_set1_epi64((long long) o), pos));
+	return (BUN) __builtin_popcount(m);
+}
+
+#define SET5_bte(v)	_mm512_set1_epi8(v)
+#define SET5_sht(v)	_mm512_set1_epi16(v)
+#define SET5_int(v)	_mm512_set1_epi32(v)
+#define SET5_lng(v)	_mm512_set1_epi64(v)
+#define SET5_flt(v)	_mm512_set1_ps(v)
+#define SET5_dbl(v)	_mm512_set1_pd(v)
+
+#define LOAD5_bte(p)	_mm512_loadu_si512((const void *) (p))
+#define LOAD5_sht(p)	_mm512_loadu_si512((const void *) (p))
+#define LOAD5_int(p)	_mm512_loadu_si512((const void *) (p))
+#define LOAD5_lng(p)	_mm512_loadu_si512((const void *) (p))
+#define LOAD5_flt(p)	_mm512_loadu_ps(p)
+#define LOAD5_dbl(p)	_mm512_loadu_pd(p)
+
+#define CMP5_bte(a, b, c)	_mm512_cmp_epi8_mask(a, b, c)
+#define CMP5_sht(a, b, c)	_mm512_cmp_epi16_mask(a, b, c)
+#define CMP5_int(a, b, c)	_mm512_cmp_epi32_mask(a, b, c)
+#define CMP5_lng(a, b, c)	_mm512_cmp_epi64_mask(a, b, c)
+#define CMP5_flt(a, b, c)	_mm512_cmp_ps_mask(a, b, c)
+#define CMP5_dbl(a, b, c)	_mm512_cmp_pd_mask(a, b, c)
+
+/* comparison predicates for the integer and floating point types;
+ * the latter need no explicit nil check */
+#define GE5_INT	_MM_CMPINT_NLT
+#define LE5_INT	_MM_CMPINT_LE
+#define EQ5_INT	_MM_CMPINT_EQ
+#define GE5_FLT	_CMP_GE_OQ
+#define LE5_FLT	_CMP_LE_OQ
+#define EQ5_FLT	_CMP_EQ_OQ
+#define NILCHECK5_INT(TYPE, v)	& CMP5_##TYPE(v, nil, _MM_CMPINT_NE)
+#define NILCHECK5_FLT(TYPE, v)
+
+#define RANGE5(TYPE, KIND, v)						\
+	(CMP5_##TYPE(v, lo, GE5_##KIND) & CMP5_##TYPE(v, hi, LE5_##KIND))
+#define ANTI5(TYPE, KIND, v)						\
+	((CMP5_##TYPE(v, lo, LE5_##KIND) | CMP5_##TYPE(v, hi, GE5_##KIND)) \
+	 NILCHECK5_##KIND(TYPE, v))
+#define EQUI5(TYPE, KIND, v)	CMP5_##TYPE(v, lo, EQ5_##KIND)
+
+/* 64 rows per block */
+#define SIMDLOOP5(TYPE, TEST)						\
+	do {								\
+		for (; i + 64 <= n; i += 64) {				\
+			uint64_t m = 0;					\
+			int j;						\
+			for (j = 0; j < (int) sizeof(TYPE); j++) {	\
+				const TYPE *p = src + i + j * L;	\
+				m |= (uint64_t) (TEST) << (j * L);	\
+			}						\
+			for (j = 0; m; j += 8, m >>= 8)			\
+				if (m & 0xFF)				\
+					cnt += emit_avx512((unsigned int) (m & 0xFF), \
+							   o + i + j, dst + cnt); \
+		}							\
+	} while (0)
+
+#define AVX512(TYPE, VT, KIND)						\
+static __attribute__((__target__("avx512f,avx512bw"))) BUN		\
+select_##TYPE##_avx512(const TYPE *restrict src, BUN n, TYPE vl, TYPE vh, \
+		       int mode, oid o, oid *restrict dst)		\
+{									\
+	const int L = 64 / (int) sizeof(TYPE);				\
+	const VT lo = SET5_##TYPE(vl);					\
+	const VT hi = SET5_##TYPE(vh);					\
+	const VT nil = SET5_##TYPE(TYPE##_nil);				\
+	BUN i = 0, cnt = 0;						\
+									\
+	(void) nil;							\
+	switch (mode) {							\
+	case SEL_RANGE:							\
+		SIMDLOOP5(TYPE, RANGE5(TYPE, KIND, LOAD5_##TYPE(p)));	\
+		break;							\
+	case SEL_ANTI:							\
+		SIMDLOOP5(TYPE, ANTI5(TYPE, KIND, LOAD5_##TYPE(p)));	\
+		break;							\
+	default:							\
+		SIMDLOOP5(TYPE, EQUI5(TYPE, KIND, LOAD5_##TYPE(p)));	\
+		break;							\
+	}								\
+	SCALARLOOP(TYPE);						\
+	return cnt;							\
+}
+
+AVX512(bte, __m512i, INT)
+AVX512(sht, __m512i, INT)
+AVX512(int, __m512i, INT)
+AVX512(lng, __m512i, INT)
+AVX512(flt, __m512, FLT)
+AVX512(dbl, __m512d, FLT)
+
+int
+BATselect_simd_ok(BAT *b)
+{
+	if (simd_level == SIMD_NONE)
+		return 0;
+	switch (ATOMbasetype(b->ttype)) {
+	case TYPE_bte:
+	case TYPE_sht:
+	case TYPE_int:
+	case TYPE_lng:
+	case TYPE_flt:
+	case TYPE_dbl:
+		return 1;
+	case TYPE_oid:
+		/* valid oids are below oid_nil, which has the bit
+		 * pattern of lng_nil, so signed comparisons work */
+		return SIZEOF_OID == SIZEOF_LNG;
+	default:
+		return 0;
+	}
+}
+
+#define SIMDCALL(TYPE)							\
+	(simd_level == SIMD_AVX512 ?					\
+	 select_##TYPE##_avx512((const TYPE *) src + p, n,		\
+				*(const TYPE *) tl, *(const TYPE *) th,	\
+				mode, o, dst + cnt) :			\
+	 select_##TYPE##_avx2((const TYPE *) src + p, n,		\
+			      *(const TYPE *) tl, *(const TYPE *) th,	\
+			      mode, o, dst + cnt))
+
+/* Select the rows in [p,q) of b that satisfy the (normalized)
+ * predicate, appending their oids to bn.  Returns the new count of
+ * bn, or BUN_NONE on allocation failure, in which case bn has been
+ * reclaimed (as in the scalar loops). */
+BUN
+BATselect_simd(BAT *b, BAT *bn, const void *tl, const void *th,
+	       int equi, int anti, BUN p, BUN q, BUN cnt, lng off)
+{
+	const void *src = Tloc(b, 0);
+	int mode = equi ? SEL_EQUI : anti ? SEL_ANTI : SEL_RANGE;
+	int t = ATOMbasetype(b->ttype);
+	BUN r = p, n, need;
+	oid o, *dst;
+
+	ALGODEBUG fprintf(stderr, "#BATselect(b=%s#"BUNFMT",anti=%d): "
+			  "%s %s select\n", BATgetId(b), BATcount(b), anti,
+			  simd_level == SIMD_AVX512 ? "avx512" : "avx2",
+			  equi ? "equi" : anti ? "anti" : "range");
+	if (t == TYPE_oid)
+		t = TYPE_lng;
+	while (p < q) {
+		n = MIN(q - p, SIMD_CHUNK);
+		need = cnt + n + SIMD_SLACK;
+		if (BATcapacity(bn) < need) {
+			/* extrapolate the selectivity so far */
+			BUN grow = (BUN) ((dbl) cnt / (dbl) (p == r ? 1 : p - r)
+					  * (dbl) (q - p) * 1.1) + n + SIMD_SLACK;
+			BATsetcount(bn, cnt);
+			if (BATextend(bn, MIN(cnt + grow, cnt + q - p + SIMD_SLACK)) != GDK_SUCCEED) {
+				BBPreclaim(bn);
+				return BUN_NONE;
+			}
+		}
+		dst = (oid *) Tloc(bn, 0);
+		o = (oid) ((lng) p + off);
+		switch (t) {
+		case TYPE_bte:
+			cnt += SIMDCALL(bte);
+			break;
+		case TYPE_sht:
+			cnt += SIMDCALL(sht);
+			break;
+		case TYPE_int:
+			cnt += SIMDCALL(int);
+			break;
+		case TYPE_lng:
+			cnt += SIMDCALL(lng);
+			break;
+		case TYPE_flt:
+			cnt += SIMDCALL(flt);
+			break;
+		case TYPE_dbl:
+			cnt += SIMDCALL(dbl);
+			break;
+		default:
+			assert(0);
+		}
+		p += n;
+	}
+	return cnt;
+}
+
+#endif /* GDK_SELECT_SIMD */
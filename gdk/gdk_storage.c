@@ -728,6 +728,91 @@ BATmsync(BAT *b)
 #endif	/* DISABLE_MSYNC */
 }
 
+/* The BATs to be prefaulted are queued and handled in order by a
+ * single worker thread, which is started when a BAT is queued and
+ * stops when the queue is empty.  The queue is bounded: prefaulting
+ * is only a hint, so when the worker cannot keep up, BATs are not
+ * queued. */
+#define PREFAULT_QUEUE	1024
+
+static MT_Lock prefaultLock MT_LOCK_INITIALIZER("prefaultLock");
+static bat prefaultQueue[PREFAULT_QUEUE];
+static int prefaultHead, prefaultCount;
+static bool prefaultRunning;
+
+static void
+BATprefaultWorker(void *arg)
+{
+	bat bid;
+	BAT *b;
+
+	(void) arg;
+	for (;;) {
+		MT_lock_set(&prefaultLock);
+		if (prefaultCount == 0) {
+			prefaultRunning = false;
+			MT_lock_unset(&prefaultLock);
+			return;
+		}
+		bid = prefaultQueue[prefaultHead];
+		prefaultHead = (prefaultHead + 1) % PREFAULT_QUEUE;
+		prefaultCount--;
+		MT_lock_unset(&prefaultLock);
+		/* the BAT was fixed when it was queued, so it is
+		 * still loaded */
+		if (!GDKexiting() && (b = BBP_cache(bid)) != NULL) {
+			HEAPprefault(&b->theap);
+			if (b->tvheap)
+				HEAPprefault(b->tvheap);
+		}
+		BBPunfix(bid);
+	}
+}
+
+/* Start faulting in the memory mapped heaps of the freshly loaded BAT
+ * B in the background. */
+void
+BATprefault(BAT *b)
+{
+	MT_Id tid;
+	bool start;
+
+	if (!GDK_prefault || isVIEW(b) || GDKexiting())
+		return;
+	if (b->theap.storage == STORE_MEM &&
+	    (b->tvheap == NULL || b->tvheap->storage == STORE_MEM))
+		return;
+	BBPfix(b->batCacheid);
+	MT_lock_set(&prefaultLock);
+	if (prefaultCount == PREFAULT_QUEUE) {
+		MT_lock_unset(&prefaultLock);
+		BBPunfix(b->batCacheid);
+		return;
+	}
+	prefaultQueue[(prefaultHead + prefaultCount) % PREFAULT_QUEUE] = b->batCacheid;
+	prefaultCount++;
+	start = !prefaultRunning;
+	prefaultRunning = true;
+	MT_lock_unset(&prefaultLock);
+	if (start &&
+	    MT_create_thread(&tid, BATprefaultWorker, NULL, MT_THR_DETACHED) < 0) {
+		/* don't bother if we can't create a thread: empty
+		 * the queue */
+		MT_lock_set(&prefaultLock);
+		while (prefaultCount > 0) {
+			bat bid = prefaultQueue[prefaultHead];
+
+			prefaultHead = (prefaultHead + 1) % PREFAULT_QUEUE;
+			prefaultCount--;
+			MT_lock_unset(&prefaultLock);
+			BBPunfix(bid);
+			MT_lock_set(&prefaultLock);
+		}
+		prefaultRunning = false;
+		MT_lock_unset(&prefaultLock);
+	}
+}
+
 gdk_return
 BATsave(BAT *bd)
 {
@@ -782,6 +867,11 @@ BATsave(BAT *bd)
 	if (err == GDK_SUCCEED) {
 		bd->batCopiedtodisk = 1;
 		DESCclean(bd);
+		if (BBP_status(bd->batCacheid) & BBPPERSISTENT) {
+			IMPSpersist(bd);
+			ZNMpersist(bd);
+			PCKpersist(bd);
+		}
 		return GDK_SUCCEED;
 	}
 	return err;
@@ -874,6 +964,8 @@ BATdelete(BAT *b)
 		b = loaded;
 		HASHdestroy(b);
 		IMPSdestroy(b);
+		ZNMdestroy(b);
+		PCKdestroy(b);
 		OIDXdestroy(b);
 	}
 	if (b->batCopiedtodisk || (b->theap.storage != STORE_MEM)) {
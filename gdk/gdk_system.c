@@ -771,3 +771,74 @@ MT_check_nr_cores(void)
 
 	return ncpus;
 }
+
+/*
+ * NUMA topology support is restricted to Linux, where the nodes and
+ * their cores are described under /sys/devices/system/node. On other
+ * systems there is a single node and binding is a no-op.
+ */
+#define NUMA_SYSFS	"/sys/devices/system/node"
+
+int
+MT_numa_nodes(void)
+{
+	static int nnodes = 0;
+#ifdef HAVE_SCHED_SETAFFINITY
+	char path[64];
+	int n;
+
+	if (nnodes > 0)
+		return nnodes;
+	for (n = 0; n < 1024; n++) {
+		snprintf(path, sizeof(path), NUMA_SYSFS "/node%d", n);
+		if (access(path, F_OK) < 0)
+			break;
+	}
+	nnodes = n > 0 ? n : 1;
+#else
+	nnodes = 1;
+#endif
+	return nnodes;
+}
+
+/* restrict the calling thread to the cores of the given node */
+int
+MT_numa_bind(int node)
+{
+#ifdef HAVE_SCHED_SETAFFINITY
+	char path[64], buf[1024], *s, *e;
+	FILE *f;
+	cpu_set_t set;
+	long lo, hi;
+	int ncpus = 0;
+
+	if (node < 0 || node >= MT_numa_nodes())
+		return -1;
+	snprintf(path, sizeof(path), NUMA_SYSFS "/node%d/cpulist", node);
+	if ((f = fopen(path, "r")) == NULL)
+		return -1;
+	s = fgets(buf, (int) sizeof(buf), f);
+	fclose(f);
+	if (s == NULL)
+		return -1;
+	/* the list looks like "0-7,16-23" */
+	CPU_ZERO(&set);
+	while (*s) {
+		lo = strtol(s, &e, 10);
+		if (e == s)
+			break;
+		hi = lo;
+		if (*e == '-')
+			hi = strtol(e + 1, &e, 10);
+		for (; lo <= hi && lo < CPU_SETSIZE; lo++, ncpus++)
+			CPU_SET((int) lo, &set);
+		s = *e == ',' ? e + 1 : e;
+	}
+	if (ncpus == 0)
+		return -1;
+	return sched_setaffinity(0, sizeof(set), &set) < 0 ? -1 : 0;
+#else
+	(void) node;
+	return 0;
+#endif
+}
@@ -335,5 +335,7 @@ typedef struct {
 	} while (0)
 
 gdk_export int MT_check_nr_cores(void);
+gdk_export int MT_numa_nodes(void);
+gdk_export int MT_numa_bind(int node);
 
 #endif /*_GDK_SYSTEM_H_*/
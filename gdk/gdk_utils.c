@@ -279,6 +279,9 @@ BATSIGinit(void)
 size_t GDK_mmap_minsize_persistent = MMAP_MINSIZE_PERSISTENT;
 size_t GDK_mmap_minsize_transient = MMAP_MINSIZE_TRANSIENT;
 size_t GDK_mmap_pagesize = MMAP_PAGESIZE; /* mmap granularity */
+size_t GDK_heapcache_maxsize = 0; /* set in GDKinit() */
+int GDK_hugepages = 0;
+int GDK_prefault = 0;
 size_t GDK_mem_maxsize = GDK_VM_MAXSIZE;
 size_t GDK_vm_maxsize = GDK_VM_MAXSIZE;
 
@@ -435,6 +438,7 @@ GDKinit(opt *set, int setlen)
 	int i, nlen = 0;
 	int farmid;
 	char buf[16];
+	bool heapcache_set = false;
 
 	/* some sanity checks (should also find if symbols are not defined) */
 	assert(sizeof(char) == SIZEOF_CHAR);
@@ -493,6 +497,9 @@ GDKinit(opt *set, int setlen)
 #endif
 #endif
 	MT_init();
+#ifdef GDK_SELECT_SIMD
+	SIMDinit();
+#endif
 	BBPdirty(1);
 
 	/* now try to lock the database: go through all farms, and if
@@ -522,7 +529,6 @@ GDKinit(opt *set, int setlen)
 		if (GDK_mmap_minsize_persistent > GDK_mmap_minsize_transient)
 			GDK_mmap_minsize_persistent = GDK_mmap_minsize_transient;
 	}
-
 	n = (opt *) malloc(setlen * sizeof(opt));
 	if (n == NULL)
 		GDKfatal("GDKinit: malloc failed\n");
@@ -560,6 +566,9 @@ GDKinit(opt *set, int setlen)
 			GDK_mmap_minsize_persistent = (size_t) strtoll(n[i].value, NULL, 10);
 		} else if (strcmp("gdk_mmap_minsize_transient", n[i].name) == 0) {
 			GDK_mmap_minsize_transient = (size_t) strtoll(n[i].value, NULL, 10);
+		} else if (strcmp("gdk_heapcache_maxsize", n[i].name) == 0) {
+			GDK_heapcache_maxsize = (size_t) strtoll(n[i].value, NULL, 10);
+			heapcache_set = true;
 		} else if (strcmp("gdk_mmap_pagesize", n[i].name) == 0) {
 			GDK_mmap_pagesize = (size_t) strtoll(n[i].value, NULL, 10);
 			if (GDK_mmap_pagesize < 1 << 12 ||
@@ -571,6 +580,8 @@ GDKinit(opt *set, int setlen)
 				GDKfatal("GDKinit: gdk_mmap_pagesize must be power of 2 between 2**12 and 2**20\n");
 		}
 	}
+	if (!heapcache_set)
+		GDK_heapcache_maxsize = GDK_mem_maxsize / 32;
 
 	GDKkey = COLnew(0, TYPE_str, 100, TRANSIENT);
 	GDKval = COLnew(0, TYPE_str, 100, TRANSIENT);
@@ -591,6 +602,8 @@ GDKinit(opt *set, int setlen)
 	GDKnr_threads = GDKgetenv_int("gdk_nr_threads", 0);
 	if (GDKnr_threads == 0)
 		GDKnr_threads = MT_check_nr_cores();
+	GDK_hugepages = GDKgetenv_istrue("gdk_hugepages") || GDKgetenv_isyes("gdk_hugepages");
+	GDK_prefault = GDKgetenv_istrue("gdk_prefault") || GDKgetenv_isyes("gdk_prefault");
 
 	if ((p = GDKgetenv("gdk_dbpath")) != NULL &&
 	    (p = strrchr(p, DIR_SEP)) != NULL) {
@@ -623,6 +636,11 @@ GDKinit(opt *set, int setlen)
 		if (GDKsetenv("gdk_mmap_minsize_transient", buf) != GDK_SUCCEED)
 			GDKfatal("GDKinit: GDKsetenv failed");
 	}
+	if (GDKgetenv("gdk_heapcache_maxsize") == NULL) {
+		snprintf(buf, sizeof(buf), "%zu", GDK_heapcache_maxsize);
+		if (GDKsetenv("gdk_heapcache_maxsize", buf) != GDK_SUCCEED)
+			GDKfatal("GDKinit: GDKsetenv failed");
+	}
 	if (GDKgetenv("gdk_mmap_pagesize") == NULL) {
 		snprintf(buf, sizeof(buf), "%zu", GDK_mmap_pagesize);
 		if (GDKsetenv("gdk_mmap_pagesize", buf) != GDK_SUCCEED)
@@ -750,6 +768,7 @@ GDKreset(int status, int exit)
 			/* we can't clean up after killing threads */
 			BBPexit();
 		}
+		HEAPcacheflush();
 		GDKlog(GET_GDKLOCK(0), GDKLOGOFF);
 
 		for (farmid = 0; farmid < MAXFARMS; farmid++) {
@@ -775,6 +794,9 @@ GDKreset(int status, int exit)
 		GDK_mmap_minsize_persistent = MMAP_MINSIZE_PERSISTENT;
 		GDK_mmap_minsize_transient = MMAP_MINSIZE_TRANSIENT;
 		GDK_mmap_pagesize = MMAP_PAGESIZE;
+		GDK_heapcache_maxsize = 0;
+		GDK_hugepages = 0;
+		GDK_prefault = 0;
 		GDK_mem_maxsize = (size_t) ((double) MT_npages() * (double) MT_pagesize() * 0.815);
 		GDK_vm_maxsize = GDK_VM_MAXSIZE;
 		GDKatomcnt = TYPE_str + 1;
@@ -1773,6 +1795,14 @@ GDKfree(void *s)
 	heapdec((ssize_t) asize);
 }
 
+/* return the usable size of an area allocated by GDKmalloc and
+ * friends */
+size_t
+GDKmallocated(const void *s)
+{
+	return ((const size_t *) s)[-1] - MALLOC_EXTRA_SPACE - DEBUG_SPACE;
+}
+
 #undef GDKrealloc
 void *
 GDKrealloc(void *s, size_t size)
@@ -1901,6 +1931,14 @@ GDKstrndup(const char *s, size_t size)
 	return p;
 }
 
+size_t
+GDKmallocated(const void *s)
+{
+	/* unknown */
+	(void) s;
+	return 0;
+}
+
 #endif	/* STATIC_CODE_ANALYSIS */
 
 void
@@ -0,0 +1,473 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright 1997 - July 2008 CWI, August 2008 - 2018 MonetDB B.V.
+ */
+
+/*
+ * Zone maps.
+ *
+ * A zone map records for each block ("zone") of ZONEMAP_SIZE
+ * consecutive values of a column the smallest and the largest non-nil
+ * value in the zone, and the number of nils in it.  Selections use the
+ * zone map to skip the zones that cannot contain qualifying values.
+ *
+ * Zone maps are created for persistent columns of the fixed-size
+ * numerical types (and types derived from them) with at least
+ * ZONEMAP_MIN values.  They are extended when values are appended to
+ * the column, and saved together with the column.
+ *
+ * The heap starts with ZONEMAP_HEADER size_t values: version number
+ * and flags, the number of zones, and the number of values described.
+ * The zones follow, each consisting of the minimum, the maximum (both
+ * nil if there are only nils in the zone) and the nil count.
+ */
+
+#include "monetdb_config.h"
+#include "gdk.h"
+#include "gdk_private.h"
+
+#define ZONEMAP_VERSION		((size_t) 1)
+#define ZONEMAP_SYNCED		((size_t) 1 << 24)
+#define ZONEMAP_HEADER		3	/* nr of size_t fields in header */
+
+#define ZONEMAP_MASK		(ZONEMAP_SIZE - 1)
+
+/* offset of the nil count in a zone: after min and max */
+static inline size_t
+zonenils(int width)
+{
+	return ((size_t) 2 * width + SIZEOF_BUN - 1) & ~((size_t) SIZEOF_BUN - 1);
+}
+
+/* size of a zone, a multiple of the alignment of all its parts */
+static inline size_t
+zonesize(int width)
+{
+	size_t align = (size_t) width > SIZEOF_BUN ? (size_t) width : SIZEOF_BUN;
+
+	return (zonenils(width) + SIZEOF_BUN + align - 1) & ~(align - 1);
+}
+
+#define ZONE(hp, zsz, z)						\
+	((hp)->base + ZONEMAP_HEADER * SIZEOF_SIZE_T + (size_t) (z) * (zsz))
+#define ZONESIZE(b, nzones)						\
+	(ZONEMAP_HEADER * SIZEOF_SIZE_T + (size_t) (nzones) * zonesize((b)->twidth))
+#define NZONES(cnt)	(((cnt) + ZONEMAP_SIZE - 1) >> ZONEMAP_SHIFT)
+
+/* the types we can make zone maps for */
+static bool
+zonemap_type(const BAT *b)
+{
+	if (ATOMtype(b->ttype) == TYPE_oid)
+		return false;
+	switch (ATOMbasetype(b->ttype)) {
+	case TYPE_bte:
+	case TYPE_sht:
+	case TYPE_int:
+	case TYPE_lng:
+#ifdef HAVE_HGE
+	case TYPE_hge:
+#endif
+	case TYPE_flt:
+	case TYPE_dbl:
+		return true;
+	default:
+		return false;
+	}
+}
+
+#define ZONE_FILL(TYPE)							\
+	do {								\
+		const TYPE *restrict vals = (const TYPE *) Tloc(b, 0);	\
+		for (z = start >> ZONEMAP_SHIFT; z < nzones; z++) {	\
+			char *zp = ZONE(hp, zsz, z);			\
+			BUN i = z << ZONEMAP_SHIFT;			\
+			BUN e = MIN(i + ZONEMAP_SIZE, cnt);		\
+			BUN nils;					\
+			TYPE mn, mx;					\
+									\
+			if (i < start) {				\
+				/* continue the last zone */		\
+				mn = ((TYPE *) zp)[0];			\
+				mx = ((TYPE *) zp)[1];			\
+				nils = *(BUN *) (zp + nilsoff);		\
+				i = start;				\
+			} else {					\
+				mn = mx = TYPE##_nil;			\
+				nils = 0;				\
+			}						\
+			for (; i < e; i++) {				\
+				const TYPE v = vals[i];			\
+				if (is_##TYPE##_nil(v))			\
+					nils++;				\
+				else if (is_##TYPE##_nil(mn))		\
+					mn = mx = v;			\
+				else if (v < mn)			\
+					mn = v;				\
+				else if (v > mx)			\
+					mx = v;				\
+			}						\
+			((TYPE *) zp)[0] = mn;				\
+			((TYPE *) zp)[1] = mx;				\
+			*(BUN *) (zp + nilsoff) = nils;			\
+		}							\
+	} while (0)
+
+/* fill in the zones of hp for the values of b from start onward;
+ * values before start are already accounted for */
+static void
+zonemap_fill(BAT *b, Heap *hp, BUN start)
+{
+	BUN z, cnt = BATcount(b), nzones = NZONES(cnt);
+	size_t zsz = zonesize(b->twidth), nilsoff = zonenils(b->twidth);
+
+	switch (ATOMbasetype(b->ttype)) {
+	case TYPE_bte:
+		ZONE_FILL(bte);
+		break;
+	case TYPE_sht:
+		ZONE_FILL(sht);
+		break;
+	case TYPE_int:
+		ZONE_FILL(int);
+		break;
+	case TYPE_lng:
+		ZONE_FILL(lng);
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		ZONE_FILL(hge);
+		break;
+#endif
+	case TYPE_flt:
+		ZONE_FILL(flt);
+		break;
+	case TYPE_dbl:
+		ZONE_FILL(dbl);
+		break;
+	default:
+		assert(0);
+	}
+	((size_t *) hp->base)[1] = (size_t) nzones;
+	((size_t *) hp->base)[2] = (size_t) cnt;
+	hp->free = ZONESIZE(b, nzones);
+	hp->dirty = 1;
+}
+
+/* write the zone map to disk and mark it as usable there; must be
+ * called with the lock held */
+static void
+zonemap_persist(BAT *b, Heap *hp)
+{
+	lng t0 = 0;
+
+	ALGODEBUG t0 = GDKusec();
+	if (HEAPsaveaux(hp, b, "tzonemap", ZONEMAP_SYNCED) != GDK_SUCCEED) {
+		GDKclrerr();	/* not persisting is not an error */
+		return;
+	}
+	ALGODEBUG fprintf(stderr, "#BATzonemap: persisting zonemap %d (" LLFMT " usec)\n", b->batCacheid, GDKusec() - t0);
+}
+
+/* the size of the persisted zone map with header hdr if it describes
+ * the first cnt values of b, or 0 */
+static size_t
+zonemap_check(const BAT *b, BUN cnt, const size_t *hdr)
+{
+	if (hdr[0] != (ZONEMAP_SYNCED | ZONEMAP_VERSION) ||
+	    hdr[2] != (size_t) cnt ||
+	    hdr[1] != (size_t) NZONES(cnt))
+		return 0;
+	return ZONESIZE(b, hdr[1]);
+}
+
+/* Load the persisted zone map of b if it describes the first cnt
+ * values; must be called with the lock held and b->tzonemap ==
+ * (Heap *) 1. */
+static void
+zonemap_load(BAT *b, BUN cnt)
+{
+	Heap *hp;
+
+	b->tzonemap = NULL;
+	if ((hp = GDKzalloc(sizeof(*hp))) != NULL &&
+	    (hp->farmid = BBPselectfarm(b->batRole, b->ttype, zonemapheap)) >= 0 &&
+	    HEAPloadaux(hp, b, cnt, "tzonemap", ZONEMAP_HEADER, zonemap_check) == GDK_SUCCEED) {
+		b->tzonemap = hp;
+		ALGODEBUG fprintf(stderr, "#BATcheckzonemap: reusing persisted zonemap %d\n", b->batCacheid);
+		return;
+	}
+	GDKfree(hp);
+	GDKclrerr();	/* we're not currently interested in errors */
+}
+
+/* Return true if we have a zone map on b, even if we need to read it
+ * from disk.  b->tzonemap is NULL if there is no zone map, (Heap *) 1
+ * if there may be one on disk, or the loaded zone map. */
+bool
+BATcheckzonemap(BAT *b)
+{
+	bool ret;
+
+	if (b == NULL)
+		return false;
+	assert(b->batCacheid > 0);
+	MT_lock_set(&GDKhashLock(b->batCacheid));
+	if (b->tzonemap == (Heap *) 1)
+		zonemap_load(b, BATcount(b));
+	ret = b->tzonemap != NULL;
+	MT_lock_unset(&GDKhashLock(b->batCacheid));
+	return ret;
+}
+
+/* Create a zone map for b (or for its parent if b is a view).  Columns
+ * of a type without zone maps, or too small to need one, are left
+ * alone. */
+gdk_return
+BATzonemap(BAT *b)
+{
+	Heap *hp;
+	lng t0 = 0;
+
+	if (VIEWtparent(b))
+		b = BBPdescriptor(VIEWtparent(b));
+	if (!zonemap_type(b) || BATcount(b) < ZONEMAP_MIN)
+		return GDK_SUCCEED;
+	if (BATcheckzonemap(b))
+		return GDK_SUCCEED;
+	MT_lock_set(&GDKhashLock(b->batCacheid));
+	if (b->tzonemap == NULL) {
+		ALGODEBUG t0 = GDKusec();
+		if ((hp = GDKzalloc(sizeof(Heap))) == NULL ||
+		    (hp->farmid = BBPselectfarm(b->batRole, b->ttype, zonemapheap)) < 0 ||
+		    snprintf(hp->filename, sizeof(hp->filename), "%s.tzonemap", BBP_physical(b->batCacheid)) < 0 ||
+		    HEAPalloc(hp, ZONESIZE(b, NZONES(BATcount(b))), 1) != GDK_SUCCEED) {
+			MT_lock_unset(&GDKhashLock(b->batCacheid));
+			GDKfree(hp);
+			return GDK_FAIL;
+		}
+		((size_t *) hp->base)[0] = ZONEMAP_VERSION;
+		zonemap_fill(b, hp, 0);
+		b->tzonemap = hp;
+		ALGODEBUG fprintf(stderr, "#BATzonemap(%s#" BUNFMT "): " BUNFMT " zones in " LLFMT " usec\n", BATgetId(b), BATcount(b), (BUN) ((size_t *) hp->base)[1], GDKusec() - t0);
+		if (BBP_status(b->batCacheid) & BBPEXISTING)
+			zonemap_persist(b, hp);
+	}
+	MT_lock_unset(&GDKhashLock(b->batCacheid));
+	return GDK_SUCCEED;
+}
+
+/* Extend the zone map of b, which describes the first start values of
+ * b, with the values that were appended after those. */
+void
+ZNMappend(BAT *b, BUN start)
+{
+	Heap *hp;
+	size_t need;
+
+	if (b == NULL || b->tzonemap == NULL)
+		return;
+	assert(!VIEWtparent(b));
+	MT_lock_set(&GDKhashLock(b->batCacheid));
+	if (b->tzonemap == (Heap *) 1)
+		zonemap_load(b, start);
+	if ((hp = b->tzonemap) == NULL) {
+		MT_lock_unset(&GDKhashLock(b->batCacheid));
+		return;
+	}
+	if (((size_t *) hp->base)[2] != (size_t) start)
+		goto bailout;
+	/* the persisted zone map will not describe b anymore */
+	if (HEAPunsyncaux(hp, b, "tzonemap", ZONEMAP_SYNCED) != GDK_SUCCEED)
+		goto bailout;
+	need = ZONESIZE(b, NZONES(BATcount(b)));
+	if (need > hp->size &&
+	    HEAPextend(hp, MAX(need, hp->size + hp->size / 2), 0) != GDK_SUCCEED)
+		goto bailout;
+	zonemap_fill(b, hp, start);
+	MT_lock_unset(&GDKhashLock(b->batCacheid));
+	return;
+
+  bailout:
+	MT_lock_unset(&GDKhashLock(b->batCacheid));
+	GDKclrerr();	/* not maintaining the zone map is not an error */
+	ZNMdestroy(b);
+}
+
+/* Called when the persistent BAT b is saved: create the zone map if
+ * there isn't one yet, and write it to disk if it changed. */
+void
+ZNMpersist(BAT *b)
+{
+	Heap *hp;
+
+	if (VIEWtparent(b) || !zonemap_type(b) || BATcount(b) < ZONEMAP_MIN)
+		return;
+	if (b->tzonemap == NULL) {
+		if (BATzonemap(b) != GDK_SUCCEED) {
+			GDKclrerr();
+			return;
+		}
+	}
+	MT_lock_set(&GDKhashLock(b->batCacheid));
+	if ((hp = b->tzonemap) != NULL && hp != (Heap *) 1 &&
+	    !(((size_t *) hp->base)[0] & ZONEMAP_SYNCED) &&
+	    ((size_t *) hp->base)[2] == (size_t) BATcount(b))
+		zonemap_persist(b, hp);
+	MT_lock_unset(&GDKhashLock(b->batCacheid));
+}
+
+#define ZONE_SELECT(TYPE)						\
+	do {								\
+		const TYPE vl = *(const TYPE *) tl;			\
+		const TYPE vh = *(const TYPE *) th;			\
+		for (z = zf; z <= zl; z++) {				\
+			const char *zp = ZONE(hp, zsz, z);		\
+			const TYPE mn = ((const TYPE *) zp)[0];		\
+			const TYPE mx = ((const TYPE *) zp)[1];		\
+			const BUN nils = *(const BUN *) (zp + nilsoff);	\
+			bool q;						\
+									\
+			if (equi && lnil)				\
+				q = nils > 0;				\
+			else if (is_##TYPE##_nil(mn))			\
+				q = false; /* only nils */		\
+			else if (anti)					\
+				q = (li ? mn < vl : mn <= vl) ||	\
+					(hi ? mx > vh : mx >= vh);	\
+			else						\
+				q = (!lval || (li ? mx >= vl : mx > vl)) && \
+					(!hval || (hi ? mn <= vh : mn < vh)); \
+			if (q) {					\
+				BUN lo = z << ZONEMAP_SHIFT;		\
+				BUN up = lo + ZONEMAP_SIZE;		\
+				lo = lo < off ? 0 : lo - off;		\
+				up = MIN(up - off, cnt);		\
+				if (nruns > 0 &&			\
+				    (runs[2 * nruns - 1] == lo ||	\
+				     nruns == maxruns))			\
+					runs[2 * nruns - 1] = up;	\
+				else {					\
+					runs[2 * nruns] = lo;		\
+					runs[2 * nruns + 1] = up;	\
+					nruns++;			\
+				}					\
+			}						\
+		}							\
+	} while (0)
+
+/* Find the ranges of positions in b that can contain values that
+ * qualify for the selection described by the (normalized) arguments
+ * (see BATselect).  The ranges are stored as [start,end) pairs in
+ * runs; if there would be more than maxruns ranges, the last range
+ * also covers the rest.  Returns the number of ranges, or BUN_NONE if
+ * there is no zone map for b or its parent.  The zone map is not
+ * created here but when the column is saved or analyzed, so that a
+ * query never waits for it to be built and written.  The zones are
+ * read with the lock held, since ZNMappend may move the heap. */
+BUN
+ZNMselect(BAT *b, const void *tl, const void *th, int li, int hi,
+	  int equi, int anti, int lval, int hval, int lnil,
+	  BUN *runs, BUN maxruns)
+{
+	BAT *pb = b;
+	BUN off = 0, cnt = BATcount(b), nruns = 0, z, zf, zl;
+	Heap *hp;
+	size_t zsz, nilsoff;
+
+	if (VIEWtparent(b)) {
+		pb = BBPdescriptor(VIEWtparent(b));
+		off = (BUN) ((Tloc(b, 0) - Tloc(pb, 0)) >> b->tshift);
+	}
+	if (BATcount(pb) < ZONEMAP_MIN || !zonemap_type(pb) ||
+	    pb->ttype != b->ttype || cnt == 0)
+		return BUN_NONE;
+	if (!BATcheckzonemap(pb))
+		return BUN_NONE;
+	MT_lock_set(&GDKhashLock(pb->batCacheid));
+	hp = pb->tzonemap;
+	if (hp == NULL || hp == (Heap *) 1 ||
+	    ((size_t *) hp->base)[2] != (size_t) BATcount(pb) ||
+	    off + cnt > BATcount(pb)) {
+		MT_lock_unset(&GDKhashLock(pb->batCacheid));
+		return BUN_NONE;
+	}
+	zsz = zonesize(b->twidth);
+	nilsoff = zonenils(b->twidth);
+	zf = off >> ZONEMAP_SHIFT;
+	zl = (off + cnt - 1) >> ZONEMAP_SHIFT;
+
+	switch (ATOMbasetype(b->ttype)) {
+	case TYPE_bte:
+		ZONE_SELECT(bte);
+		break;
+	case TYPE_sht:
+		ZONE_SELECT(sht);
+		break;
+	case TYPE_int:
+		ZONE_SELECT(int);
+		break;
+	case TYPE_lng:
+		ZONE_SELECT(lng);
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		ZONE_SELECT(hge);
+		break;
+#endif
+	case TYPE_flt:
+		ZONE_SELECT(flt);
+		break;
+	case TYPE_dbl:
+		ZONE_SELECT(dbl);
+		break;
+	default:
+		assert(0);
+		nruns = BUN_NONE;
+		break;
+	}
+	MT_lock_unset(&GDKhashLock(pb->batCacheid));
+	return nruns;
+}
+
+/* free the memory of the zone map, but keep it on disk */
+void
+ZNMfree(BAT *b)
+{
+	if (b) {
+		Heap *hp;
+
+		MT_lock_set(&GDKhashLock(b->batCacheid));
+		if ((hp = b->tzonemap) != NULL && hp != (Heap *) 1) {
+			b->tzonemap = (Heap *) 1;
+			HEAPfree(hp, 0);
+			GDKfree(hp);
+		}
+		MT_lock_unset(&GDKhashLock(b->batCacheid));
+	}
+}
+
+void
+ZNMdestroy(BAT *b)
+{
+	if (b) {
+		Heap *hp;
+
+		MT_lock_set(&GDKhashLock(b->batCacheid));
+		hp = b->tzonemap;
+		b->tzonemap = NULL;
+		MT_lock_unset(&GDKhashLock(b->batCacheid));
+		if (hp == (Heap *) 1) {
+			GDKunlink(BBPselectfarm(b->batRole, b->ttype, zonemapheap),
+				  BATDIR,
+				  BBP_physical(b->batCacheid),
+				  "tzonemap");
+		} else if (hp != NULL) {
+			HEAPdelete(hp, BBP_physical(b->batCacheid), "tzonemap");
+			GDKfree(hp);
+		}
+	}
+}
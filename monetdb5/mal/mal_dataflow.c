@@ -24,6 +24,22 @@
  *
  * The flow graphs should be organized such that parallel threads can
  * access it mostly without expensive locking.
+ *
+ * By default all workers take their instructions from a single shared
+ * queue. With many cores this queue lock becomes a hot spot. Setting
+ * dataflow_stealing=yes at startup gives each worker its own queue.
+ * Instructions enabled by a finished instruction are pushed onto the
+ * queue of the worker that executed it, where they are picked up LIFO.
+ * An idle worker first tries the shared queue and then steals the
+ * oldest instruction from the queue of another worker.
+ *
+ * On multi-socket machines dataflow_numa=yes additionally pins the
+ * workers round-robin to the NUMA nodes (dataflow_numa=<n> pretends
+ * there are n nodes, folded onto the real ones). The slices produced by the
+ * mitosis optimizer are handed to a worker on the node derived from
+ * the slice number, such that the same slice of a column is always
+ * scanned (and its intermediates first touched) on the same node.
+ * Stealing prefers victims on the same node.
  */
 #include "monetdb_config.h"
 #include "mal_dataflow.h"
@@ -48,6 +64,8 @@ typedef struct FLOWEVENT {
 	lng hotclaim;   /* memory foot print of result variables */
 	lng argclaim;   /* memory foot print of arguments */
 	lng maxclaim;   /* memory foot print of  largest argument, counld be used to indicate result size */
+	int worker;     /* worker that executed the instruction */
+	int node;       /* preferred NUMA node, -1 for any */
 } *FlowEvent, FlowEventRec;
 
 typedef struct queue {
@@ -82,9 +100,19 @@ static struct worker {
 	enum {IDLE, RUNNING, JOINING, EXITED} flag;
 	Client cntxt;				/* client we do work for (NULL -> any) */
 	MT_Sema s;
+	Queue *local;				/* private queue for work stealing */
+	int node;					/* NUMA node the worker is bound to */
+	lng localpops;				/* instructions taken from local queue */
+	lng globalpops;				/* instructions taken from todo queue */
+	lng steals;					/* instructions taken from other workers */
 } workers[THREADS];
 
 static Queue *todo = 0;	/* pending instructions */
+static int stealing = 0;	/* use per worker queues */
+static int nworkers = 0;	/* highest worker slot in use + 1 */
+static int numanodes = 0;	/* bind workers to NUMA nodes if > 1 */
+static int numanext = 0;	/* round-robin over workers of a node */
+static str sqlName, bindName, bindidxName, tidName;	/* sliced binds */
 
 #ifdef ATOMIC_LOCK
 static MT_Lock exitingLock MT_LOCK_INITIALIZER("exitingLock");
@@ -92,10 +120,17 @@ static MT_Lock exitingLock MT_LOCK_INITIALIZER("exitingLock");
 static volatile ATOMIC_TYPE exiting = 0;
 static MT_Lock dataflowLock MT_LOCK_INITIALIZER("dataflowLock");
 
+static void q_destroy(Queue *q);
+
 void
 mal_dataflow_reset(void)
 {
+	int i;
+
 	stopMALdataflow();
+	for (i = 0; i < THREADS; i++)
+		if (workers[i].local)
+			q_destroy(workers[i].local);
 	memset((char*) workers, 0,  sizeof(workers));
 	if( todo) {
 		GDKfree(todo->data);
@@ -104,6 +139,10 @@ mal_dataflow_reset(void)
 		GDKfree(todo);
 	}
 	todo = 0;	/* pending instructions */
+	stealing = 0;
+	nworkers = 0;
+	numanodes = 0;
+	numanext = 0;
 	exiting = 0;
 }
 
@@ -299,6 +338,186 @@ q_dequeue(Queue *q, Client cntxt)
 	return r;
 }
 
+/*
+ * The work stealing scheduler keeps one semaphore for all queues,
+ * i.e. the one of the todo queue. It counts the instructions
+ * available in any of them. Pushing onto a local queue therefore
+ * signals the todo semaphore.
+ */
+static void
+q_push(Queue *q, FlowEvent d)
+{
+	assert(q);
+	assert(d);
+	MT_lock_set(&q->l);
+	q_enqueue_(q, d);
+	MT_lock_unset(&q->l);
+	MT_sema_up(&todo->s);
+}
+
+/* take an instruction from either end of the queue without waiting */
+static FlowEvent
+q_take(Queue *q, Client cntxt, int oldest)
+{
+	FlowEvent r = NULL;
+	int i, j;
+
+	if (q == NULL || q->last == 0)
+		return NULL;
+	MT_lock_set(&q->l);
+	if (q->last == 0) {
+		MT_lock_unset(&q->l);
+		return NULL;
+	}
+	if (cntxt) {
+		/* oldest instruction of this client */
+		for (j = -1, i = q->last - 1; i >= 0; i--)
+			if (q->data[i]->flow->cntxt == cntxt &&
+				(j < 0 || q->data[i]->pc < q->data[j]->pc))
+				j = i;
+		if (j < 0) {
+			MT_lock_unset(&q->l);
+			return NULL;
+		}
+	} else if (oldest)
+		j = 0;
+	else
+		j = q->last - 1;
+	r = q->data[j];
+	q->last--;
+	for (i = j; i < q->last; i++)
+		q->data[i] = q->data[i + 1];
+	q->data[q->last] = 0;
+	MT_lock_unset(&q->l);
+	return r;
+}
+
+/*
+ * Work stealing variant of q_dequeue. A worker prefers its own queue
+ * (most recently enabled instruction first), then the shared todo
+ * queue and finally it steals the oldest instruction from a victim,
+ * starting with its right neighbour. With NUMA binding, victims on
+ * the worker's own node are tried first.
+ */
+static FlowEvent
+q_steal(struct worker *t, Client cntxt)
+{
+	FlowEvent r = NULL;
+	int id = (int) (t - workers);
+	int i, j, n, pass;
+
+	MT_sema_down(&todo->s);
+	if (ATOMIC_GET(exiting, exitingLock))
+		return NULL;
+	if (cntxt == NULL) {
+		MT_lock_set(&todo->l);
+		if (todo->exitcount > 0) {
+			todo->exitcount--;
+			MT_lock_unset(&todo->l);
+			return NULL;
+		}
+		MT_lock_unset(&todo->l);
+	}
+	for (;;) {
+		if ((r = q_take(t->local, cntxt, 0)) != NULL) {
+			t->localpops++;
+			return r;
+		}
+		if ((r = q_take(todo, cntxt, 0)) != NULL) {
+			t->globalpops++;
+			return r;
+		}
+		n = nworkers;
+		for (pass = numanodes > 1 ? 0 : 1; pass < 2; pass++)
+			for (i = 1; i < n; i++) {
+				j = (id + i) % n;
+				if (pass == 0 && workers[j].node != t->node)
+					continue;
+				if ((r = q_take(workers[j].local, cntxt, 1)) != NULL) {
+					t->steals++;
+					return r;
+				}
+			}
+		/* a client specific worker may find nothing of interest */
+		if (cntxt)
+			return NULL;
+		/* the signal and the instruction may briefly be out of
+		 * step while a client specific worker compensates */
+		if (ATOMIC_GET(exiting, exitingLock))
+			return NULL;
+		MT_sleep_ms(1);
+	}
+}
+
+static FlowEvent
+DFLOWdequeue(struct worker *t, Client cntxt)
+{
+	FlowEvent r;
+
+	if (stealing)
+		return q_steal(t, cntxt);
+	r = q_dequeue(todo, cntxt);
+	if (r)
+		t->globalpops++;
+	return r;
+}
+
+/*
+ * Decide where an eligible instruction is queued. A mitosis slice
+ * goes to a generic worker on its NUMA node, other instructions stay
+ * with the worker that produced their last argument.
+ */
+static void
+DFLOWplace(FlowEvent fe, FlowEvent producer)
+{
+	int i, j, n;
+
+	if (numanodes > 1 && fe->node >= 0) {
+		n = nworkers;
+		for (i = 0; i < n; i++) {
+			j = (numanext + i) % n;
+			if (workers[j].node == fe->node && workers[j].local &&
+				workers[j].flag == RUNNING && workers[j].cntxt == NULL) {
+				numanext = j + 1;
+				q_push(workers[j].local, fe);
+				return;
+			}
+		}
+	}
+	if (stealing && producer && producer->worker >= 0 && workers[producer->worker].local) {
+		q_push(workers[producer->worker].local, fe);
+		return;
+	}
+	q_enqueue(todo, fe);
+}
+
+/*
+ * The mitosis optimizer slices a column by adding the slice number
+ * and the number of slices to the sql.bind/bindidx/tid calls. Slice
+ * i of n is mapped onto NUMA node i * nodes / n.
+ */
+static int
+DFLOWslicenode(MalBlkPtr mb, InstrPtr p)
+{
+	int part, pieces;
+
+	if (numanodes <= 1 || p->argc < 2 || getModuleId(p) != sqlName ||
+		!(getFunctionId(p) == bindName ||
+		  getFunctionId(p) == bindidxName ||
+		  getFunctionId(p) == tidName))
+		return -1;
+	if (!isVarConstant(mb, getArg(p, p->argc - 1)) ||
+		!isVarConstant(mb, getArg(p, p->argc - 2)) ||
+		getArgType(mb, p, p->argc - 1) != TYPE_int ||
+		getArgType(mb, p, p->argc - 2) != TYPE_int)
+		return -1;
+	part = getVarConstant(mb, getArg(p, p->argc - 2)).val.ival;
+	pieces = getVarConstant(mb, getArg(p, p->argc - 1)).val.ival;
+	if (pieces <= 1 || part < 0 || part >= pieces)
+		return -1;
+	return (int) ((lng) part * numanodes / pieces);
+}
+
 /*
  * We simply move an instruction into the front of the queue.
  * Beware, we assume that variables are assigned a value once, otherwise
@@ -331,6 +550,8 @@ DFLOWworker(void *T)
 	InstrPtr p;
 
 	thr = THRnew("DFLOWworker");
+	if (numanodes > 1 && MT_numa_bind(t->node % MT_numa_nodes()) < 0)
+		fprintf(stderr, "#DFLOWworker: could not bind to NUMA node %d\n", t->node);
 
 #ifdef _MSC_VER
 	srand((unsigned int) GDKusec());
@@ -352,7 +573,7 @@ DFLOWworker(void *T)
 			MT_lock_set(&dataflowLock);
 			cntxt = t->cntxt;
 			MT_lock_unset(&dataflowLock);
-			fe = q_dequeue(todo, cntxt);
+			fe = DFLOWdequeue(t, cntxt);
 			if (fe == NULL) {
 				if (cntxt) {
 					/* we're not done yet with work for the current
@@ -376,6 +597,7 @@ DFLOWworker(void *T)
 		assert(fe);
 		flow = fe->flow;
 		assert(flow);
+		fe->worker = id;
 
 		/* whenever we have a (concurrent) error, skip it */
 		MT_lock_set(&flow->flowlock);
@@ -484,6 +706,25 @@ DFLOWworker(void *T)
 	MT_lock_unset(&dataflowLock);
 }
 
+/*
+ * Prepare a worker slot for use. In work stealing mode the slot keeps
+ * its private queue for the lifetime of the pool, such that any
+ * instructions left behind by an exiting worker can still be stolen.
+ * Called with the dataflowLock set.
+ */
+static void
+DFLOWprepare(struct worker *t)
+{
+	int id = (int) (t - workers);
+
+	t->cntxt = NULL;
+	t->node = numanodes > 1 ? id % numanodes : 0;
+	if (stealing && t->local == NULL)
+		t->local = q_create(64, "DFLOWlocal");
+	if (id >= nworkers)
+		nworkers = id + 1;
+}
+
 /*
  * Create an interpreter pool.
  * One worker will adaptively be available for each client.
@@ -494,8 +735,9 @@ DFLOWworker(void *T)
 static int
 DFLOWinitialize(void)
 {
-	int i, limit;
+	int i, limit, nodes = 0;
 	int created = 0;
+	const char *numa;
 
 	MT_lock_set(&mal_contextLock);
 	if (todo) {
@@ -511,6 +753,20 @@ DFLOWinitialize(void)
 	for (i = 0; i < THREADS; i++)
 		MT_sema_init(&workers[i].s, 0, "DFLOWinitialize");
 	limit = GDKnr_threads ? GDKnr_threads - 1 : 0;
+	stealing = GDKgetenv_isyes("dataflow_stealing");
+	/* dataflow_numa=yes uses the NUMA nodes of the machine, a number
+	 * pretends there are that many (for testing on a single node) */
+	if ((numa = GDKgetenv("dataflow_numa")) != NULL)
+		nodes = GDKgetenv_isyes("dataflow_numa") ? MT_numa_nodes() : atoi(numa);
+	if (nodes > 1) {
+		/* NUMA placement relies on the per worker queues */
+		numanodes = nodes;
+		stealing = 1;
+		sqlName = putName("sql");
+		bindName = putName("bind");
+		bindidxName = putName("bindidx");
+		tidName = putName("tid");
+	}
 #ifdef NEED_MT_LOCK_INIT
 	ATOMIC_INIT(exitingLock);
 	MT_lock_init(&dataflowLock, "dataflowLock");
@@ -518,7 +774,7 @@ DFLOWinitialize(void)
 	MT_lock_set(&dataflowLock);
 	for (i = 0; i < limit; i++) {
 		workers[i].flag = RUNNING;
-		workers[i].cntxt = NULL;
+		DFLOWprepare(&workers[i]);
 		if (MT_create_thread(&workers[i].id, DFLOWworker, (void *) &workers[i], MT_THR_JOINABLE) < 0)
 			workers[i].flag = IDLE;
 		else
@@ -570,6 +826,8 @@ DFLOWinitBlk(DataFlow flow, MalBlkPtr mb, int size)
 		flow->status[n].pc = pc;
 		flow->status[n].state = DFLOWpending;
 		flow->status[n].cost = -1;
+		flow->status[n].worker = -1;
+		flow->status[n].node = DFLOWslicenode(mb, p);
 		flow->status[n].flow->error = NULL;
 
 		/* administer flow dependencies */
@@ -739,7 +997,7 @@ DFLOWscheduler(DataFlow flow, struct worker *w)
 			for (j = p->retc; j < p->argc; j++)
 				fe[i].argclaim = getMemoryClaim(fe[0].flow->mb, fe[0].flow->stk, p, j, FALSE);
 #endif
-			q_enqueue(todo, flow->status + i);
+			DFLOWplace(flow->status + i, NULL);
 			flow->status[i].state = DFLOWrunning;
 			PARDEBUG fprintf(stderr, "#enqueue pc=%d claim=" LLFMT "\n", flow->status[i].pc, flow->status[i].argclaim);
 		}
@@ -769,7 +1027,7 @@ DFLOWscheduler(DataFlow flow, struct worker *w)
 				if (flow->status[i].blocks == 1 ) {
 					flow->status[i].state = DFLOWrunning;
 					flow->status[i].blocks--;
-					q_enqueue(todo, flow->status + i);
+					DFLOWplace(flow->status + i, f);
 					PARDEBUG fprintf(stderr, "#enqueue pc=%d claim= " LLFMT "\n", flow->status[i].pc, flow->status[i].argclaim);
 				} else {
 					flow->status[i].blocks--;
@@ -865,6 +1123,7 @@ runMALdataflow(Client cntxt, MalBlkPtr mb, int startpc, int stoppc, MalStkPtr st
 	}
 	for (i = 0; i < THREADS; i++) {
 		if (workers[i].flag == IDLE) {
+			DFLOWprepare(&workers[i]);
 			/* only create specific worker if we are not doing a
 			 * recursive call */
 			if (stk->calldepth > 1) {
@@ -981,6 +1240,53 @@ deblockdataflow( Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
     return MAL_SUCCEED;
 }
 
+/*
+ * The scheduler counters show how each worker obtained its
+ * instructions, i.e. from its own queue, from the shared todo queue,
+ * or by stealing them from another worker.
+ */
+str
+DFLOWstatistics(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	bat *w = getArgReference_bat(stk, pci, 0);
+	bat *l = getArgReference_bat(stk, pci, 1);
+	bat *g = getArgReference_bat(stk, pci, 2);
+	bat *s = getArgReference_bat(stk, pci, 3);
+	BAT *wb, *lb, *gb, *sb;
+	int i;
+
+	(void) cntxt;
+	(void) mb;
+	wb = COLnew(0, TYPE_int, nworkers, TRANSIENT);
+	lb = COLnew(0, TYPE_lng, nworkers, TRANSIENT);
+	gb = COLnew(0, TYPE_lng, nworkers, TRANSIENT);
+	sb = COLnew(0, TYPE_lng, nworkers, TRANSIENT);
+	if (wb == NULL || lb == NULL || gb == NULL || sb == NULL)
+		goto bailout;
+	MT_lock_set(&dataflowLock);
+	for (i = 0; i < nworkers; i++) {
+		if (BUNappend(wb, &i, FALSE) != GDK_SUCCEED ||
+			BUNappend(lb, &workers[i].localpops, FALSE) != GDK_SUCCEED ||
+			BUNappend(gb, &workers[i].globalpops, FALSE) != GDK_SUCCEED ||
+			BUNappend(sb, &workers[i].steals, FALSE) != GDK_SUCCEED) {
+			MT_lock_unset(&dataflowLock);
+			goto bailout;
+		}
+	}
+	MT_lock_unset(&dataflowLock);
+	BBPkeepref(*w = wb->batCacheid);
+	BBPkeepref(*l = lb->batCacheid);
+	BBPkeepref(*g = gb->batCacheid);
+	BBPkeepref(*s = sb->batCacheid);
+	return MAL_SUCCEED;
+  bailout:
+	if (wb) BBPunfix(wb->batCacheid);
+	if (lb) BBPunfix(lb->batCacheid);
+	if (gb) BBPunfix(gb->batCacheid);
+	if (sb) BBPunfix(sb->batCacheid);
+	throw(MAL, "language.dataflowstatistics", SQLSTATE(HY001) MAL_MALLOC_FAIL);
+}
+
 void
 stopMALdataflow(void)
 {
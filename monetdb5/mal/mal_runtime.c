@@ -102,7 +102,7 @@ runtimeProfileInit(Client cntxt, MalBlkPtr mb, MalStkPtr stk)
 void
 runtimeProfileFinish(Client cntxt, MalBlkPtr mb, MalStkPtr stk)
 {
-	int i,j;
+	int i,j, idle;
 
 	(void) cntxt;
 	(void) mb;
@@ -134,13 +134,17 @@ runtimeProfileFinish(Client cntxt, MalBlkPtr mb, MalStkPtr stk)
 
 	qtop = j;
 	QRYqueue[qtop].query = NULL; /* sentinel for SYSMONqueue() */
+	idle = qtop == 0;
 	MT_lock_unset(&mal_delayLock);
+	// release the memory kept for the intermediates of the queries
+	if (idle)
+		HEAPcacheflush();
 }
 
 void
 finishSessionProfiler(Client cntxt)
 {
-	int i,j;
+	int i,j, idle;
 
 	(void) cntxt;
 
@@ -160,7 +164,10 @@ finishSessionProfiler(Client cntxt)
 		QRYqueue[i].mb =0;
 	}
 	qtop = j;
+	idle = qtop == 0;
 	MT_lock_unset(&mal_delayLock);
+	if (idle)
+		HEAPcacheflush();
 }
 
 void
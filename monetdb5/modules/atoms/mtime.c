@@ -641,7 +641,8 @@ date_fromstr(const char *buf, size_t *len, date **d)
 ssize_t
 date_tostr(str *buf, size_t *len, const date *val)
 {
-	int day, month, year;
+	int day, month, year, n = 0;
+	char tmp[16], *s;
 
 	fromdate(*val, &day, &month, &year);
 	/* longest possible string: "-5867411-01-01" i.e. 14 chars
@@ -656,8 +657,27 @@ date_tostr(str *buf, size_t *len, const date *val)
 		strcpy(*buf, "nil");
 		return 3;
 	}
-	sprintf(*buf, "%d-%02d-%02d", year, month, day);
-	return (ssize_t) strlen(*buf);
+	/* equivalent to sprintf(*buf, "%d-%02d-%02d", year, month, day),
+	 * but this is on the critical path of result formatting */
+	s = *buf;
+	if (year < 0) {
+		*s++ = '-';
+		year = -year;
+	}
+	do {
+		tmp[n++] = (char) ('0' + year % 10);
+		year /= 10;
+	} while (year > 0);
+	while (n > 0)
+		*s++ = tmp[--n];
+	*s++ = '-';
+	*s++ = (char) ('0' + month / 10);
+	*s++ = (char) ('0' + month % 10);
+	*s++ = '-';
+	*s++ = (char) ('0' + day / 10);
+	*s++ = (char) ('0' + day % 10);
+	*s = 0;
+	return (ssize_t) (s - *buf);
 }
 
 /*
@@ -788,6 +808,7 @@ ssize_t
 daytime_tostr(str *buf, size_t *len, const daytime *val)
 {
 	int hour, min, sec, msec;
+	char *s;
 
 	fromtime(*val, &hour, &min, &sec, &msec);
 	if (*len < 12 || *buf == NULL) {
@@ -800,7 +821,22 @@ daytime_tostr(str *buf, size_t *len, const daytime *val)
 		strcpy(*buf, "nil");
 		return 3;
 	}
-	return sprintf(*buf, "%02d:%02d:%02d.%03d", hour, min, sec, msec);
+	/* equivalent to "%02d:%02d:%02d.%03d" */
+	s = *buf;
+	*s++ = (char) ('0' + hour / 10);
+	*s++ = (char) ('0' + hour % 10);
+	*s++ = ':';
+	*s++ = (char) ('0' + min / 10);
+	*s++ = (char) ('0' + min % 10);
+	*s++ = ':';
+	*s++ = (char) ('0' + sec / 10);
+	*s++ = (char) ('0' + sec % 10);
+	*s++ = '.';
+	*s++ = (char) ('0' + msec / 100);
+	*s++ = (char) ('0' + msec / 10 % 10);
+	*s++ = (char) ('0' + msec % 10);
+	*s = 0;
+	return (ssize_t) (s - *buf);
 }
 
 /*
@@ -143,6 +143,10 @@ infoHeap(BAT *bk, BAT*bv, Heap *hp, str nme)
 	if (BUNappend(bk, buf, FALSE) != GDK_SUCCEED ||
 		BUNappend(bv, hp->filename[0] ? hp->filename : "no file", FALSE) != GDK_SUCCEED)
 		return GDK_FAIL;
+	strcpy(p, "faults");
+	if (BUNappend(bk, buf, FALSE) != GDK_SUCCEED ||
+		BUNappend(bv, local_utoa(hp->faults), FALSE) != GDK_SUCCEED)
+		return GDK_FAIL;
 	return GDK_SUCCEED;
 }
 
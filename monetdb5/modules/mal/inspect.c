@@ -519,15 +519,33 @@ str
 INSPECTgetEnvironment(bat *ret, bat *ret2)
 {
 	BAT *b, *bn;
+	lng hits, misses;
+	size_t cached;
+	char hbuf[24], mbuf[24], cbuf[24];
 
-	b = COLcopy(GDKkey, GDKkey->ttype, 0, TRANSIENT);
+	b = COLcopy(GDKkey, GDKkey->ttype, 1, TRANSIENT);
 	if (b == 0)
 		throw(MAL, "inspect.getEnvironment", SQLSTATE(HY001) MAL_MALLOC_FAIL);
-	bn = COLcopy(GDKval, GDKval->ttype, 0, TRANSIENT);
+	bn = COLcopy(GDKval, GDKval->ttype, 1, TRANSIENT);
 	if (bn == 0){
 		BBPunfix(b->batCacheid);
 		throw(MAL, "inspect.getEnvironment", SQLSTATE(HY001) MAL_MALLOC_FAIL);
  	}
+	/* add the statistics of the heap cache */
+	HEAPcachestats(&hits, &misses, &cached);
+	snprintf(hbuf, sizeof(hbuf), LLFMT, hits);
+	snprintf(mbuf, sizeof(mbuf), LLFMT, misses);
+	snprintf(cbuf, sizeof(cbuf), "%zu", cached);
+	if (BUNappend(b, "gdk_heapcache_hits", FALSE) != GDK_SUCCEED ||
+	    BUNappend(bn, hbuf, FALSE) != GDK_SUCCEED ||
+	    BUNappend(b, "gdk_heapcache_misses", FALSE) != GDK_SUCCEED ||
+	    BUNappend(bn, mbuf, FALSE) != GDK_SUCCEED ||
+	    BUNappend(b, "gdk_heapcache_size", FALSE) != GDK_SUCCEED ||
+	    BUNappend(bn, cbuf, FALSE) != GDK_SUCCEED) {
+		BBPunfix(b->batCacheid);
+		BBPunfix(bn->batCacheid);
+		throw(MAL, "inspect.getEnvironment", SQLSTATE(HY001) MAL_MALLOC_FAIL);
+	}
 	BAThseqbase(b,0);
 	BAThseqbase(bn,0);
 
@@ -242,6 +242,236 @@ pcre_compile_wrap(pcre **res, const char *pattern, bit insensitive)
 }
 #endif
 
+/* Compiled regular expressions are kept in a small cache so that
+ * repeating a query with the same pattern, or matching a pattern
+ * value by value, does not compile it over and over again.  An entry
+ * is taken out of the cache while it is being used, so a compiled
+ * expression is never shared between threads, and it is put back
+ * afterwards. */
+#define PCRE_CACHE_SIZE		16
+
+typedef struct pcre_cached {
+	struct pcre_cached *next;
+	char *pat;
+	int options;
+#ifdef HAVE_LIBPCRE
+	pcre *re;
+	pcre_extra *pe;
+#else
+	pcre re;
+#endif
+} pcre_cached;
+
+static MT_Lock pcre_cache_lock MT_LOCK_INITIALIZER("pcre_cache_lock");
+static pcre_cached *pcre_cache;
+
+static void
+pcre_cache_free(pcre_cached *c)
+{
+#ifdef HAVE_LIBPCRE
+	if (c->pe)
+		pcre_free_study(c->pe);
+	pcre_free(c->re);
+#else
+	regfree(&c->re);
+#endif
+	GDKfree(c->pat);
+	GDKfree(c);
+}
+
+static str
+pcre_cache_get(pcre_cached **res, const char *pat, int options, const char *fcn)
+{
+	pcre_cached *c, **pp;
+#ifdef HAVE_LIBPCRE
+	const char *err_p = NULL;
+	int errpos = 0;
+#endif
+
+	MT_lock_set(&pcre_cache_lock);
+	for (pp = &pcre_cache; (c = *pp) != NULL; pp = &c->next) {
+		if (c->options == options && strcmp(c->pat, pat) == 0) {
+			*pp = c->next;
+			break;
+		}
+	}
+	MT_lock_unset(&pcre_cache_lock);
+	if (c == NULL) {
+		if ((c = GDKmalloc(sizeof(pcre_cached))) == NULL)
+			throw(MAL, fcn, SQLSTATE(HY001) MAL_MALLOC_FAIL);
+		if ((c->pat = GDKstrdup(pat)) == NULL) {
+			GDKfree(c);
+			throw(MAL, fcn, SQLSTATE(HY001) MAL_MALLOC_FAIL);
+		}
+		c->options = options;
+#ifdef HAVE_LIBPCRE
+		if ((c->re = pcre_compile(pat, options, &err_p, &errpos, NULL)) == NULL) {
+			GDKfree(c->pat);
+			GDKfree(c);
+			throw(MAL, fcn, OPERATION_FAILED
+				  ": compilation of regular expression (%s) failed"
+				  " at %d with '%s'", pat, errpos, err_p);
+		}
+		c->pe = pcre_study(c->re, 0, &err_p);
+		if (err_p != NULL) {
+			pcre_free(c->re);
+			GDKfree(c->pat);
+			GDKfree(c);
+			throw(MAL, fcn, OPERATION_FAILED
+				  ": studying pattern \"%s\" failed\n", pat);
+		}
+#else
+		if (regcomp(&c->re, pat, options) != 0) {
+			GDKfree(c->pat);
+			GDKfree(c);
+			throw(MAL, fcn, OPERATION_FAILED
+				  ": compilation of regular expression (%s) failed",
+				  pat);
+		}
+#endif
+	}
+	c->next = NULL;
+	*res = c;
+	return MAL_SUCCEED;
+}
+
+static void
+pcre_cache_put(pcre_cached *c)
+{
+	pcre_cached **pp, *old;
+	int n = 1;
+
+	MT_lock_set(&pcre_cache_lock);
+	c->next = pcre_cache;
+	pcre_cache = c;
+	for (pp = &c->next; *pp && n < PCRE_CACHE_SIZE; pp = &(*pp)->next)
+		n++;
+	old = *pp;
+	*pp = NULL;
+	MT_lock_unset(&pcre_cache_lock);
+	while (old) {
+		c = old->next;
+		pcre_cache_free(old);
+		old = c;
+	}
+}
+
+/* returns >= 0 on a match, -1 if there is no match, and < -1 on error */
+static int
+pcre_cache_match(const pcre_cached *c, const char *v)
+{
+#ifdef HAVE_LIBPCRE
+	return pcre_exec(c->re, c->pe, v, (int) strlen(v), 0, 0, NULL, 0);
+#else
+	int retval = regexec(&c->re, v, (size_t) 0, NULL, 0);
+
+	return retval == REG_NOMATCH ? -1 : retval == REG_ENOSYS ? -2 : 0;
+#endif
+}
+
+/* Return the longest stretch of at least two characters that every
+ * string matching the SQL LIKE pattern pat contains literally, or
+ * NULL if there is none.  Since the literal is only used to reject
+ * strings early, failing to allocate it simply means no prefilter. */
+static char *
+like_literal(const char *pat, const char *esc)
+{
+	size_t len = 0, best = 0, n = strlen(pat) + 1;
+	char *cur = GDKmalloc(n), *lit = GDKmalloc(n);
+	int e = *esc, escaped = 0;
+
+	if (cur == NULL || lit == NULL) {
+		GDKfree(cur);
+		GDKfree(lit);
+		return NULL;
+	}
+	for (;; pat++) {
+		int c = *pat;
+
+		if (c != 0 && c == e && !escaped) {
+			escaped = 1;
+			continue;
+		}
+		if (c == 0 || (!escaped && (c == '%' || c == '_'))) {
+			if (len > best) {
+				memcpy(lit, cur, len);
+				best = len;
+			}
+			len = 0;
+			if (c == 0)
+				break;
+		} else {
+			cur[len++] = c;
+		}
+		escaped = 0;
+	}
+	GDKfree(cur);
+	if (best < 2) {
+		GDKfree(lit);
+		return NULL;
+	}
+	lit[best] = 0;
+	return lit;
+}
+
+/* Scanning the whole string heap for a literal only pays when the
+ * heap is not much larger than the strings we would look at row by
+ * row, e.g. not for a small slice of a large column. */
+#define LIKE_GRANULE		8
+#define like_useheapfilter(b, n)	((b)->tvheap->free / 64 <= (size_t) (n))
+
+/* Search the string heap of b for the literal lit, and return a
+ * bitmap with a bit per LIKE_GRANULE bytes of the heap that is set
+ * for each part of the heap where a string containing lit may start.
+ * Strings are zero terminated, so a string containing lit starts in
+ * the run of non-zero bytes around an occurrence of lit; we mark
+ * those runs, which is correct whatever else the heap contains.  The
+ * search is done with memchr and memcmp, which the C library
+ * vectorizes.  Rows whose bit is not set cannot match, and are
+ * rejected without touching their string. */
+static unsigned char *
+like_heapfilter(BAT *b, const char *lit)
+{
+	const char *base = b->tvheap->base;
+	const char *end = base + b->tvheap->free;
+	const char *h = base, *stop = base, *s, *e;
+	size_t len = strlen(lit), i;
+	unsigned char *bm;
+
+	assert(len > 0);
+	bm = GDKzalloc((b->tvheap->free / LIKE_GRANULE + 8) / 8);
+	if (bm == NULL)
+		return NULL;
+	while ((size_t) (end - h) >= len &&
+	       (h = memchr(h, lit[0], (size_t) (end - h) - len + 1)) != NULL) {
+		if (memcmp(h, lit, len) != 0) {
+			h++;
+			continue;
+		}
+		for (s = h; s > stop && s[-1] != 0; s--)
+			;
+		if ((e = memchr(h + len, 0, (size_t) (end - h) - len)) == NULL)
+			e = end - 1;
+		for (i = (size_t) (s - base) / LIKE_GRANULE;
+		     i <= (size_t) (e - base) / LIKE_GRANULE;
+		     i++)
+			bm[i >> 3] |= 1 << (i & 7);
+		h = stop = e + 1;
+	}
+	ALGODEBUG fprintf(stderr, "#like_heapfilter(b=%s#" BUNFMT ",lit=%s): "
+			  "scanned %zu bytes\n", BATgetId(b), BATcount(b), lit,
+			  (size_t) b->tvheap->free);
+	return bm;
+}
+
+static inline int
+like_maybe(const unsigned char *bm, const char *base, const char *v)
+{
+	size_t i = (size_t) (v - base) / LIKE_GRANULE;
+
+	return bm == NULL || (bm[i >> 3] >> (i & 7)) & 1;
+}
+
 /* these two defines are copies from gdk_select.c */
 
 /* scan select loop with candidates */
@@ -278,29 +508,51 @@ pcre_compile_wrap(pcre **res, const char *pattern, bit insensitive)
 		}																\
 	} while (0)
 
+/* the predicates for BATdictselect */
+static int
+pcre_likematch(const char *v, void *arg)
+{
+	return pcre_cache_match(arg, v) >= 0;
+}
+
+struct re_likearg {
+	const char *pat;
+	RE *re;
+	int caseignore;
+};
+
+static int
+re_likematch(const char *v, void *arg)
+{
+	struct re_likearg *a = arg;
+
+	if (a->re == NULL)
+		return (a->caseignore ? strcasecmp(v, a->pat) : strcmp(v, a->pat)) == 0;
+	return a->caseignore ? re_match_ignore(v, a->re) : re_match_no_ignore(v, a->re);
+}
+
 static str
-pcre_likeselect(BAT **bnp, BAT *b, BAT *s, const char *pat, int caseignore, int anti)
+pcre_likeselect(BAT **bnp, BAT *b, BAT *s, const char *pat, const char *lit, int caseignore, int anti)
 {
 #ifdef HAVE_LIBPCRE
 	int options = PCRE_UTF8 | PCRE_MULTILINE | PCRE_DOTALL;
-	pcre *re;
-	pcre_extra *pe;
-	const char *error;
-	int errpos;
-	int ovector[10];
 #else
 	int options = REG_NEWLINE | REG_NOSUB;
-	pcre re;
-	int errcode;
 #endif
+	pcre_cached *re;
 	BATiter bi = bat_iterator(b);
 	BAT *bn;
 	BUN p, q;
 	oid o, off;
 	const char *v;
+	const char *vars = b->tvheap->base;
+	unsigned char *bm = NULL;
+	str msg;
 
 	assert(ATOMstorage(b->ttype) == TYPE_str);
 	assert(anti == 0 || anti == 1);
+	/* the literal is only valid for case sensitive matching */
+	assert(lit == NULL || !caseignore);
 
 	if (caseignore) {
 #ifdef HAVE_LIBPCRE
@@ -309,34 +561,29 @@ pcre_likeselect(BAT **bnp, BAT *b, BAT *s, const char *pat, int caseignore, int
 		options |= REG_ICASE;
 #endif
 	}
-#ifdef HAVE_LIBPCRE
-	if ((re = pcre_compile(pat, options, &error, &errpos, NULL)) == NULL)
-		throw(MAL, "pcre.likeselect",
-			  OPERATION_FAILED ": compilation of pattern \"%s\" failed\n", pat);
-	pe = pcre_study(re, 0, &error);
-	if (error != NULL) {
-		pcre_free(re);
-		throw(MAL, "pcre.likeselect",
-			  OPERATION_FAILED ": studying pattern \"%s\" failed\n", pat);
-	}
-#else
-	if ((errcode = regcomp(&re, pat, options)) != 0) {
-		throw(MAL, "pcre.likeselect",
-			  OPERATION_FAILED ": compilation of pattern \"%s\" failed\n", pat);
+	if ((msg = pcre_cache_get(&re, pat, options, "pcre.likeselect")) != MAL_SUCCEED)
+		return msg;
+	if (s == NULL || BATtdense(s)) {
+		/* match each distinct string only once if the column
+		 * has a dictionary */
+		bn = BATdictselect(b, s, pcre_likematch, re, anti);
+		if (bn) {
+			pcre_cache_put(re);
+			*bnp = bn;
+			return MAL_SUCCEED;
+		}
 	}
-#endif
 	bn = COLnew(0, TYPE_oid, s ? BATcount(s) : BATcount(b), TRANSIENT);
 	if (bn == NULL) {
-#ifdef HAVE_LIBPCRE
-		pcre_free_study(pe);
-		pcre_free(re);
-#else
-		regfree(&re);
-#endif
+		pcre_cache_put(re);
 		throw(MAL, "pcre.likeselect", SQLSTATE(HY001) MAL_MALLOC_FAIL);
 	}
 	off = b->hseqbase;
 
+/* strings that cannot contain the literal are rejected before
+ * invoking the regular expression matcher */
+#define MAYBE    (like_maybe(bm, vars, v) && (lit == NULL || strstr(v, lit) != NULL))
+#define BODY     (pcre_cache_match(re, v) >= 0)
 	if (s && !BATtdense(s)) {
 		const oid *candlist;
 		BUN r;
@@ -350,15 +597,12 @@ pcre_likeselect(BAT **bnp, BAT *b, BAT *s, const char *pat, int caseignore, int
 		q = SORTfndfirst(s, &o);
 		p = SORTfndfirst(s, &b->hseqbase);
 		candlist = (const oid *) Tloc(s, p);
-#ifdef HAVE_LIBPCRE
-#define BODY     (pcre_exec(re, pe, v, (int) strlen(v), 0, 0, ovector, 10) >= 0)
-#else
-#define BODY     (regexec(&re, v, (size_t) 0, NULL, 0) != REG_NOMATCH)
-#endif
+		if (lit && like_useheapfilter(b, q - p))
+			bm = like_heapfilter(b, lit);
 		if (anti)
-			candscanloop(v && *v != '\200' && !BODY);
+			candscanloop(v && *v != '\200' && !(MAYBE && BODY));
 		else
-			candscanloop(v && *v != '\200' && BODY);
+			candscanloop(v && MAYBE && *v != '\200' && BODY);
 	} else {
 		if (s) {
 			assert(BATtdense(s));
@@ -372,17 +616,17 @@ pcre_likeselect(BAT **bnp, BAT *b, BAT *s, const char *pat, int caseignore, int
 			p = off;
 			q = BUNlast(b) + off;
 		}
+		if (lit && p < q && like_useheapfilter(b, q - p))
+			bm = like_heapfilter(b, lit);
 		if (anti)
-			scanloop(v && *v != '\200' && !BODY);
+			scanloop(v && *v != '\200' && !(MAYBE && BODY));
 		else
-			scanloop(v && *v != '\200' && BODY);
+			scanloop(v && MAYBE && *v != '\200' && BODY);
 	}
-#ifdef HAVE_LIBPCRE
-	pcre_free_study(pe);
-	pcre_free(re);
-#else
-	regfree(&re);
-#endif
+#undef MAYBE
+#undef BODY
+	GDKfree(bm);
+	pcre_cache_put(re);
 	BATsetcount(bn, BATcount(bn)); /* set some properties */
 	bn->tsorted = 1;
 	bn->trevsorted = bn->batCount <= 1;
@@ -393,12 +637,8 @@ pcre_likeselect(BAT **bnp, BAT *b, BAT *s, const char *pat, int caseignore, int
 
   bunins_failed:
 	BBPreclaim(bn);
-#ifdef HAVE_LIBPCRE
-	pcre_free_study(pe);
-	pcre_free(re);
-#else
-	regfree(&re);
-#endif
+	GDKfree(bm);
+	pcre_cache_put(re);
 	*bnp = NULL;
 	throw(MAL, "pcre.likeselect", OPERATION_FAILED);
 }
@@ -411,23 +651,46 @@ re_likeselect(BAT **bnp, BAT *b, BAT *s, const char *pat, int caseignore, int an
 	BUN p, q;
 	oid o, off;
 	const char *v;
+	const char *vars = b->tvheap->base;
+	const char *lit = NULL;
+	unsigned char *bm = NULL;
 	int nr;
-	RE *re = NULL;
+	RE *re = NULL, *r;
 
 	assert(ATOMstorage(b->ttype) == TYPE_str);
 	assert(anti == 0 || anti == 1);
 
-	bn = COLnew(0, TYPE_oid, s ? BATcount(s) : BATcount(b), TRANSIENT);
-	if (bn == NULL)
-		throw(MAL, "pcre.likeselect", SQLSTATE(HY001) MAL_MALLOC_FAIL);
-	off = b->hseqbase;
-
 	if (!use_strcmp) {
 		nr = re_simple(pat);
 		re = re_create(pat, nr);
 		if (!re)
 			throw(MAL, "pcre.likeselect", SQLSTATE(HY001) MAL_MALLOC_FAIL);
+		/* the longest keyword is used to prefilter the string
+		 * heap when matching case sensitively */
+		if (!caseignore) {
+			for (r = re; r; r = r->n)
+				if (r->len >= 2 && (lit == NULL || r->len > (int) strlen(lit)))
+					lit = r->k;
+		}
 	}
+	if (s == NULL || BATtdense(s)) {
+		/* match each distinct string only once if the column
+		 * has a dictionary */
+		struct re_likearg arg = {pat, re, caseignore};
+
+		if ((bn = BATdictselect(b, s, re_likematch, &arg, anti)) != NULL) {
+			re_destroy(re);
+			*bnp = bn;
+			return MAL_SUCCEED;
+		}
+	}
+	bn = COLnew(0, TYPE_oid, s ? BATcount(s) : BATcount(b), TRANSIENT);
+	if (bn == NULL) {
+		re_destroy(re);
+		throw(MAL, "pcre.likeselect", SQLSTATE(HY001) MAL_MALLOC_FAIL);
+	}
+	off = b->hseqbase;
+
 	if (s && !BATtdense(s)) {
 		const oid *candlist;
 		BUN r;
@@ -441,6 +704,8 @@ re_likeselect(BAT **bnp, BAT *b, BAT *s, const char *pat, int caseignore, int an
 		q = SORTfndfirst(s, &o);
 		p = SORTfndfirst(s, &b->hseqbase);
 		candlist = (const oid *) Tloc(s, p);
+		if (lit && like_useheapfilter(b, q - p))
+			bm = like_heapfilter(b, lit);
 		if (use_strcmp) {
 			if (caseignore) {
 				if (anti)
@@ -468,9 +733,11 @@ re_likeselect(BAT **bnp, BAT *b, BAT *s, const char *pat, int caseignore, int an
 			} else {
 				if (anti)
 					candscanloop(v && *v != '\200' &&
-								 re_match_no_ignore(v, re) == 0);
+								 (!like_maybe(bm, vars, v) ||
+								  re_match_no_ignore(v, re) == 0));
 				else
-					candscanloop(v && *v != '\200' &&
+					candscanloop(v && like_maybe(bm, vars, v) &&
+								 *v != '\200' &&
 								 re_match_no_ignore(v, re));
 			}
 		}
@@ -487,6 +754,8 @@ re_likeselect(BAT **bnp, BAT *b, BAT *s, const char *pat, int caseignore, int an
 			p = off;
 			q = BUNlast(b) + off;
 		}
+		if (lit && p < q && like_useheapfilter(b, q - p))
+			bm = like_heapfilter(b, lit);
 		if (use_strcmp) {
 			if (caseignore) {
 				if (anti)
@@ -514,9 +783,11 @@ re_likeselect(BAT **bnp, BAT *b, BAT *s, const char *pat, int caseignore, int an
 			} else {
 				if (anti)
 					scanloop(v && *v != '\200' &&
-							 re_match_no_ignore(v, re) == 0);
+							 (!like_maybe(bm, vars, v) ||
+							  re_match_no_ignore(v, re) == 0));
 				else
-					scanloop(v && *v != '\200' &&
+					scanloop(v && like_maybe(bm, vars, v) &&
+							 *v != '\200' &&
 							 re_match_no_ignore(v, re));
 			}
 		}
@@ -527,10 +798,12 @@ re_likeselect(BAT **bnp, BAT *b, BAT *s, const char *pat, int caseignore, int an
 	bn->tkey = 1;
 	bn->tseqbase = bn->batCount == 0 ? 0 : bn->batCount == 1 ? * (oid *) Tloc(bn, 0) : oid_nil;
 	*bnp = bn;
+	GDKfree(bm);
 	re_destroy(re);
 	return MAL_SUCCEED;
 
   bunins_failed:
+	GDKfree(bm);
 	re_destroy(re);
 	BBPreclaim(bn);
 	*bnp = NULL;
@@ -933,16 +1206,12 @@ pcre_match_with_flags(bit *ret, const char *val, const char *pat, const char *fl
 {
 	int pos;
 #ifdef HAVE_LIBPCRE
-	const char *err_p = NULL;
-	int errpos = 0;
 	int options = PCRE_UTF8;
-	pcre *re;
 #else
 	int options = REG_NOSUB;
-	pcre re;
-	int errcode;
-	int retval;
 #endif
+	pcre_cached *re;
+	str msg;
 
 	while (*flags) {
 		switch (*flags) {
@@ -983,29 +1252,10 @@ pcre_match_with_flags(bit *ret, const char *val, const char *pat, const char *fl
 		return MAL_SUCCEED;
 	}
 
-#ifdef HAVE_LIBPCRE
-	if ((re = pcre_compile(pat, options, &err_p, &errpos, NULL)) == NULL) 
-#else
-		if ((errcode = regcomp(&re, pat, options)) != 0)
-#endif
-			{
-				throw(MAL, "pcre.match", OPERATION_FAILED
-					  ": compilation of regular expression (%s) failed "
-#ifdef HAVE_LIBPCRE
-					  "at %d with '%s'", pat, errpos, err_p
-#else
-					  , pat
-#endif
-					);
-			}
-#ifdef HAVE_LIBPCRE
-	pos = pcre_exec(re, NULL, val, (int) strlen(val), 0, 0, NULL, 0);
-	pcre_free(re);
-#else
-	retval = regexec(&re, val, (size_t) 0, NULL, 0);
-	pos = retval == REG_NOMATCH ? -1 : (retval == REG_ENOSYS ? -2 : 0);
-	regfree(&re);
-#endif
+	if ((msg = pcre_cache_get(&re, pat, options, "pcre.match")) != MAL_SUCCEED)
+		return msg;
+	pos = pcre_cache_match(re, val);
+	pcre_cache_put(re);
 	if (pos >= 0)
 		*ret = TRUE;
 	else if (pos == -1)
@@ -1425,15 +1675,14 @@ BATPCRElike3(bat *ret, const bat *bid, const str *pat, const str *esc, const bit
 		} else {
 			int pos;
 #ifdef HAVE_LIBPCRE
-			const char *err_p = NULL;
-			int errpos = 0;
 			int options = PCRE_UTF8 | PCRE_DOTALL;
-			pcre *re;
 #else
-			pcre re;
 			int options = REG_NEWLINE | REG_NOSUB;
-			int errcode;
 #endif
+			pcre_cached *re;
+			const char *vars = strs->tvheap->base;
+			char *lit = NULL;
+			unsigned char *bm = NULL;
 
 			if (*isens) {
 #ifdef HAVE_LIBPCRE
@@ -1442,46 +1691,41 @@ BATPCRElike3(bat *ret, const bat *bid, const str *pat, const str *esc, const bit
 				options |= REG_ICASE;
 #endif
 			}
-			if (
-#ifdef HAVE_LIBPCRE
-				(re = pcre_compile(ppat, options, &err_p, &errpos, NULL)) == NULL
-#else
-				(errcode = regcomp(&re, ppat, options)) != 0
-#endif
-				) {
+			if ((res = pcre_cache_get(&re, ppat, options, "pcre.match")) != MAL_SUCCEED) {
 				BBPunfix(strs->batCacheid);
 				BBPunfix(r->batCacheid);
-				res = createException(MAL, "pcre.match", OPERATION_FAILED
-									  ": compilation of regular expression (%s) failed"
-#ifdef HAVE_LIBPCRE
-									  " at %d with '%s'", ppat, errpos, err_p
-#else
-									  , ppat
-#endif
-					);
 				GDKfree(ppat);
 				return res;
 			}
+			/* strings that cannot contain the longest literal
+			 * of the pattern cannot match */
+			if (!*isens && (lit = like_literal(*pat, *esc)) != NULL &&
+			    like_useheapfilter(strs, BATcount(strs)))
+				bm = like_heapfilter(strs, lit);
 
 			BATloop(strs, p, q) {
 				const char *s = (str)BUNtail(strsi, p);
 
-				if (*s == '\200') {
+				if (strs->tnonil && !like_maybe(bm, vars, s)) {
+					br[i] = *not ? TRUE : FALSE;
+				} else if (*s == '\200') {
 					br[i] = bit_nil;
 					r->tnonil = 0;
 					r->tnil = 1;
 				} else {
-#ifdef HAVE_LIBPCRE
-					pos = pcre_exec(re, NULL, s, (int) strlen(s), 0, 0, NULL, 0);
-#else
-					int retval = regexec(&re, s, (size_t) 0, NULL, 0);
-					pos = retval == REG_NOMATCH ? -1 : (retval == REG_ENOSYS ? -2 : 0);
-#endif
+					if (!like_maybe(bm, vars, s) ||
+					    (lit && strstr(s, lit) == NULL))
+						pos = -1;
+					else
+						pos = pcre_cache_match(re, s);
 					if (pos >= 0)
 						br[i] = *not? FALSE:TRUE;
 					else if (pos == -1)
 						br[i] = *not? TRUE: FALSE;
 					else {
+						pcre_cache_put(re);
+						GDKfree(lit);
+						GDKfree(bm);
 						BBPunfix(strs->batCacheid);
 						BBPunfix(r->batCacheid);
 						res = createException(MAL, "pcre.match", OPERATION_FAILED
@@ -1492,11 +1736,9 @@ BATPCRElike3(bat *ret, const bat *bid, const str *pat, const str *esc, const bit
 				}
 				i++;
 			}
-#ifdef HAVE_LIBPCRE
-			pcre_free(re);
-#else
-			regfree(&re);
-#endif
+			pcre_cache_put(re);
+			GDKfree(lit);
+			GDKfree(bm);
 		}
 		BATsetcount(r, i);
 		r->tsorted = 0;
@@ -1581,7 +1823,7 @@ PCRElikeselect2(bat *ret, const bat *bid, const bat *sid, const str *pat, const
 {
 	BAT *b, *s = NULL, *bn = NULL;
 	str res;
-	char *ppat = NULL;
+	char *ppat = NULL, *lit = NULL;
 	int use_re = 0;
 	int use_strcmp = 0;
 
@@ -1636,7 +1878,10 @@ PCRElikeselect2(bat *ret, const bat *bid, const bat *sid, const str *pat, const
 		else
 			res = MAL_SUCCEED;
 	} else {
-		res = pcre_likeselect(&bn, b, s, ppat, *caseignore, *anti);
+		if (!*caseignore)
+			lit = like_literal(*pat, strcmp(*esc, str_nil) != 0 ? *esc : "\\");
+		res = pcre_likeselect(&bn, b, s, ppat, lit, *caseignore, *anti);
+		GDKfree(lit);
 	}
 	BBPunfix(b->batCacheid);
 	if (s)
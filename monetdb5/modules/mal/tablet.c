@@ -522,6 +522,181 @@ output_file_dense(Tablet *as, stream *fd)
 	return res;
 }
 
+/*
+ * Large dense exports are formatted in parallel. The rows are cut into
+ * chunks of OUTPUT_CHUNK rows which are handed out round-robin to the
+ * workers. Each worker formats its chunk into a private buffer, and the
+ * calling thread writes the buffers to the stream in chunk order, so
+ * the output is identical to that of output_file_dense.
+ */
+/* minimum number of rows for a parallel export */
+#define OUTPUT_PARALLEL	((BUN) 1 << 15)
+/* number of rows formatted by a worker in one go */
+#define OUTPUT_CHUNK	((BUN) 1 << 14)
+
+struct outputchunk {
+	Tablet *as;
+	BATiter *ci;			/* private iterators, BUNtail on a
+					 * void column writes into them */
+	BUN lo, hi;			/* the rows to format */
+	char *buf, *localbuf;
+	size_t len, locallen, fill;
+	int err;
+	int exit;			/* no more chunks, terminate */
+	MT_Sema todo, ready;
+	MT_Id tid;
+};
+
+static int
+output_chunk(struct outputchunk *c)
+{
+	Column *fmt = c->as->format;
+	BUN nr_attrs = c->as->nr_attrs;
+	size_t fill = 0;
+	BUN i, r;
+
+	for (r = c->lo; r < c->hi; r++) {
+		for (i = 0; i < nr_attrs; i++) {
+			Column *f = fmt + i;
+			const char *p;
+			ssize_t l = 0;
+
+			if (f->c) {
+				p = BUNtail(c->ci[i], f->p + r);
+
+				if (!p || ATOMcmp(f->adt, ATOMnilptr(f->adt), p) == 0) {
+					p = f->nullstr;
+					l = (ssize_t) strlen(p);
+				} else {
+					l = f->tostr(f->extra, &c->localbuf, &c->locallen, f->adt, p);
+					if (l < 0)
+						return -1;
+					p = c->localbuf;
+				}
+				if (fill + (size_t) l + f->seplen >= c->len) {
+					/* extend the buffer */
+					size_t nlen = 2 * c->len + (size_t) l + f->seplen;
+					char *nbuf = GDKrealloc(c->buf, nlen);
+
+					if (nbuf == NULL)
+						return -1;
+					c->buf = nbuf;
+					c->len = nlen;
+				}
+				memcpy(c->buf + fill, p, l);
+				fill += l;
+			} else if (fill + f->seplen >= c->len) {
+				size_t nlen = 2 * c->len + f->seplen;
+				char *nbuf = GDKrealloc(c->buf, nlen);
+
+				if (nbuf == NULL)
+					return -1;
+				c->buf = nbuf;
+				c->len = nlen;
+			}
+			memcpy(c->buf + fill, f->sep, f->seplen);
+			fill += f->seplen;
+		}
+	}
+	c->fill = fill;
+	return 0;
+}
+
+static void
+output_worker(void *arg)
+{
+	struct outputchunk *c = arg;
+
+	for (;;) {
+		MT_sema_down(&c->todo);
+		if (c->exit)
+			break;
+		c->err = output_chunk(c);
+		MT_sema_up(&c->ready);
+	}
+}
+
+static int
+output_file_parallel(Tablet *as, stream *fd, int n)
+{
+	struct outputchunk *c;
+	BUN nchunks = (as->nr + OUTPUT_CHUNK - 1) / OUTPUT_CHUNK, j, k, next;
+	int res = 0, i, nw = 0;
+
+	if ((BUN) n > nchunks)
+		n = (int) nchunks;
+	if ((c = GDKzalloc(n * sizeof(struct outputchunk))) == NULL)
+		return -1;
+	for (i = 0; i < n; i++) {
+		c[i].as = as;
+		c[i].len = c[i].locallen = BUFSIZ;
+		c[i].buf = GDKmalloc(c[i].len);
+		c[i].localbuf = GDKmalloc(c[i].locallen);
+		c[i].ci = GDKmalloc(as->nr_attrs * sizeof(BATiter));
+		if (c[i].buf == NULL || c[i].localbuf == NULL || c[i].ci == NULL) {
+			res = -1;
+			goto bailout;
+		}
+		for (j = 0; j < as->nr_attrs; j++)
+			c[i].ci[j] = as->format[j].ci;
+	}
+	for (nw = 0; nw < n; nw++) {
+		MT_sema_init(&c[nw].todo, 0, "outputchunk.todo");
+		MT_sema_init(&c[nw].ready, 0, "outputchunk.ready");
+		if (MT_create_thread(&c[nw].tid, output_worker, &c[nw], MT_THR_JOINABLE) < 0) {
+			MT_sema_destroy(&c[nw].todo);
+			MT_sema_destroy(&c[nw].ready);
+			break;
+		}
+	}
+	if (nw == 0) {
+		res = output_file_dense(as, fd);
+		goto bailout;
+	}
+
+	/* give every worker its first chunk */
+	for (next = 0; next < (BUN) nw; next++) {
+		c[next].lo = next * OUTPUT_CHUNK;
+		c[next].hi = MIN(as->nr, c[next].lo + OUTPUT_CHUNK);
+		MT_sema_up(&c[next].todo);
+	}
+	/* collect the chunks in order, chunk k is formatted by worker
+	 * k % nw, which then gets the next chunk */
+	for (k = 0; k < next; k++) {
+		struct outputchunk *w = &c[k % nw];
+
+		MT_sema_down(&w->ready);
+		if (res == 0) {
+			if (w->err < 0)
+				res = -1;
+			else if (mnstr_write(fd, w->buf, 1, w->fill) != (ssize_t) w->fill)
+				res = TABLET_error(fd);
+		}
+		if (res == 0 && next < nchunks) {
+			w->lo = next * OUTPUT_CHUNK;
+			w->hi = MIN(as->nr, w->lo + OUTPUT_CHUNK);
+			next++;
+			MT_sema_up(&w->todo);
+		}
+	}
+	for (i = 0; i < nw; i++) {
+		c[i].exit = 1;
+		MT_sema_up(&c[i].todo);
+		MT_join_thread(c[i].tid);
+		MT_sema_destroy(&c[i].todo);
+		MT_sema_destroy(&c[i].ready);
+	}
+
+  bailout:
+	for (i = 0; i < n; i++) {
+		GDKfree(c[i].buf);
+		GDKfree(c[i].localbuf);
+		GDKfree(c[i].ci);
+	}
+	GDKfree(c);
+	return res;
+}
+
 static int
 output_file_ordered(Tablet *as, BAT *order, stream *fd)
 {
@@ -567,7 +742,9 @@ TABLEToutput_file(Tablet *as, BAT *order, stream *s)
 
 	base = check_BATs(as);
 	if (!is_oid_nil(base)) {
-		if (order->hseqbase == base)
+		if (order->hseqbase == base && as->nr >= OUTPUT_PARALLEL && GDKnr_threads > 1)
+			ret = output_file_parallel(as, s, GDKnr_threads);
+		else if (order->hseqbase == base)
 			ret = output_file_dense(as, s);
 		else
 			ret = output_file_ordered(as, order, s);
@@ -1220,6 +1397,262 @@ SQLworkdivider(READERtask *task, READERtask *ptask, int nr_attrs, int threads)
  * If we end up with unfinished records, then the rowlimit will terminate the process.
  */
 
+/*
+ * Record splitting
+ * The producer has to find the record separators that are not inside
+ * a quoted field and not escaped with a backslash.  Since a backslash
+ * only escapes the next character, whether a character is escaped
+ * follows from the number of backslashes right in front of it, and
+ * since records start outside of quotes, whether a position is inside
+ * quotes follows from the parity of the number of unescaped quotes
+ * before it.  A large input buffer is therefore cut into chunks that
+ * are scanned by separate threads in two passes: the first pass counts
+ * the quotes in each chunk, after which the quote state at the start
+ * of each chunk is known, and the second pass collects the positions
+ * of the record separators in each chunk.  The producer then hands out
+ * the records in order, as before.
+ *
+ * Both passes process the input in blocks of 64 bytes, for which bit
+ * masks of the quotes, backslashes and record separators are computed
+ * with SSE2 where available.  The quote state inside a block without
+ * backslashes is the prefix xor of the quote mask.  Blocks with
+ * backslashes are handled a byte at a time.
+ *
+ * Input with null bytes, or with a quote or record separator that
+ * contains a backslash or the quote, goes through the byte at a time
+ * loop in SQLproducer instead.
+ */
+
+/* minimum size of the input for splitting it in parallel */
+#define SPLIT_PARALLEL	((size_t) 1 << 20)
+/* minimum size of a chunk */
+#define SPLIT_CHUNK	((size_t) 1 << 18)
+
+struct splitchunk {
+	const char *lo, *hi;		/* the chunk */
+	int inquote;			/* quote state at start/end of chunk */
+	int hasnul;			/* null byte found, can't split */
+	char **pos;			/* record separator positions */
+	size_t npos, maxpos;
+	int err;
+};
+
+struct splitarg {
+	const READERtask *task;
+	const char *start;		/* start of the input */
+	struct splitchunk *c;
+	int pass;			/* 1: count quotes, 2: find separators */
+};
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+
+#define SPLIT_SIMD 1
+
+/* bit i is set if p[i] == c */
+static inline ulng
+split_mask(const char *p, char c)
+{
+	__m128i v = _mm_set1_epi8(c);
+	ulng m0 = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) p), v));
+	ulng m1 = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (p + 16)), v));
+	ulng m2 = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (p + 32)), v));
+	ulng m3 = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (p + 48)), v));
+
+	return m0 | m1 << 16 | m2 << 32 | m3 << 48;
+}
+
+/* bit i is the xor of bits 0 up to i */
+static inline ulng
+split_prefix_xor(ulng m)
+{
+	m ^= m << 1;
+	m ^= m << 2;
+	m ^= m << 4;
+	m ^= m << 8;
+	m ^= m << 16;
+	m ^= m << 32;
+	return m;
+}
+#endif
+
+static inline int
+split_addpos(struct splitchunk *c, char *p)
+{
+	if (c->npos == c->maxpos) {
+		size_t maxpos = c->maxpos * 2;
+		char **pos = GDKrealloc(c->pos, maxpos * sizeof(char *));
+
+		if (pos == NULL) {
+			c->err = 1;
+			return -1;
+		}
+		c->pos = pos;
+		c->maxpos = maxpos;
+	}
+	c->pos[c->npos++] = p;
+	return 0;
+}
+
+/* handle the byte at p in the byte at a time loop */
+#define SPLIT_BYTE(p)							\
+	do {								\
+		if (*(p) == 0)						\
+			c->hasnul = 1;					\
+		else if (esc)						\
+			esc = 0;					\
+		else if (*(p) == '\\')					\
+			esc = 1;					\
+		else if (quote && *(p) == quote)			\
+			inquote = !inquote;				\
+		else if (pass == 2 && !inquote && *(p) == *rsep &&	\
+			 (rseplen == 1 || strncmp((p), rsep, rseplen) == 0) && \
+			 split_addpos(c, (char *) (p)) < 0)		\
+			return;						\
+	} while (0)
+
+static void
+split_chunk(void *arg)
+{
+	struct splitarg *a = arg;
+	struct splitchunk *c = a->c;
+	const char *rsep = a->task->rsep;
+	const size_t rseplen = a->task->rseplen;
+	const char quote = a->task->quote;
+	const int pass = a->pass;
+	const char *p = c->lo, *q;
+	int inquote = pass == 1 ? 0 : c->inquote, esc = 0;
+
+	/* an odd number of backslashes in front of the chunk escapes
+	 * its first byte */
+	for (q = p; q > a->start && q[-1] == '\\'; q--)
+		esc = !esc;
+#ifdef SPLIT_SIMD
+	for (; p + 64 <= c->hi && !c->hasnul; p += 64) {
+		ulng qm, bm, rm, in;
+
+		bm = split_mask(p, '\\');
+		if (esc || bm) {
+			for (q = p; q < p + 64; q++)
+				SPLIT_BYTE(q);
+			continue;
+		}
+		if (split_mask(p, 0)) {
+			c->hasnul = 1;
+			break;
+		}
+		qm = quote ? split_mask(p, quote) : 0;
+		/* bit i of in is set if p[i] is inside quotes (or is
+		 * an opening quote) */
+		in = split_prefix_xor(qm);
+		if (inquote)
+			in = ~in;
+		if (pass == 2) {
+			rm = split_mask(p, *rsep) & ~in;
+			while (rm) {
+				q = p + __builtin_ctzll(rm);
+				rm &= rm - 1;
+				if ((rseplen == 1 || strncmp(q, rsep, rseplen) == 0) &&
+				    split_addpos(c, (char *) q) < 0)
+					return;
+			}
+		}
+		inquote = (int) (in >> 63);
+	}
+#endif
+	for (; p < c->hi && !c->hasnul; p++)
+		SPLIT_BYTE(p);
+	if (pass == 1)
+		c->inquote = inquote;
+}
+
+/* Find the record separators in [s, end) that are not escaped or
+ * inside quotes, using multiple threads if the input is large.  The
+ * result is a list of chunks with the positions in order, or NULL if
+ * the input can not be split this way. */
+static struct splitchunk *
+split_records(const READERtask *task, const char *s, const char *end, int *nchunks)
+{
+	struct splitchunk *c;
+	struct splitarg *args;
+	MT_Id *tids;
+	size_t len = (size_t) (end - s);
+	int n = 1, i, pass, inquote;
+
+	if (task->quote == '\\' || strchr(task->rsep, '\\') ||
+	    (task->quote && strchr(task->rsep, task->quote)))
+		return NULL;
+	if (len >= SPLIT_PARALLEL && GDKnr_threads > 1) {
+		n = (int) (len / SPLIT_CHUNK);
+		if (n > GDKnr_threads)
+			n = GDKnr_threads;
+	}
+	c = GDKzalloc(n * sizeof(struct splitchunk));
+	args = GDKmalloc(n * sizeof(struct splitarg));
+	tids = GDKzalloc(n * sizeof(MT_Id));
+	if (c == NULL || args == NULL || tids == NULL)
+		goto bailout;
+	for (i = 0; i < n; i++) {
+		c[i].lo = s + len / n * i;
+		c[i].hi = i == n - 1 ? end : s + len / n * (i + 1);
+		c[i].maxpos = (size_t) (c[i].hi - c[i].lo) / 64 + 16;
+		if ((c[i].pos = GDKmalloc(c[i].maxpos * sizeof(char *))) == NULL)
+			goto bailout;
+		args[i] = (struct splitarg) {
+			.task = task,
+			.start = s,
+			.c = &c[i],
+		};
+	}
+	/* a single chunk starts outside of quotes, so it only needs
+	 * the second pass */
+	for (pass = n == 1 ? 2 : 1; pass <= 2; pass++) {
+		for (i = 0; i < n; i++) {
+			args[i].pass = pass;
+			if (i > 0 &&
+			    MT_create_thread(&tids[i], split_chunk, &args[i],
+					     MT_THR_JOINABLE) < 0)
+				tids[i] = 0;
+		}
+		split_chunk(&args[0]);
+		for (i = 1; i < n; i++) {
+			if (tids[i]) {
+				MT_join_thread(tids[i]);
+				tids[i] = 0;
+			} else {
+				/* thread could not be started */
+				split_chunk(&args[i]);
+			}
+		}
+		for (i = 0; i < n; i++)
+			if (c[i].hasnul || c[i].err)
+				goto bailout;
+		if (pass == 1) {
+			/* the quote state at the start of each chunk */
+			for (i = 0, inquote = 0; i < n; i++) {
+				int q = c[i].inquote;
+
+				c[i].inquote = inquote;
+				inquote ^= q;
+			}
+		}
+	}
+	GDKfree(args);
+	GDKfree(tids);
+	*nchunks = n;
+	return c;
+
+  bailout:
+	if (c)
+		for (i = 0; i < n; i++)
+			GDKfree(c[i].pos);
+	GDKfree(c);
+	GDKfree(args);
+	GDKfree(tids);
+	GDKclrerr();
+	return NULL;
+}
+
 static void
 SQLproducer(void *p)
 {
@@ -1233,6 +1666,8 @@ SQLproducer(void *p)
 	const char *rsep = task->rsep;
 	size_t rseplen = strlen(rsep), partial = 0;
 	char quote = task->quote;
+	struct splitchunk *chunks;
+	int nchunks;
 	Thread thr;
 
 	thr = THRnew("SQLproducer");
@@ -1314,7 +1749,47 @@ SQLproducer(void *p)
 		 * scan ended (we need to back off some since we could be in
 		 * the middle of the record separator).  If this is too
 		 * costly, we have to rethink the matter. */
-		for (e = s; *e && e < end && cnt < task->maxrow;) {
+		e = s;
+		if (*s && cnt < task->maxrow &&
+		    (chunks = split_records(task, s, end, &nchunks)) != NULL) {
+			/* hand out the records in order, as the loop
+			 * below does */
+			int i = 0;
+			size_t j = 0;
+
+			while (*s && cnt < task->maxrow) {
+				/* the next separator that does not overlap
+				 * with the previous one */
+				for (e = NULL; i < nchunks; i++, j = 0) {
+					for (; j < chunks[i].npos; j++)
+						if (chunks[i].pos[j] >= s)
+							break;
+					if (j < chunks[i].npos) {
+						e = chunks[i].pos[j++];
+						break;
+					}
+				}
+				if (e == NULL) {
+					partial = end - s;
+					break;
+				}
+				if (--task->skip < 0 && cnt < task->maxrow) {
+					task->lines[cur][task->top[cur]++] = s;
+					cnt++;
+				}
+				*e = '\0';
+				s = e + rseplen;
+				task->b->pos += (size_t) (s - base);
+				base = s;
+				if (task->top[cur] == task->limit)
+					break;
+			}
+			for (i = 0; i < nchunks; i++)
+				GDKfree(chunks[i].pos);
+			GDKfree(chunks);
+			e = NULL;	/* done, skip the loop below */
+		}
+		for (; e && *e && e < end && cnt < task->maxrow;) {
 			/* tokenize the record completely the format of the input
 			 * should comply to the following grammar rule [
 			 * [[quote][[esc]char]*[quote]csep]*rsep]* where quote is
@@ -1771,10 +1771,87 @@ mat_sample(MalBlkPtr mb, InstrPtr p, matlist_t *ml, int m)
 	return 0;
 }
 
+/*
+ * A COPY INTO file of a result of which all columns are aligned mats
+ * does not need the packed result.  Instead the partitions are written
+ * in order, each one as soon as it (and its predecessor) is available:
+ *
+ *	r1 := sql.export_table_open(fname, ..., scale, c1_1, ..., cn_1);
+ *	r2 := sql.export_table_part(r1, c1_2, ..., cn_2);
+ *	...
+ *	r := sql.export_table_close(rk);
+ *
+ * The close is only added before the next instruction with side
+ * effects, such that the partitions can also be released by other
+ * instructions in the same dataflow block, like the count of the
+ * affected rows.
+ */
+static int
+is_partitioned_export(MalBlkPtr mb, InstrPtr p, matlist_t *ml)
+{
+	int k, m, pieces = -1;
+	const char *fname;
+
+	if (getModuleId(p) != sqlRef || getFunctionId(p) != export_tableRef ||
+	    p->retc != 1 || p->argc <= p->retc + 11 ||
+	    !isVarConstant(mb, getArg(p, 1)) || getArgType(mb, p, 1) != TYPE_str)
+		return 0;
+	/* the client expects a result set header with the row count */
+	fname = getVarConstant(mb, getArg(p, 1)).val.sval;
+	if (fname == NULL || strcmp(fname, "stdout") == 0)
+		return 0;
+	for (k = p->retc + 11; k < p->argc; k++) {
+		if ((m = is_a_mat(getArg(p, k), ml)) < 0 || ml->v[m].type != mat_none)
+			return 0;
+		if (pieces < 0)
+			pieces = ml->v[m].mi->argc - ml->v[m].mi->retc;
+		else if (pieces != ml->v[m].mi->argc - ml->v[m].mi->retc)
+			return 0;
+	}
+	return pieces > 0;
+}
+
+static InstrPtr
+mat_export_table(MalBlkPtr mb, InstrPtr p, matlist_t *ml)
+{
+	int k, l, m, pieces, res = -1;
+	int first = p->retc + 11;
+	InstrPtr q;
+
+	m = is_a_mat(getArg(p, first), ml);
+	pieces = ml->v[m].mi->argc - ml->v[m].mi->retc;
+	for (k = 0; k < pieces; k++) {
+		if (k == 0) {
+			q = newInstruction(mb, sqlRef, export_table_openRef);
+			if (q == NULL)
+				return NULL;
+			for (l = p->retc; l < first; l++)
+				q = pushArgument(mb, q, getArg(p, l));
+		} else {
+			q = newInstruction(mb, sqlRef, export_table_partRef);
+			if (q == NULL)
+				return NULL;
+			q = pushArgument(mb, q, res);
+		}
+		getArg(q, 0) = res = newTmpVariable(mb, TYPE_int);
+		for (l = first; l < p->argc; l++) {
+			mat_t *mat = ml->v + is_a_mat(getArg(p, l), ml);
+
+			q = pushArgument(mb, q, getArg(mat->mi, mat->mi->retc + k));
+		}
+		pushInstruction(mb, q);
+	}
+	q = newInstruction(mb, sqlRef, export_table_closeRef);
+	if (q == NULL)
+		return NULL;
+	getArg(q, 0) = getArg(p, 0);
+	return pushArgument(mb, q, res);
+}
+
 str
 OPTmergetableImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr p) 
 {
-	InstrPtr *old;
+	InstrPtr *old, export_close = NULL;
 	matlist_t ml;
 	int oldtop, fm, fn, fo, fe, i, k, m, n, o, e, slimit, bailout = 0;
 	int size=0, match, actions=0, distinct_topn = 0, /*topn_res = 0,*/ groupdone = 0, *vars;
@@ -1870,6 +1947,10 @@ OPTmergetableImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr
 		InstrPtr r, cp;
 
 		p = old[i];
+		if (export_close && (p->token == ENDsymbol || hasSideEffects(mb, p, FALSE))) {
+			pushInstruction(mb, export_close);
+			export_close = NULL;
+		}
 		if (getModuleId(p) == matRef && 
 		   (getFunctionId(p) == newRef || getFunctionId(p) == packRef)){
 			if(mat_set_prop(&ml, mb, p) || mat_add_var(&ml, p, NULL, getArg(p,0), mat_none, -1, -1, 1)) {
@@ -2094,6 +2175,15 @@ OPTmergetableImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr
 			continue;
 		}
 
+		if (match > 0 && export_close == NULL && is_partitioned_export(mb, p, &ml)) {
+			if((export_close = mat_export_table(mb, p, &ml)) == NULL) {
+				msg = createException(MAL,"optimizer.mergetable",SQLSTATE(HY001) MAL_MALLOC_FAIL);
+				goto cleanup;
+			}
+			actions++;
+			continue;
+		}
+
 		m = n = o = e = -1;
 		for( fm= p->argc-1; fm>=p->retc ; fm--)
 			if ((m=is_a_mat(getArg(p,fm), &ml)) >= 0)
@@ -2261,6 +2351,7 @@ OPTmergetableImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr
 			freeInstruction(ml.v[i].mi);
 	}
 cleanup:
+	if (export_close) freeInstruction(export_close);
 	if (ml.v) GDKfree(ml.v);
 	if (ml.horigin) GDKfree(ml.horigin);
 	if (ml.torigin) GDKfree(ml.torigin);
@@ -29,10 +29,36 @@ eligible(MalBlkPtr mb)
 	return 1;
 }
 
+/* The width of a row written by a COPY INTO file, which the mergetable
+ * optimizer turns into a partitioned export; string heaps are not
+ * taken into account. */
+static size_t
+export_row_size(MalBlkPtr mb)
+{
+	InstrPtr p;
+	int i, j;
+	size_t size = 0;
+
+	for (i = 1; i < mb->stop; i++) {
+		p = getInstrPtr(mb, i);
+		if (getModuleId(p) != sqlRef || getFunctionId(p) != export_tableRef ||
+			p->argc <= p->retc + 11 || !isVarConstant(mb, getArg(p, 1)) ||
+			getArgType(mb, p, 1) != TYPE_str ||
+			getVarConstant(mb, getArg(p, 1)).val.sval == NULL ||
+			strcmp(getVarConstant(mb, getArg(p, 1)).val.sval, "stdout") == 0)
+			continue;
+		for (j = p->retc + 11; j < p->argc; j++)
+			if (isaBatType(getArgType(mb, p, j)))
+				size += ATOMsize(getBatType(getArgType(mb, p, j)));
+	}
+	return size;
+}
+
 str
 OPTmitosisImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr p)
 {
-	int i, j, limit, slimit, estimate = 0, pieces = 1, mito_parts = 0, mito_size = 0, row_size = 0, mt = -1;
+	int i, j, limit, slimit, estimate = 0, pieces = 1, mito_parts = 0, mito_size = 0, row_size = 0, mt = -1, stream_budget;
+	size_t export_size;
 	str schema = 0, table = 0;
 	BUN r = 0, rowcnt = 0;    /* table should be sizeable to consider parallel execution*/
 	InstrPtr q, *old, target = 0;
@@ -158,6 +184,15 @@ OPTmitosisImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr p)
 	FORCEMITODEBUG
 	if (pieces < threads)
 		pieces = (int) MIN((BUN) threads, rowcnt);
+	/* the partitions of a COPY INTO file that are being computed or
+	 * wait to be written should fit in the export budget (in MB) */
+	stream_budget = GDKgetenv_int("sql_stream_budget", 0);
+	if (stream_budget > 0 && (export_size = export_row_size(mb)) > 0) {
+		size_t n = (size_t) rowcnt * export_size * threads / ((size_t) stream_budget << 20) + 1;
+
+		if (n > (size_t) pieces)
+			pieces = (int) MIN(n, (size_t) MAXSLICES);
+	}
 	/* prevent plan explosion */
 	if (pieces > MAXSLICES)
 		pieces = MAXSLICES;
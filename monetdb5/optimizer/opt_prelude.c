@@ -122,6 +122,9 @@ str execRef;
 str expandRef;
 str exportOperationRef;
 str export_tableRef;
+str export_table_closeRef;
+str export_table_openRef;
+str export_table_partRef;
 str findRef;
 str finishRef;
 str firstnRef;
@@ -373,6 +376,9 @@ void optimizerInit(void)
 	copyRef = putName("copy");
 	copy_fromRef = putName("copy_from");
 	export_tableRef = putName("export_table");
+	export_table_closeRef = putName("export_table_close");
+	export_table_openRef = putName("export_table_open");
+	export_table_partRef = putName("export_table_part");
 	count_no_nilRef = putName("count_no_nil");
 	crossRef = putName("crossproduct");
 	createRef = putName("create");
@@ -120,6 +120,9 @@ mal_export  str execRef;
 mal_export  str expandRef;
 mal_export  str exportOperationRef;
 mal_export  str export_tableRef;
+mal_export  str export_table_closeRef;
+mal_export  str export_table_openRef;
+mal_export  str export_table_partRef;
 mal_export  str findRef;
 mal_export  str finishRef;
 mal_export  str firstnRef;
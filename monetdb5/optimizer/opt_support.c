@@ -433,6 +433,10 @@ hasSideEffects(MalBlkPtr mb, InstrPtr p, int strict)
 		if (getFunctionId(p) == zero_or_oneRef) return FALSE;
 		if (getFunctionId(p) == mvcRef) return FALSE;
 		if (getFunctionId(p) == singleRef) return FALSE;
+		/* export_table_open opens the COPY INTO file, its
+		 * partitions are ordered by their chain, and
+		 * export_table_close is the end-point */
+		if (getFunctionId(p) == export_table_partRef) return FALSE;
 		return TRUE;
 	}
 	if( getModuleId(p) == mapiRef){
@@ -36,12 +36,15 @@ backend_create(mvc *m, Client c)
 	b->client = c;
 	b->mvc_var = 0;
 	b->output_format = OFMT_CSV;
+	b->export = NULL;
 	return backend_reset(b);
 }
 
 void
 backend_destroy(backend *b)
 {
+	if (b->export)
+		close_stream(b->export);
 	_DELETE(b);
 }
 
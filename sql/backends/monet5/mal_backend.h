@@ -42,6 +42,7 @@ typedef struct backend {
 	int 	mvc_var;	
 	int	vtop;		/* top of the variable stack before the current function */
 	cq 	*q;		/* pointer to the cached query */
+	stream	*export;	/* open file of a partitioned COPY INTO */
 } backend;
 
 extern backend *backend_reset(backend *b);
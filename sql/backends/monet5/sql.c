@@ -110,6 +110,41 @@ rel_need_distinct_query(sql_rel *rel)
 	return need_distinct;
 }
 
+/* the number of times table t is read in rel; table functions and
+ * ddl may read anything */
+static int
+rel_table_refs(sql_rel *rel, sql_table *t)
+{
+	if (!rel)
+		return 0;
+	if (is_basetable(rel->op))
+		return rel->l == t;
+	if (rel->op == op_table || is_ddl(rel->op))
+		return 2;
+	if (is_joinop(rel->op) || is_apply(rel->op) || is_set(rel->op) || is_modify(rel->op))
+		return rel_table_refs(rel->l, t) + rel_table_refs(rel->r, t);
+	return rel_table_refs(rel->l, t);
+}
+
+/* The id of the table an update or delete changes if it reads that
+ * table only to find the rows to change, else 0.  The deleted rows
+ * of that table are then not read by the statement itself (see
+ * SQLtid). */
+static int
+rel_owndels(sql_rel *rel)
+{
+	sql_table *t;
+
+	if (!rel || (rel->op != op_update && rel->op != op_delete) ||
+	    !rel->l || !is_basetable(((sql_rel *) rel->l)->op))
+		return 0;
+	t = ((sql_rel *) rel->l)->l;
+	/* triggers may read the table as well */
+	if (t->triggers.set && t->triggers.set->h)
+		return 0;
+	return rel_table_refs(rel->r, t) <= 1 ? t->base.id : 0;
+}
+
 sql_rel *
 sql_symbol2relation(mvc *c, symbol *sym)
 {
@@ -124,6 +159,7 @@ sql_symbol2relation(mvc *c, symbol *sym)
 		r = rel_partition(c, r);
 		if (rel_no_mitosis(r) || rel_need_distinct_query(r))
 			c->no_mitosis = 1;
+		c->owndels = rel_owndels(r);
 	}
 	return r;
 }
@@ -141,9 +177,12 @@ sqlcleanup(mvc *c, int err)
 	c->sqs = NULL;
 
 	if ((c->emod & mod_locked) == mod_locked) {
+		lng lsn = 0;
+
 		/* here we should commit the transaction */
 		if (!err) {
-			sql_trans_commit(c->session->tr);
+			if (sql_trans_commit(c->session->tr) == SQL_OK)
+				lsn = c->session->tr->log_lsn;
 			/* write changes to disk */
 			sql_trans_end(c->session);
 			store_apply_deltas();
@@ -151,6 +190,8 @@ sqlcleanup(mvc *c, int err)
 		}
 		store_unlock();
 		c->emod = 0;
+		if (store_sync(lsn) != LOG_OK)
+			GDKfatal("sqlcleanup: write-ahead log sync failed (kernel error: %s)", GDKerrbuf);
 	}
 	/* some statements dynamically disable caching */
 	c->sym = NULL;
@@ -162,6 +203,7 @@ sqlcleanup(mvc *c, int err)
 		c->session->status = err;
 	c->label = 0;
 	c->no_mitosis = 0;
+	c->owndels = 0;
 	scanner_query_processed(&(c->scanner));
 	return err;
 }
@@ -1856,6 +1898,8 @@ SQLtid(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	if (t == NULL)
 		throw(SQL, "sql.tid", SQLSTATE(42S02) "Table missing %s.%s",sname,tname);
 	c = t->columns.set->h->data;
+	if (m->owndels != t->base.id)
+		sql_trans_read_dels(tr, t);
 
 	nr = store_funcs.count_col(tr, c, 1);
 
@@ -1981,8 +2025,8 @@ mvc_result_set_wrap( Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 
 
 /* Copy the result set into a CSV file */
-str
-mvc_export_table_wrap( Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+static str
+mvc_export_table_(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci, int partitioned)
 {
 	int *res_id =getArgReference_int(stk,pci,0);
 	const char *filename = *getArgReference_str(stk,pci,1);
@@ -2105,6 +2149,18 @@ mvc_export_table_wrap( Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 				      filename?filename:"stdout", strerror(errnr));
 		goto wrapup_result_set1;
 	}
+	if (partitioned) {
+		/* the file stays open for the next partitions */
+		backend *be = (backend *) cntxt->sqlcontext;
+
+		assert(s != cntxt->fdout);
+		if (be->export)
+			close_stream(be->export);
+		be->export = s;
+		if (mvc_export_part(be, s, res))
+			msg = createException(SQL, "sql.resultset", SQLSTATE(45000) "Result set construction failed");
+		goto wrapup_result_set1;
+	}
 	if (mvc_export_result(cntxt->sqlcontext, s, res, mb->starttime, mb->optimize))
 		msg = createException(SQL, "sql.resultset", SQLSTATE(45000) "Result set construction failed");
 	if( s != cntxt->fdout)
@@ -2119,6 +2175,91 @@ mvc_export_table_wrap( Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	return msg;
 }
 
+str
+mvc_export_table_wrap(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	return mvc_export_table_(cntxt, mb, stk, pci, 0);
+}
+
+/*
+ * The mergetable optimizer replaces the export_table of a result whose
+ * columns are all partitioned by a chain of export_table_open,
+ * export_table_part (one for each next partition) and
+ * export_table_close instructions.  Each partition is then written as
+ * soon as it and its predecessors are done, rather than after all of
+ * them have been packed into one result.
+ */
+str
+mvc_export_table_open_wrap(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	return mvc_export_table_(cntxt, mb, stk, pci, 1);
+}
+
+str
+mvc_export_table_part_wrap(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	int *res = getArgReference_int(stk, pci, 0);
+	int res_id = *getArgReference_int(stk, pci, 1);
+	int i, nr_cols = pci->argc - 2;
+	str msg = MAL_SUCCEED;
+	mvc *m = NULL;
+	backend *be = NULL;
+	BAT **cols;
+
+	if ((msg = getSQLContext(cntxt, mb, &m, &be)) != NULL)
+		return msg;
+	if ((msg = checkSQLContext(cntxt)) != NULL)
+		return msg;
+	if (be->export == NULL)
+		throw(SQL, "sql.export_table_part", SQLSTATE(45000) "No COPY INTO file is open");
+	cols = GDKzalloc(nr_cols * sizeof(BAT *));
+	if (cols == NULL)
+		throw(SQL, "sql.export_table_part", SQLSTATE(HY001) MAL_MALLOC_FAIL);
+	for (i = 0; i < nr_cols; i++) {
+		cols[i] = BATdescriptor(*getArgReference_bat(stk, pci, i + 2));
+		if (cols[i] == NULL) {
+			msg = createException(SQL, "sql.export_table_part", SQLSTATE(HY005) "Cannot access column descriptor");
+			goto bailout;
+		}
+	}
+	if (mvc_result_part(m, res_id, nr_cols, cols))
+		msg = createException(SQL, "sql.export_table_part", SQLSTATE(45000) "Result set partitions do not match");
+	else if (mvc_export_part(be, be->export, res_id))
+		msg = createException(SQL, "sql.export_table_part", SQLSTATE(45000) "Result set construction failed");
+	*res = res_id;
+  bailout:
+	for (i = 0; i < nr_cols && cols[i]; i++)
+		BBPunfix(cols[i]->batCacheid);
+	GDKfree(cols);
+	return msg;
+}
+
+str
+mvc_export_table_close_wrap(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	int *res = getArgReference_int(stk, pci, 0);
+	int res_id = *getArgReference_int(stk, pci, 1);
+	str msg = MAL_SUCCEED;
+	mvc *m = NULL;
+	backend *be = NULL;
+	res_table *t;
+
+	if ((msg = getSQLContext(cntxt, mb, &m, &be)) != NULL)
+		return msg;
+	if ((msg = checkSQLContext(cntxt)) != NULL)
+		return msg;
+	if (be->export == NULL)
+		throw(SQL, "sql.export_table_close", SQLSTATE(45000) "No COPY INTO file is open");
+	if (mnstr_errnr(be->export))
+		msg = createException(SQL, "sql.export_table_close", SQLSTATE(45000) "Result set construction failed");
+	close_stream(be->export);
+	be->export = NULL;
+	if ((t = res_tables_find(m->results, res_id)) != NULL)
+		m->results = res_tables_remove(m->results, t);
+	*res = res_id;
+	return msg;
+}
+
 /* unsafe pattern resultSet(tbl:bat[:str], attr:bat[:str], tpe:bat[:str], len:bat[:int],scale:bat[:int], cols:any...) :int */
 str
 mvc_row_result_wrap( Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
@@ -3513,6 +3654,122 @@ dump_cache(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	return MAL_SUCCEED;
 }
 
+/* str dump_cache_stats(int *r); */
+str
+dump_cache_stats(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	mvc *m = NULL;
+	str msg;
+	BAT *event, *count;
+	bat *revent = getArgReference_bat(stk, pci, 0);
+	bat *rcount = getArgReference_bat(stk, pci, 1);
+	lng entries, limit;
+
+	if ((msg = getSQLContext(cntxt, mb, &m, NULL)) != NULL ||
+	    (msg = checkSQLContext(cntxt)) != NULL)
+		return msg;
+	event = COLnew(0, TYPE_str, 5, TRANSIENT);
+	count = COLnew(0, TYPE_lng, 5, TRANSIENT);
+	if (event == NULL || count == NULL) {
+		BBPreclaim(event);
+		BBPreclaim(count);
+		throw(SQL, "sql.dumpcachestats", SQLSTATE(HY001) MAL_MALLOC_FAIL);
+	}
+	entries = m->qc->nr;
+	limit = m->cache;
+	if (BUNappend(event, "entries", FALSE) != GDK_SUCCEED ||
+	    BUNappend(count, &entries, FALSE) != GDK_SUCCEED ||
+	    BUNappend(event, "limit", FALSE) != GDK_SUCCEED ||
+	    BUNappend(count, &limit, FALSE) != GDK_SUCCEED ||
+	    BUNappend(event, "hits", FALSE) != GDK_SUCCEED ||
+	    BUNappend(count, &m->qc->hits, FALSE) != GDK_SUCCEED ||
+	    BUNappend(event, "misses", FALSE) != GDK_SUCCEED ||
+	    BUNappend(count, &m->qc->misses, FALSE) != GDK_SUCCEED ||
+	    BUNappend(event, "evictions", FALSE) != GDK_SUCCEED ||
+	    BUNappend(count, &m->qc->evictions, FALSE) != GDK_SUCCEED) {
+		BBPreclaim(event);
+		BBPreclaim(count);
+		throw(SQL, "sql.dumpcachestats", SQLSTATE(HY001) MAL_MALLOC_FAIL);
+	}
+	*revent = event->batCacheid;
+	*rcount = count->batCacheid;
+	BBPkeepref(*revent);
+	BBPkeepref(*rcount);
+	return MAL_SUCCEED;
+}
+
+/*
+ * The rows of the persistent tables that are kept in deltas, i.e. not
+ * yet merged into the columns, as seen by the current transaction.
+ * create function sys.deltas()
+ * returns table ("schema" string, "table" string, inserted bigint, updated bigint, deleted bigint)
+ * external name sql.deltas;
+ */
+str
+sql_deltas(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	mvc *m = NULL;
+	str msg;
+	sql_trans *tr;
+	node *nsch, *ntab;
+	BAT *sch, *tab, *ins, *upd, *del;
+	bat *rsch = getArgReference_bat(stk, pci, 0);
+	bat *rtab = getArgReference_bat(stk, pci, 1);
+	bat *rins = getArgReference_bat(stk, pci, 2);
+	bat *rupd = getArgReference_bat(stk, pci, 3);
+	bat *rdel = getArgReference_bat(stk, pci, 4);
+
+	if ((msg = getSQLContext(cntxt, mb, &m, NULL)) != NULL ||
+	    (msg = checkSQLContext(cntxt)) != NULL)
+		return msg;
+	tr = m->session->tr;
+	sch = COLnew(0, TYPE_str, 0, TRANSIENT);
+	tab = COLnew(0, TYPE_str, 0, TRANSIENT);
+	ins = COLnew(0, TYPE_lng, 0, TRANSIENT);
+	upd = COLnew(0, TYPE_lng, 0, TRANSIENT);
+	del = COLnew(0, TYPE_lng, 0, TRANSIENT);
+	if (sch == NULL || tab == NULL || ins == NULL || upd == NULL || del == NULL)
+		goto bailout;
+	for (nsch = tr->schemas.set->h; nsch; nsch = nsch->next) {
+		sql_schema *s = nsch->data;
+
+		if (isTempSchema(s) || !s->tables.set)
+			continue;
+		for (ntab = s->tables.set->h; ntab; ntab = ntab->next) {
+			sql_table *t = ntab->data;
+			size_t u, d;
+			lng i;
+
+			if (!isTable(t) || isTempTable(t))
+				continue;
+			i = (lng) store_funcs.count_deltas(tr, t, &u, &d);
+			if (BUNappend(sch, s->base.name, FALSE) != GDK_SUCCEED ||
+			    BUNappend(tab, t->base.name, FALSE) != GDK_SUCCEED ||
+			    BUNappend(ins, &i, FALSE) != GDK_SUCCEED)
+				goto bailout;
+			i = (lng) u;
+			if (BUNappend(upd, &i, FALSE) != GDK_SUCCEED)
+				goto bailout;
+			i = (lng) d;
+			if (BUNappend(del, &i, FALSE) != GDK_SUCCEED)
+				goto bailout;
+		}
+	}
+	BBPkeepref(*rsch = sch->batCacheid);
+	BBPkeepref(*rtab = tab->batCacheid);
+	BBPkeepref(*rins = ins->batCacheid);
+	BBPkeepref(*rupd = upd->batCacheid);
+	BBPkeepref(*rdel = del->batCacheid);
+	return MAL_SUCCEED;
+  bailout:
+	BBPreclaim(sch);
+	BBPreclaim(tab);
+	BBPreclaim(ins);
+	BBPreclaim(upd);
+	BBPreclaim(del);
+	throw(SQL, "sql.deltas", SQLSTATE(HY001) MAL_MALLOC_FAIL);
+}
+
 /* str dump_opt_stats(int *r); */
 str
 dump_opt_stats(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
@@ -374,6 +374,11 @@ SQLrun(Client c, backend *be, mvc *m)
 			msg = runMAL(c, mb, 0, 0);
 		}
 	}
+	if (be->export) {
+		/* an error interrupted a partitioned COPY INTO */
+		close_stream(be->export);
+		be->export = NULL;
+	}
 
 	// release the resources
 	freeMalBlk(mb);
@@ -305,3 +305,728 @@ SQLdense_rank(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	}
 	return MAL_SUCCEED;
 }
+
+/* Window aggregates.
+ *
+ * All window aggregates get the values, the partition and peer
+ * boundaries (as computed by diff), the order key (converted to dbl,
+ * only used for RANGE frames with an offset), the frame units and the
+ * frame start and end offsets (nil for UNBOUNDED, 0 for CURRENT ROW).
+ * First the frame of each row is determined as a range [fs, fe) of
+ * positions, after which the aggregate is computed for each frame.
+ * Since both fs and fe never decrease within a partition, invertible
+ * aggregates (integer sums, counts) are computed incrementally by
+ * adding the rows that enter and subtracting the rows that leave the
+ * frame.  The others (min, max and floating point sums, where
+ * subtracting loses precision) use a segment tree, so that each frame
+ * takes O(log n) steps independent of its size. */
+
+typedef struct {
+	BAT *b, *p, *o, *k;
+	BUN cnt;
+	BUN *fs, *fe;		/* frame of row i is [fs[i], fe[i]) */
+} window;
+
+static void
+window_close(window *w)
+{
+	if (w->b)
+		BBPunfix(w->b->batCacheid);
+	if (w->p)
+		BBPunfix(w->p->batCacheid);
+	if (w->o)
+		BBPunfix(w->o->batCacheid);
+	if (w->k)
+		BBPunfix(w->k->batCacheid);
+	GDKfree(w->fs);
+	GDKfree(w->fe);
+}
+
+static void
+window_bounds(window *w, int units, lng start, lng end)
+{
+	const bit *np = w->p ? (const bit *) Tloc(w->p, 0) : NULL;
+	const bit *no = w->o ? (const bit *) Tloc(w->o, 0) : NULL;
+	const dbl *kp = w->k ? (const dbl *) Tloc(w->k, 0) : NULL;
+	BUN *restrict fs = w->fs, *restrict fe = w->fe;
+	BUN cnt = w->cnt, i, j, ps, pe, gs, ge;
+
+	for (ps = 0; ps < cnt; ps = pe) {
+		for (pe = ps + 1; pe < cnt && !(np && np[pe]); pe++)
+			;
+		if (units == FRAME_ROWS) {
+			for (i = ps; i < pe; i++) {
+				fs[i] = is_lng_nil(start) || (lng) (i - ps) <= start ? ps : i - (BUN) start;
+				fe[i] = is_lng_nil(end) || (lng) (pe - i - 1) <= end ? pe : i + (BUN) end + 1;
+			}
+			continue;
+		}
+		/* RANGE: the current row includes all its peers */
+		for (gs = ps; gs < pe; gs = ge) {
+			for (ge = gs + 1; ge < pe && !(no && no[ge]); ge++)
+				;
+			for (i = gs; i < ge; i++) {
+				fs[i] = is_lng_nil(start) ? ps : gs;
+				fe[i] = is_lng_nil(end) ? pe : ge;
+			}
+		}
+		if (kp == NULL)
+			continue;
+		/* n PRECEDING/FOLLOWING: all rows whose key is within n
+		 * of the key of the current row; since the keys are
+		 * sorted, the frame bounds only move forward.  Rows with
+		 * a nil key only have their peers in the frame. */
+		if (!is_lng_nil(start) && start > 0) {
+			for (i = j = ps; i < pe; i++) {
+				if (is_dbl_nil(kp[i]))
+					continue;
+				while (j < i && (is_dbl_nil(kp[j]) || fabs(kp[i] - kp[j]) > (dbl) start))
+					j++;
+				fs[i] = j;
+			}
+		}
+		if (!is_lng_nil(end) && end > 0) {
+			for (i = j = ps; i < pe; i++) {
+				if (is_dbl_nil(kp[i]))
+					continue;
+				if (j <= i)
+					j = i + 1;
+				while (j < pe && !is_dbl_nil(kp[j]) && fabs(kp[j] - kp[i]) <= (dbl) end)
+					j++;
+				fe[i] = j;
+			}
+		}
+	}
+}
+
+/* load the arguments of a window aggregate and determine the frames */
+static str
+window_open(MalBlkPtr mb, MalStkPtr stk, InstrPtr pci, const char *fname, window *w)
+{
+	int units = *getArgReference_int(stk, pci, 5);
+	lng start = *getArgReference_lng(stk, pci, 6);
+	lng end = *getArgReference_lng(stk, pci, 7);
+
+	*w = (window) {0};
+	if ((!is_lng_nil(start) && start < 0) || (!is_lng_nil(end) && end < 0))
+		throw(SQL, fname, SQLSTATE(22013) "Frame offset must be non-negative");
+	if ((w->b = BATdescriptor(*getArgReference_bat(stk, pci, 1))) == NULL ||
+	    (isaBatType(getArgType(mb, pci, 2)) &&
+	     (w->p = BATdescriptor(*getArgReference_bat(stk, pci, 2))) == NULL) ||
+	    (isaBatType(getArgType(mb, pci, 3)) &&
+	     (w->o = BATdescriptor(*getArgReference_bat(stk, pci, 3))) == NULL) ||
+	    (isaBatType(getArgType(mb, pci, 4)) &&
+	     (w->k = BATdescriptor(*getArgReference_bat(stk, pci, 4))) == NULL)) {
+		window_close(w);
+		throw(SQL, fname, SQLSTATE(HY005) "Cannot access column descriptor");
+	}
+	w->cnt = BATcount(w->b);
+	if (w->cnt == 0)
+		return MAL_SUCCEED;
+	w->fs = GDKmalloc(w->cnt * sizeof(BUN));
+	w->fe = GDKmalloc(w->cnt * sizeof(BUN));
+	if (w->fs == NULL || w->fe == NULL) {
+		window_close(w);
+		throw(SQL, fname, SQLSTATE(HY001) MAL_MALLOC_FAIL);
+	}
+	window_bounds(w, units, start, end);
+	return MAL_SUCCEED;
+}
+
+/* the window aggregate of an empty column is an empty column */
+static str
+window_empty(MalStkPtr stk, InstrPtr pci, window *w, int tpe, const char *fname)
+{
+	BAT *r = COLnew(w->b->hseqbase, tpe, 0, TRANSIENT);
+
+	window_close(w);
+	if (r == NULL)
+		throw(SQL, fname, SQLSTATE(HY001) MAL_MALLOC_FAIL);
+	BBPkeepref(*getArgReference_bat(stk, pci, 0) = r->batCacheid);
+	return MAL_SUCCEED;
+}
+
+/* a single value is its own window */
+static str
+window_scalar(MalBlkPtr mb, MalStkPtr stk, InstrPtr pci, const char *fname)
+{
+	ValPtr ret = &stk->stk[getArg(pci, 0)];
+	const ValRecord *v = &stk->stk[getArg(pci, 1)];
+
+	ret->vtype = getArgType(mb, pci, 0);
+	if (ret->vtype == v->vtype) {
+		if (VALcopy(ret, v) == NULL)
+			throw(SQL, fname, SQLSTATE(HY001) MAL_MALLOC_FAIL);
+	} else if (VARconvert(ret, v, 1) != GDK_SUCCEED) {
+		throw(SQL, fname, GDK_EXCEPTION);
+	}
+	return MAL_SUCCEED;
+}
+
+/* number of non-nil values in the first i values is pc[i] */
+static BUN *
+window_nonils(BAT *b)
+{
+	BUN *pc = GDKmalloc((BATcount(b) + 1) * sizeof(BUN));
+	BATiter bi = bat_iterator(b);
+	const void *nil = ATOMnilptr(ATOMtype(b->ttype));
+	int (*cmp)(const void *, const void *) = ATOMcompare(ATOMtype(b->ttype));
+	BUN i;
+
+	if (pc == NULL)
+		return NULL;
+	pc[0] = 0;
+	for (i = 0; i < BATcount(b); i++)
+		pc[i + 1] = pc[i] + (b->tnonil || (*cmp)(BUNtail(bi, i), nil) != 0);
+	return pc;
+}
+
+/* bottom-up segment tree: the n leaves are t[n .. 2n), node j
+ * combines t[2j] and t[2j+1]; this works for any n as long as the
+ * operation is commutative */
+#define SEGTREE_BUILD(t, n, COMBINE)					\
+	do {								\
+		BUN _j;							\
+		for (_j = (n) - 1; _j > 0; _j--)			\
+			COMBINE(t[_j], t[2 * _j], t[2 * _j + 1]);	\
+	} while (0)
+
+#define SEGTREE_QUERY(t, n, lo, hi, res, COMBINE)			\
+	do {								\
+		BUN _l = (lo) + (n), _h = (hi) + (n);			\
+		while (_l < _h) {					\
+			if (_l & 1) {					\
+				COMBINE(res, res, t[_l]);		\
+				_l++;					\
+			}						\
+			if (_h & 1) {					\
+				_h--;					\
+				COMBINE(res, res, t[_h]);		\
+			}						\
+			_l >>= 1;					\
+			_h >>= 1;					\
+		}							\
+	} while (0)
+
+#define COMBINE_ADD(d, a, b)	((d) = (a) + (b))
+
+#define ADD_CHECK(TPE, s, v)						\
+	do {								\
+		if ((v) > 0 ? (s) > GDK_##TPE##_max - (v) : (s) < GDK_##TPE##_min - (v)) \
+			goto overflow;					\
+		(s) += (v);						\
+	} while (0)
+
+/* integer sums are computed incrementally */
+#define WINDOW_SUM_SLIDE(TPE1, TPE2)					\
+	do {								\
+		const TPE1 *restrict bp = (const TPE1 *) Tloc(w.b, 0);	\
+		TPE2 *restrict rp = (TPE2 *) Tloc(r, 0);		\
+		TPE2 s = 0, v;						\
+		BUN ws = 0, we = 0, nn = 0;				\
+		for (i = 0; i < w.cnt; i++) {				\
+			if (w.fs[i] < ws || w.fe[i] < we) {		\
+				/* not expected, but start afresh */	\
+				s = 0;					\
+				nn = 0;					\
+				ws = we = w.fs[i];			\
+			}						\
+			for (; we < w.fe[i]; we++) {			\
+				if (!is_##TPE1##_nil(bp[we])) {		\
+					v = (TPE2) bp[we];		\
+					ADD_CHECK(TPE2, s, v);		\
+					nn++;				\
+				}					\
+			}						\
+			for (; ws < w.fs[i]; ws++) {			\
+				if (!is_##TPE1##_nil(bp[ws])) {		\
+					v = -(TPE2) bp[ws];		\
+					ADD_CHECK(TPE2, s, v);		\
+					nn--;				\
+				}					\
+			}						\
+			if (nn == 0) {					\
+				rp[i] = TPE2##_nil;			\
+				nils++;					\
+			} else {					\
+				rp[i] = s;				\
+			}						\
+		}							\
+	} while (0)
+
+/* floating point sums use a segment tree, nils count as 0 */
+#define WINDOW_SUM_TREE(TPE1, TPE2)					\
+	do {								\
+		const TPE1 *restrict bp = (const TPE1 *) Tloc(w.b, 0);	\
+		TPE2 *restrict rp = (TPE2 *) Tloc(r, 0);		\
+		TPE2 *restrict t = GDKmalloc(2 * w.cnt * sizeof(TPE2));	\
+		if (t == NULL)						\
+			goto bailout;					\
+		for (i = 0; i < w.cnt; i++)				\
+			t[w.cnt + i] = is_##TPE1##_nil(bp[i]) ? 0 : (TPE2) bp[i]; \
+		SEGTREE_BUILD(t, w.cnt, COMBINE_ADD);			\
+		for (i = 0; i < w.cnt; i++) {				\
+			TPE2 s = 0;					\
+			if (pc[w.fe[i]] == pc[w.fs[i]]) {		\
+				rp[i] = TPE2##_nil;			\
+				nils++;					\
+				continue;				\
+			}						\
+			SEGTREE_QUERY(t, w.cnt, w.fs[i], w.fe[i], s, COMBINE_ADD); \
+			rp[i] = s;					\
+		}							\
+		GDKfree(t);						\
+	} while (0)
+
+#define WINDOW_SUM_FLT(TPE1)						\
+	do {								\
+		switch (tp2) {						\
+		case TYPE_flt:						\
+			WINDOW_SUM_TREE(TPE1, flt);			\
+			break;						\
+		case TYPE_dbl:						\
+			WINDOW_SUM_TREE(TPE1, dbl);			\
+			break;						\
+		default:						\
+			goto nosupport;					\
+		}							\
+	} while (0)
+
+#ifdef HAVE_HGE
+#define WINDOW_SUM_HGE(TPE1)						\
+		case TYPE_hge:						\
+			WINDOW_SUM_SLIDE(TPE1, hge);			\
+			break;
+#else
+#define WINDOW_SUM_HGE(TPE1)
+#endif
+
+#define WINDOW_SUM_INT(TPE1)						\
+	do {								\
+		switch (tp2) {						\
+		case TYPE_int:						\
+			if (ATOMsize(tp1) > sizeof(int))		\
+				goto nosupport;				\
+			WINDOW_SUM_SLIDE(TPE1, int);			\
+			break;						\
+		case TYPE_lng:						\
+			if (ATOMsize(tp1) > sizeof(lng))		\
+				goto nosupport;				\
+			WINDOW_SUM_SLIDE(TPE1, lng);			\
+			break;						\
+		WINDOW_SUM_HGE(TPE1)					\
+		default:						\
+			goto nosupport;					\
+		}							\
+	} while (0)
+
+str
+SQLwindow_sum(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	window w;
+	BAT *r;
+	BUN i, nils = 0, *pc = NULL;
+	int tp1, tp2;
+	str msg;
+
+	(void) cntxt;
+	if (!isaBatType(getArgType(mb, pci, 1)))
+		return window_scalar(mb, stk, pci, "sql.sum");
+	if ((msg = window_open(mb, stk, pci, "sql.sum", &w)) != MAL_SUCCEED)
+		return msg;
+	tp1 = ATOMbasetype(w.b->ttype);
+	tp2 = ATOMbasetype(getBatType(getArgType(mb, pci, 0)));
+	if (w.cnt == 0)
+		return window_empty(stk, pci, &w, getBatType(getArgType(mb, pci, 0)), "sql.sum");
+	if ((r = COLnew(w.b->hseqbase, tp2, w.cnt, TRANSIENT)) == NULL)
+		goto bailout;
+	if ((tp2 == TYPE_flt || tp2 == TYPE_dbl) &&
+	    (pc = window_nonils(w.b)) == NULL)
+		goto bailout;
+	switch (tp1) {
+	case TYPE_bte:
+		WINDOW_SUM_INT(bte);
+		break;
+	case TYPE_sht:
+		WINDOW_SUM_INT(sht);
+		break;
+	case TYPE_int:
+		WINDOW_SUM_INT(int);
+		break;
+	case TYPE_lng:
+		WINDOW_SUM_INT(lng);
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		WINDOW_SUM_INT(hge);
+		break;
+#endif
+	case TYPE_flt:
+		WINDOW_SUM_FLT(flt);
+		break;
+	case TYPE_dbl:
+		WINDOW_SUM_FLT(dbl);
+		break;
+	default:
+		goto nosupport;
+	}
+	GDKfree(pc);
+	BATsetcount(r, w.cnt);
+	r->tsorted = r->trevsorted = w.cnt <= 1;
+	r->tnonil = nils == 0;
+	r->tnil = nils > 0;
+	window_close(&w);
+	BBPkeepref(*getArgReference_bat(stk, pci, 0) = r->batCacheid);
+	return MAL_SUCCEED;
+
+  overflow:
+	msg = createException(SQL, "sql.sum", SQLSTATE(22003) "overflow in calculation");
+	goto cleanup;
+  nosupport:
+	msg = createException(SQL, "sql.sum", SQLSTATE(42000) "sum(%s) into %s not supported", ATOMname(tp1), ATOMname(tp2));
+	goto cleanup;
+  bailout:
+	msg = createException(SQL, "sql.sum", SQLSTATE(HY001) MAL_MALLOC_FAIL);
+  cleanup:
+	GDKfree(pc);
+	BBPreclaim(r);
+	window_close(&w);
+	return msg;
+}
+
+/* averages of small integers are computed incrementally, the others
+ * use a segment tree of dbl sums */
+#define WINDOW_AVG_SLIDE(TPE)						\
+	do {								\
+		const TPE *restrict bp = (const TPE *) Tloc(w.b, 0);	\
+		lng s = 0, v;						\
+		BUN ws = 0, we = 0, nn = 0;				\
+		for (i = 0; i < w.cnt; i++) {				\
+			if (w.fs[i] < ws || w.fe[i] < we) {		\
+				s = 0;					\
+				nn = 0;					\
+				ws = we = w.fs[i];			\
+			}						\
+			for (; we < w.fe[i]; we++) {			\
+				if (!is_##TPE##_nil(bp[we])) {		\
+					v = (lng) bp[we];		\
+					ADD_CHECK(lng, s, v);		\
+					nn++;				\
+				}					\
+			}						\
+			for (; ws < w.fs[i]; ws++) {			\
+				if (!is_##TPE##_nil(bp[ws])) {		\
+					v = -(lng) bp[ws];		\
+					ADD_CHECK(lng, s, v);		\
+					nn--;				\
+				}					\
+			}						\
+			if (nn == 0) {					\
+				rp[i] = dbl_nil;			\
+				nils++;					\
+			} else {					\
+				rp[i] = (dbl) s / nn;			\
+			}						\
+		}							\
+	} while (0)
+
+#define WINDOW_AVG_TREE(TPE)						\
+	do {								\
+		const TPE *restrict bp = (const TPE *) Tloc(w.b, 0);	\
+		dbl *restrict t = GDKmalloc(2 * w.cnt * sizeof(dbl));	\
+		if (t == NULL || (pc = window_nonils(w.b)) == NULL) {	\
+			GDKfree(t);					\
+			goto bailout;					\
+		}							\
+		for (i = 0; i < w.cnt; i++)				\
+			t[w.cnt + i] = is_##TPE##_nil(bp[i]) ? 0 : (dbl) bp[i]; \
+		SEGTREE_BUILD(t, w.cnt, COMBINE_ADD);			\
+		for (i = 0; i < w.cnt; i++) {				\
+			dbl s = 0;					\
+			BUN nn = pc[w.fe[i]] - pc[w.fs[i]];		\
+			if (nn == 0) {					\
+				rp[i] = dbl_nil;			\
+				nils++;					\
+				continue;				\
+			}						\
+			SEGTREE_QUERY(t, w.cnt, w.fs[i], w.fe[i], s, COMBINE_ADD); \
+			rp[i] = s / nn;					\
+		}							\
+		GDKfree(t);						\
+	} while (0)
+
+str
+SQLwindow_avg(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	window w;
+	BAT *r;
+	BUN i, nils = 0, *pc = NULL;
+	dbl *rp;
+	int tp1;
+	str msg;
+
+	(void) cntxt;
+	if (!isaBatType(getArgType(mb, pci, 1)))
+		return window_scalar(mb, stk, pci, "sql.avg");
+	if ((msg = window_open(mb, stk, pci, "sql.avg", &w)) != MAL_SUCCEED)
+		return msg;
+	if (w.cnt == 0)
+		return window_empty(stk, pci, &w, TYPE_dbl, "sql.avg");
+	tp1 = ATOMbasetype(w.b->ttype);
+	if ((r = COLnew(w.b->hseqbase, TYPE_dbl, w.cnt, TRANSIENT)) == NULL)
+		goto bailout;
+	rp = (dbl *) Tloc(r, 0);
+	switch (tp1) {
+	case TYPE_bte:
+		WINDOW_AVG_SLIDE(bte);
+		break;
+	case TYPE_sht:
+		WINDOW_AVG_SLIDE(sht);
+		break;
+	case TYPE_int:
+		WINDOW_AVG_SLIDE(int);
+		break;
+	case TYPE_lng:
+		WINDOW_AVG_TREE(lng);
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		WINDOW_AVG_TREE(hge);
+		break;
+#endif
+	case TYPE_flt:
+		WINDOW_AVG_TREE(flt);
+		break;
+	case TYPE_dbl:
+		WINDOW_AVG_TREE(dbl);
+		break;
+	default:
+		msg = createException(SQL, "sql.avg", SQLSTATE(42000) "avg(%s) not supported", ATOMname(tp1));
+		goto cleanup;
+	}
+	GDKfree(pc);
+	BATsetcount(r, w.cnt);
+	r->tsorted = r->trevsorted = w.cnt <= 1;
+	r->tnonil = nils == 0;
+	r->tnil = nils > 0;
+	window_close(&w);
+	BBPkeepref(*getArgReference_bat(stk, pci, 0) = r->batCacheid);
+	return MAL_SUCCEED;
+
+  overflow:
+	msg = createException(SQL, "sql.avg", SQLSTATE(22003) "overflow in calculation");
+	goto cleanup;
+  bailout:
+	msg = createException(SQL, "sql.avg", SQLSTATE(HY001) MAL_MALLOC_FAIL);
+  cleanup:
+	GDKfree(pc);
+	BBPreclaim(r);
+	window_close(&w);
+	return msg;
+}
+
+/* min and max use a segment tree in which a nil only wins from
+ * another nil */
+#define COMBINE_MIN(TPE, d, a, b)					\
+	((d) = is_##TPE##_nil(a) ? (b) : is_##TPE##_nil(b) ? (a) : (a) < (b) ? (a) : (b))
+#define COMBINE_MAX(TPE, d, a, b)					\
+	((d) = is_##TPE##_nil(a) ? (b) : is_##TPE##_nil(b) ? (a) : (a) > (b) ? (a) : (b))
+
+#define WINDOW_MINMAX(TPE, OP)						\
+	do {								\
+		const TPE *restrict bp = (const TPE *) Tloc(w.b, 0);	\
+		TPE *restrict rp = (TPE *) Tloc(r, 0);			\
+		TPE *restrict t = GDKmalloc(2 * w.cnt * sizeof(TPE));	\
+		if (t == NULL)						\
+			goto bailout;					\
+		memcpy(t + w.cnt, bp, w.cnt * sizeof(TPE));		\
+		SEGTREE_BUILD(t, w.cnt, COMBINE_##OP##_##TPE);		\
+		for (i = 0; i < w.cnt; i++) {				\
+			TPE m = TPE##_nil;				\
+			SEGTREE_QUERY(t, w.cnt, w.fs[i], w.fe[i], m, COMBINE_##OP##_##TPE); \
+			rp[i] = m;					\
+			nils += is_##TPE##_nil(m);			\
+		}							\
+		GDKfree(t);						\
+	} while (0)
+
+#define COMBINE_MIN_bte(d, a, b) COMBINE_MIN(bte, d, a, b)
+#define COMBINE_MIN_sht(d, a, b) COMBINE_MIN(sht, d, a, b)
+#define COMBINE_MIN_int(d, a, b) COMBINE_MIN(int, d, a, b)
+#define COMBINE_MIN_lng(d, a, b) COMBINE_MIN(lng, d, a, b)
+#define COMBINE_MIN_hge(d, a, b) COMBINE_MIN(hge, d, a, b)
+#define COMBINE_MIN_flt(d, a, b) COMBINE_MIN(flt, d, a, b)
+#define COMBINE_MIN_dbl(d, a, b) COMBINE_MIN(dbl, d, a, b)
+#define COMBINE_MAX_bte(d, a, b) COMBINE_MAX(bte, d, a, b)
+#define COMBINE_MAX_sht(d, a, b) COMBINE_MAX(sht, d, a, b)
+#define COMBINE_MAX_int(d, a, b) COMBINE_MAX(int, d, a, b)
+#define COMBINE_MAX_lng(d, a, b) COMBINE_MAX(lng, d, a, b)
+#define COMBINE_MAX_hge(d, a, b) COMBINE_MAX(hge, d, a, b)
+#define COMBINE_MAX_flt(d, a, b) COMBINE_MAX(flt, d, a, b)
+#define COMBINE_MAX_dbl(d, a, b) COMBINE_MAX(dbl, d, a, b)
+
+/* other types: a segment tree of positions, BUN_NONE for nil */
+#define COMBINE_POS(d, a, b)						\
+	((d) = (a) == BUN_NONE ? (b) : (b) == BUN_NONE ? (a) :		\
+	 (*cmp)(BUNtail(bi, a), BUNtail(bi, b)) * dir >= 0 ? (a) : (b))
+
+static str
+window_minmax(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci, int dir, const char *fname)
+{
+	window w;
+	BAT *r;
+	BUN i, nils = 0;
+	int tpe;
+	str msg;
+
+	(void) cntxt;
+	if (!isaBatType(getArgType(mb, pci, 1)))
+		return window_scalar(mb, stk, pci, fname);
+	if ((msg = window_open(mb, stk, pci, fname, &w)) != MAL_SUCCEED)
+		return msg;
+	tpe = ATOMtype(w.b->ttype);
+	if (w.cnt == 0)
+		return window_empty(stk, pci, &w, tpe, fname);
+	if ((r = COLnew(w.b->hseqbase, tpe, w.cnt, TRANSIENT)) == NULL)
+		goto bailout;
+	switch (ATOMstorage(w.b->ttype)) {
+	case TYPE_bte:
+		if (dir < 0)
+			WINDOW_MINMAX(bte, MIN);
+		else
+			WINDOW_MINMAX(bte, MAX);
+		break;
+	case TYPE_sht:
+		if (dir < 0)
+			WINDOW_MINMAX(sht, MIN);
+		else
+			WINDOW_MINMAX(sht, MAX);
+		break;
+	case TYPE_int:
+		if (dir < 0)
+			WINDOW_MINMAX(int, MIN);
+		else
+			WINDOW_MINMAX(int, MAX);
+		break;
+	case TYPE_lng:
+		if (dir < 0)
+			WINDOW_MINMAX(lng, MIN);
+		else
+			WINDOW_MINMAX(lng, MAX);
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		if (dir < 0)
+			WINDOW_MINMAX(hge, MIN);
+		else
+			WINDOW_MINMAX(hge, MAX);
+		break;
+#endif
+	case TYPE_flt:
+		if (dir < 0)
+			WINDOW_MINMAX(flt, MIN);
+		else
+			WINDOW_MINMAX(flt, MAX);
+		break;
+	case TYPE_dbl:
+		if (dir < 0)
+			WINDOW_MINMAX(dbl, MIN);
+		else
+			WINDOW_MINMAX(dbl, MAX);
+		break;
+	default: {
+		BATiter bi = bat_iterator(w.b);
+		const void *nil = ATOMnilptr(tpe);
+		int (*cmp)(const void *, const void *) = ATOMcompare(tpe);
+		BUN *t = GDKmalloc(2 * w.cnt * sizeof(BUN));
+
+		if (t == NULL)
+			goto bailout;
+		for (i = 0; i < w.cnt; i++)
+			t[w.cnt + i] = (*cmp)(BUNtail(bi, i), nil) == 0 ? BUN_NONE : i;
+		SEGTREE_BUILD(t, w.cnt, COMBINE_POS);
+		for (i = 0; i < w.cnt; i++) {
+			BUN m = BUN_NONE;
+
+			SEGTREE_QUERY(t, w.cnt, w.fs[i], w.fe[i], m, COMBINE_POS);
+			nils += m == BUN_NONE;
+			if (BUNappend(r, m == BUN_NONE ? nil : BUNtail(bi, m), FALSE) != GDK_SUCCEED) {
+				GDKfree(t);
+				goto bailout;
+			}
+		}
+		GDKfree(t);
+		break;
+	}
+	}
+	BATsetcount(r, w.cnt);
+	r->tsorted = r->trevsorted = w.cnt <= 1;
+	r->tnonil = nils == 0;
+	r->tnil = nils > 0;
+	window_close(&w);
+	BBPkeepref(*getArgReference_bat(stk, pci, 0) = r->batCacheid);
+	return MAL_SUCCEED;
+
+  bailout:
+	BBPreclaim(r);
+	window_close(&w);
+	throw(SQL, fname, SQLSTATE(HY001) MAL_MALLOC_FAIL);
+}
+
+str
+SQLwindow_min(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	return window_minmax(cntxt, mb, stk, pci, -1, "sql.min");
+}
+
+str
+SQLwindow_max(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	return window_minmax(cntxt, mb, stk, pci, 1, "sql.max");
+}
+
+str
+SQLwindow_count(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	window w;
+	BAT *r;
+	BUN i, *pc = NULL;
+	bit ignore_nils = *getArgReference_bit(stk, pci, 8);
+	lng *rp;
+	str msg;
+
+	(void) cntxt;
+	if (!isaBatType(getArgType(mb, pci, 1))) {
+		lng *res = getArgReference_lng(stk, pci, 0);
+		const ValRecord *v = &stk->stk[getArg(pci, 1)];
+
+		*res = !ignore_nils || ATOMcmp(v->vtype, VALptr(v), ATOMnilptr(v->vtype)) != 0;
+		return MAL_SUCCEED;
+	}
+	if ((msg = window_open(mb, stk, pci, "sql.count", &w)) != MAL_SUCCEED)
+		return msg;
+	if (w.cnt == 0)
+		return window_empty(stk, pci, &w, TYPE_lng, "sql.count");
+	if ((r = COLnew(w.b->hseqbase, TYPE_lng, w.cnt, TRANSIENT)) == NULL ||
+	    (ignore_nils && !w.b->tnonil && (pc = window_nonils(w.b)) == NULL)) {
+		BBPreclaim(r);
+		window_close(&w);
+		throw(SQL, "sql.count", SQLSTATE(HY001) MAL_MALLOC_FAIL);
+	}
+	rp = (lng *) Tloc(r, 0);
+	if (pc) {
+		for (i = 0; i < w.cnt; i++)
+			rp[i] = (lng) (pc[w.fe[i]] - pc[w.fs[i]]);
+		GDKfree(pc);
+	} else {
+		for (i = 0; i < w.cnt; i++)
+			rp[i] = (lng) (w.fe[i] - w.fs[i]);
+	}
+	BATsetcount(r, w.cnt);
+	r->tsorted = r->trevsorted = w.cnt <= 1;
+	r->tnonil = 1;
+	r->tnil = 0;
+	window_close(&w);
+	BBPkeepref(*getArgReference_bat(stk, pci, 0) = r->batCacheid);
+	return MAL_SUCCEED;
+}
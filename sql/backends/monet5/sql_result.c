@@ -826,9 +826,61 @@ _ASCIIadt_frStr(Column *c, int type, const char *s)
 }
 
 
+/* format an integer without the overhead of snprintf, nil values
+ * are left to the atom's own toStr function */
+#define NUM_TOSTR(TYPE)							\
+	do {								\
+		TYPE v = *(const TYPE *) a;				\
+		char tmp[48];						\
+		int cur = (int) sizeof(tmp) - 1, neg = v < 0;		\
+		ssize_t l;						\
+									\
+		if (is_##TYPE##_nil(v))					\
+			break;						\
+		tmp[cur] = 0;						\
+		do {							\
+			int d = (int) (v % 10);				\
+			tmp[--cur] = (char) ('0' + (neg ? -d : d));	\
+			v /= 10;					\
+		} while (v != 0);					\
+		if (neg)						\
+			tmp[--cur] = '-';				\
+		l = (ssize_t) sizeof(tmp) - 1 - cur;			\
+		if (*buf == NULL || *len < (size_t) l + 1) {		\
+			GDKfree(*buf);					\
+			*len = sizeof(tmp);				\
+			*buf = GDKmalloc(*len);				\
+			if (*buf == NULL)				\
+				return -1;				\
+		}							\
+		memcpy(*buf, tmp + cur, (size_t) l + 1);		\
+		return l;						\
+	} while (0)
+
 static ssize_t
 _ASCIIadt_toStr(void *extra, char **buf, size_t *len, int type, const void *a)
 {
+	switch (type) {
+	case TYPE_bte:
+		NUM_TOSTR(bte);
+		break;
+	case TYPE_sht:
+		NUM_TOSTR(sht);
+		break;
+	case TYPE_int:
+		NUM_TOSTR(int);
+		break;
+	case TYPE_lng:
+		NUM_TOSTR(lng);
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		NUM_TOSTR(hge);
+		break;
+#endif
+	default:
+		break;
+	}
 	if (type == TYPE_str) {
 		Column *c = extra;
 		char *dst;
@@ -1581,7 +1633,7 @@ mvc_export_table_prot10(backend *b, stream *s, res_table *t, BAT *order, BUN off
 						} else {
 							ssize_t slen = 0;
 							if (convert_to_string) {
-								void *element = (void*) BUNtail(iterators[i], crow);
+								void *element = (void*) BUNtail(iterators[i], row);
 								if ((slen = BATatoms[mtype].atomToStr(&result, &length, element)) < 0) {
 									fres = -1;
 									goto cleanup;
@@ -1711,7 +1763,10 @@ mvc_export_table_prot10(backend *b, stream *s, res_table *t, BAT *order, BUN off
 					timestamp *times = (timestamp*) Tloc(iterators[i].b, srow);
 					lng *bufptr = (lng*) buf;
 					for(j = 0; j < (row - srow); j++) {
-						MTIMEepoch2lng(&time, times + j);
+						if (ts_isnil(times[j]))
+							time = lng_nil;
+						else
+							MTIMEepoch2lng(&time, times + j);
 						bufptr[j] = swap ? long_long_SWAP(time) : time;
 					}
 					atom_size = sizeof(lng);
@@ -1723,9 +1778,14 @@ mvc_export_table_prot10(backend *b, stream *s, res_table *t, BAT *order, BUN off
 					int swap = mnstr_byteorder(s) != 1234;
 					date *dates = (date*) Tloc(iterators[i].b, srow);
 					lng *bufptr = (lng*) buf;
+					tstamp.payload.p_msecs = 0;
 					for(j = 0; j < (row - srow); j++) {
-						tstamp.payload.p_days = dates[j];
-						MTIMEepoch2lng(&time, &tstamp);
+						if (date_isnil(dates[j])) {
+							time = lng_nil;
+						} else {
+							tstamp.payload.p_days = dates[j];
+							MTIMEepoch2lng(&time, &tstamp);
+						}
 						bufptr[j] = swap ? long_long_SWAP(time) : time;
 					}
 					atom_size = sizeof(lng);
@@ -2247,6 +2307,7 @@ mvc_export_head_prot10(backend *b, stream *s, int res_id, int only_header, int c
 			// timestamps are converted to Unix Timestamps
 			mtype = TYPE_lng;
 			typelen = sizeof(lng);	
+			nil_type = TYPE_lng;
 		}
 
 		if (convert_to_string) {
@@ -2633,6 +2694,31 @@ mvc_export_chunk(backend *b, stream *s, int res_id, BUN offset, BUN nr)
 	return res;
 }
 
+/*
+ * A partitioned result set is exported to its COPY INTO file one
+ * partition at a time (see the sql.export_table_part instruction).
+ * The result table keeps the columns of the partition that is being
+ * written; rows are written in partition order.
+ */
+int
+mvc_export_part(backend *b, stream *s, int res_id)
+{
+	mvc *m = b->mvc;
+	int res = 0;
+	res_table *t = res_tables_find(m->results, res_id);
+	BAT *order = NULL;
+
+	if (!s || !t)
+		return -1;
+
+	order = BATdescriptor(t->order);
+	if (!order)
+		return -1;
+	res = mvc_export_table(b, s, t, order, 0, BATcount(order), "", t->tsep, t->rsep, t->ssep, t->ns);
+	BBPunfix(order->batCacheid);
+	return res;
+}
+
 
 int
 mvc_result_table(mvc *m, oid query_id, int nr_cols, int type, BAT *order)
@@ -2652,6 +2738,31 @@ mvc_result_column(mvc *m, char *tn, char *name, char *typename, int digits, int
 	return res_col_create(m->session->tr, m->results, tn, name, typename, digits, scale, TYPE_bat, b) == NULL;
 }
 
+/* replace the columns of the result table by the next partition */
+int
+mvc_result_part(mvc *m, int res_id, int nr_cols, BAT **cols)
+{
+	res_table *t = res_tables_find(m->results, res_id);
+	int i;
+
+	if (!t || t->nr_cols != nr_cols)
+		return -1;
+	for (i = 1; i < nr_cols; i++)
+		if (BATcount(cols[i]) != BATcount(cols[0]))
+			return -1;
+	for (i = 0; i < nr_cols; i++) {
+		res_col *c = t->cols + i;
+
+		BBPretain(cols[i]->batCacheid);
+		BBPrelease(c->b);
+		c->b = cols[i]->batCacheid;
+	}
+	BBPretain(cols[0]->batCacheid);
+	BBPrelease(t->order);
+	t->order = cols[0]->batCacheid;
+	return 0;
+}
+
 int
 mvc_result_value(mvc *m, const char *tn, const char *name, const char *typename, int digits, int scale, ptr *p, int mtype)
 {
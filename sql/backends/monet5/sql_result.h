@@ -22,6 +22,7 @@ extern int mvc_export_operation(backend *b, stream *s, str w, lng starttime, lng
 extern int mvc_export_result(backend *b, stream *s, int res_id, lng starttime, lng maloptimizer);
 extern int mvc_export_head(backend *b, stream *s, int res_id, int only_header, int compute_lengths, lng starttime, lng maloptimizer);
 extern int mvc_export_chunk(backend *b, stream *s, int res_id, BUN offset, BUN nr);
+extern int mvc_export_part(backend *b, stream *s, int res_id);
 
 extern int mvc_export_prepare(mvc *c, stream *s, cq *q, str w);
 
@@ -29,6 +30,7 @@ extern str mvc_import_table(Client cntxt, BAT ***bats, mvc *c, bstream *s, sql_t
 extern int mvc_result_table(mvc *m, oid query_id, int nr_cols, int type, BAT *order);
 
 extern int mvc_result_column(mvc *m, char *tn, char *name, char *typename, int digits, int scale, BAT *b);
+extern int mvc_result_part(mvc *m, int res_id, int nr_cols, BAT **cols);
 extern int mvc_result_value(mvc *m, const char *tn, const char *name, const char *typename, int digits, int scale, ptr *p, int mtype);
 
 extern int convert2str(mvc *m, int eclass, int d, int sc, int has_tz, ptr p, int mtype, char **buf, int len);
@@ -223,7 +223,7 @@ SQLepilogue(void *ret)
 	return res;
 }
 
-MT_Id sqllogthread, idlethread;
+MT_Id sqllogthread, idlethread, mergethread;
 
 static str
 SQLinit(void)
@@ -277,6 +277,10 @@ SQLinit(void)
 		}
 		GDKregister(idlethread);
 	}
+	if (MT_create_thread(&mergethread, (void (*)(void *)) mvc_mergemanager, NULL, MT_THR_JOINABLE) != 0) {
+		throw(SQL, "SQLinit", SQLSTATE(42000) "Starting merge manager failed");
+	}
+	GDKregister(mergethread);
 	return WLCinit();
 }
 
@@ -1160,11 +1164,13 @@ SQLparser(Client c)
 			sqlcleanup(m, err);
 			goto finalize;
 		}
+		m->owndels = be->q->owndels;
 		scanner_query_processed(&(m->scanner));
 	} else if (caching(m) && cachable(m, NULL) && m->emode != m_prepare && (be->q = qc_match(m->qc, m->sym, m->args, m->argc, m->scanner.key ^ m->session->schema->base.id)) != NULL) {
 		/* query template was found in the query cache */
 		scanner_query_processed(&(m->scanner));
 		m->no_mitosis = be->q->no_mitosis;
+		m->owndels = be->q->owndels;
 	} else {
 		sql_rel *r;
 
@@ -1222,7 +1228,8 @@ SQLparser(Client c)
 						  m->argc, m->scanner.key ^ m->session->schema->base.id,	/* the statement hash key */
 						  m->emode == m_prepare ? Q_PREPARE : m->type,	/* the type of the statement */
 						  escaped_q,
-						  m->no_mitosis);
+						  m->no_mitosis,
+						  m->owndels);
 			}
 			if(!be->q) {
 				err = 1;
@@ -52,6 +52,157 @@ strToStrSQuote(char **dst, size_t *len, const void *src)
 	return l;
 }
 
+/* Columns with more values than HLL_EXACT get their number of
+ * distinct values estimated with a HyperLogLog sketch of HLL_REGS
+ * registers (a standard error of about 0.8%) instead of counted. */
+#define HLL_EXACT	((BUN) 1 << 16)
+#define HLL_BITS	14
+#define HLL_REGS	(1 << HLL_BITS)
+
+/* number of buckets of the equi-depth histograms, and the maximum
+ * number of values a histogram is computed from */
+#define HIST_BUCKETS	64
+#define HIST_SAMPLE	((BUN) 1 << 16)
+
+static inline ulng
+hll_hash(const void *v, size_t len)
+{
+	const unsigned char *p = v;
+	ulng h = 0xcbf29ce484222325ULL; /* FNV-1a */
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		h ^= p[i];
+		h *= 0x100000001b3ULL;
+	}
+	/* spread the bits (finalizer of MurmurHash3) */
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+/* estimate the number of distinct values of b, or of those in the
+ * sample s if given */
+static lng
+hll_distinct(BAT *b, BAT *s)
+{
+	BATiter bi = bat_iterator(b);
+	unsigned char *regs;
+	const oid *cand = NULL;
+	BUN i, n, p;
+	int j, zeros = 0;
+	dbl sum = 0, est;
+
+	if ((regs = GDKzalloc(HLL_REGS)) == NULL)
+		return -1;
+	if (s) {
+		n = BATcount(s);
+		if (!BATtdense(s))
+			cand = (const oid *) Tloc(s, 0);
+	} else {
+		n = BATcount(b);
+	}
+	for (i = 0; i < n; i++) {
+		const void *v;
+		ulng h;
+		unsigned char r;
+
+		if (s)
+			p = (cand ? cand[i] : s->tseqbase + i) - b->hseqbase;
+		else
+			p = i;
+		v = BUNtail(bi, p);
+		h = hll_hash(v, ATOMvarsized(b->ttype) ? (size_t) ATOMlen(b->ttype, v) : (size_t) b->twidth);
+		/* the first bits select the register, which keeps the
+		 * maximum position of the first 1 bit in the rest */
+		j = (int) (h >> (64 - HLL_BITS));
+		h <<= HLL_BITS;
+		for (r = 1; r <= 64 - HLL_BITS && (h & ((ulng) 1 << 63)) == 0; r++)
+			h <<= 1;
+		if (r > regs[j])
+			regs[j] = r;
+	}
+	for (j = 0; j < HLL_REGS; j++) {
+		sum += ldexp(1.0, -regs[j]);
+		zeros += regs[j] == 0;
+	}
+	GDKfree(regs);
+	est = 0.7213 / (1 + 1.079 / HLL_REGS) * HLL_REGS * HLL_REGS / sum;
+	if (est <= 2.5 * HLL_REGS && zeros > 0) {
+		/* small cardinalities: linear counting */
+		est = HLL_REGS * log((dbl) HLL_REGS / zeros);
+	}
+	return (lng) (est + 0.5);
+}
+
+/* Compute an equi-depth histogram of the non-nil values of b, or of
+ * those in the sample s: HIST_BUCKETS + 1 boundaries such that each
+ * bucket holds about as many values.  The result is a comma separated
+ * list of the boundaries, or NULL if there are no values or in case
+ * of an error. */
+static char *
+equidepth_histogram(BAT *b, BAT *s, ssize_t (*tostr)(str *, size_t *, const void *))
+{
+	BAT *smp = NULL, *nn = NULL, *v = NULL, *srt = NULL;
+	BATiter si;
+	char *res = NULL, *buf = NULL;
+	size_t buflen = 0, reslen = 0, pos = 0;
+	ssize_t l;
+	BUN i, n;
+
+	if (s == NULL && BATcount(b) > HIST_SAMPLE)
+		s = smp = BATsample(b, HIST_SAMPLE);
+	if ((nn = BATselect(b, s, ATOMnilptr(b->ttype), NULL, 1, 1, 1)) == NULL ||
+	    (v = BATproject(nn, b)) == NULL ||
+	    BATsort(&srt, NULL, NULL, v, NULL, NULL, 0, 0) != GDK_SUCCEED ||
+	    (n = BATcount(srt)) == 0)
+		goto bailout;
+	si = bat_iterator(srt);
+	for (i = 0; i <= HIST_BUCKETS; i++) {
+		BUN p = (BUN) ((lng) (n - 1) * (lng) i / HIST_BUCKETS);
+
+		if ((l = tostr(&buf, &buflen, BUNtail(si, p))) < 0)
+			goto bailout;
+		if (pos + l + 2 > reslen) {
+			char *r;
+
+			reslen = (pos + l + 2) * 2;
+			if ((r = GDKrealloc(res, reslen)) == NULL)
+				goto bailout;
+			res = r;
+		}
+		if (i > 0)
+			res[pos++] = ',';
+		memcpy(res + pos, buf, l);
+		pos += l;
+		res[pos] = 0;
+	}
+	GDKfree(buf);
+	BBPunfix(srt->batCacheid);
+	BBPunfix(v->batCacheid);
+	BBPunfix(nn->batCacheid);
+	if (smp)
+		BBPunfix(smp->batCacheid);
+	return res;
+
+  bailout:
+	GDKclrerr();
+	GDKfree(buf);
+	GDKfree(res);
+	if (srt)
+		BBPunfix(srt->batCacheid);
+	if (v)
+		BBPunfix(v->batCacheid);
+	if (nn)
+		BBPunfix(nn->batCacheid);
+	if (smp)
+		BBPunfix(smp->batCacheid);
+	return NULL;
+}
+
 str
 sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
@@ -61,7 +212,7 @@ sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	node *nsch, *ntab, *ncol;
 	char *query = NULL, *dquery;
 	size_t querylen = 0;
-	char *maxval = NULL, *minval = NULL;
+	char *maxval = NULL, *minval = NULL, *histogram = NULL;
 	size_t minlen = 0, maxlen = 0;
 	str sch = 0, tbl = 0, col = 0;
 	int sorted, revsorted;
@@ -136,11 +287,19 @@ sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 							c->min = NULL;
 						if (c->max)
 							c->max = NULL;
+						c->histogram = NULL;
+						c->dcount = 0;
 
 						if ((bn = store_funcs.bind_col(tr, c, RDONLY)) == NULL) {
 							/* XXX throw error instead? */
 							continue;
 						}
+						/* build the zone map and packed form
+						 * here rather than in the first query
+						 * that could use them */
+						if (BATzonemap(bn) != GDK_SUCCEED ||
+						    BATpacked(bn) != GDK_SUCCEED)
+							GDKclrerr();
 						sz = BATcount(bn);
 						tostr = BATatoms[bn->ttype].atomToStr;
 
@@ -163,7 +322,10 @@ sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 						BBPunfix(br->batCacheid);
 						if (bn->tkey)
 							uniq = sz;
-						else if (!minmax) {
+						else if (!minmax &&
+							 (bsample ? BATcount(bsample) : (BUN) sz) > HLL_EXACT) {
+							uniq = hll_distinct(bn, bsample);
+						} else if (!minmax) {
 							BAT *en;
 							if (bsample)
 								br = BATproject(bsample, bn);
@@ -177,6 +339,28 @@ sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 							if (bsample && br)
 								BBPunfix(br->batCacheid);
 						}
+						/* equi-depth histograms of
+						 * numerical and temporal
+						 * columns for estimating the
+						 * selectivity of predicates */
+						histogram = NULL;
+						if (!minmax && tostr &&
+						    bn->ttype != TYPE_void &&
+						    ATOMtype(bn->ttype) != TYPE_oid) {
+							switch (ATOMstorage(bn->ttype)) {
+							case TYPE_bte:
+							case TYPE_sht:
+							case TYPE_int:
+							case TYPE_lng:
+#ifdef HAVE_HGE
+							case TYPE_hge:
+#endif
+							case TYPE_flt:
+							case TYPE_dbl:
+								histogram = equidepth_histogram(bn, bsample, tostr);
+								break;
+							}
+						}
 						if (bsample)
 							BBPunfix(bsample->batCacheid);
 						/* use BATordered(_rev)
@@ -196,6 +380,7 @@ sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 							if (maxval == NULL) {
 								GDKfree(dquery);
 								GDKfree(minval);
+								GDKfree(histogram);
 								throw(SQL, "analyze", SQLSTATE(HY001) MAL_MALLOC_FAIL);
 							}
 							maxlen = 4;
@@ -206,6 +391,7 @@ sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 							if (minval == NULL){
 								GDKfree(dquery);
 								GDKfree(maxval);
+								GDKfree(histogram);
 								throw(SQL, "analyze", SQLSTATE(HY001) MAL_MALLOC_FAIL);
 							}
 							minlen = 4;
@@ -219,6 +405,7 @@ sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 									GDKfree(dquery);
 									GDKfree(minval);
 									GDKfree(maxval);
+									GDKfree(histogram);
 									throw(SQL, "analyze", GDK_EXCEPTION);
 								}
 								GDKfree(val);
@@ -231,6 +418,7 @@ sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 									GDKfree(dquery);
 									GDKfree(minval);
 									GDKfree(maxval);
+									GDKfree(histogram);
 									throw(SQL, "analyze", GDK_EXCEPTION);
 								}
 								GDKfree(val);
@@ -239,18 +427,21 @@ sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 							strcpy(maxval, "nil");
 							strcpy(minval, "nil");
 						}
-						if (strlen(minval) + strlen(maxval) + 1024 > querylen) {
-							querylen = strlen(minval) + strlen(maxval) + 1024;
+						if (strlen(minval) + strlen(maxval) + (histogram ? strlen(histogram) : 0) + 1024 > querylen) {
+							querylen = strlen(minval) + strlen(maxval) + (histogram ? strlen(histogram) : 0) + 1024;
 							GDKfree(query);
 							query = GDKmalloc(querylen);
 							if (query == NULL) {
 								GDKfree(dquery);
 								GDKfree(maxval);
 								GDKfree(minval);
+								GDKfree(histogram);
 								throw(SQL, "analyze", SQLSTATE(HY001) MAL_MALLOC_FAIL);
 							}
 						}
-						snprintf(query, querylen, "insert into sys.statistics (column_id,type,width,stamp,\"sample\",count,\"unique\",nils,minval,maxval,sorted,revsorted) values(%d,'%s',%d,now()," LLFMT "," LLFMT "," LLFMT "," LLFMT ",'%s','%s',%s,%s);", c->base.id, c->type.type->sqlname, width, (samplesize ? samplesize : sz), sz, uniq, nils, minval, maxval, sorted ? "true" : "false", revsorted ? "true" : "false");
+						snprintf(query, querylen, "insert into sys.statistics (column_id,type,width,stamp,\"sample\",count,\"unique\",nils,minval,maxval,sorted,revsorted,histogram) values(%d,'%s',%d,now()," LLFMT "," LLFMT "," LLFMT "," LLFMT ",'%s','%s',%s,%s,%s%s%s);", c->base.id, c->type.type->sqlname, width, (samplesize ? samplesize : sz), sz, uniq, nils, minval, maxval, sorted ? "true" : "false", revsorted ? "true" : "false", histogram ? "'" : "", histogram ? histogram : "null", histogram ? "'" : "");
+						GDKfree(histogram);
+						histogram = NULL;
 #ifdef DEBUG_SQL_STATISTICS
 						fprintf(stderr, "%s\n", dquery);
 						fprintf(stderr, "%s\n", query);
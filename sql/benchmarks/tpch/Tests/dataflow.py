@@ -0,0 +1,80 @@
+import os, sys
+
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# Run the TPC-H queries from several concurrent clients with the work
+# stealing dataflow scheduler and with NUMA placement (pretending there
+# are two nodes, so that the placement is also used on machines with a
+# single node), and compare the results with those of the queries run
+# one at a time with the default scheduler.  Query 15 creates and drops
+# a view, so concurrent clients would conflict; it is left out.
+
+SRCDIR = os.path.join(os.environ['TSTSRCBASE'], os.environ['TSTDIR'])
+TRGDIR = os.environ['TSTTRGDIR']
+
+nclients = 4
+queries = ['%02d' % i for i in range(1, 23) if i != 15]
+common = ['--forcemito', '--set', 'gdk_nr_threads=4']
+modes = [('stealing', ['--set', 'dataflow_stealing=yes']),
+         ('numa', ['--set', 'dataflow_numa=2'])]
+
+def query(q):
+    f = open(os.path.join(SRCDIR, '%s.sql' % q))
+    text = f.read()
+    f.close()
+    return text
+
+def server(args):
+    return process.server(args = common + args,
+                          stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+
+def server_stop(s):
+    out, err = s.communicate()
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+def run_clients(inputs):
+    # the output is large, so write it to files
+    clients = []
+    for k, input in enumerate(inputs):
+        name = os.path.join(TRGDIR, 'dataflow%d.out' % k)
+        f = open(name, 'w')
+        c = process.client('sql', stdin = process.PIPE, stdout = f, stderr = process.PIPE)
+        clients.append((c, f, name))
+    for (c, f, name), input in zip(clients, inputs):
+        c.stdin.write(input)
+        c.stdin.close()
+    outs = []
+    for c, f, name in clients:
+        sys.stderr.write(c.stderr.read())
+        c.wait()
+        f.close()
+        f = open(name)
+        outs.append(f.read())
+        f.close()
+        os.remove(name)
+    return outs
+
+# the reference: one query at a time with the default scheduler
+s = server([])
+expected = {}
+for q in queries:
+    expected[q] = run_clients([query(q)])[0]
+server_stop(s)
+
+for mode, args in modes:
+    # each client runs all queries, starting at a different one
+    inputs = []
+    results = []
+    for k in range(nclients):
+        order = queries[k * 5:] + queries[:k * 5]
+        inputs.append(''.join([query(q) for q in order]))
+        results.append(''.join([expected[q] for q in order]))
+    s = server(args)
+    outs = run_clients(inputs)
+    server_stop(s)
+    sys.stdout.write('%s: %d clients, %d queries, same results: %s\n' %
+                     (mode, nclients, len(queries), outs == results))
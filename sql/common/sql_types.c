@@ -1246,6 +1246,28 @@ sql_create_analytic(sql_allocator *sa, const char *name, const char *mod, const
 	return sql_create_func_(sa, name, mod, imp, l, sres, FALSE, F_ANALYTIC, fix_scale);
 }
 
+/* window aggregates get the partition and peer boundaries, the order
+ * key (as dbl, for RANGE offsets), the frame units and the frame start
+ * and end offsets; count gets an extra flag whether to skip nils */
+static sql_func *
+sql_create_window(sql_allocator *sa, const char *name, const char *imp, sql_type *tpe, sql_type *res, int count, int fix_scale)
+{
+	list *l = sa_list(sa);
+	sql_arg *sres;
+
+	list_append(l, create_arg(sa, NULL, sql_create_subtype(sa, tpe, 0, 0), ARG_IN));
+	list_append(l, create_arg(sa, NULL, sql_bind_localtype("bit"), ARG_IN));
+	list_append(l, create_arg(sa, NULL, sql_bind_localtype("bit"), ARG_IN));
+	list_append(l, create_arg(sa, NULL, sql_bind_localtype("dbl"), ARG_IN));
+	list_append(l, create_arg(sa, NULL, sql_bind_localtype("int"), ARG_IN));
+	list_append(l, create_arg(sa, NULL, sql_bind_localtype("lng"), ARG_IN));
+	list_append(l, create_arg(sa, NULL, sql_bind_localtype("lng"), ARG_IN));
+	if (count)
+		list_append(l, create_arg(sa, NULL, sql_bind_localtype("bit"), ARG_IN));
+	sres = create_arg(sa, NULL, sql_create_subtype(sa, res, 0, 0), ARG_OUT);
+	return sql_create_func_(sa, name, "sql", imp, l, sres, FALSE, F_ANALYTIC, fix_scale);
+}
+
 sql_func *
 sql_create_func4(sql_allocator *sa, const char *name, const char *mod, const char *imp, sql_type *tpe1, sql_type *tpe2, sql_type *tpe3, sql_type *tpe4, sql_type *res, int fix_scale)
 {
@@ -1589,11 +1611,37 @@ sqltypeinit( sql_allocator *sa)
 	//sql_create_analytic(sa, "lead", "sql", "lead", ANY, BIT, BIT, ANY, SCALE_NONE);
 	//sql_create_analytic(sa, "first_value", "sql", "first_value", ANY, BIT, BIT, ANY, SCALE_NONE);
 	//sql_create_analytic(sa, "last_value", "sql", "last_value", ANY, BIT, BIT, ANY, SCALE_NONE);
-	//sql_create_analytic(sa, "sum", "sql", "sum", ANY, BIT, BIT, ANY, SCALE_NONE);
-	//sql_create_analytic(sa, "min", "sql", "min", ANY, BIT, BIT, ANY, SCALE_NONE);
-	//sql_create_analytic(sa, "max", "sql", "max", ANY, BIT, BIT, ANY, SCALE_NONE);
-	//sql_create_analytic(sa, "avg", "sql", "avg", ANY, BIT, BIT, ANY, SCALE_NONE);
-	//sql_create_analytic(sa, "count", "sql", "count", ANY, BIT, BIT, ANY, SCALE_NONE);
+
+	/* window aggregates */
+	sql_create_window(sa, "sum", "sum", BTE, LargestINT, 0, SCALE_FIX);
+	sql_create_window(sa, "sum", "sum", SHT, LargestINT, 0, SCALE_FIX);
+	sql_create_window(sa, "sum", "sum", INT, LargestINT, 0, SCALE_FIX);
+#ifdef HAVE_HGE
+	if (have_hge)
+		sql_create_window(sa, "sum", "sum", HGE, LargestINT, 0, SCALE_FIX);
+#endif
+	sql_create_window(sa, "sum", "sum", LNG, LNG, 0, SCALE_FIX);
+	for (t = decimals; t < floats; t++)
+		sql_create_window(sa, "sum", "sum", *t, LargestDEC, 0, SCALE_FIX);
+	for (t = floats; t < dates; t++)
+		sql_create_window(sa, "sum", "sum", *t, *t, 0, SCALE_FIX);
+	sql_create_window(sa, "sum", "sum", MONINT, MONINT, 0, SCALE_FIX);
+	sql_create_window(sa, "sum", "sum", SECINT, SECINT, 0, SCALE_FIX);
+
+	sql_create_window(sa, "avg", "avg", DBL, DBL, 0, SCALE_NONE);
+	sql_create_window(sa, "avg", "avg", BTE, DBL, 0, SCALE_NONE);
+	sql_create_window(sa, "avg", "avg", SHT, DBL, 0, SCALE_NONE);
+	sql_create_window(sa, "avg", "avg", INT, DBL, 0, SCALE_NONE);
+	sql_create_window(sa, "avg", "avg", LNG, DBL, 0, SCALE_NONE);
+#ifdef HAVE_HGE
+	if (have_hge)
+		sql_create_window(sa, "avg", "avg", HGE, DBL, 0, SCALE_NONE);
+#endif
+	sql_create_window(sa, "avg", "avg", FLT, DBL, 0, SCALE_NONE);
+
+	sql_create_window(sa, "min", "min", ANY, ANY, 0, SCALE_NONE);
+	sql_create_window(sa, "max", "max", ANY, ANY, 0, SCALE_NONE);
+	sql_create_window(sa, "count", "count", ANY, LNG, 1, SCALE_NONE);
 
 	sql_create_func(sa, "and", "calc", "and", BIT, BIT, BIT, SCALE_FIX);
 	sql_create_func(sa, "or",  "calc",  "or", BIT, BIT, BIT, SCALE_FIX);
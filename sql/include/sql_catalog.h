@@ -211,6 +211,7 @@ typedef struct sql_trans {
 	int schema_number;	/* schema timestamp */
 	int schema_updates;	/* set on schema changes */
 	int status;		/* status of the last query */
+	lng log_lsn;		/* write-ahead log sequence number of the commit */
 	list *dropped;  	/* protection against recursive cascade action*/
 
 	changeset schemas;
@@ -466,6 +467,7 @@ typedef struct sql_column {
 	size_t dcount;
 	char *min;
 	char *max;
+	char *histogram;	/* equi-depth histogram from the statistics */
 
 	struct sql_table *t;
 	struct sql_column *po;	/* the outer transactions column */
@@ -518,6 +520,7 @@ typedef struct sql_table {
 	int drop_action;	/* only needed for alter drop table */
 
 	int cleared;		/* cleared in the current transaction */
+	int drtime;		/* deleted rows read, other than to change them */
 	void *data;
 	struct sql_schema *s;
 	struct sql_table *p;	/* The table is part of this merge table */
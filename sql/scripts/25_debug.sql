@@ -17,6 +17,12 @@ create function sys.queryCache()
 	returns table (query string, count int)
 	external name sql.dump_cache;
 
+-- The number of entries, the limit on the number of entries, and the
+-- number of hits, misses and evictions of the SQL query cache
+create function sys.queryCacheStats()
+	returns table (event string, count bigint)
+	external name sql.dump_cache_stats;
+
 -- Trace the SQL input
 create procedure sys.querylog(filename string)
 	external name sql.logfile;
@@ -52,5 +58,12 @@ create procedure sys.evalAlgebra( ra_stmt string, opt bool)
 create procedure sys.flush_log ()
 	external name sql."flush_log";
 
+-- the number of inserted rows, updated values and deleted rows of the
+-- persistent tables that are kept in deltas, i.e. not yet merged into
+-- the columns
+create function sys.deltas()
+	returns table ("schema" string, "table" string, inserted bigint, updated bigint, deleted bigint)
+	external name sql.deltas;
+
 create function sys.debug(debug int) returns integer
 	external name mdb."setDebug";
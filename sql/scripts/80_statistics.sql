@@ -21,7 +21,8 @@ CREATE TABLE sys.statistics(
 	minval string,
 	maxval string,
 	sorted boolean,
-	revsorted boolean);
+	revsorted boolean,
+	histogram string);
 
 create procedure sys.analyze(minmax int, "sample" bigint)
 external name sql.analyze;
@@ -20,6 +20,7 @@
 #include "mal.h"		/* for have_hge */
 #endif
 #include "mtime.h"
+#include <math.h>
 
 #define new_func_list(sa) sa_list(sa)
 #define new_col_list(sa) sa_list(sa)
@@ -460,6 +461,256 @@ exp_keyvalue(sql_exp *e)
 	return cnt;
 }
 
+/* Selectivity estimation using the statistics gathered by ANALYZE.
+ * The histograms are equi-depth, i.e. each bucket between two
+ * consecutive boundaries holds about as many values. */
+#define HIST_MAXBOUNDS	1024
+
+/* value v of type tpe as a double, unless it is nil */
+static int
+val_todbl(int tpe, const void *v, dbl *d)
+{
+	switch (ATOMstorage(tpe)) {
+	case TYPE_bte:
+		if (is_bte_nil(*(const bte *) v))
+			return 0;
+		*d = (dbl) *(const bte *) v;
+		return 1;
+	case TYPE_sht:
+		if (is_sht_nil(*(const sht *) v))
+			return 0;
+		*d = (dbl) *(const sht *) v;
+		return 1;
+	case TYPE_int:
+		if (is_int_nil(*(const int *) v))
+			return 0;
+		*d = (dbl) *(const int *) v;
+		return 1;
+	case TYPE_lng:
+		if (is_lng_nil(*(const lng *) v))
+			return 0;
+		*d = (dbl) *(const lng *) v;
+		return 1;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		if (is_hge_nil(*(const hge *) v))
+			return 0;
+		*d = (dbl) *(const hge *) v;
+		return 1;
+#endif
+	case TYPE_flt:
+		if (is_flt_nil(*(const flt *) v))
+			return 0;
+		*d = (dbl) *(const flt *) v;
+		return 1;
+	case TYPE_dbl:
+		if (is_dbl_nil(*(const dbl *) v))
+			return 0;
+		*d = *(const dbl *) v;
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/* parse the histogram h of column c into its boundaries */
+static int
+hist_bounds(sql_column *c, const char *h, dbl *bounds)
+{
+	int tpe = c->type.type->localtype, n = 0;
+	void *v = NULL;
+	size_t vlen = 0;
+	char buf[128];
+
+	while (*h && n < HIST_MAXBOUNDS) {
+		size_t l = strcspn(h, ",");
+
+		if (l >= sizeof(buf))
+			break;
+		memcpy(buf, h, l);
+		buf[l] = 0;
+		if (ATOMfromstr(tpe, &v, &vlen, buf) < 0 ||
+		    !val_todbl(tpe, v, &bounds[n])) {
+			GDKclrerr();
+			n = 0;
+			break;
+		}
+		n++;
+		h += l;
+		if (*h == ',')
+			h++;
+	}
+	GDKfree(v);
+	return n;
+}
+
+/* fraction of the values below x, or not above x if incl */
+static dbl
+hist_frac(const dbl *b, int n, dbl x, int incl)
+{
+	int j;
+
+	for (j = 0; j < n && (incl ? b[j] <= x : b[j] < x); j++)
+		;
+	if (j == 0)
+		return 0;
+	if (j == n)
+		return 1;
+	return (j - 1 + (x - b[j - 1]) / (b[j] - b[j - 1])) / (n - 1);
+}
+
+/* Estimate the fraction of the rows of rel that satisfy e, a
+ * comparison of a column with constants.  Returns -1 if there are no
+ * statistics to base the estimate on. */
+static dbl
+exp_selectivity(mvc *sql, sql_rel *rel, sql_exp *e)
+{
+	sql_column *c;
+	sql_exp *le;
+	char *h;
+	atom *a, *f = NULL;
+	dbl b[HIST_MAXBOUNDS], x, y = 0, sel;
+	int n, tpe;
+
+	if (e->type != e_cmp || is_complex_exp(e->flag) || !sql->session->tr)
+		return -1;
+	le = e->l;
+	if (le->type != e_column ||
+	    (c = exp_find_column(rel, le, -2)) == NULL ||
+	    (h = sql_trans_histogram(sql->session->tr, c)) == NULL)
+		return -1;
+	tpe = c->type.type->localtype;
+	if ((a = exp_value(sql, e->r, sql->args, sql->argc)) == NULL ||
+	    a->isnull || a->data.vtype != tpe ||
+	    !val_todbl(tpe, VALptr(&a->data), &x))
+		return -1;
+	if (e->f &&
+	    ((f = exp_value(sql, e->f, sql->args, sql->argc)) == NULL ||
+	     f->isnull || f->data.vtype != tpe ||
+	     !val_todbl(tpe, VALptr(&f->data), &y)))
+		return -1;
+	if ((n = hist_bounds(c, h, b)) < 2)
+		return -1;
+	if (f) {
+		/* range, see compare2range */
+		int r = get_cmp(e);
+
+		sel = hist_frac(b, n, y, (r & 2) != 0) - hist_frac(b, n, x, (r & 1) == 0);
+	} else {
+		switch (get_cmp(e)) {
+		case cmp_equal:
+		case cmp_notequal: {
+			int i, eq = 0;
+
+			/* a value that spans buckets is frequent */
+			for (i = 0; i < n; i++)
+				eq += b[i] == x;
+			sel = eq > 1 ? (dbl) (eq - 1) / (n - 1) : 0;
+			if (c->dcount > 0 && x >= b[0] && x <= b[n - 1])
+				sel = MAX(sel, 1.0 / c->dcount);
+			if (get_cmp(e) == cmp_notequal)
+				sel = 1 - sel;
+			break;
+		}
+		case cmp_lt:
+			sel = hist_frac(b, n, x, 0);
+			break;
+		case cmp_lte:
+			sel = hist_frac(b, n, x, 1);
+			break;
+		case cmp_gt:
+			sel = 1 - hist_frac(b, n, x, 1);
+			break;
+		case cmp_gte:
+			sel = 1 - hist_frac(b, n, x, 0);
+			break;
+		default:
+			return -1;
+		}
+	}
+	if (is_anti(e))
+		sel = 1 - sel;
+	/* the histogram is built from a sample, so never rule out
+	 * everything */
+	return MAX(MIN(sel, 1.0), 1e-6);
+}
+
+/* Estimate the number of rows of rel, a (selection on a) base table.
+ * Sets *known if statistics were used.  Returns -1 if there is no
+ * estimate. */
+static dbl
+rel_estimate(mvc *sql, sql_rel *rel, int *known)
+{
+	switch (rel->op) {
+	case op_basetable: {
+		sql_table *t = rel->l;
+
+		if (t && isTable(t) && t->columns.set && t->columns.set->h && sql->session->tr)
+			return (dbl) store_funcs.count_col(sql->session->tr, t->columns.set->h->data, 1);
+		return -1;
+	}
+	case op_select: {
+		dbl est = rel->l ? rel_estimate(sql, rel->l, known) : -1, sel;
+		node *n;
+
+		if (est < 0 || !rel->exps)
+			return est;
+		for (n = rel->exps->h; n; n = n->next) {
+			sql_exp *e = n->data;
+
+			if ((sel = exp_selectivity(sql, rel, e)) >= 0) {
+				est *= sel;
+				*known = 1;
+			} else if (e->type == e_cmp && get_cmp(e) == cmp_equal && !e->f) {
+				est *= 0.1;
+			} else {
+				est *= 0.5;
+			}
+		}
+		return est;
+	}
+	case op_project:
+		return rel->l ? rel_estimate(sql, rel->l, known) : -1;
+	default:
+		return -1;
+	}
+}
+
+/* number of distinct values of column expression ce of rel: from the
+ * statistics, or else assume it is a key of the underlying table */
+static dbl
+rel_exp_distinct(mvc *sql, sql_rel *rel, sql_exp *ce, int *known)
+{
+	sql_column *c = exp_find_column(rel, ce, -2);
+
+	if (c && sql_trans_histogram(sql->session->tr, c) && c->dcount > 0) {
+		*known = 1;
+		return (dbl) c->dcount;
+	}
+	while (rel && (is_select(rel->op) || is_project(rel->op)) && rel->l)
+		rel = rel->l;
+	return rel ? rel_estimate(sql, rel, known) : -1;
+}
+
+/* Estimate the size of the result of the equi-join e of l and r. */
+static dbl
+exp_join_estimate(mvc *sql, sql_exp *e, sql_rel *l, sql_rel *r, int *known)
+{
+	dbl el, er, dl, dr;
+
+	if (e->type != e_cmp || is_complex_exp(e->flag) ||
+	    get_cmp(e) != cmp_equal || e->f || is_anti(e) ||
+	    ((sql_exp *) e->l)->type != e_column ||
+	    ((sql_exp *) e->r)->type != e_column)
+		return -1;
+	if ((el = rel_estimate(sql, l, known)) < 0 ||
+	    (er = rel_estimate(sql, r, known)) < 0 ||
+	    (dl = rel_exp_distinct(sql, l, e->l, known)) < 0 ||
+	    (dr = rel_exp_distinct(sql, r, e->r, known)) < 0)
+		return -1;
+	return el * er / MAX(MAX(dl, dr), 1);
+}
+
 static sql_exp *
 joinexp_col(sql_exp *e, sql_rel *r)
 {
@@ -617,27 +868,33 @@ order_join_expressions(mvc *sql, list *dje, list *rels)
 	list *res;
 	node *n = NULL;
 	int i, j, *keys, *pos, cnt = list_length(dje);
-	int debug = mvc_debug_on(sql, 16);
+	int debug = mvc_debug_on(sql, 16), known = 0;
+	dbl *est;
 
 	keys = (int*)malloc(cnt*sizeof(int));
 	pos = (int*)malloc(cnt*sizeof(int));
-	if (keys == NULL || pos == NULL) {
+	est = (dbl*)malloc(cnt*sizeof(dbl));
+	if (keys == NULL || pos == NULL || est == NULL) {
 		if (keys)
 			free(keys);
 		if (pos)
 			free(pos);
+		if (est)
+			free(est);
 		return NULL;
 	}
 	res = sa_list(sql->sa);
 	if (res == NULL) {
 		free(keys);
 		free(pos);
+		free(est);
 		return NULL;
 	}
 	for (n = dje->h, i = 0; n; n = n->next, i++) {
 		sql_exp *e = n->data;
 
 		keys[i] = exp_keyvalue(e);
+		est[i] = -1;
 		/* add some weight for the selections */
 		if (e->type == e_cmp && !is_complex_exp(e->flag)) {
 			sql_rel *l = find_rel(rels, e->l);
@@ -647,9 +904,18 @@ order_join_expressions(mvc *sql, list *dje, list *rels)
 				keys[i] += list_length(l->exps)*10 + exps_count(l->exps)*debug;
 			if (r && is_select(r->op) && r->exps)
 				keys[i] += list_length(r->exps)*10 + exps_count(r->exps)*debug;
+			if (l && r)
+				est[i] = exp_join_estimate(sql, e, l, r, &known);
 		}
 		pos[i] = i;
 	}
+	/* with statistics, first the joins that are estimated to
+	 * produce the fewest rows */
+	for (i = 0; i < cnt && known; i++)
+		if (est[i] < 0)
+			known = 0;
+	for (i = 0; i < cnt && known; i++)
+		keys[i] -= (int) (10 * log2(est[i] + 1));
 	/* sort descending */
 	if (cnt > 1) 
 		GDKqsort_rev(keys, pos, NULL, cnt, sizeof(int), sizeof(int), TYPE_int);
@@ -660,6 +926,7 @@ order_join_expressions(mvc *sql, list *dje, list *rels)
 	}
 	free(keys);
 	free(pos);
+	free(est);
 	return res;
 }
 
@@ -6822,10 +7089,15 @@ static int
 score_se( mvc *sql, sql_rel *rel, sql_exp *e)
 {
 	int score = 0;
+	dbl sel;
+
 	if (e->type == e_cmp && !is_complex_exp(e->flag)) {
 		score += score_gbe(sql, rel, e->l);
 	}
 	score += exp_keyvalue(e);
+	/* with statistics, the more selective the earlier */
+	if ((sel = exp_selectivity(sql, rel, e)) >= 0)
+		score += (int) (-10 * log2(sel));
 	return score;
 }
 
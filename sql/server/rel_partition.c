@@ -144,6 +144,9 @@ rel_partition(mvc *sql, sql_rel *rel)
 		rel_partition(sql, rel->l);
 	} else if (is_project(rel->op) && rel->l) {
 		rel_partition(sql, rel->l);
+	} else if (is_output(rel) && rel->l) {
+		/* COPY INTO file/stdout */
+		rel_partition(sql, rel->l);
 	} else if (rel->op == op_semi && rel->l && rel->r) {
 		rel_partition(sql, rel->l);
 		rel_partition(sql, rel->r);
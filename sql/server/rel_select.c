@@ -4380,24 +4380,54 @@ rel_order_by(mvc *sql, sql_rel **R, symbol *orderby, int f )
 	return exps;
 }
 
+/* frame bounds are passed as lng offsets: nil for UNBOUNDED, 0 for
+ * CURRENT ROW and the (constant) value of n for n PRECEDING/FOLLOWING */
+static sql_exp *
+rel_frame_bound(mvc *sql, symbol *bound)
+{
+	exp_kind ek = {type_value, card_value, FALSE};
+	sql_exp *e;
+
+	if (bound->token == SQL_FRAME)
+		return exp_atom_lng(sql->sa, bound->data.i_val < 0 ? lng_nil : 0);
+	e = rel_value_exp(sql, NULL, bound, sql_sel, ek);
+	if (!e)
+		return NULL;
+	return rel_check_type(sql, sql_bind_localtype("lng"), e, type_equal);
+}
+
 static list *
 rel_frame(mvc *sql, symbol *frame, list *exps)
 {
-	/* units, extent, exclusion */
+	/* extent (start, end), units, exclusion */
 	dnode *d = frame->data.lval->h;
-
-	/* RANGE vs UNITS */
-	sql_exp *units = exp_atom_int(sql->sa, d->next->next->data.i_val);
-	sql_exp *start = exp_atom_int(sql->sa, d->data.i_val);
-	sql_exp *end   = exp_atom_int(sql->sa, d->next->data.i_val);
-	sql_exp *excl  = exp_atom_int(sql->sa, d->next->next->next->data.i_val);
-	append(exps, units);
+	int units = d->next->next->data.i_val;
+	int excl = d->next->next->next->data.i_val;
+	sql_exp *start, *end;
+
+	if (excl != EXCLUDE_NONE && excl != EXCLUDE_NO_OTHERS)
+		return sql_error(sql, 02, SQLSTATE(42000) "OVER: frame exclusion not supported");
+	start = rel_frame_bound(sql, d->data.sym);
+	end = rel_frame_bound(sql, d->next->data.sym);
+	if (!start || !end)
+		return NULL;
+	append(exps, exp_atom_int(sql->sa, units));
 	append(exps, start);
 	append(exps, end);
-	append(exps, excl);
 	return exps;
 }
 
+/* RANGE frames with an offset need the (single, numerical) order key */
+static int
+rel_frame_has_offset(symbol *frame)
+{
+	dnode *d = frame->data.lval->h;
+
+	return d->next->next->data.i_val == FRAME_RANGE &&
+		(d->data.sym->token != SQL_FRAME ||
+		 d->next->data.sym->token != SQL_FRAME);
+}
+
 /* window functions */
 
 /*
@@ -4491,28 +4521,68 @@ rel_rankop(mvc *sql, sql_rel **rel, symbol *se, int f)
 		}
 	}
 	/* Frame */
-	if (window_specification->h->next->next->data.sym) {
+	if (window_function->token != SQL_RANK) {
+		symbol *frame = window_specification->h->next->next->data.sym;
+		sql_exp *ke;
+
 		fbe = new_exp_list(sql->sa);
-		fbe = rel_frame(sql, window_specification->h->next->next->data.sym, fbe);
-		if (!fbe)
-			return NULL;
+		if (frame) {
+			fbe = rel_frame(sql, frame, fbe);
+			if (!fbe)
+				return NULL;
+		} else if (obe) {
+			/* RANGE BETWEEN UNBOUNDED PRECEDING AND CURRENT ROW */
+			append(fbe, exp_atom_int(sql->sa, FRAME_RANGE));
+			append(fbe, exp_atom_lng(sql->sa, lng_nil));
+			append(fbe, exp_atom_lng(sql->sa, 0));
+		} else {
+			/* the whole partition */
+			append(fbe, exp_atom_int(sql->sa, FRAME_ROWS));
+			append(fbe, exp_atom_lng(sql->sa, lng_nil));
+			append(fbe, exp_atom_lng(sql->sa, lng_nil));
+		}
+		if (frame && rel_frame_has_offset(frame)) {
+			int ec;
+
+			if (list_length(obe) != 1)
+				return sql_error(sql, 02, SQLSTATE(42000) "OVER: RANGE with offset requires exactly one ORDER BY column");
+			ke = obe->h->data;
+			ec = exp_subtype(ke)->type->eclass;
+			if (ec != EC_NUM && ec != EC_DEC && ec != EC_FLT)
+				return sql_error(sql, 02, SQLSTATE(42000) "OVER: RANGE with offset requires a numerical ORDER BY column");
+			ke = rel_check_type(sql, sql_bind_localtype("dbl"), ke, type_equal);
+			if (!ke)
+				return NULL;
+		} else {
+			ke = exp_atom(sql->sa, atom_float(sql->sa, sql_bind_localtype("dbl"), 0));
+		}
+		list_prepend(fbe, ke);
 	}
 
 	if (window_function->token == SQL_RANK) {
-		e = p->exps->h->data; 
+		e = p->exps->h->data;
 		e = exp_column(sql->sa, exp_relname(e), exp_name(e), exp_subtype(e), exp_card(e), has_nil(e), is_intern(e));
 	} else {
 		dnode *n = window_function->data.lval->h->next;
 
-		if (n) {
+		distinct = n->data.i_val;
+		if (distinct)
+			return sql_error(sql, 02, SQLSTATE(42000) "OVER: DISTINCT not supported in window functions");
+		if (n->next->data.sym) {
 			int is_last = 0;
 			exp_kind ek = {type_value, card_column, FALSE};
 
-			distinct = n->data.i_val;
 			e = rel_value_exp2(sql, &p, n->next->data.sym, f, ek, &is_last);
+		} else if (strcmp(aname, "count") == 0) {
+			e = p->exps->h->data;
+			e = exp_column(sql->sa, exp_relname(e), exp_name(e), exp_subtype(e), exp_card(e), has_nil(e), is_intern(e));
+		} else {
+			return sql_error(sql, 02, SQLSTATE(42000) "SELECT: function '%s' not found", aname);
 		}
+		/* count(x) skips nils, count(*) does not */
+		if (strcmp(aname, "count") == 0)
+			append(fbe, exp_atom_bool(sql->sa, n->next->data.sym != NULL));
 	}
-	(void)distinct;
 
 	/* diff for partitions */
 	if (gbe) {
@@ -4563,17 +4633,25 @@ rel_rankop(mvc *sql, sql_rel **rel, symbol *se, int f)
 
 	if (!e || !pe || !oe)
 		return NULL;
-	types = sa_list(sql->sa);
-	append(types, exp_subtype(e));
-	append(types, exp_subtype(pe));
-	append(types, exp_subtype(oe));
-	wf = bind_func_(sql, s, aname, types, F_ANALYTIC);
-	if (!wf)
-		return sql_error(sql, 02, SQLSTATE(42000) "SELECT: function '%s' not found", aname );
 	args = sa_list(sql->sa);
 	append(args, e);
 	append(args, pe);
 	append(args, oe);
+	if (fbe)
+		list_merge(args, fbe, (fdup)NULL);
+	types = exp_types(sql->sa, args);
+	wf = bind_func_(sql, s, aname, types, F_ANALYTIC);
+	if (!wf && fbe && strcmp(aname, "avg") == 0) {
+		/* average of other numerical types in dbl */
+		e = rel_check_type(sql, sql_bind_localtype("dbl"), e, type_equal);
+		if (!e)
+			return NULL;
+		args->h->data = e;
+		types->h->data = exp_subtype(e);
+		wf = bind_func_(sql, s, aname, types, F_ANALYTIC);
+	}
+	if (!wf)
+		return sql_error(sql, 02, SQLSTATE(42000) "SELECT: function '%s' not found", aname );
 	e = exp_op(sql->sa, args, wf);
 
 	r->l = p = rel_project(sql->sa, p, rel_projections(sql, p, NULL, 1, 1));
@@ -222,6 +222,15 @@ mvc_idlemanager(void)
 	THRdel(thr);
 }
 
+void
+mvc_mergemanager(void)
+{
+	Thread thr = THRnew("mergemanager");
+
+	merge_manager();
+	THRdel(thr);
+}
+
 int
 mvc_status(mvc *m)
 {
@@ -276,8 +285,8 @@ mvc_trans(mvc *m)
 				store_unlock();
 				return -1;
 			}
-		} else { /* clean all but the prepared statements */
-			qc_clean(m->qc);
+		} else { /* evict the least recently used queries */
+			qc_evict(m->qc, m->cache);
 		}
 	}
 	store_unlock();
@@ -335,6 +344,7 @@ mvc_commit(mvc *m, int chain, const char *name)
 {
 	sql_trans *cur, *tr = m->session->tr, *ctr;
 	int ok = SQL_OK;//, wait = 0;
+	lng lsn = 0;
 	str msg;
 
 	assert(tr);
@@ -435,6 +445,7 @@ build up the hash (not copied in the trans dup)) */
 			GDKfatal("%s", msg);
 			_DELETE(msg);
 		}
+		lsn = tr->log_lsn;
 	} else {
 		store_unlock();
 		(void)sql_error(m, 010, SQLSTATE(40000) "COMMIT: transaction is aborted because of concurrency conflicts, will ROLLBACK instead");
@@ -452,6 +463,13 @@ build up the hash (not copied in the trans dup)) */
 	if (chain) 
 		sql_trans_begin(m->session);
 	store_unlock();
+	/* wait for the write-ahead log to be on disk, together with
+	 * the commits of other sessions */
+	if (store_sync(lsn) != LOG_OK) {
+		char *msg = sql_message(SQLSTATE(40000) "COMMIT: write-ahead log sync failed (perhaps your disk is full?) exiting (kernel error: %s)", GDKerrbuf);
+		GDKfatal("%s", msg);
+		_DELETE(msg);
+	}
 	m->type = Q_TRANS;
 	if (mvc_debug)
 		fprintf(stderr, "#mvc_commit %s done\n", (name) ? name : "");
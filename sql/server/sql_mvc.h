@@ -105,6 +105,7 @@ typedef struct mvc {
 	int argmax;
 	struct symbol *sym;
 	int no_mitosis;		/* run query without mitosis */
+	int owndels;		/* table whose deleted rows are only read to change them */
 
 	int user_id;
 	int role_id;
@@ -141,6 +142,7 @@ extern int mvc_init(int debug, store_type store, int ro, int su, backend_stack s
 extern void mvc_exit(void);
 extern void mvc_logmanager(void);
 extern void mvc_idlemanager(void);
+extern void mvc_mergemanager(void);
 
 extern mvc *mvc_create(int clientid, backend_stack stk, int debug, bstream *rs, stream *ws);
 extern int mvc_reset(mvc *m, bstream *rs, stream *ws, int debug, int globalvars);
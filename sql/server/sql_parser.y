@@ -4030,7 +4030,7 @@ window_frame_units:
   ;
 
 window_frame_extent:
-	window_frame_start	{ $$ = append_symbol(append_symbol(L(), $1), _symbol_create_int(SQL_FRAME, -1)); }
+	window_frame_start	{ $$ = append_symbol(append_symbol(L(), $1), _symbol_create_int(SQL_FRAME, 0)); }
   |	window_frame_between	{ $$ = $1; }
   ;
 
@@ -34,6 +34,13 @@
  *
  * The optimization/processing cost should be kept around and the re-use of
  * a cache entry.
+ *
+ * The entries are kept in two hash tables, one on the query key and
+ * the number of parameters (used by qc_match) and one on the cache
+ * entry number (used by qc_find), and in a list ordered on the last
+ * use.  When the cache grows beyond its limit (the session variable
+ * "cache"), the least recently used entries other than prepared
+ * statements are evicted.
  */
 
 #include "monetdb_config.h"
@@ -42,20 +49,139 @@
 #include "sql_mvc.h"
 #include "sql_atom.h"
 
+#define QC_HASHSIZE	64
+
+static inline unsigned int
+qc_khash(qc *cache, int key, int plen)
+{
+	unsigned int h = (unsigned int) key ^ ((unsigned int) plen << 24);
+
+	h ^= h >> 16;
+	h *= 0x45d9f3b;
+	h ^= h >> 16;
+	return h & (cache->hsize - 1);
+}
+
+#define qc_ihash(cache, id)	((unsigned int) (id) & ((cache)->hsize - 1))
+
 qc *
 qc_create(int clientid, int seqnr)
 {
-	qc *r = MNEW(qc);
+	qc *r = ZNEW(qc);
 	if(!r)
 		return NULL;
 	r->clientid = clientid;
 	r->id = seqnr;
 	r->nr = 0;
 
-	r->q = NULL;
+	r->q = r->last = NULL;
+	r->hsize = QC_HASHSIZE;
+	r->khash = GDKzalloc(r->hsize * sizeof(cq *));
+	r->ihash = GDKzalloc(r->hsize * sizeof(cq *));
+	if (!r->khash || !r->ihash) {
+		GDKfree(r->khash);
+		GDKfree(r->ihash);
+		_DELETE(r);
+		return NULL;
+	}
 	return r;
 }
 
+/* double the number of hash buckets; on failure the chains just get
+ * longer */
+static void
+qc_grow(qc *cache)
+{
+	int hsize = cache->hsize * 2;
+	cq **khash, **ihash, *q;
+
+	khash = GDKzalloc(hsize * sizeof(cq *));
+	ihash = GDKzalloc(hsize * sizeof(cq *));
+	if (!khash || !ihash) {
+		GDKfree(khash);
+		GDKfree(ihash);
+		GDKclrerr();
+		return;
+	}
+	GDKfree(cache->khash);
+	GDKfree(cache->ihash);
+	cache->khash = khash;
+	cache->ihash = ihash;
+	cache->hsize = hsize;
+	for (q = cache->q; q; q = q->next) {
+		unsigned int k = qc_khash(cache, q->key, q->paramlen);
+		unsigned int i = qc_ihash(cache, q->id);
+
+		q->knext = khash[k];
+		khash[k] = q;
+		q->inext = ihash[i];
+		ihash[i] = q;
+	}
+}
+
+/* add q to the cache as the most recently used entry */
+static void
+qc_link(qc *cache, cq *q)
+{
+	unsigned int k, i;
+
+	if (cache->nr >= cache->hsize)
+		qc_grow(cache);
+	k = qc_khash(cache, q->key, q->paramlen);
+	i = qc_ihash(cache, q->id);
+	q->knext = cache->khash[k];
+	cache->khash[k] = q;
+	q->inext = cache->ihash[i];
+	cache->ihash[i] = q;
+	q->prev = NULL;
+	q->next = cache->q;
+	if (cache->q)
+		cache->q->prev = q;
+	else
+		cache->last = q;
+	cache->q = q;
+	cache->nr++;
+}
+
+static void
+qc_unlink(qc *cache, cq *q)
+{
+	cq **p;
+
+	for (p = &cache->khash[qc_khash(cache, q->key, q->paramlen)]; *p != q; p = &(*p)->knext)
+		assert(*p);
+	*p = q->knext;
+	for (p = &cache->ihash[qc_ihash(cache, q->id)]; *p != q; p = &(*p)->inext)
+		assert(*p);
+	*p = q->inext;
+	if (q->prev)
+		q->prev->next = q->next;
+	else
+		cache->q = q->next;
+	if (q->next)
+		q->next->prev = q->prev;
+	else
+		cache->last = q->prev;
+	cache->nr--;
+}
+
+/* move q to the front of the use list */
+static void
+qc_touch(qc *cache, cq *q)
+{
+	if (cache->q == q)
+		return;
+	q->prev->next = q->next;
+	if (q->next)
+		q->next->prev = q->prev;
+	else
+		cache->last = q->prev;
+	q->prev = NULL;
+	q->next = cache->q;
+	cache->q->prev = q;
+	cache->q = q;
+}
+
 static void
 cq_delete(int clientid, cq *q)
 {
@@ -75,17 +201,12 @@ cq_delete(int clientid, cq *q)
 void
 qc_delete(qc *cache, cq *q)
 {
-	cq *n, *p = NULL;
+	cq *n;
 
-	for (n = cache->q; n; p = n, n = n->next) {
+	for (n = cache->ihash[qc_ihash(cache, q->id)]; n; n = n->inext) {
 		if (n == q) {
-			if (p) {
-				p->next = q->next;
-			} else {
-				cache->q = q->next;
-			}
+			qc_unlink(cache, q);
 			cq_delete(cache->clientid, q);
-			cache->nr--;
 			break;
 		}
 	}
@@ -94,22 +215,31 @@ qc_delete(qc *cache, cq *q)
 void
 qc_clean(qc *cache)
 {
-	cq *n, *q, *p = NULL;
+	cq *n, *q;
+
+	for (q = cache->q; q; q = n) {
+		n = q->next;
+		if (q->type != Q_PREPARE) {
+			qc_unlink(cache, q);
+			cq_delete(cache->clientid, q);
+		}
+	}
+}
+
+/* evict the least recently used entries, except the prepared
+ * statements, until at most max are left */
+void
+qc_evict(qc *cache, int max)
+{
+	cq *p, *q;
 
-	for (q = cache->q; q; ) {
+	for (q = cache->last; q && cache->nr > max; q = p) {
+		p = q->prev;
 		if (q->type != Q_PREPARE) {
-			n = q->next;
-			if (p) 
-				p->next = n;
-			else
-				cache->q = n;
+			qc_unlink(cache, q);
 			cq_delete(cache->clientid, q);
-			cache->nr--;
-			q = n;
-			continue;
+			cache->evictions++;
 		}
-		p = q;
-		q = q->next;
 	}
 }
 
@@ -123,6 +253,8 @@ qc_destroy(qc *cache)
 		cq_delete(cache->clientid, q);
 		cache->nr--;
 	}
+	GDKfree(cache->khash);
+	GDKfree(cache->ihash);
 	_DELETE(cache);
 }
 
@@ -212,9 +344,10 @@ qc_find(qc *cache, int id)
 {
 	cq *q;
 
-	for (q = cache->q; q; q = q->next) {
+	for (q = cache->ihash[qc_ihash(cache, id)]; q; q = q->inext) {
 		if (q->id == id) {
 			q->count++;
+			qc_touch(cache, q);
 			return q;
 		}
 	}
@@ -226,19 +359,22 @@ qc_match(qc *cache, symbol *s, atom **params, int  plen, int key)
 {
 	cq *q;
 
-	for (q = cache->q; q; q = q->next) {
+	for (q = cache->khash[qc_khash(cache, key, plen)]; q; q = q->knext) {
 		if (q->key == key) {
 			if (q->paramlen == plen && param_list_cmp(q->params, params, plen, q->type) == 0 && symbol_cmp(q->s, s) == 0) {
 				q->count++;
+				qc_touch(cache, q);
+				cache->hits++;
 				return q;
 			}
 		}
 	}
+	cache->misses++;
 	return NULL;
 }
 
 cq *
-qc_insert(qc *cache, sql_allocator *sa, sql_rel *r, char *qname,  symbol *s, atom **params, int paramlen, int key, int type, char *cmd, int no_mitosis)
+qc_insert(qc *cache, sql_allocator *sa, sql_rel *r, char *qname,  symbol *s, atom **params, int paramlen, int key, int type, char *cmd, int no_mitosis, int owndels)
 {
 	int i, namelen;
 	cq *n = MNEW(cq);
@@ -246,7 +382,6 @@ qc_insert(qc *cache, sql_allocator *sa, sql_rel *r, char *qname,  symbol *s, ato
 		return NULL;
 
 	n->id = cache->id++;
-	cache->nr++;
 
 	n->sa = sa;
 	n->rel = r;
@@ -266,7 +401,6 @@ qc_insert(qc *cache, sql_allocator *sa, sql_rel *r, char *qname,  symbol *s, ato
 			n->params[i] = *(atom_type(a));
 		}
 	}
-	n->next = cache->q;
 	n->stk = 0;
 	n->code = NULL;
 	n->type = type;
@@ -276,13 +410,14 @@ qc_insert(qc *cache, sql_allocator *sa, sql_rel *r, char *qname,  symbol *s, ato
 	namelen = 5 + ((n->id+7)>>3) + ((cache->clientid+7)>>3);
 	n->name = sa_alloc(sa, namelen);
 	n->no_mitosis = no_mitosis;
+	n->owndels = owndels;
 	if(!n->name) {
 		_DELETE(n->params);
 		_DELETE(n);
 		return NULL;
 	}
 	strcpy(n->name, qname);
-	cache->q = n;
+	qc_link(cache, n);
 	return n;
 }
 
@@ -16,7 +16,10 @@
 
 #define DEFAULT_CACHESIZE 100
 typedef struct cq {
-	struct cq *next;	/* link them into a queue */
+	struct cq *next;	/* link them into a queue, most recently used first */
+	struct cq *prev;
+	struct cq *knext;	/* hash chain on key and number of parameters */
+	struct cq *inext;	/* hash chain on id */
 	int type;		/* sql_query_t: Q_PARSE,Q_SCHEMA,.. */
 	sql_allocator *sa;	/* the symbols are allocated from this sa */
 	sql_rel *rel;		/* relational query */
@@ -30,6 +33,7 @@ typedef struct cq {
 	char *codestring;	/* keep code in string form to aid debugging */
 	char *name;		/* name of cache query */
 	int no_mitosis;		/* run query without mitosis */
+	int owndels;		/* table whose deleted rows are only read to change them */
 	int count;		/* number of times the query is matched */
 } cq;
 
@@ -37,15 +41,23 @@ typedef struct qc {
 	int clientid;
 	int id;
 	int nr;
-	cq *q;
+	cq *q;			/* most recently used */
+	cq *last;		/* least recently used */
+	cq **khash;		/* entries hashed on key and number of parameters */
+	cq **ihash;		/* entries hashed on id */
+	int hsize;		/* number of hash buckets, a power of 2 */
+	lng hits;		/* number of successful lookups */
+	lng misses;		/* number of failed lookups */
+	lng evictions;		/* number of entries evicted to make room */
 } qc;
 
 extern qc *qc_create(int clientid, int seqnr);
 extern void qc_destroy(qc *cache);
 extern void qc_clean(qc *cache);
+extern void qc_evict(qc *cache, int max);
 extern cq *qc_find(qc *cache, int id);
 extern cq *qc_match(qc *cache, symbol *s, atom **params, int plen, int key);
-extern cq *qc_insert(qc *cache, sql_allocator *sa, sql_rel *r, char *qname, symbol *s, atom **params, int paramlen, int key, int type, char *codedstr, int no_mitosis);
+extern cq *qc_insert(qc *cache, sql_allocator *sa, sql_rel *r, char *qname, symbol *s, atom **params, int paramlen, int key, int type, char *codedstr, int no_mitosis, int owndels);
 extern void qc_delete(qc *cache, cq *q);
 extern int qc_size(qc *cache);
 extern int qc_isaquerytemplate(char *nme);
@@ -221,7 +221,12 @@ bl_destroy(void)
 
 	bat_logger = NULL;
 	if (l) {
+		/* sync commits that did not wait for it */
+		if (log_flush(l) != GDK_SUCCEED)
+			fprintf(stderr, "!ERROR: bl_destroy: log_flush failed\n");
 		close_stream(l->log);
+		MT_lock_destroy(&l->lock);
+		MT_lock_destroy(&l->flush_lock);
 		GDKfree(l->fn);
 		GDKfree(l->dir);
 		GDKfree(l->local_dir);
@@ -325,9 +330,25 @@ bl_tstart(void)
 }
 
 static int 
-bl_tend(void)
+bl_tend(lng *lsn)
 {
-	return log_tend(bat_logger) == GDK_SUCCEED ? LOG_OK : LOG_ERR;
+	return log_tend_group(bat_logger, lsn) == GDK_SUCCEED ? LOG_OK : LOG_ERR;
+}
+
+static int 
+bl_sync(lng lsn)
+{
+	if (bat_logger == NULL)
+		return LOG_OK;
+	return log_sync(bat_logger, lsn) == GDK_SUCCEED ? LOG_OK : LOG_ERR;
+}
+
+static int 
+bl_flush(void)
+{
+	if (bat_logger == NULL)
+		return LOG_OK;
+	return log_flush(bat_logger) == GDK_SUCCEED ? LOG_OK : LOG_ERR;
 }
 
 static int 
@@ -354,6 +375,8 @@ bat_logger_init( logger_functions *lf )
 	lf->log_isnew = bl_log_isnew;
 	lf->log_tstart = bl_tstart;
 	lf->log_tend = bl_tend;
+	lf->log_sync = bl_sync;
+	lf->log_flush = bl_flush;
 	lf->log_sequence = bl_sequence;
 }
 
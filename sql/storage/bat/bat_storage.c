@@ -259,6 +259,10 @@ delta_update_bat( sql_delta *bat, BAT *tids, BAT *updates, int is_new)
 
 		if (BATcount(ib)) { 
 			BAT *nui = tids, *nuv = updates;
+			/* inserts of earlier transactions were logged
+			 * already, so their updates go into the update
+			 * deltas as well */
+			oid logged = ib->hseqbase + ib->batInserted;
 
 			o = BATselect(tids, NULL, &ib->hseqbase, ATOMnilptr(tids->ttype), 1, 0, 0);
 			if (o == NULL) {
@@ -283,7 +287,7 @@ delta_update_bat( sql_delta *bat, BAT *tids, BAT *updates, int is_new)
 				return LOG_ERR;
 			}
 
-			o = BATselect(tids, NULL, ATOMnilptr(tids->ttype), &ib->hseqbase, 0, 0, 0);
+			o = BATselect(tids, NULL, ATOMnilptr(tids->ttype), &logged, 0, 0, 0);
 			if (o == NULL) {
 				bat_destroy(ib);
 				return LOG_ERR;
@@ -436,7 +440,9 @@ delta_update_val( sql_delta *bat, oid rid, void *upd)
 				bat_destroy(ib);
 				return LOG_ERR;
 			}
-		} else {
+		}
+		/* also log updates of inserts of earlier transactions */
+		if (!BATcount(ib) || rid < ib->hseqbase + ib->batInserted) {
 			BAT *ui = temp_descriptor(bat->uibid);
 			BAT *uv = temp_descriptor(bat->uvbid);
 			if(ui == NULL || uv == NULL) {
@@ -606,7 +612,10 @@ update_col(sql_trans *tr, sql_column *c, void *tids, void *upd, int tpe)
 	}
 	bat = c->data;
 	bat->wtime = c->base.wtime = c->t->base.wtime = c->t->s->base.wtime = tr->wtime = tr->wstime;
-	c->base.rtime = c->t->base.rtime = c->t->s->base.rtime = tr->rtime = tr->stime;
+	/* an update only reads the column if the new values are
+	 * computed from it, and then the column was bound for
+	 * reading, so only the table is marked as read */
+	c->t->base.rtime = c->t->s->base.rtime = tr->rtime = tr->stime;
 	if (tpe == TYPE_bat)
 		return delta_update_bat(bat, tids, upd, isNew(c));
 	else 
@@ -636,7 +645,7 @@ update_idx(sql_trans *tr, sql_idx * i, void *tids, void *upd, int tpe)
 	}
 	bat = i->data;
 	bat->wtime = i->base.wtime = i->t->base.wtime = i->t->s->base.wtime = tr->wtime = tr->wstime;
-	i->base.rtime = i->t->base.rtime = i->t->s->base.rtime = tr->rtime = tr->stime;
+	i->t->base.rtime = i->t->s->base.rtime = tr->rtime = tr->stime;
 	if (tpe == TYPE_bat)
 		return delta_update_bat(bat, tids, upd, isNew(i));
 	else
@@ -2218,6 +2227,8 @@ gtr_update_dbat(sql_dbat *d, int *changes)
 			(*changes)++;
 			if (append_inserted(cdb, idb) == BUN_NONE)
 				ok = LOG_ERR;
+			else
+				BATcommit(idb);
 			bat_destroy(cdb);
 		} else {
 			ok = LOG_ERR;
@@ -2366,6 +2377,135 @@ gtr_minmax( sql_trans *tr )
 	return _gtr_update(tr, &gtr_minmax_table);
 }
 
+/* Incremental merge of the deltas of the global transaction. Where
+ * gtr_update merges everything at once, gtr_merge stops after the
+ * columns and indices it merged hold about nr pending rows, and sets
+ * *more when there is work left.  A column or index is merged in one go,
+ * so each is either fully merged or not at all, and a table is only
+ * marked as merged (base.allocated) once all its columns and indices
+ * are.  Like gtr_update it may only be called without active
+ * transactions. */
+static size_t
+delta_pending(sql_delta *d)
+{
+	if (!d)
+		return 0;
+	return (size_t) (d->cnt - d->ibase) + (size_t) d->ucnt;
+}
+
+static int
+gtr_merge_table(sql_trans *tr, sql_table *t, size_t nr, size_t *done, int *more, int *tchanges)
+{
+	int ok = LOG_OK, all = 1;
+	node *n;
+
+	if (t->base.wtime <= t->base.allocated)
+		return ok;
+	ok = gtr_update_dbat(t->data, tchanges);
+	for (n = t->columns.set->h; ok == LOG_OK && n; n = n->next) {
+		int changes = 0;
+		sql_column *c = n->data;
+		size_t p;
+
+		if (!c->base.wtime || c->base.wtime <= c->base.allocated)
+			continue;
+		if ((p = delta_pending(c->data)) == 0)
+			continue;
+		if (*done >= nr) {
+			all = 0;
+			continue;
+		}
+		ok = gtr_update_delta(tr, c->data, &changes);
+		*done += p;
+		if (changes)
+			c->base.allocated = c->base.wtime = tr->wstime;
+		(*tchanges) |= changes;
+	}
+	if (ok == LOG_OK && t->idxs.set) {
+		for (n = t->idxs.set->h; ok == LOG_OK && n; n = n->next) {
+			int changes = 0;
+			sql_idx *ci = n->data;
+			size_t p;
+
+			if (!isTable(ci->t) || !idx_has_column(ci->type))
+				continue;
+			if (!ci->base.wtime || ci->base.wtime <= ci->base.allocated)
+				continue;
+			if ((p = delta_pending(ci->data)) == 0)
+				continue;
+			if (*done >= nr) {
+				all = 0;
+				continue;
+			}
+			ok = gtr_update_delta(tr, ci->data, &changes);
+			*done += p;
+			if (changes)
+				ci->base.allocated = ci->base.wtime = tr->wstime;
+			(*tchanges) |= changes;
+		}
+	}
+	if (!all)
+		*more = 1;
+	if (*tchanges) {
+		t->base.wtime = tr->wstime;
+		if (all)
+			t->base.allocated = tr->wstime;
+	}
+	return ok;
+}
+
+static int
+gtr_merge( sql_trans *tr, size_t nr, int *more )
+{
+	int ok = LOG_OK, tchanges = 0;
+	size_t done = 0;
+	node *sn;
+
+	*more = 0;
+	for (sn = tr->schemas.set->h; sn && ok == LOG_OK; sn = sn->next) {
+		int schanges = 0, smore = 0;
+		sql_schema *s = sn->data;
+
+		if (!s->base.wtime || s->base.wtime <= s->base.allocated)
+			continue;
+		if (!isTempSchema(s) && s->tables.set) {
+			node *n;
+			for (n = s->tables.set->h; n && ok == LOG_OK; n = n->next) {
+				int changes = 0;
+				sql_table *t = n->data;
+
+				if (isTable(t) && isGlobal(t))
+					ok = gtr_merge_table(tr, t, nr, &done, &smore, &changes);
+				schanges |= changes;
+			}
+		}
+		if (schanges) {
+			s->base.wtime = tr->wstime;
+			if (!smore)
+				s->base.allocated = tr->wstime;
+			tchanges ++;
+		}
+		*more |= smore;
+	}
+	if (tchanges)
+		tr->wtime = tr->wstime;
+	return ok;
+}
+
+static size_t
+count_deltas(sql_trans *tr, sql_table *t, size_t *upd, size_t *del)
+{
+	node *n;
+
+	*upd = *del = 0;
+	if (!isTable(t) || !t->columns.set->h)
+		return 0;
+	for (n = t->columns.set->h; n; n = n->next)
+		*upd += count_col_upd(tr, n->data);
+	*del = count_del(tr, t);
+	return count_col(tr, t->columns.set->h->data, 0);
+}
+
 static int 
 tr_update_delta( sql_trans *tr, sql_delta *obat, sql_delta *cbat, int unique)
 {
@@ -2629,7 +2769,9 @@ tr_update_dbat(sql_trans *tr, sql_dbat *tdb, sql_dbat *fdb, int cleared)
 
 			if (ok == LOG_OK) {
 				fdb->dbid = 0;
-				tdb->cnt = fdb->cnt;
+				/* other transactions may have deleted
+				 * rows as well */
+				tdb->cnt = BATcount(odb);
 			}
 			bat_destroy(odb);
 		} else {
@@ -2653,8 +2795,9 @@ tr_update_dbat_swap(sql_dbat *tdb, sql_dbat *fdb)
 	 * and remove the rows from tdb->dbid.
 	 * Swap both tdb->dbid/fdb->dbid */
 	int ok = LOG_OK;
-	BAT *db = NULL;
+	BAT *db = NULL, *odb;
 	BUN cnt;
+	log_bid id;
 
 	if (!fdb)
 		return ok;
@@ -2662,25 +2805,49 @@ tr_update_dbat_swap(sql_dbat *tdb, sql_dbat *fdb)
 	db = temp_descriptor(tdb->dbid);
 	if(!db)
 		return LOG_ERR;
+	odb = temp_descriptor(fdb->dbid);
+	if (!odb) {
+		bat_destroy(db);
+		return LOG_ERR;
+	}
+	cnt = BATcount(odb);
 	if (BUNlast(db) > db->batInserted) {
-		BAT *odb = temp_descriptor(fdb->dbid);
-		if(odb) {
-			cnt = BATcount(odb);
-			if (append_inserted(odb, db) == BUN_NONE)
+		if (append_inserted(odb, db) == BUN_NONE)
+			ok = LOG_ERR;
+		else
+			BATcommit(odb);
+	}
+	id = db->batCacheid;
+	if (ok == LOG_OK) {
+		if (db->batInserted == cnt) {
+			BATsetcount(db, cnt);
+		} else {
+			/* other transactions deleted rows after this
+			 * one started (see validate_table), so the
+			 * older version gets a copy of the central bat
+			 * as it was */
+			BAT *s = BATslice(odb, 0, cnt), *c = NULL;
+
+			if (s)
+				c = COLcopy(s, s->ttype, TRUE, PERSISTENT);
+			bat_destroy(s);
+			if (c == NULL) {
 				ok = LOG_ERR;
-			else {
-				BATcommit(odb);
-				BATsetcount(db, cnt);
+			} else {
+				bat_set_access(c, BAT_READ);
+				BATcommit(c);
+				id = temp_create(c);
+				bat_destroy(c);
+				temp_destroy(db->batCacheid);
 			}
-			bat_destroy(odb);
-		} else {
-			ok = LOG_ERR;
 		}
 	}
 	if (ok == LOG_OK) {
 		tdb->dbid = fdb->dbid; 
-		fdb->dbid = db->batCacheid;
+		fdb->dbid = id;
+		tdb->cnt = BATcount(odb);
 	}
+	bat_destroy(odb);
 	bat_destroy(db);
 	return ok;
 }
@@ -2893,6 +3060,369 @@ update_table(sql_trans *tr, sql_table *ft, sql_table *tt)
 	return ok;
 }
 
+/* Row-level validation.  Transactions that changed a table that
+ * another transaction changed and committed in the mean time used to
+ * be aborted.  When both only updated and deleted existing rows, the
+ * changes can be combined as long as they do not touch the same rows.
+ * The global deltas are versioned: a commit pushes a new version that
+ * extends the one the committer started from, so the tids changed by
+ * others since a transaction started are the entries that the current
+ * version has beyond the version that transaction started from. */
+
+/* append the tids in b from position from onward to r */
+static int
+tids_append(BAT *r, BAT *b, BUN from)
+{
+	BAT *s;
+	gdk_return ret;
+
+	if (from >= BATcount(b))
+		return LOG_OK;
+	if ((s = BATslice(b, from, BATcount(b))) == NULL)
+		return LOG_ERR;
+	ret = BATappend(r, s, NULL, TRUE);
+	bat_destroy(s);
+	return ret == GDK_SUCCEED ? LOG_OK : LOG_ERR;
+}
+
+/* Pending inserts are updated in place, so the rows of the insert bat
+ * of d that were changed are found by comparing it with the version it
+ * was copied from.  The tids of those rows are appended to tids and, if
+ * vals is set, their new values to vals. */
+static int
+delta_ins_changes(sql_delta *d, sql_delta *base, BAT *tids, BAT *vals)
+{
+	BAT *ib, *bib;
+	BATiter ii, bi;
+	BUN p, n;
+	int (*cmp)(const void *, const void *);
+	int ok = LOG_OK;
+
+	if (d->ibid == base->ibid)
+		return LOG_OK;
+	ib = temp_descriptor(d->ibid);
+	bib = temp_descriptor(base->ibid);
+	if (ib == NULL || bib == NULL) {
+		bat_destroy(ib);
+		bat_destroy(bib);
+		return LOG_ERR;
+	}
+	n = BATcount(bib);
+	assert(BATcount(ib) >= n);
+	ii = bat_iterator(ib);
+	bi = bat_iterator(bib);
+	cmp = ATOMcompare(ib->ttype);
+	for (p = 0; p < n && ok == LOG_OK; p++) {
+		if ((*cmp)(BUNtail(ii, p), BUNtail(bi, p)) != 0) {
+			oid o = base->ibase + p;
+
+			if (BUNappend(tids, &o, TRUE) != GDK_SUCCEED ||
+			    (vals && BUNappend(vals, BUNtail(ii, p), TRUE) != GDK_SUCCEED))
+				ok = LOG_ERR;
+		}
+	}
+	bat_destroy(ib);
+	bat_destroy(bib);
+	return ok;
+}
+
+/* Collect the tids that the local delta cbat (NULL if this transaction
+ * did not change the column) changed in mine, and the tids changed in
+ * the global delta obat since version base in theirs.  Returns 0 if the
+ * deltas cannot be combined row by row. */
+static int
+delta_tids(sql_delta *cbat, sql_delta *base, sql_delta *obat, BAT *mine, BAT *theirs)
+{
+	BAT *ui;
+	BUN bcnt, icnt;
+
+	if (!base->uibid || !base->ibid)
+		return cbat == NULL && obat == base;
+	if ((ui = temp_descriptor(base->uibid)) == NULL)
+		return 0;
+	bcnt = BATcount(ui);
+	bat_destroy(ui);
+	if ((ui = temp_descriptor(base->ibid)) == NULL)
+		return 0;
+	icnt = BATcount(ui);
+	bat_destroy(ui);
+
+	if (cbat) {
+		/* only updates of existing rows, no inserts */
+		if (!cbat->uibid || cbat->bid != base->bid ||
+		    cbat->ibase != base->ibase ||
+		    (ui = temp_descriptor(cbat->ibid)) == NULL)
+			return 0;
+		if (BATcount(ui) != icnt) {
+			bat_destroy(ui);
+			return 0;
+		}
+		bat_destroy(ui);
+		if ((ui = temp_descriptor(cbat->uibid)) == NULL)
+			return 0;
+		if (BATcount(ui) < bcnt ||
+		    tids_append(mine, ui, bcnt) != LOG_OK ||
+		    delta_ins_changes(cbat, base, mine, NULL) != LOG_OK) {
+			bat_destroy(ui);
+			return 0;
+		}
+		bat_destroy(ui);
+	}
+	if (obat != base) {
+		if (!obat->uibid || obat->bid != base->bid ||
+		    obat->ibase != base->ibase ||
+		    (ui = temp_descriptor(obat->uibid)) == NULL)
+			return 0;
+		if (BATcount(ui) < bcnt ||
+		    tids_append(theirs, ui, bcnt) != LOG_OK ||
+		    delta_ins_changes(obat, base, theirs, NULL) != LOG_OK) {
+			bat_destroy(ui);
+			return 0;
+		}
+		bat_destroy(ui);
+	}
+	return 1;
+}
+
+/* Make the local delta cbat extend the current global version obat
+ * instead of the older version base it was copied from: start from
+ * the global version and redo the changes of this transaction. */
+static int
+delta_rebase(sql_delta *cbat, sql_delta *base, sql_delta *obat, int ts)
+{
+	BAT *ui = NULL, *uv = NULL, *ib = NULL, *nui = NULL, *nuv = NULL;
+	BAT *itids = NULL, *ivals = NULL;
+	log_bid nuibid = 0, nuvbid = 0, nibid = 0;
+	BUN bcnt;
+	int ok = LOG_ERR;
+
+	cbat->wtime = ts;
+	if (obat == base)
+		return LOG_OK;
+	if (cbat->cached) {
+		bat_destroy(cbat->cached);
+		cbat->cached = NULL;
+	}
+	if ((ui = temp_descriptor(base->uibid)) == NULL)
+		return LOG_ERR;
+	bcnt = BATcount(ui);
+	bat_destroy(ui);
+	ui = temp_descriptor(cbat->uibid);
+	uv = temp_descriptor(cbat->uvbid);
+	if (ui == NULL || uv == NULL)
+		goto bailout;
+
+	/* the changes of this transaction to pending inserts */
+	itids = COLnew(0, TYPE_oid, 0, TRANSIENT);
+	ivals = COLnew(0, uv->ttype, 0, TRANSIENT);
+	if (itids == NULL || ivals == NULL ||
+	    delta_ins_changes(cbat, base, itids, ivals) != LOG_OK)
+		goto bailout;
+
+	if ((nibid = ebat_copy(obat->ibid, obat->ibase, 0)) == BID_NIL ||
+	    (nuibid = temp_copy(obat->uibid, FALSE)) == BID_NIL ||
+	    (nuvbid = temp_copy(obat->uvbid, FALSE)) == BID_NIL)
+		goto bailout;
+	if (BATcount(itids)) {
+		if ((ib = temp_descriptor(nibid)) == NULL ||
+		    void_replace_bat(ib, itids, ivals, TRUE) != GDK_SUCCEED)
+			goto bailout;
+	}
+	nui = temp_descriptor(nuibid);
+	nuv = temp_descriptor(nuvbid);
+	if (nui == NULL || nuv == NULL ||
+	    tids_append(nui, ui, bcnt) != LOG_OK ||
+	    tids_append(nuv, uv, bcnt) != LOG_OK)
+		goto bailout;
+
+	temp_destroy(cbat->ibid);
+	temp_destroy(cbat->uibid);
+	temp_destroy(cbat->uvbid);
+	cbat->ibid = nibid;
+	cbat->uibid = nuibid;
+	cbat->uvbid = nuvbid;
+	nibid = nuibid = nuvbid = 0;
+	cbat->ibase = obat->ibase;
+	cbat->cnt = obat->cnt;
+	cbat->ucnt = obat->ucnt + (BATcount(ui) - bcnt);
+	ok = LOG_OK;
+  bailout:
+	/* BID_NIL is 0, so this also covers failed copies */
+	if (nibid)
+		temp_destroy(nibid);
+	if (nuibid)
+		temp_destroy(nuibid);
+	if (nuvbid)
+		temp_destroy(nuvbid);
+	bat_destroy(ui);
+	bat_destroy(uv);
+	bat_destroy(ib);
+	bat_destroy(nui);
+	bat_destroy(nuv);
+	bat_destroy(itids);
+	bat_destroy(ivals);
+	return ok;
+}
+
+static int
+column_in_key(sql_table *t, sql_column *c)
+{
+	node *n, *m;
+
+	if (t->keys.set)
+		for (n = t->keys.set->h; n; n = n->next)
+			for (m = ((sql_key *) n->data)->columns->h; m; m = m->next)
+				if (((sql_kc *) m->data)->c->base.id == c->base.id)
+					return 1;
+	return 0;
+}
+
+static int
+table_referenced(sql_table *t)
+{
+	node *n;
+
+	if (t->keys.set)
+		for (n = t->keys.set->h; n; n = n->next) {
+			sql_key *k = n->data;
+
+			if (k->type != fkey && ((sql_ukey *) k)->keys &&
+			    list_length(((sql_ukey *) k)->keys) > 0)
+				return 1;
+		}
+	return 0;
+}
+
+static int
+validate_table(sql_trans *tr, sql_table *ft, sql_table *tt)
+{
+	BAT *mine = NULL, *theirs = NULL, *r;
+	sql_dbat *bdb, *odb = tt->data;
+	node *n, *m;
+	int ok = 0;
+
+	if (!isTable(ft) || isTempTable(ft) || isNew(ft) || isNew(tt) ||
+	    ft->cleared || !odb)
+		return 0;
+	mine = COLnew(0, TYPE_oid, 0, TRANSIENT);
+	theirs = COLnew(0, TYPE_oid, 0, TRANSIENT);
+	if (mine == NULL || theirs == NULL)
+		goto bailout;
+
+	/* deletes; the global deletes bat only grows while there are
+	 * other active transactions */
+	bdb = timestamp_dbat(odb, tr->stime);
+	if (ft->base.allocated && ft->data) {
+		sql_dbat *fdb = ft->data;
+		BAT *db;
+
+		/* rows referenced from other tables cannot be deleted
+		 * without a look at those tables */
+		if (table_referenced(ft) || (db = temp_descriptor(fdb->dbid)) == NULL)
+			goto bailout;
+		if (tids_append(mine, db, db->batInserted) != LOG_OK) {
+			bat_destroy(db);
+			goto bailout;
+		}
+		bat_destroy(db);
+	}
+	if (odb != bdb) {
+		BAT *db = temp_descriptor(odb->dbid);
+
+		if (db == NULL)
+			goto bailout;
+		if (BATcount(db) < bdb->cnt ||
+		    tids_append(theirs, db, bdb->cnt) != LOG_OK) {
+			bat_destroy(db);
+			goto bailout;
+		}
+		bat_destroy(db);
+	}
+	/* rows deleted by others change what was read */
+	if (ft->drtime && BATcount(theirs) > 0)
+		goto bailout;
+
+	/* updates */
+	for (n = ft->columns.set->h, m = tt->columns.set->h; n && m; n = n->next, m = m->next) {
+		sql_column *cc = n->data;
+		sql_column *oc = m->data;
+		sql_delta *cbat = NULL;
+
+		if (!oc->data)
+			continue;
+		if (cc->base.wtime && cc->base.allocated) {
+			if (isNew(cc) || column_in_key(ft, cc))
+				goto bailout;
+			cbat = cc->data;
+		}
+		if (!delta_tids(cbat, timestamp_delta(oc->data, tr->stime), oc->data, mine, theirs))
+			goto bailout;
+	}
+	if (ft->idxs.set) {
+		for (n = ft->idxs.set->h, m = tt->idxs.set->h; n && m; n = n->next, m = m->next) {
+			sql_idx *ci = n->data;
+			sql_idx *oi = m->data;
+			sql_delta *cbat = NULL;
+
+			if (!oi->data)
+				continue;
+			if (ci->base.wtime && ci->base.allocated) {
+				if (isNew(ci))
+					goto bailout;
+				cbat = ci->data;
+			}
+			if (!delta_tids(cbat, timestamp_delta(oi->data, tr->stime), oi->data, mine, theirs))
+				goto bailout;
+		}
+	}
+
+	/* do the changes overlap */
+	if ((r = BATintersect(mine, theirs, NULL, NULL, 0, BUN_NONE)) == NULL)
+		goto bailout;
+	ok = BATcount(r) == 0;
+	bat_destroy(r);
+  bailout:
+	bat_destroy(mine);
+	bat_destroy(theirs);
+	return ok;
+}
+
+/* Base the changes of a table that passed validate_table on the
+ * current versions of its columns, and stamp them with time stamp ts.
+ * This is only done once all tables of the transaction have been
+ * validated. */
+static int
+rebase_table(sql_trans *tr, sql_table *ft, sql_table *tt, int ts)
+{
+	node *n, *m;
+	int ok = LOG_OK;
+
+	for (n = ft->columns.set->h, m = tt->columns.set->h; ok == LOG_OK && n && m; n = n->next, m = m->next) {
+		sql_column *cc = n->data;
+		sql_column *oc = m->data;
+
+		if (oc->data && cc->base.wtime && cc->base.allocated) {
+			ok = delta_rebase(cc->data, timestamp_delta(oc->data, tr->stime), oc->data, ts);
+			cc->base.wtime = ts;
+		}
+	}
+	if (ft->idxs.set) {
+		for (n = ft->idxs.set->h, m = tt->idxs.set->h; ok == LOG_OK && n && m; n = n->next, m = m->next) {
+			sql_idx *ci = n->data;
+			sql_idx *oi = m->data;
+
+			if (oi->data && ci->base.wtime && ci->base.allocated) {
+				ok = delta_rebase(ci->data, timestamp_delta(oi->data, tr->stime), oi->data, ts);
+				ci->base.wtime = ts;
+			}
+		}
+	}
+	if (ft->base.allocated && ft->data)
+		((sql_dbat *) ft->data)->wtime = ts;
+	ft->base.wtime = ts;
+	return ok;
+}
+
 static int 
 tr_log_delta( sql_trans *tr, sql_delta *cbat, int cleared)
 {
@@ -3066,6 +3596,7 @@ bat_storage_init( store_functions *sf)
 
 	sf->count_del = (count_del_fptr)&count_del;
 	sf->count_upd = (count_upd_fptr)&count_upd;
+	sf->count_deltas = (count_deltas_fptr)&count_deltas;
 	sf->count_col = (count_col_fptr)&count_col;
 	sf->count_idx = (count_idx_fptr)&count_idx;
 	sf->dcount_col = (dcount_col_fptr)&dcount_col;
@@ -3101,9 +3632,12 @@ bat_storage_init( store_functions *sf)
 	sf->clear_del = (clear_del_fptr)&clear_del;
 
 	sf->update_table = (update_table_fptr)&update_table;
+	sf->validate_table = (validate_table_fptr)&validate_table;
+	sf->rebase_table = (rebase_table_fptr)&rebase_table;
 	sf->log_table = (update_table_fptr)&log_table;
 	sf->snapshot_table = (update_table_fptr)&snapshot_table;
 	sf->gtrans_update = (gtrans_update_fptr)&gtr_update;
 	sf->gtrans_minmax = (gtrans_update_fptr)&gtr_minmax;
+	sf->gtrans_merge = (gtrans_merge_fptr)&gtr_merge;
 }
 
@@ -141,6 +141,12 @@ typedef size_t (*count_idx_fptr) (sql_trans *tr, sql_idx *i, int all /* all or n
 typedef size_t (*dcount_col_fptr) (sql_trans *tr, sql_column *c);
 typedef int (*prop_col_fptr) (sql_trans *tr, sql_column *c);
 
+/*
+-- count the inserted rows, the updated values (*upd) and the deleted
+-- rows (*del) kept in the deltas of a table
+*/
+typedef size_t (*count_deltas_fptr) (sql_trans *tr, sql_table *t, size_t *upd, size_t *del);
+
 /*
 -- create the necessary storage resources for columns, indices and tables
 -- returns LOG_OK, LOG_ERR
@@ -179,12 +185,34 @@ typedef BUN (*clear_del_fptr) (sql_trans *tr, sql_table *t);
 */
 typedef int (*update_table_fptr) (sql_trans *tr, sql_table *ft, sql_table *tt); 
 
+/*
+-- validate_table checks whether the rows updated and deleted in table ft
+-- are disjoint from those changed in table tt by transactions that
+-- committed after tr started
+-- returns 1 if ft can be committed, 0 on a conflict
+*/
+typedef int (*validate_table_fptr) (sql_trans *tr, sql_table *ft, sql_table *tt);
+
+/*
+-- rebase_table bases the changes of ft (validated with validate_table)
+-- on those of tt and stamps them with time stamp ts
+-- returns LOG_OK, LOG_ERR
+*/
+typedef int (*rebase_table_fptr) (sql_trans *tr, sql_table *ft, sql_table *tt, int ts);
+
 /*
 -- gtrans_update push ibats and ubats
 -- returns LOG_OK, LOG_ERR
 */
 typedef int (*gtrans_update_fptr) (sql_trans *tr); 
 
+/*
+-- gtrans_merge push the ibats and ubats of the columns and indices
+-- holding the first (about) nr pending rows, sets *more if others remain
+-- returns LOG_OK, LOG_ERR
+*/
+typedef int (*gtrans_merge_fptr) (sql_trans *tr, size_t nr, int *more);
+
 /*
 -- handle inserts and updates of columns and indices
 -- returns LOG_OK, LOG_ERR
@@ -214,6 +242,7 @@ typedef struct store_functions {
 
 	count_del_fptr count_del;
 	count_upd_fptr count_upd;
+	count_deltas_fptr count_deltas;
 	count_col_fptr count_col;
 	count_idx_fptr count_idx;
 	dcount_col_fptr dcount_col;
@@ -258,8 +287,11 @@ typedef struct store_functions {
 	update_table_fptr snapshot_table;
 	update_table_fptr log_table;
 	update_table_fptr update_table;
+	validate_table_fptr validate_table;
+	rebase_table_fptr rebase_table;
 	gtrans_update_fptr gtrans_update;
 	gtrans_update_fptr gtrans_minmax;
+	gtrans_merge_fptr gtrans_merge;
 
 	col_ins_fptr col_ins;
 	col_upd_fptr col_upd;
@@ -288,7 +320,9 @@ typedef int (*logger_reload_fptr) (void);
 
 typedef int (*log_isnew_fptr)(void);
 typedef int (*log_tstart_fptr) (void);
-typedef int (*log_tend_fptr) (void);
+typedef int (*log_tend_fptr) (lng *lsn);
+typedef int (*log_sync_fptr) (lng lsn);
+typedef int (*log_flush_fptr) (void);
 typedef int (*log_sequence_fptr) (int seq, lng id);
 
 typedef struct logger_functions {
@@ -308,6 +342,8 @@ typedef struct logger_functions {
 	log_isnew_fptr log_isnew;
 	log_tstart_fptr log_tstart;
 	log_tend_fptr log_tend;
+	log_sync_fptr log_sync;
+	log_flush_fptr log_flush;
 	log_sequence_fptr log_sequence;
 } logger_functions;
 
@@ -331,9 +367,11 @@ extern void store_apply_deltas(void);
 extern void store_flush_log(void);
 extern void store_manager(void);
 extern void idle_manager(void);
+extern void merge_manager(void);
 
 extern void store_lock(void);
 extern void store_unlock(void);
+extern int store_sync(lng lsn);
 extern int store_next_oid(void);
 
 extern sql_trans *sql_trans_create(backend_stack stk, sql_trans *parent, const char *name);
@@ -363,6 +401,7 @@ extern sql_table *sql_trans_del_table(sql_trans *tr, sql_table *mt, sql_table *p
 
 extern int sql_trans_drop_table(sql_trans *tr, sql_schema *s, int id, int drop_action);
 extern BUN sql_trans_clear_table(sql_trans *tr, sql_table *t);
+extern void sql_trans_read_dels(sql_trans *tr, sql_table *t);
 extern sql_table *sql_trans_alter_access(sql_trans *tr, sql_table *t, sht access);
 
 extern sql_column *sql_trans_create_column(sql_trans *tr, sql_table *t, const char *name, sql_subtype *tpe);
@@ -373,6 +412,7 @@ extern sql_column *sql_trans_alter_storage(sql_trans *tr, sql_column *col, char
 extern int sql_trans_is_sorted(sql_trans *tr, sql_column *col);
 extern size_t sql_trans_dist_count(sql_trans *tr, sql_column *col);
 extern int sql_trans_ranges(sql_trans *tr, sql_column *col, void **min, void **max);
+extern char *sql_trans_histogram(sql_trans *tr, sql_column *col);
 
 extern sql_key *sql_trans_create_ukey(sql_trans *tr, sql_table *t, const char *name, key_type kt);
 extern sql_key * sql_trans_key_done(sql_trans *tr, sql_key *k);
@@ -614,6 +614,7 @@ load_table(sql_trans *tr, sql_schema *s, sqlid tid, subrids *nrs)
 	if (isRemote(t))
 		t->persistence = SQL_REMOTE;
 	t->cleared = 0;
+	t->drtime = 0;
 	v = table_funcs.column_find_value(tr, find_sql_column(tables, "access"),rid);
 	t->access = *(sht*)v;	_DELETE(v);
 
@@ -1298,6 +1299,7 @@ create_sql_table_with_id(sql_allocator *sa, int id, const char *name, sht type,
 	t->pkey = NULL;
 	t->sz = COLSIZE;
 	t->cleared = 0;
+	t->drtime = 0;
 	t->s = NULL;
 	return t;
 }
@@ -1603,6 +1605,8 @@ store_load(void) {
 
 		if (sql_trans_commit(tr) != SQL_OK) {
 			fprintf(stderr, "cannot commit initial transaction\n");
+		} else if (store_sync(tr->log_lsn) != LOG_OK) {
+			fprintf(stderr, "cannot sync initial transaction\n");
 		}
 		sql_trans_destroy(tr);
 	}
@@ -1816,6 +1820,20 @@ store_manager(void)
 			MT_sleep_ms(sleeptime);
 			if (GDKexiting())
 				return;
+			/* sync commits that did not wait for it */
+			MT_lock_set(&bs_lock);
+			if (GDKexiting()) {
+				MT_lock_unset(&bs_lock);
+				return;
+			}
+			logging = 1;
+			MT_lock_unset(&bs_lock);
+			res = logger_funcs.log_flush();
+			MT_lock_set(&bs_lock);
+			logging = 0;
+			MT_lock_unset(&bs_lock);
+			if (res != LOG_OK)
+				GDKfatal("write-ahead log sync failure, disk full?");
 		}
 		/* check if we have a shared logger as well */
 		if (create_shared_logger) {
@@ -1900,6 +1918,7 @@ idle_manager(void)
 
 	while (!GDKexiting()) {
 		sql_session *s;
+		lng lsn;
 		int t;
 
 		for (t = timeout; t > 0; t -= sleeptime) {
@@ -1919,12 +1938,60 @@ idle_manager(void)
 			continue;
 		}
 		sql_trans_begin(s);
-		if (store_vacuum( s->tr ) == 0)
-			sql_trans_commit(s->tr);
+		lsn = 0;
+		if (store_vacuum( s->tr ) == 0 &&
+		    sql_trans_commit(s->tr) == SQL_OK)
+			lsn = s->tr->log_lsn;
 		sql_trans_end(s);
 		sql_session_destroy(s);
 
 		MT_lock_unset(&bs_lock);
+		if (store_sync(lsn) != LOG_OK)
+			GDKfatal("store_manager: write-ahead log sync failed\n");
+	}
+}
+
+/* Fold the deltas of the persistent tables into their base columns in
+ * the background, a slice of about sql_delta_merge rows at a time, so
+ * that the store manager finds little left to merge when it checkpoints
+ * the log.  A slice is only merged while no transaction is active and
+ * the store lock is released in between, so new transactions need not
+ * wait for more than one slice. */
+void
+merge_manager(void)
+{
+	const int sleeptime = GDKdebug & FORCEMITOMASK ? 10 : 50;
+	const int timeout = GDKdebug & FORCEMITOMASK ? 50 : 1000;
+	int nr = GDKgetenv_int("sql_delta_merge", 100000);
+	int more = 0;
+
+	if (nr <= 0 || store_readonly || !store_funcs.gtrans_merge)
+		return;
+	while (!GDKexiting()) {
+		int t;
+
+		for (t = more ? sleeptime : timeout; t > 0; t -= sleeptime) {
+			MT_sleep_ms(sleeptime);
+			if (GDKexiting())
+				return;
+		}
+		MT_lock_set(&bs_lock);
+		if (store_nr_active || logging || GDKexiting()) {
+			MT_lock_unset(&bs_lock);
+			continue;
+		}
+		/* the merged columns may reach the disk before the
+		 * next checkpoint, the log should be there first */
+		if (logger_funcs.log_flush() != LOG_OK) {
+			MT_lock_unset(&bs_lock);
+			GDKfatal("write-ahead log sync failure, disk full?");
+		}
+		gtrans->wstime = timestamp();
+		if (store_funcs.gtrans_merge(gtrans, (size_t) nr, &more) != LOG_OK) {
+			MT_lock_unset(&bs_lock);
+			GDKfatal("merging deltas failed");
+		}
+		MT_lock_unset(&bs_lock);
 	}
 }
 
@@ -1947,6 +2014,16 @@ store_unlock(void)
 	MT_lock_unset(&bs_lock);
 }
 
+/* Wait until the commit with write-ahead log sequence number lsn is on
+ * disk.  Called without holding the store lock. */
+int
+store_sync(lng lsn)
+{
+	if (lsn == 0)
+		return LOG_OK;
+	return logger_funcs.log_sync(lsn);
+}
+
 static sql_kc *
 kc_dup_(sql_trans *tr, int flag, sql_kc *kc, sql_table *t, int copy)
 {
@@ -2434,6 +2511,7 @@ table_dup(sql_trans *tr, int flag, sql_table *ot, sql_schema *s)
 	t->s = s;
 	t->sz = ot->sz;
 	t->cleared = 0;
+	t->drtime = 0;
 
 	if (ot->columns.set) {
 		for (n = ot->columns.set->h; n; n = n->next) {
@@ -3127,6 +3205,7 @@ rollforward_update_table(sql_trans *tr, sql_table *ft, sql_table *tt, int mode)
 				fprintf(stderr, "#update table %s\n", tt->base.name);
 			ok = store_funcs.update_table(tr, ft, tt);
 			ft->cleared = 0;
+			ft->drtime = 0;
 			ft->base.rtime = ft->base.wtime = 0;
 			tt->access = ft->access;
 		}
@@ -3242,41 +3321,105 @@ rollforward_trans(sql_trans *tr, int mode)
 	return ok;
 }
 
+/* Check the read and write times of table t of this transaction
+ * against those of ot, the committed version of the table.  Returns 1
+ * if t can be committed, 0 on a conflict, and -1 if the only conflicts
+ * are writes by both to the same columns or to the deleted rows, which
+ * store_funcs.validate_table then checks row by row.  Reads are always
+ * checked per column: a column this transaction read must not have
+ * been changed by others. */
 static int
-validate_tables(sql_schema *s, sql_schema *os)
+validate_table(sql_table *t, sql_table *ot)
+{
+	node *o, *p;
+	int rows = 0;
+
+	if (t->base.wtime && (t->base.wtime < ot->base.rtime || t->base.wtime < ot->base.wtime))
+		rows = 1;
+	if (t->base.rtime && t->base.rtime < ot->base.wtime) {
+		/* only the deleted rows are read at the table level;
+		 * the row level check covers them if they were only
+		 * read to find the rows this transaction changed, and
+		 * otherwise rejects any rows deleted by others */
+		if (!t->base.wtime)
+			return 0;
+		rows = 1;
+	}
+	for (o = t->columns.set->h, p = ot->columns.set->h; o && p; o = o->next, p = p->next) {
+		sql_column *c = o->data;
+		sql_column *oc = p->data;
+
+		if (!c->base.wtime && !c->base.rtime)
+			continue;
+
+		/* read after t's write */
+		if (c->base.wtime && c->base.wtime < oc->base.rtime)
+			return 0;
+		/* commited write before t's read */
+		if (c->base.rtime && c->base.rtime < oc->base.wtime) 
+			return 0;
+		/* write after t's write */
+		if (c->base.wtime && c->base.wtime < oc->base.wtime)
+			rows = 1;
+	}
+	return rows ? -1 : 1;
+}
+
+static int
+validate_tables(sql_trans *tr, sql_schema *s, sql_schema *os)
 {
-	node *n, *o, *p;
+	node *n;
 
 	if (cs_size(&s->tables))
 		for (n = s->tables.set->h; n; n = n->next) {
 			sql_table *t = n->data;
 			sql_table *ot;
+			int ok;
 
 			if (!t->base.wtime && !t->base.rtime)
 				continue;
 
  			ot = find_sql_table(os, t->base.name);
-			if (ot && isKindOfTable(ot) && isKindOfTable(t)) {
-				if ((t->base.wtime && (t->base.wtime < ot->base.rtime || t->base.wtime < ot->base.wtime)) ||
-				    (t->base.rtime && (t->base.rtime < ot->base.wtime))) 
-					return 0;
-				for (o = t->columns.set->h, p = ot->columns.set->h; o && p; o = o->next, p = p->next) {
-					sql_column *c = o->data;
-					sql_column *oc = p->data;
-
-					if (!c->base.wtime && !c->base.rtime)
-						continue;
-
-					/* t wrote, ie. check read and write time */
-					/* read or write after t's write */
-					if (c->base.wtime && (c->base.wtime < oc->base.rtime
-							  ||  c->base.wtime < oc->base.wtime)) 
-						return 0;
-					/* commited write before t's read */
-					if (c->base.rtime && c->base.rtime < oc->base.wtime) 
-						return 0;
-				}
-			}
+			if (!ot || !isKindOfTable(ot) || !isKindOfTable(t))
+				continue;
+			ok = validate_table(t, ot);
+			/* a table we changed, which was changed by
+			 * others too, only conflicts if the same rows
+			 * were changed */
+			if (ok < 0 && store_funcs.validate_table)
+				ok = store_funcs.validate_table(tr, t, ot);
+			if (ok <= 0)
+				return 0;
+		}
+	return 1;
+}
+
+/* Once all tables have been validated, base the changes to the tables
+ * that were validated row by row on the committed versions and stamp
+ * them with a new time, so that they are ordered after those of the
+ * others. */
+static int
+rebase_tables(sql_trans *tr, sql_schema *s, sql_schema *os, int *ts)
+{
+	node *n;
+
+	if (cs_size(&s->tables))
+		for (n = s->tables.set->h; n; n = n->next) {
+			sql_table *t = n->data;
+			sql_table *ot;
+
+			if (!t->base.wtime)
+				continue;
+
+ 			ot = find_sql_table(os, t->base.name);
+			if (!ot || !isKindOfTable(ot) || !isKindOfTable(t) ||
+			    validate_table(t, ot) >= 0)
+				continue;
+			if (*ts == 0)
+				*ts = timestamp();
+			if (store_funcs.rebase_table(tr, t, ot, *ts) != LOG_OK)
+				return 0;
+			s->base.wtime = tr->wtime = *ts;
 		}
 	return 1;
 }
@@ -3401,7 +3544,7 @@ reset_column(sql_trans *tr, sql_column *fc, sql_column *pfc)
 		if (pfc->def)
 			fc->def = pfc->def;
 		fc->base.wtime = fc->base.rtime = 0;
-		fc->min = fc->max = NULL;
+		fc->min = fc->max = fc->histogram = NULL;
 	}
 	return LOG_OK;
 }
@@ -3435,6 +3578,7 @@ reset_table(sql_trans *tr, sql_table *ft, sql_table *pft)
 
 		ft->base.wtime = ft->base.rtime = 0;
 		ft->cleared = 0;
+		ft->drtime = 0;
 		ft->access = pft->access;
 		ok = reset_changeset( tr, &ft->columns, &pft->columns, &ft->base, (resetf) &reset_column, (dupfunc) &column_dup);
 		if (ok == LOG_OK)
@@ -3540,6 +3684,7 @@ int
 sql_trans_validate(sql_trans *tr)
 {
 	node *n;
+	int ts = 0;
 
 	/* depends on the iso level */
 
@@ -3566,10 +3711,22 @@ sql_trans_validate(sql_trans *tr)
 
  			os = find_sql_schema(tr->parent, s->base.name);
 			if (os && (s->base.wtime != 0 || s->base.rtime != 0)) {
-				if (!validate_tables(s, os)) 
+				if (!validate_tables(tr, s, os)) 
 					return 0;
 			}
 		}
+	if (cs_size(&tr->schemas))
+		for (n = tr->schemas.set->h; n; n = n->next) {
+			sql_schema *s = n->data;
+			sql_schema *os;
+
+			if (isTempSchema(s) || s->base.wtime == 0)
+				continue;
+
+ 			os = find_sql_schema(tr->parent, s->base.name);
+			if (os && !rebase_tables(tr, s, os, &ts))
+				return 0;
+		}
 	return 1;
 }
 
@@ -3597,6 +3754,7 @@ int
 sql_trans_commit(sql_trans *tr)
 {
 	int ok = LOG_OK;
+	lng lsn = 0;
 
 	/* write phase */
 	if (bs_debug)
@@ -3613,7 +3771,7 @@ sql_trans_commit(sql_trans *tr)
 			ok = logger_funcs.log_sequence(OBJ_SID, store_oid);
 		prev_oid = store_oid;
 		if (ok == LOG_OK)
-			ok = logger_funcs.log_tend();
+			ok = logger_funcs.log_tend(&lsn);
 		tr->schema_number = store_schema_number();
 	}
 	if (ok == LOG_OK) {
@@ -3623,6 +3781,9 @@ sql_trans_commit(sql_trans *tr)
 	}
 	if (bs_debug)
 		fprintf(stderr, "#done forwarding changes %d,%d\n", gtrans->stime, gtrans->wstime);
+	/* the log is synced by store_sync, after the store lock is
+	 * released, so concurrent commits can share the sync */
+	tr->log_lsn = lsn;
 	return (ok==LOG_OK)?SQL_OK:SQL_ERR;
 }
 
@@ -4671,6 +4832,15 @@ sql_trans_clear_table(sql_trans *tr, sql_table *t)
 	return sz;
 }
 
+/* The deleted rows of t were read for other purposes than finding the
+ * rows an update or delete changes, so rows deleted by others in the
+ * meantime cause a conflict (see validate_table). */
+void
+sql_trans_read_dels(sql_trans *tr, sql_table *t)
+{
+	t->drtime = t->base.rtime = t->s->base.rtime = tr->rtime = tr->stime;
+}
+
 sql_column *
 sql_trans_create_column(sql_trans *tr, sql_table *t, const char *name, sql_subtype *tpe)
 {
@@ -4929,6 +5099,49 @@ sql_trans_ranges( sql_trans *tr, sql_column *col, void **min, void **max )
 	return 0;
 }
 
+/* Return the equi-depth histogram that ANALYZE stored for col, a comma
+ * separated list of bucket boundaries, or NULL if there is none.  If
+ * there is one, the distinct count of the column is known too. */
+char *
+sql_trans_histogram(sql_trans *tr, sql_column *col)
+{
+	if (col && isTable(col->t)) {
+		sql_schema *sys;
+		sql_table *stats;
+
+		if (col->histogram)
+			return col->histogram;
+		sys = find_sql_schema(tr, "sys");
+		stats = find_sql_table(sys, "statistics");
+		if (stats) {
+			sql_column *stats_column_id = find_sql_column(stats, "column_id");
+			sql_column *stats_histogram = find_sql_column(stats, "histogram");
+			oid rid;
+
+			/* the common case: nothing was analyzed */
+			if (!stats_histogram ||
+			    store_funcs.count_col(tr, stats_column_id, 1) == 0)
+				return NULL;
+			rid = table_funcs.column_find_row(tr, stats_column_id, &col->base.id, NULL);
+			if (!is_oid_nil(rid)) {
+				sql_column *stats_unique = find_sql_column(stats, "unique");
+				char *v = table_funcs.column_find_value(tr, stats_histogram, rid);
+				void *u;
+
+				if (v && strcmp(v, str_nil) != 0 &&
+				    (u = table_funcs.column_find_value(tr, stats_unique, rid)) != NULL) {
+					col->histogram = sa_strdup(tr->sa, v);
+					col->dcount = (size_t) *(lng *) u;
+					_DELETE(u);
+				}
+				_DELETE(v);
+				return col->histogram;
+			}
+		}
+	}
+	return NULL;
+}
+
 
 sql_key *
 sql_trans_create_ukey(sql_trans *tr, sql_table *t, const char *name, key_type kt)
@@ -0,0 +1,45 @@
+-- ANALYZE stores equi-depth histograms and distinct counts, which the
+-- optimizer uses to order selections and joins; the plans below change
+-- once the statistics exist, the results must not
+create table hskew (a int, b int);
+-- 99% of the values of a are 1, b is uniform and not sorted
+insert into hskew
+select case when value % 100 = 0 then value else 1 end, value * 7919 % 200000
+  from generate_series(0, 200000);
+
+create table hfact (k1 int, k2 int);
+create table hdim1 (k int, v int);
+create table hdim2 (k int, v int);
+-- k1 is mostly 7, k2 matches only few rows of the small hdim2
+insert into hfact
+select case when value % 1000 = 0 then value else 7 end, value * 7919 % 100000
+  from generate_series(0, 100000);
+insert into hdim1 select value * 31 % 100000, value from generate_series(0, 100000);
+insert into hdim2 select value * 37, value from generate_series(0, 1000);
+
+-- without statistics
+plan select count(*) from hskew where a = 1 and b < 100;
+select count(*) from hskew where a = 1 and b < 100;
+plan select count(*) from hfact, hdim1, hdim2 where hfact.k1 = hdim1.k and hfact.k2 = hdim2.k;
+select count(*) from hfact, hdim1, hdim2 where hfact.k1 = hdim1.k and hfact.k2 = hdim2.k;
+
+analyze sys.hskew;
+analyze sys.hfact;
+analyze sys.hdim1;
+analyze sys.hdim2;
+select t.name, c.name, s.histogram is not null, s."unique" > 0
+  from sys.statistics s, sys.columns c, sys.tables t
+ where s.column_id = c.id and c.table_id = t.id and t.name in ('hskew', 'hfact', 'hdim1', 'hdim2')
+ order by t.name, c.name;
+
+-- with statistics: the range on b is more selective than the equality
+-- with the frequent value of a, and the join with hdim2 is smaller
+plan select count(*) from hskew where a = 1 and b < 100;
+select count(*) from hskew where a = 1 and b < 100;
+plan select count(*) from hfact, hdim1, hdim2 where hfact.k1 = hdim1.k and hfact.k2 = hdim2.k;
+select count(*) from hfact, hdim1, hdim2 where hfact.k1 = hdim1.k and hfact.k2 = hdim2.k;
+
+drop table hskew;
+drop table hfact;
+drop table hdim1;
+drop table hdim2;
@@ -0,0 +1,131 @@
+import sys, time
+
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# Reference counts of BATs are changed without a lock when that is
+# safe, and threads take free BBP entries from their own lists, which
+# are refilled in batches.  Let many clients concurrently create and
+# drop transient BATs: MAL clients create BATs, views on them and
+# projections in a loop, SQL clients run queries that are split over
+# the dataflow workers (so that BATs are created and destroyed by
+# different threads), all while fixing the BATs of a shared persistent
+# table.  The results must be right, and afterwards the BBP must hold
+# as many BATs with as many references as before.  The first
+# concurrent round fills caches, so the BBP is compared around a
+# second round, each time after the sessions of the clients have been
+# cleaned up, which the server does after they disconnect.  Every
+# connection leaves a logical reference to some catalog BATs, so of
+# the persistent BATs only the physical references are compared.
+
+nmal = 6
+nsql = 4
+iterations = 2000
+queries = 25
+
+mal = '''\
+n := 0:lng;
+i := 0;
+barrier go := i < %d;
+	b := bat.new(:int);
+	b := bat.append(b, 1);
+	b := bat.append(b, i);
+	b := bat.append(b, 3);
+	v := algebra.slice(b, 1:lng, 2:lng);
+	m := bat.mirror(v);
+	p := algebra.projection(m, b);
+	c := aggr.count(p);
+	n := n + c;
+	t:bat[:int] := bbp.bind("%s");
+	s := algebra.slice(t, i, i);
+	c := aggr.count(s);
+	n := n + c;
+	i := i + 1;
+	redo go := i < %d;
+exit go;
+io.print(n);
+'''
+
+sql = '''\
+select count(*), cast(sum(i) as bigint), count(distinct s) from bbpconcurrent where i < 50000;
+select s, count(*) from bbpconcurrent where i < 1000 group by s order by s limit 3;
+select count(*) from bbpconcurrent as x, bbpconcurrent as y where x.i = y.i + %d and x.s = y.s;
+select count(*) from (select s, max(i) as m from bbpconcurrent where i %% 10 = %d group by s) as g where m > 99000;
+'''
+
+bbp = '''\
+select kind, count(*), sum(lrefcnt) from sys.bbp() group by kind order by kind;
+select sum(refcnt) from sys.bbp() where kind = 'transient';
+'''
+
+def client(lang, input):
+    c = process.client(lang, stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+    out, err = c.communicate(input)
+    sys.stderr.write(err)
+    return out
+
+def concurrently(scripts):
+    clients = []
+    for input in scripts:
+        lang = 'mal' if input is mal else 'sql'
+        c = process.client(lang, stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+        clients.append((c, input))
+    for c, input in clients:
+        c.stdin.write(input)
+        c.stdin.close()
+    results = []
+    for c, input in clients:
+        out = c.stdout.read()
+        sys.stderr.write(c.stderr.read())
+        c.wait()
+        results.append(out)
+    return results
+
+def snapshot():
+    # wait until the BBP no longer changes
+    last = None
+    for i in range(20):
+        time.sleep(0.5)
+        out = client('sql', bbp)
+        if out == last:
+            break
+        last = out
+    return out
+
+def server():
+    return process.server(args = ['--forcemito', '--set', 'gdk_nr_threads=4'],
+                          stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+
+def server_stop(s):
+    out, err = s.communicate()
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+# after a restart the rows are in the persistent BATs, which the MAL
+# clients use for column i
+s = server()
+sys.stdout.write(client('sql', '''\
+create table bbpconcurrent (i int, s varchar(10));
+insert into bbpconcurrent select value, 's' || (value % 97) from generate_series(0, 100000);
+'''))
+server_stop(s)
+s = server()
+out = client('sql', "select name from sys.bbp() where kind = 'persistent' and ttype = 'int' and count = 100000;\n")
+mal = mal % (iterations, [l for l in out.split('\n') if l.startswith('[')][0].strip('[ ]"\t'), iterations)
+scripts = [mal] * nmal + [''.join([sql % (k * 97, k)] * queries) for k in range(nsql)]
+
+# the results of each client on its own
+expected = [client('mal', mal)] + [client('sql', x) for x in scripts[nmal:]]
+expected = [expected[0]] * nmal + expected[1:]
+sys.stdout.write(expected[0])
+sys.stdout.write([l for l in expected[nmal].split('\n') if l.startswith('[')][0] + '\n')
+
+sys.stdout.write('concurrent results same as alone: %s\n' % (concurrently(scripts) == expected))
+before = snapshot()
+sys.stdout.write('concurrent results same as alone: %s\n' % (concurrently(scripts) == expected))
+after = snapshot()
+sys.stdout.write('BBP as before: %s\n' % (after == before))
+sys.stdout.write(client('sql', 'drop table bbpconcurrent;\n'))
+server_stop(s)
@@ -0,0 +1,78 @@
+import sys, time
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# Two sessions update the same table concurrently.  Writes to
+# different rows of a column don't conflict, writes to the same row
+# do, and so does a transaction that read a column another transaction
+# changed before it committed.
+
+def client():
+    return process.client('sql', interactive = True,
+                          stdin = process.PIPE, stdout = process.PIPE,
+                          stderr = process.PIPE)
+
+def run(c, stmt):
+    c.stdin.write(stmt + '\n')
+    c.stdin.flush()
+    time.sleep(1)                       # let it finish before the other session goes on
+
+c1 = client()
+c2 = client()
+
+run(c1, 'create table rowconf (id int, b int);')
+run(c1, 'insert into rowconf values (1, 10), (2, 20), (3, 30), (4, 40), (5, 50), (6, 60), (7, 70);')
+
+cases = [
+    # blind updates of different rows: both commit
+    ('update rowconf set b = 11 where id = 1;',
+     'update rowconf set b = 21 where id = 2;', False),
+    # update and delete of different rows: both commit
+    ('delete from rowconf where id = 3;',
+     'update rowconf set b = 22 where id = 2;', False),
+    # updates of the same row: the second commit fails
+    ('update rowconf set b = 12 where id = 1;',
+     'update rowconf set b = 13 where id = 1;', False),
+    # delete and update of the same row: the second commit fails
+    ('delete from rowconf where id = 2;',
+     'update rowconf set b = 23 where id = 2;', False),
+    # c1 reads b, which c2 changes and commits first: c1 fails
+    ('update rowconf set b = (select max(b) from rowconf) + 1 where id = 1;',
+     'update rowconf set b = 41 where id = 4;', True),
+    # c1 counts the rows, c2 deletes another row and commits first:
+    # c1 fails
+    ('update rowconf set b = (select count(*) from rowconf) where id = 1;',
+     'delete from rowconf where id = 4;', True),
+    # c1 deletes a row only to find it, c2 deletes another row and
+    # commits first: both commit
+    ('delete from rowconf where id = 6;',
+     'delete from rowconf where id = 5;', True),
+    # as before, but c1 counted the rows in an earlier statement: c1
+    # fails
+    ('select count(*) from rowconf; update rowconf set b = 42 where id = 1;',
+     'delete from rowconf where id = 7;', True),
+]
+
+for q1, q2, c2first in cases:
+    run(c1, 'start transaction;')
+    run(c2, 'start transaction;')
+    run(c1, q1)
+    run(c2, q2)
+    if c2first:
+        run(c2, 'commit;')
+        run(c1, 'commit;')
+    else:
+        run(c1, 'commit;')
+        run(c2, 'commit;')
+    run(c1, 'select * from rowconf order by id;')
+
+run(c1, 'drop table rowconf;')
+
+out, err = c1.communicate()
+sys.stdout.write(out)
+sys.stderr.write(err)
+out, err = c2.communicate()
+sys.stdout.write(out)
+sys.stderr.write(err)
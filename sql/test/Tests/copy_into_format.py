@@ -0,0 +1,72 @@
+import os, sys
+
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# COPY INTO files of at least 32768 rows are formatted by several
+# threads when there are; the files written with one and with four
+# threads must be the same, and read back they must give the original
+# values.
+
+def outfile(nthreads):
+    return os.path.join(os.getenv('TSTTRGDIR'), 'copy_into_format%d.csv' % nthreads)
+
+def try_remove_files():
+    for n in (1, 4):
+        try:
+            os.remove(outfile(n))
+        except:
+            pass
+
+script = '''\
+create table fmt (id int, b tinyint, s smallint, l bigint, dt date, tm time, ts timestamp, dc decimal(12,3), str varchar(20), d double);
+insert into fmt
+select value,
+       case when value %% 97 = 0 then null else value %% 255 - 127 end,
+       case when value %% 89 = 0 then null else value %% 65535 - 32767 end,
+       case when value %% 83 = 0 then null when value = 1 then -9223372036854775807 when value = 2 then 9223372036854775807 else (value - 200000) * 1000000007 end,
+       case when value %% 79 = 0 then null else date '1900-01-01' + (value %% 100000) * interval '1' day end,
+       case when value %% 73 = 0 then null else time '00:00:00' + (value %% 86400) * interval '1' second end,
+       case when value %% 71 = 0 then null else timestamp '1999-12-31 23:59:59.123' + value * interval '61' second end,
+       case when value %% 67 = 0 then null else (value - 200000) / 7.0 end,
+       case when value %% 61 = 0 then null else 'x' || value end,
+       case when value %% 59 = 0 then null else (value - 200000) / 3.0 end
+  from generate_series(0, 400000);
+copy select * from fmt into '%s';
+create table fmt2 (id int, b tinyint, s smallint, l bigint, dt date, tm time, ts timestamp, dc decimal(12,3), str varchar(20), d double);
+copy into fmt2 from '%s' delimiters '|', '\\n', '"';
+select count(*) from fmt2;
+select count(*) from fmt as a, fmt2 as b where a.id = b.id
+ and (a.b = b.b or a.b is null and b.b is null)
+ and (a.s = b.s or a.s is null and b.s is null)
+ and (a.l = b.l or a.l is null and b.l is null)
+ and (a.dt = b.dt or a.dt is null and b.dt is null)
+ and (a.tm = b.tm or a.tm is null and b.tm is null)
+ and (a.ts = b.ts or a.ts is null and b.ts is null)
+ and (a.dc = b.dc or a.dc is null and b.dc is null)
+ and (a.str = b.str or a.str is null and b.str is null)
+ and (a.d = b.d or a.d is null and b.d is null);
+drop table fmt;
+drop table fmt2;
+'''
+
+try_remove_files()
+
+for nthreads in (1, 4):
+    s = process.server(args = ["--set", "gdk_nr_threads=%d" % nthreads],
+                       stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+    c = process.client('sql', stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+    out, err = c.communicate(script % (outfile(nthreads), outfile(nthreads)))
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+    out, err = s.communicate()
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+a = open(outfile(1)).read()
+b = open(outfile(4)).read()
+sys.stdout.write('%d lines, %s\n' % (a.count('\n'), 'same' if a == b else 'different'))
+
+try_remove_files()
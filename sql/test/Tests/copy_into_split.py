@@ -0,0 +1,110 @@
+import os, sys, random
+
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# COPY INTO input buffers of 1 MiB or more are split into records by
+# several threads, 64 bytes at a time.  Load a file of a few MiB with
+# quoted fields, escaped quotes, backslashes and separators inside
+# quotes, and a record separator of more than one byte, and compare
+# with the same records loaded from files that are too small to be
+# split in parallel.  Two records have a quoted field of 600 KiB that
+# spans chunk boundaries.
+
+def tstfile(name):
+    return os.path.join(os.getenv('TSTTRGDIR'), 'copy_into_split_%s.csv' % name)
+
+rsep = '~~\n'
+pieces = [('abc', 'abc'), (',', ','), ('~~\n', '~~\n'), ('~', '~'),
+          ('\\"', '"'), ('\\\\', '\\'), ('\u00e9', '\u00e9'),
+          ('\u20ac~', '\u20ac~'), (' ', ' '), ('0123456789', '0123456789')]
+
+random.seed(20181018)
+records = []
+nchars = 0
+nnulls = 0
+nrecords = 30000
+for i in range(nrecords):
+    if i == nrecords // 3:
+        # a long quoted field without backslashes
+        raw = (',~~\n' + 'x' * 61) * 10000
+        val = raw
+    elif i == 2 * nrecords // 3:
+        # a long quoted field with backslashes
+        raw = ('\\\\~~\n\\",' + 'y' * 57) * 10000
+        val = ('\\~~\n",' + 'y' * 57) * 10000
+    else:
+        parts = [random.choice(pieces) for j in range(random.randint(0, 12))]
+        raw = ''.join([p[0] for p in parts])
+        val = ''.join([p[1] for p in parts])
+    nchars += len(val)
+    if i % 37 == 0:
+        b = 'null'
+        nnulls += 1
+    else:
+        b = 'b%d~%d' % (i, i % 7)
+    records.append('%d,"%s",%s%s' % (i, raw, b, rsep))
+
+def try_remove_files():
+    for f in os.listdir(os.getenv('TSTTRGDIR')):
+        if f.startswith('copy_into_split_') and f.endswith('.csv'):
+            try:
+                os.remove(os.path.join(os.getenv('TSTTRGDIR'), f))
+            except:
+                pass
+
+try_remove_files()
+
+big = open(tstfile('big'), 'w', encoding = 'utf-8')
+big.write(''.join(records))
+big.close()
+small = []
+cur = []
+size = 0
+for r in records:
+    n = len(r.encode('utf-8'))
+    if cur and size + n > 200000:
+        small.append(''.join(cur))
+        cur = []
+        size = 0
+    cur.append(r)
+    size += n
+small.append(''.join(cur))
+for i, data in enumerate(small):
+    f = open(tstfile('small%d' % i), 'w', encoding = 'utf-8')
+    f.write(data)
+    f.close()
+
+sys.stdout.write('%d records, %d characters, %d nulls, file over 1 MiB: %s\n' %
+                 (nrecords, nchars, nnulls,
+                  os.path.getsize(tstfile('big')) > 1 << 20))
+
+delims = "delimiters ',', '~~\\n', '\"'"
+script = 'create table splitbig (id int, a clob, b clob);\n'
+script += 'create table splitsmall (id int, a clob, b clob);\n'
+script += "copy into splitbig from '%s' %s;\n" % (tstfile('big'), delims)
+for i in range(len(small)):
+    script += "copy into splitsmall from '%s' %s;\n" % (tstfile('small%d' % i), delims)
+script += '''\
+select count(*), count(distinct id), cast(sum(length(a)) as bigint), count(b) from splitbig;
+select count(*), count(distinct id), cast(sum(length(a)) as bigint), count(b) from splitsmall;
+select count(*) from splitbig as x, splitsmall as y where x.id = y.id
+ and x.a = y.a and (x.b = y.b or x.b is null and y.b is null);
+select id, length(a), b from splitbig where id in (9999, 10000, 10001, 19999, 20000, 20001) order by id;
+drop table splitbig;
+drop table splitsmall;
+'''
+
+s = process.server(args = ["--set", "gdk_nr_threads=4"],
+                   stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+c = process.client('sql', stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+out, err = c.communicate(script)
+sys.stdout.write(out)
+sys.stderr.write(err)
+out, err = s.communicate()
+sys.stdout.write(out)
+sys.stderr.write(err)
+
+try_remove_files()
@@ -0,0 +1,67 @@
+import os, sys
+
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# With a small sql_stream_budget a COPY SELECT INTO file is split by
+# mitosis and its partitions are written as they are produced (by a
+# chain of sql.export_table_open, sql.export_table_part and
+# sql.export_table_close in the plan); the file must be the same as the
+# one written from the sorted, and so packed, result.
+
+streamed = os.path.join(os.getenv('TSTTRGDIR'), 'copy_into_stream1.csv')
+packed = os.path.join(os.getenv('TSTTRGDIR'), 'copy_into_stream2.csv')
+
+def try_remove_files():
+    for f in (streamed, packed):
+        try:
+            os.remove(f)
+        except:
+            pass
+
+create = '''\
+create table cstream (id int, s varchar(20), d double);
+insert into cstream select value, 'r' || value, case when value % 1000 = 0 then null else value / 8.0 end from generate_series(0, 500000);
+'''
+
+explain = '''\
+explain copy select id, s, d from cstream where id %% 3 <> 1 into '%s';
+''' % streamed
+
+script = '''\
+copy select id, s, d from cstream where id %% 3 <> 1 into '%s';
+copy select id, s, d from cstream where id %% 3 <> 1 order by id into '%s';
+drop table cstream;
+''' % (streamed, packed)
+
+try_remove_files()
+
+s = process.server(args = ["--set", "sql_stream_budget=1"],
+                   stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+c = process.client('sql', stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+out, err = c.communicate(create)
+sys.stdout.write(out)
+sys.stderr.write(err)
+c = process.client('sql', stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+out, err = c.communicate(explain)
+sys.stderr.write(err)
+# only the number of partitions depends on the machine
+sys.stdout.write('open %d, part %s, close %d\n' %
+                 (out.count('sql.export_table_open('),
+                  'yes' if 'sql.export_table_part(' in out else 'no',
+                  out.count('sql.export_table_close(')))
+c = process.client('sql', stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+out, err = c.communicate(script)
+sys.stdout.write(out)
+sys.stderr.write(err)
+out, err = s.communicate()
+sys.stdout.write(out)
+sys.stderr.write(err)
+
+a = open(streamed).read()
+b = open(packed).read()
+sys.stdout.write('%d lines, %s\n' % (a.count('\n'), 'same' if a == b else 'different'))
+
+try_remove_files()
@@ -0,0 +1,60 @@
+import sys, time
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# The changes to a table are kept in deltas while another transaction
+# is active and merged into the columns once no transaction is, after
+# which the data must survive a restart.
+
+def server():
+    return process.server(stdin = process.PIPE, stdout = process.PIPE,
+                          stderr = process.PIPE)
+
+def client():
+    return process.client('sql', interactive = True,
+                          stdin = process.PIPE, stdout = process.PIPE,
+                          stderr = process.PIPE)
+
+def run(c, stmt):
+    c.stdin.write(stmt + '\n')
+    c.stdin.flush()
+    time.sleep(1)                       # let it finish before the other session goes on
+
+def finish(p):
+    out, err = p.communicate()
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+check = 'select id, v from deltamerge where id % 100 = 5 or id >= 995 order by id;'
+deltas = 'select * from sys.deltas() where "table" = \'deltamerge\';'
+
+s = server()
+c1 = client()
+c2 = client()
+run(c1, "create table deltamerge (id int, v varchar(10));")
+run(c1, "insert into deltamerge select value, 'v' || value from generate_series(0, 1000);")
+# the open transaction keeps the changes below in the deltas
+run(c2, 'start transaction;')
+run(c2, 'select count(*) from deltamerge;')
+run(c1, "insert into deltamerge select value, 'w' || value from generate_series(1000, 1010);")
+run(c1, "update deltamerge set v = 'u' where id % 100 = 5;")
+run(c1, 'delete from deltamerge where id % 200 = 7;')
+run(c1, deltas)
+run(c2, 'rollback;')
+time.sleep(2)                           # give the merge manager a chance
+run(c1, deltas)
+run(c1, check)
+run(c1, 'select count(*) from deltamerge;')
+finish(c1)
+finish(c2)
+finish(s)
+
+s = server()
+c1 = client()
+run(c1, check)
+run(c1, 'select count(*) from deltamerge;')
+run(c1, 'drop table deltamerge;')
+finish(c1)
+finish(s)
@@ -0,0 +1,28 @@
+-- Strings of a large persistent column with few distinct values are
+-- dictionary encoded; selects and grouping on the codes must give the
+-- same results as on the decoded (computed) strings.
+create table dictstr (i int, s varchar(20));
+insert into dictstr
+select value, case when value % 1013 = 0 then null else 'key' || ((value * 7) % 5000) end
+  from generate_series(0, 300000);
+-- the dictionary is made when the column is saved or analyzed
+analyze sys.dictstr;
+
+select 'equal', (select count(*) from dictstr where s = 'key42'), (select count(*) from dictstr where s || '' = 'key42');
+select 'not equal', (select count(*) from dictstr where s <> 'key42'), (select count(*) from dictstr where s || '' <> 'key42');
+select 'missing', (select count(*) from dictstr where s = 'key5000'), (select count(*) from dictstr where s || '' = 'key5000');
+select 'between', (select count(*) from dictstr where s between 'key100' and 'key2'), (select count(*) from dictstr where s || '' between 'key100' and 'key2');
+select 'less', (select count(*) from dictstr where s < 'key3'), (select count(*) from dictstr where s || '' < 'key3');
+select 'greater', (select count(*) from dictstr where s >= 'key4999'), (select count(*) from dictstr where s || '' >= 'key4999');
+select 'like prefix', (select count(*) from dictstr where s like 'key12%'), (select count(*) from dictstr where s || '' like 'key12%');
+select 'like infix', (select count(*) from dictstr where s like '%99%'), (select count(*) from dictstr where s || '' like '%99%');
+select 'like single', (select count(*) from dictstr where s like 'key_7'), (select count(*) from dictstr where s || '' like 'key_7');
+select 'not like', (select count(*) from dictstr where s not like '%1%'), (select count(*) from dictstr where s || '' not like '%1%');
+select 'ilike', (select count(*) from dictstr where s ilike 'KEY33%'), (select count(*) from dictstr where s || '' ilike 'KEY33%');
+
+select 'groups', count(*), sum(c), min(c), max(c) from (select s, count(*) as c from dictstr group by s) as g;
+select 'groups', count(*), sum(c), min(c), max(c) from (select t, count(*) as c from (select s || '' as t from dictstr) as x group by t) as g;
+select s, count(*), sum(i) from dictstr where s in ('key0', 'key1', 'key4999') or s is null group by s order by s;
+select t, count(*), sum(i) from (select s || '' as t, i from dictstr) as x where t in ('key0', 'key1', 'key4999') or t is null group by t order by t;
+
+drop table dictstr;
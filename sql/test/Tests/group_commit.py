@@ -0,0 +1,74 @@
+import sys, time
+
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# Transactions that commit at the same time share a single sync of the
+# write-ahead log (group commit).  Run several clients that commit
+# concurrently, each to its own table (concurrent inserts into the same
+# table conflict), kill the server without shutting it down and check
+# after a restart that every commit that was acknowledged survived.
+# Then do the same with relaxed durability, where commits do not wait
+# for the sync, after giving the background sync time to run.
+
+nclients = 4
+ninserts = 250
+
+create = ''.join(['create table groupcommit%d (i int);\n' % k for k in range(nclients)])
+checks = ''.join(['select %d, count(*), min(i), max(i), cast(sum(i) as bigint) from groupcommit%d;\n' % (k, k)
+                  for k in range(nclients)])
+cleanup = ''.join(['drop table groupcommit%d;\n' % k for k in range(nclients)])
+
+def server(args):
+    return process.server(args = args,
+                          stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+
+def client(input):
+    c = process.client('sql', stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+    out, err = c.communicate(input)
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+def server_stop(s):
+    out, err = s.communicate()
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+def server_kill(s):
+    # the output of a killed server is not interesting
+    s.kill()
+    s.communicate()
+
+def load(first):
+    # each client does ninserts transactions of one row each
+    clients = []
+    for k in range(nclients):
+        c = process.client('sql', stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+        input = ''.join(['insert into groupcommit%d values (%d);\n' % (k, first + i)
+                         for i in range(ninserts)])
+        clients.append((c, input))
+    for c, input in clients:
+        c.stdin.write(input)
+        c.stdin.close()
+    for c, input in clients:
+        out = c.stdout.read()
+        err = c.stderr.read()
+        c.wait()
+        sys.stderr.write(err)
+
+for args, pause in ((['--set', 'gdk_commit_delay=5'], 0),
+                    (['--set', 'gdk_relaxed_durability=yes'], 1)):
+    s = server(args)
+    client(create)
+    load(0)
+    time.sleep(pause)
+    server_kill(s)
+    s = server(args)
+    client(checks)
+    load(ninserts)
+    server_stop(s)
+    s = server(args)
+    client(checks + cleanup)
+    server_stop(s)
@@ -0,0 +1,27 @@
+-- multi-column GROUP BY on a string column with fingerprints (more
+-- distinct values than fit a dictionary)
+create table grpfps (i int, s varchar(20));
+insert into grpfps select cast(value % 4 as int), 'v' || cast(value % 100000 as varchar(10)) from sys.generate_series(0, 200000);
+-- the fingerprints are made when the column is saved or analyzed
+analyze sys.grpfps;
+select count(*), min(c), max(c) from (select i, s, count(*) as c from grpfps group by i, s) as x;
+select count(*), min(c), max(c) from (select s, i, count(*) as c from grpfps group by s, i) as x;
+select count(*) from (select i, s, count(*) as c from grpfps group by i, s) as a, (select i, s || '' as s2, count(*) as c from grpfps group by i, s2) as b where a.i = b.i and a.s = b.s2 and a.c = b.c;
+select i, s, count(*) from grpfps where s in ('v0', 'v1', 'v99999') group by i, s order by i, s;
+
+-- (in)equality selects and hash joins also use the fingerprints, which
+-- must not let nils match
+insert into grpfps values (1, null), (2, null);
+analyze sys.grpfps;
+select 'equal', (select count(*) from grpfps where s = 'v12345'), (select count(*) from grpfps where s || '' = 'v12345');
+select 'not equal', (select count(*) from grpfps where s <> 'v12345'), (select count(*) from grpfps where s || '' <> 'v12345');
+select 'missing', (select count(*) from grpfps where s = 'w12345'), (select count(*) from grpfps where s || '' = 'w12345');
+select 'missing', (select count(*) from grpfps where s <> 'w12345'), (select count(*) from grpfps where s || '' <> 'w12345');
+create table grpkeys (s varchar(20), n int);
+insert into grpkeys select 'v' || cast(value * 7 as varchar(10)), cast(value as int) from sys.generate_series(0, 20000);
+insert into grpkeys values (null, -1);
+select 'join', count(*), cast(sum(k.n) as bigint) from grpfps g, grpkeys k where g.s = k.s;
+select 'join', count(*), cast(sum(k.n) as bigint) from grpfps g, grpkeys k where g.s || '' = k.s;
+select 'join', count(*), cast(sum(g.i) as bigint) from grpkeys k, grpfps g where k.s = g.s;
+drop table grpkeys;
+drop table grpfps;
@@ -0,0 +1,34 @@
+import sys
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# The memory of freed large intermediates is reused for later ones
+# through the heap cache; the results must be the same when the cache
+# is disabled, in which case it is never used.
+
+script = '''\
+create table heapcache (i int, j bigint, d double);
+insert into heapcache select value, value * 3, value / 7.0 from generate_series(0, 500000);
+select count(*), sum(j), sum(x) from (select i + 1 as x, j from heapcache where i % 3 <> 0) as t;
+select count(*), sum(cast(i as bigint) * 2), sum(j - i), min(d * 2), max(d + i) from heapcache where j > 100;
+select k, count(*), sum(j) from (select i % 10 as k, j from heapcache) as t group by k order by k;
+select name, cast(value as bigint) > 0 from sys.env() where name like 'gdk_heapcache%' order by name;
+drop table heapcache;
+'''
+
+for maxsize in (None, 0):
+    args = []
+    if maxsize is not None:
+        args = ["--set", "gdk_heapcache_maxsize=%d" % maxsize]
+    s = process.server(args = args, stdin = process.PIPE,
+                       stdout = process.PIPE, stderr = process.PIPE)
+    c = process.client('sql', stdin = process.PIPE, stdout = process.PIPE,
+                       stderr = process.PIPE)
+    out, err = c.communicate(script)
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+    out, err = s.communicate()
+    sys.stdout.write(out)
+    sys.stderr.write(err)
@@ -0,0 +1,73 @@
+import os, sys
+
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# Range selects on persistent columns use imprints, which are extended
+# when the column is appended to and saved with the column.  Append in
+# batches with range selects in between, restart the server (which
+# moves the appended rows into the persistent columns) and select
+# again, and compare the results with evaluating the predicates row by
+# row, which does not use imprints.  The values are neither clustered
+# nor small, so that zone maps and packing do not replace the imprints.
+
+nbatches = 4
+batchsize = 100000
+
+ranges = [('i', '10', '2000'), ('i', '99000', '99999'),
+          ('l', '500000000000000', '510000000000000'), ('l', '-1', '100000000000'),
+          ('d', '10.5', '20.25'), ('d', '249', '300')]
+
+def batch(k):
+    return ('insert into impappend select value * 7 %% 100000, (value * 7919 %% 1000003) * 1000000007, (value %% 1000) / 4.0'
+            ' from generate_series(%d, %d);\n' % (k * batchsize, (k + 1) * batchsize))
+
+def selects(label):
+    q = ''
+    for c, lo, hi in ranges:
+        q += ("select '%s %s', (select count(*) from impappend where %s between %s and %s),"
+              " (select sum(case when %s between %s and %s then 1 else 0 end) from impappend);\n" %
+              (label, c, c, lo, hi, c, lo, hi))
+    return q
+
+sizes = "select \"column\", imprints > 0 from sys.storage where \"table\" = 'impappend' order by \"column\";\n"
+
+def imprints_files():
+    n = 0
+    for d, dirs, files in os.walk(os.path.join(os.getenv('GDK_DBFARM'), os.getenv('TSTDB'), 'bat')):
+        n += len([f for f in files if f.endswith('.timprints')])
+    return n
+
+def server():
+    return process.server(stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+
+def client(input):
+    c = process.client('sql', stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+    out, err = c.communicate(input)
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+def server_stop(s):
+    out, err = s.communicate()
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+s = server()
+client('create table impappend (i int, l bigint, d double);\n')
+for k in range(2):
+    client(batch(k) + selects('batch %d' % k))
+server_stop(s)
+
+for k in range(2, nbatches):
+    s = server()
+    client(selects('restart') + sizes)
+    client(batch(k) + selects('batch %d' % k))
+    server_stop(s)
+    sys.stdout.write('imprints saved: %s\n' % (imprints_files() >= 3))
+
+s = server()
+client(selects('restart') + sizes)
+client('drop table impappend;\n')
+server_stop(s)
@@ -0,0 +1,25 @@
+-- LIKE rejects strings that lack the longest literal part of the
+-- pattern, honouring the escape character, and reuses compiled patterns;
+-- the results must agree with plain substring searches.
+create table likelit (i int, s varchar(30));
+insert into likelit
+select value, case when value % 997 = 0 then null else
+       'r' || value || case value % 8 when 0 then 'a_b' when 1 then 'axb' when 2 then '50%' when 3 then '50x'
+                                      when 4 then 'Abc' when 5 then 'abc' when 6 then 'a\\b' else '' end end
+  from generate_series(0, 200000);
+
+select 'escaped _', (select count(*) from likelit where s like '%a\\_b%' escape '\\'), (select count(*) from likelit where locate('a_b', s) > 0);
+select 'escaped %', (select count(*) from likelit where s like '%50!%%' escape '!'), (select count(*) from likelit where locate('50%', s) > 0);
+select 'unescaped _', (select count(*) from likelit where s like '%a_b%'), (select count(*) from likelit where locate('a_b', s) > 0 or locate('axb', s) > 0 or locate('a\\b', s) > 0);
+select 'plain', (select count(*) from likelit where s like '%abc%'), (select count(*) from likelit where locate('abc', s) > 0);
+select 'plain again', (select count(*) from likelit where s like '%abc%'), (select count(*) from likelit where locate('abc', s) > 0);
+select 'keywords', (select count(*) from likelit where s like '%99%abc%'), (select count(*) from likelit where locate('abc', s) > 0 and locate('99', s) > 0 and locate('99', s) < locate('abc', s));
+select 'ilike', (select count(*) from likelit where s ilike '%abc%'), (select count(*) from likelit where locate('abc', lower(s)) > 0);
+select 'not like', (select count(*) from likelit where s not like '%a\\_b%' escape '\\'), (select count(*) from likelit where s is not null and locate('a_b', s) = 0);
+select 'prefix', (select count(*) from likelit where s like 'r12%50!%' escape '!'), (select count(*) from likelit where s like 'r12%' and locate('50%', s) > 0);
+
+select 'projection', sum(case when s like '%a\\_b%' escape '\\' then 1 else 0 end), sum(case when s like '%50!%%' escape '!' then 1 else 0 end),
+       sum(case when s like '%abc%' then 1 else 0 end), sum(case when s ilike '%abc%' then 1 else 0 end) from likelit;
+select i, s from likelit where s like '%a\\_b%' escape '\\' and i < 100 order by i;
+
+drop table likelit;
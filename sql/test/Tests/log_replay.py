@@ -0,0 +1,63 @@
+import sys
+
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# The write-ahead log is replayed at startup, applying the changes to
+# different columns in parallel.  Make inserts, updates and deletes,
+# restart and check that the data is the same, with one and with four
+# threads.
+
+changes = '''\
+create table walreplay (id int, a int, b bigint, c double, s varchar(20));
+insert into walreplay select value, value % 1000, value * 3, value / 7.0, 's' || value from generate_series(0, 200000);
+insert into walreplay select value, value % 1000, value * 3, value / 7.0, 's' || value from generate_series(200000, 250000);
+update walreplay set a = -1 where id % 10 = 3;
+update walreplay set b = b + 1, s = 'u' || id where id % 7 = 2;
+update walreplay set a = a - 1 where id % 10 = 3;
+delete from walreplay where id % 100 = 55;
+update walreplay set c = 0.5 where id % 1000 = 999;
+insert into walreplay select value, value % 1000, value * 3, value / 7.0, 's' || value from generate_series(250000, 260000);
+update walreplay set s = 'v' || id where id > 255000;
+create table walreplay2 (x int);
+insert into walreplay2 select value from generate_series(0, 1000);
+update walreplay2 set x = x + 1;
+update walreplay2 set x = x * 2 where x % 3 = 0;
+'''
+
+checks = '''\
+select count(*), sum(id), sum(a), sum(b), sum(c), count(distinct s), sum(length(s)) from walreplay;
+select count(*) from walreplay where s like 'u%';
+select count(*) from walreplay where s like 'v%';
+select count(*), sum(x) from walreplay2;
+'''
+
+cleanup = '''\
+drop table walreplay;
+drop table walreplay2;
+'''
+
+def server(nthreads):
+    return process.server(args = ["--set", "gdk_nr_threads=%d" % nthreads],
+                          stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+
+def client(input):
+    c = process.client('sql', stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+    out, err = c.communicate(input)
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+def server_stop(s):
+    out, err = s.communicate()
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+for nthreads in (1, 4):
+    s = server(nthreads)
+    client(changes + checks)
+    server_stop(s)
+    s = server(nthreads)
+    client(checks + cleanup)
+    server_stop(s)
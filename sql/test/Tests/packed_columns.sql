@@ -0,0 +1,36 @@
+-- aggregates, selects and projections on persistent integer columns with
+-- a packed copy (frame of reference, run length and dictionary encoded)
+-- must agree with the same computations on the unpacked values
+create table packed (i int, r bigint, k int, s smallint, dt date);
+insert into packed
+select case when value % 1009 = 0 then null else value % 5000 - 2500 end,
+       (value / 1000) * 1000000000,
+       case value % 4 when 0 then -1000000 when 1 then 5 when 2 then 70000000 else 123 end,
+       case when value % 7 = 0 then null else value % 100 end,
+       date '2000-01-01' + (value % 3000) * interval '1' day
+  from generate_series(0, 300000);
+-- the packed copies are made when the columns are saved or analyzed
+analyze sys.packed;
+
+select 'int', count(i), sum(i), min(i), max(i) from packed;
+select 'int', count(i + 0), sum(i + 0), min(i + 0), max(i + 0) from packed;
+select 'bigint', count(r), sum(r), min(r), max(r) from packed;
+select 'bigint', count(r + 0), sum(r + 0), min(r + 0), max(r + 0) from packed;
+select 'dict', count(k), sum(k), min(k), max(k) from packed;
+select 'dict', count(k + 0), sum(k + 0), min(k + 0), max(k + 0) from packed;
+select 'smallint', count(s), sum(s), min(s), max(s) from packed;
+select 'smallint', count(s + 0), sum(s + 0), min(s + 0), max(s + 0) from packed;
+select 'date', count(dt), min(dt), max(dt) from packed;
+select 'date', count(dt + interval '0' day), min(dt + interval '0' day), max(dt + interval '0' day) from packed;
+
+select 'select', count(*), sum(r), sum(k), sum(s) from packed where i between -10 and 10;
+select 'select', count(*), sum(r + 0), sum(k + 0), sum(s + 0) from packed where i + 0 between -10 and 10;
+select 'select', count(*), min(dt), max(i) from packed where k = 123 and r >= 250000000000;
+select 'select', count(*), min(dt + interval '0' day), max(i + 0) from packed where k + 0 = 123 and r + 0 >= 250000000000;
+
+-- the packed copy is dropped when the column changes
+update packed set i = 100000 where i = 0;
+select 'int', count(i), sum(i), min(i), max(i) from packed;
+select 'int', count(i + 0), sum(i + 0), min(i + 0), max(i + 0) from packed;
+
+drop table packed;
@@ -0,0 +1,79 @@
+import sys
+
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# With gdk_hugepages and gdk_prefault set, the memory mapped heaps of
+# BATs loaded from disk are faulted in by a background thread.  The
+# query results must be the same as without, and bat.info must report
+# the page faults taken by prefaulting as tail.faults (and, for
+# strings, theap.faults).
+
+options = ['--set', 'gdk_hugepages=yes', '--set', 'gdk_prefault=yes']
+
+create = '''\
+create table prefault (i int, s varchar(20));
+insert into prefault select value, 's' || (value % 100000) from generate_series(0, 3000000);
+'''
+
+queries = '''\
+select count(*), cast(sum(i) as bigint), count(distinct s) from prefault;
+select count(*), min(i), max(i) from prefault where s = 's4242';
+update prefault set i = -i where i % 1000 = 0;
+select count(*), cast(sum(i) as bigint) from prefault where i < 0;
+insert into prefault select value, 't' || value from generate_series(3000000, 3500000);
+select count(*), cast(sum(i) as bigint), count(distinct s) from prefault;
+'''
+
+names = '''\
+select ttype, name from sys.bbp() where count >= 3000000 and kind = 'persistent' and ttype in ('int', 'str') order by ttype;
+'''
+
+def server(args):
+    return process.server(args = args,
+                          stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+
+def client(lang, input, output = True):
+    c = process.client(lang, stdin = process.PIPE, stdout = process.PIPE, stderr = process.PIPE)
+    out, err = c.communicate(input)
+    if output:
+        sys.stdout.write(out)
+    sys.stderr.write(err)
+    return out
+
+def server_stop(s):
+    out, err = s.communicate()
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+# the BATs are loaded from disk after each restart
+s = server([])
+client('sql', create)
+server_stop(s)
+s = server([])
+expected = client('sql', queries, output = False)
+client('sql', 'drop table prefault;\n' + create)
+server_stop(s)
+
+s = server(options)
+out = client('sql', queries)
+sys.stdout.write('same as without prefaulting: %s\n' % (out == expected))
+server_stop(s)
+
+s = server(options)
+client('sql', 'select count(*), cast(sum(i) as bigint), count(distinct s) from prefault;\n')
+out = client('sql', names, output = False)
+for line in out.split('\n'):
+    if not line.startswith('['):
+        continue
+    tpe, name = [x.strip().strip('"') for x in line.strip('[ ]').split(',')]
+    info = client('mal', 'b:bat[:%s] := bbp.bind("%s");\n(k, v) := bat.info(b);\nio.print(k, v);\n' % (tpe, name), output = False)
+    for key in ('tail.faults', 'theap.faults'):
+        for l in info.split('\n'):
+            if '"%s"' % key in l:
+                value = l.split(',')[-1].strip(' ]"\t')
+                sys.stdout.write('%s %s: %s\n' % (tpe, key, 'reported' if value.isdigit() else value))
+client('sql', 'drop table prefault;\n')
+server_stop(s)
@@ -0,0 +1,19 @@
+-- the query cache keeps the "cache" most recently used queries
+create table qcache (a int, b int);
+insert into qcache values (1, 10), (2, 20), (3, 30);
+set cache = 3;
+select a from qcache where b = 10;
+select b from qcache where a = 2;
+select a + b from qcache where a = 3;
+select a * b from qcache where b = 20;
+select a - b from qcache where a = 1;
+select event, count from sys.queryCacheStats();
+-- the most recently used queries are still cached, the older ones
+-- were evicted
+select a - b from qcache where a = 1;
+select a * b from qcache where b = 20;
+select a from qcache where b = 10;
+select event, count from sys.queryCacheStats();
+select query, count from sys.queryCache() where query like '%from qcache%' order by query;
+set cache = 100;
+drop table qcache;
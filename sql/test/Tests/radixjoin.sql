@@ -0,0 +1,21 @@
+-- equi-joins with an inner side of at least 1M rows without a hash
+-- table use the radix-partitioned join
+set optimizer = 'no_mitosis_pipe';
+create table rjl (k int, v int);
+create table rjr (k int, w int);
+insert into rjl select cast(value as int), cast(value % 7 as int) from sys.generate_series(0, 1500000);
+insert into rjr select cast((value * 3) % 2000000 as int), cast(value % 5 as int) from sys.generate_series(0, 1200000);
+insert into rjr values (null, 1), (5, 9), (6, 9);
+select count(*), sum(cast(l.k as bigint)), sum(l.v * r.w) from rjl l, rjr r where l.k = r.k;
+select count(*), sum(cast(l.k as bigint)), sum(l.v * r.w) from rjl l, rjr r where cast(l.k as bigint) = cast(r.k as bigint);
+-- with a candidate list that is not dense the hash join is used
+select count(*), sum(cast(l.k as bigint)), sum(l.v * r.w) from rjl l, rjr r where l.k = r.k and r.w <> 3 and l.v <> 4;
+select count(*), sum(cast(l.k as bigint)), sum(l.v * r.w) from rjl l, rjr r where l.k = r.k and r.w < 10 and l.v < 10;
+select l.k, r.w from rjl l, rjr r where l.k = r.k and l.k < 12 order by l.k, r.w;
+-- the left output is sorted
+select l.k, l.v, r.w from rjl l, rjr r where l.k = r.k limit 8;
+select count(*) from rjl l left outer join rjr r on l.k = r.k;
+select count(*) from rjl l where l.k in (select k from rjr);
+drop table rjl;
+drop table rjr;
+set optimizer = 'default_pipe';
@@ -0,0 +1,36 @@
+-- the full scan selects on the fixed width types (vectorized where the
+-- CPU allows) must agree with evaluating the predicate per row
+create table simdsel (b tinyint, s smallint, i int, l bigint, r real, d double);
+insert into simdsel
+select case when value % 13 = 0 then null else value % 100 - 50 end,
+       case when value % 17 = 0 then null else value % 1000 - 500 end,
+       case when value % 19 = 0 then null else value - 5000 end,
+       case when value % 23 = 0 then null else value * 1000003 - 5000000000 end,
+       case when value % 29 = 0 then null else (value % 777) / 7.0 end,
+       case when value % 31 = 0 then null else value / 3.0 end
+  from generate_series(0, 10003);
+
+select 'tinyint =', (select count(*) from simdsel where b = 7), (select sum(case when b = 7 then 1 else 0 end) from simdsel);
+select 'tinyint <>', (select count(*) from simdsel where b <> 7), (select sum(case when b <> 7 then 1 else 0 end) from simdsel);
+select 'tinyint between', (select count(*) from simdsel where b between -10 and 20), (select sum(case when b between -10 and 20 then 1 else 0 end) from simdsel);
+select 'tinyint not between', (select count(*) from simdsel where b not between -10 and 20), (select sum(case when b not between -10 and 20 then 1 else 0 end) from simdsel);
+select 'tinyint >', (select count(*) from simdsel where b > 30), (select sum(case when b > 30 then 1 else 0 end) from simdsel);
+select 'smallint =', (select count(*) from simdsel where s = -499), (select sum(case when s = -499 then 1 else 0 end) from simdsel);
+select 'smallint between', (select count(*) from simdsel where s between -100 and 100), (select sum(case when s between -100 and 100 then 1 else 0 end) from simdsel);
+select 'smallint <', (select count(*) from simdsel where s < -250), (select sum(case when s < -250 then 1 else 0 end) from simdsel);
+select 'int =', (select count(*) from simdsel where i = 4998), (select sum(case when i = 4998 then 1 else 0 end) from simdsel);
+select 'int <>', (select count(*) from simdsel where i <> 4998), (select sum(case when i <> 4998 then 1 else 0 end) from simdsel);
+select 'int between', (select count(*) from simdsel where i between -1234 and 2345), (select sum(case when i between -1234 and 2345 then 1 else 0 end) from simdsel);
+select 'int not between', (select count(*) from simdsel where i not between -1234 and 2345), (select sum(case when i not between -1234 and 2345 then 1 else 0 end) from simdsel);
+select 'int >=', (select count(*) from simdsel where i >= 5000), (select sum(case when i >= 5000 then 1 else 0 end) from simdsel);
+select 'bigint =', (select count(*) from simdsel where l = -4997999994), (select sum(case when l = -4997999994 then 1 else 0 end) from simdsel);
+select 'bigint between', (select count(*) from simdsel where l between -10000000 and 5000000000), (select sum(case when l between -10000000 and 5000000000 then 1 else 0 end) from simdsel);
+select 'bigint <=', (select count(*) from simdsel where l <= 0), (select sum(case when l <= 0 then 1 else 0 end) from simdsel);
+select 'real =', (select count(*) from simdsel where r = 1), (select sum(case when r = 1 then 1 else 0 end) from simdsel);
+select 'real between', (select count(*) from simdsel where r between 10 and 50), (select sum(case when r between 10 and 50 then 1 else 0 end) from simdsel);
+select 'real not between', (select count(*) from simdsel where r not between 10 and 50), (select sum(case when r not between 10 and 50 then 1 else 0 end) from simdsel);
+select 'double =', (select count(*) from simdsel where d = 1000), (select sum(case when d = 1000 then 1 else 0 end) from simdsel);
+select 'double between', (select count(*) from simdsel where d between 100.5 and 2000.25), (select sum(case when d between 100.5 and 2000.25 then 1 else 0 end) from simdsel);
+select 'double >', (select count(*) from simdsel where d > 3333), (select sum(case when d > 3333 then 1 else 0 end) from simdsel);
+
+drop table simdsel;
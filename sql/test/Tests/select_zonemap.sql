@@ -0,0 +1,30 @@
+-- selects on persistent numerical columns with clustered values use the
+-- zone map; they must agree with evaluating the predicate per row
+create table zonemap (i int, l bigint, d double);
+insert into zonemap
+select case when value % 1001 = 0 then null else value - (value * 37) % 100 end,
+       (value - (value * 53) % 1000) * 1000,
+       case when value % 997 = 0 then null else (value - (value * 29) % 50) / 4.0 end
+  from generate_series(0, 300000);
+-- the zone maps are built when the columns are saved or analyzed
+analyze sys.zonemap;
+
+select 'int between', (select count(*) from zonemap where i between 123456 and 130000), (select sum(case when i between 123456 and 130000 then 1 else 0 end) from zonemap);
+select 'int =', (select count(*) from zonemap where i = 200000), (select sum(case when i = 200000 then 1 else 0 end) from zonemap);
+select 'int <', (select count(*) from zonemap where i < 5000), (select sum(case when i < 5000 then 1 else 0 end) from zonemap);
+select 'int none', (select count(*) from zonemap where i between 400000 and 500000), (select sum(case when i between 400000 and 500000 then 1 else 0 end) from zonemap);
+select 'int not between', (select count(*) from zonemap where i not between 1000 and 290000), (select sum(case when i not between 1000 and 290000 then 1 else 0 end) from zonemap);
+select 'bigint between', (select count(*) from zonemap where l between 50000000 and 52000000), (select sum(case when l between 50000000 and 52000000 then 1 else 0 end) from zonemap);
+select 'bigint >=', (select count(*) from zonemap where l >= 299000000), (select sum(case when l >= 299000000 then 1 else 0 end) from zonemap);
+select 'double between', (select count(*) from zonemap where d between 10000 and 10500.5), (select sum(case when d between 10000 and 10500.5 then 1 else 0 end) from zonemap);
+select 'double none', (select count(*) from zonemap where d < -1), (select sum(case when d < -1 then 1 else 0 end) from zonemap);
+
+-- the zone map must follow appends and updates
+insert into zonemap select value, value * 1000, value / 4.0 from generate_series(300000, 310000);
+update zonemap set i = 1000000 where i between 150000 and 150010;
+select 'int between', (select count(*) from zonemap where i between 123456 and 130000), (select sum(case when i between 123456 and 130000 then 1 else 0 end) from zonemap);
+select 'int appended', (select count(*) from zonemap where i between 305000 and 306000), (select sum(case when i between 305000 and 306000 then 1 else 0 end) from zonemap);
+select 'int updated', (select count(*) from zonemap where i > 999999), (select sum(case when i > 999999 then 1 else 0 end) from zonemap);
+select 'bigint >=', (select count(*) from zonemap where l >= 299000000), (select sum(case when l >= 299000000 then 1 else 0 end) from zonemap);
+
+drop table zonemap;
@@ -0,0 +1,39 @@
+import sys
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# BATsort sorts inputs of at least 1M values in parallel when there is
+# more than one thread; run the same sorts with one and with four
+# threads, the results must be the same.
+
+script = '''\
+create table psort (id int, i int, d double, s varchar(10));
+insert into psort select value, cast((value * 7919) % 1000003 as int) % 50000, ((value * 104729) % 1000033) / 7.0, 'k' || ((value * 31) % 99991) from generate_series(0, 1200000);
+select count(*), sum(cast(rn as bigint) * id) from (select id, row_number() over (order by i, id) as rn from psort) as x;
+select count(*), sum(cast(rn as bigint) * id) from (select id, row_number() over (order by d desc, id) as rn from psort) as x;
+select count(*), sum(cast(rn as bigint) * id) from (select id, row_number() over (order by s, id desc) as rn from psort) as x;
+select count(*), sum(cast(rn as bigint) * id) from (select id, row_number() over (order by i desc, d, id) as rn from psort) as x;
+drop table psort;
+'''
+
+def main():
+    for nthreads in (1, 4):
+        s = process.server(args = ["--set", "gdk_nr_threads=%d" % nthreads],
+                           stdin = process.PIPE,
+                           stdout = process.PIPE,
+                           stderr = process.PIPE)
+        c = process.client('sql',
+                           stdin = process.PIPE,
+                           stdout = process.PIPE,
+                           stderr = process.PIPE)
+        out, err = c.communicate(script)
+        sys.stdout.write(out)
+        sys.stderr.write(err)
+        out, err = s.communicate()
+        sys.stdout.write(out)
+        sys.stderr.write(err)
+
+if __name__ == '__main__':
+    main()
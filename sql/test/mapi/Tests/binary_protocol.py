@@ -0,0 +1,91 @@
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0.  If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#
+# Copyright 1997 - July 2008 CWI, August 2008 - 2018 MonetDB B.V.
+
+# Result sets received in binary (protocol 10) must give the same
+# output as the textual protocol.  Compare the output of mclient with
+# and without --binary/--compression in several formats, and the
+# values returned by mapi_fetch_row and mapi_fetch_column_block (see
+# clients/examples/C/columnblock.c).  Used by the binary_protocol_*
+# tests, one for each compression.
+
+import os, sys, subprocess
+
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+create = '''\
+create table binprot (i int, t tinyint, l bigint, d decimal(12,3), f double, s varchar(40), dt date, ts timestamp);
+insert into binprot select value,
+       case when value % 3 = 0 then null else value % 100 end,
+       case when value % 7 = 0 then null else (value - 25000) * 1000000007 end,
+       case when value % 11 = 0 then null else (value - 25000) / 7.0 end,
+       case when value % 13 = 0 then null else (value - 25000) / 16.0 end,
+       case when value % 17 = 0 then null
+            when value % 5 = 0 then 'q"t\\tb\\\\n\\n' || value
+            when value % 5 = 1 then ''
+            else 's' || value end,
+       case when value % 19 = 0 then null else date '2000-01-01' + value * interval '1' day end,
+       case when value % 23 = 0 then null else timestamp '2000-01-01 12:34:56.789' + value * interval '61' second end
+  from generate_series(0, 50000);
+'''
+
+sample = 'select * from binprot where i < 12 order by i'
+query = 'select * from binprot order by i'
+
+def client(args = [], input = None, format = None):
+    c = process.client('sql', args = args, format = format,
+                       stdin = process.PIPE if input else None,
+                       stdout = process.PIPE, stderr = process.PIPE)
+    return c.communicate(input)
+
+def output(args, format):
+    # the output is large, so write it to a file
+    name = os.path.join(os.getenv('TSTTRGDIR'), 'binary_protocol.out')
+    f = open(name, 'w')
+    c = process.client('sql', args = args + ['-s', query], format = format,
+                       stdout = f, stderr = process.PIPE)
+    out, err = c.communicate()
+    f.close()
+    sys.stderr.write(err)
+    f = open(name)
+    out = f.read()
+    f.close()
+    os.remove(name)
+    return out
+
+def run(compression):
+    out, err = client(input = create)
+    sys.stderr.write(err)
+
+    if compression == 'none':
+        binaries = [['-B'], ['-C', 'none']]
+    else:
+        binaries = [['-C', compression]]
+
+    out, err = client(args = binaries[-1] + ['-s', sample], format = 'sql')
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+    for fmt in ('sql', 'csv', 'tab', 'raw'):
+        text = output([], fmt)
+        for args in binaries:
+            out = output(args, fmt)
+            sys.stdout.write('%s %s: %d lines, %s\n' %
+                             (' '.join(args), fmt, text.count('\n'),
+                              'same' if out == text else 'different'))
+
+    p = subprocess.Popen(['columnblock', os.getenv('MAPIHOST'),
+                          os.getenv('MAPIPORT'), compression],
+                         stdout = subprocess.PIPE, stderr = subprocess.PIPE,
+                         universal_newlines = True)
+    out, err = p.communicate()
+    sys.stdout.write(out)
+    sys.stderr.write(err)
+
+    out, err = client(input = 'drop table binprot;\n')
+    sys.stderr.write(err)
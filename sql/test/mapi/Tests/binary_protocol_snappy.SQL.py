@@ -0,0 +1,5 @@
+import os, sys
+sys.path.insert(0, os.getenv('TSTSRCDIR'))
+import binary_protocol
+
+binary_protocol.run('snappy')
@@ -0,0 +1,27 @@
+create table windowtest (g int, x int, v int, d decimal(9,2), f double, s varchar(10));
+insert into windowtest values (1, 1, 10, 1.50, 1.5, 'b'), (1, 2, null, 2.25, null, 'a'), (1, 3, 30, 3.00, 3.0, null), (1, 3, 35, 3.50, 3.5, 'e'), (1, 6, 40, 4.00, 4.0, 'd'), (2, 1, 5, 0.10, 0.1, 'z'), (2, 3, 6, 0.20, 0.2, 'y'), (2, null, 7, 0.30, 0.3, 'x');
+
+-- default frames: the whole partition, or up to the last peer
+select g, x, v, sum(v) over (partition by g) as s, count(*) over (partition by g) as c, count(v) over (partition by g) as cv from windowtest order by g, x, v;
+select g, x, v, sum(v) over (partition by g order by x) as s, min(v) over (partition by g order by x) as mn, max(s) over (partition by g order by x) as mx from windowtest order by g, x, v;
+
+-- ROWS frames
+select g, x, v, sum(v) over (partition by g order by x, v rows between 1 preceding and 1 following) as s, avg(v) over (partition by g order by x, v rows 2 preceding) as a, max(v) over (partition by g order by x, v rows between current row and unbounded following) as mx from windowtest order by g, x, v;
+select x, v, sum(f) over (order by g, x, v rows between 2 preceding and current row) as sf, sum(d) over (order by g, x, v rows between unbounded preceding and current row) as sd, avg(d) over (order by g, x, v rows between 1 preceding and 1 following) as ad from windowtest order by g, x, v;
+
+-- RANGE frames
+select g, x, v, sum(v) over (partition by g order by x range between 1 preceding and 1 following) as s, count(v) over (partition by g order by x range between 2 preceding and current row) as c, min(v) over (partition by g order by x desc range between current row and 3 following) as mn from windowtest order by g, x, v;
+select g, x, v, sum(v) over (partition by g order by d range between 1 preceding and current row) as s from windowtest order by g, x, v;
+
+-- an empty input
+create table windowempty (x int, v int, f double, s varchar(10));
+select x, sum(v) over (order by x rows 1 preceding) as s, sum(f) over (order by x rows between 1 preceding and 1 following) as sf, avg(v) over (order by x rows 2 preceding) as a, min(s) over (order by x rows 1 preceding) as mn, max(v) over (order by x range between 1 preceding and current row) as mx, count(v) over (order by x rows 1 preceding) as c from windowempty;
+drop table windowempty;
+
+-- errors
+select sum(v) over (order by s range between 1 preceding and current row) from windowtest;
+select sum(v) over (order by x, v range between 1 preceding and current row) from windowtest;
+select sum(v) over (order by x rows between 1 preceding and current row exclude ties) from windowtest;
+select sum(distinct v) over (order by x) from windowtest;
+
+drop table windowtest;